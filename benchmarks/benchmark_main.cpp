@@ -9,6 +9,7 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -20,8 +21,12 @@
 #endif
 
 #include "fixtures.hpp"
+#include "jazzy_index_autotune.hpp"
+#include "jazzy_index_coroutine.hpp"
+#include "jazzy_index_executor.hpp"
 #include "jazzy_index_export.hpp"
 #include "jazzy_index_parallel.hpp"
+#include "jazzy_index_prefix.hpp"
 
 namespace {
 
@@ -37,6 +42,9 @@ static bool use_full_benchmarks = false;
 // Global flag to run ONLY 20 million element benchmarks
 static bool use_20m_benchmarks = false;
 
+// Global flag to record index_stats() next to each JazzyIndex/* timing (--index-stats)
+static bool record_index_stats = false;
+
 // Key-value struct for benchmarking
 struct KeyValue {
     std::uint64_t key;
@@ -139,6 +147,27 @@ auto maybe_add_threads(BenchmarkType* bench) -> decltype(bench) {
     return bench;
 }
 
+// With --index-stats, the index's memory, model mix, errors, expected probes and build time
+// as counters (plotted against latency by scripts/plot_benchmarks.py --pareto)
+template <typename Index>
+void add_index_stats_counters(benchmark::State& state, const Index& index) {
+    if (!record_index_stats) {
+        return;
+    }
+    const jazzy::IndexStats stats = index.index_stats();
+    state.counters["index_bytes"] = static_cast<double>(stats.memory_bytes);
+    state.counters["built_segments"] = static_cast<double>(stats.num_segments);
+    state.counters["constant"] = static_cast<double>(stats.constant_segments);
+    state.counters["linear"] = static_cast<double>(stats.linear_segments);
+    state.counters["quadratic"] = static_cast<double>(stats.quadratic_segments);
+    state.counters["cubic"] = static_cast<double>(stats.cubic_segments);
+    state.counters["max_error"] = static_cast<double>(stats.max_error);
+    state.counters["mean_error"] = stats.mean_error;
+    state.counters["uniform"] = stats.uniform ? 1.0 : 0.0;
+    state.counters["expected_probes"] = stats.expected_probes;
+    state.counters["build_ns"] = static_cast<double>(stats.build.total_ns());
+}
+
 // Baseline: std::lower_bound benchmarks for comparison
 
 template <typename T>
@@ -373,13 +402,19 @@ void register_build_benchmark(std::size_t size, const std::string& distribution,
     maybe_add_threads(
         benchmark::RegisterBenchmark(name.c_str(),
                                      [data](benchmark::State& state) {
+                                         std::size_t index_bytes = 0;
                                          for (auto _ : state) {
                                              jazzy::JazzyIndex<std::uint64_t, jazzy::to_segment_count<Segments>()> index;
                                              index.build(data.data(), data.data() + data.size());
                                              benchmark::DoNotOptimize(index);
+                                             index_bytes = index.memory_usage();
                                          }
+                                         // Keys analyzed per second, comparable across sizes of a distribution
+                                         state.SetItemsProcessed(state.iterations() *
+                                                                 static_cast<std::int64_t>(data.size()));
                                          state.counters["segments"] = Segments;
                                          state.counters["size"] = static_cast<double>(data.size());
+                                         state.counters["index_bytes"] = static_cast<double>(index_bytes);
                                      })
             ->Unit(benchmark::kMicrosecond));
 }
@@ -398,12 +433,40 @@ void register_parallel_build_benchmark(std::size_t size, const std::string& dist
                                          index.build_parallel(data.data(), data.data() + data.size());
                                          benchmark::DoNotOptimize(index);
                                      }
+                                     state.SetItemsProcessed(state.iterations() *
+                                                             static_cast<std::int64_t>(data.size()));
                                      state.counters["segments"] = Segments;
                                      state.counters["size"] = static_cast<double>(data.size());
                                  })
         ->Unit(benchmark::kMicrosecond);
 }
 
+// Parallel build scaling: the same build on thread pools of 1 to 64 threads (counts above the
+// hardware thread count are skipped). Wall-clock time, since the workers' CPU time is not the
+// benchmark thread's
+void register_parallel_build_scaling_suite(std::size_t size, const std::string& distribution,
+                                           const std::vector<std::uint64_t>& data) {
+    const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1; threads <= 64 && threads <= hardware; threads *= 2) {
+        const std::string name = "JazzyIndexBuildScaling/" + distribution + "/S2048/N" +
+                                 std::to_string(size) + "/T" + std::to_string(threads);
+
+        benchmark::RegisterBenchmark(name.c_str(),
+                                     [data, threads](benchmark::State& state) {
+                                         jazzy::parallel::ThreadPool pool(threads);
+                                         for (auto _ : state) {
+                                             jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MAX> index;
+                                             index.build_parallel(data.data(), data.data() + data.size(), pool);
+                                             benchmark::DoNotOptimize(index);
+                                         }
+                                         state.counters["threads"] = static_cast<double>(threads);
+                                         state.counters["size"] = static_cast<double>(data.size());
+                                     })
+            ->Unit(benchmark::kMicrosecond)
+            ->UseRealTime();
+    }
+}
+
 void register_build_suites() {
     std::vector<std::size_t> sizes;
     if (use_20m_benchmarks) {
@@ -459,6 +522,9 @@ void register_build_suites() {
             register_build_benchmark<decltype(seg_tag)::value>(size, "InversePoly", inverse_poly_data);
             register_parallel_build_benchmark<decltype(seg_tag)::value>(size, "InversePoly", inverse_poly_data);
         });
+
+        register_parallel_build_scaling_suite(size, "Uniform", uniform_data);
+        register_parallel_build_scaling_suite(size, "Zipf", zipf_data);
     }
 }
 
@@ -492,6 +558,7 @@ void register_uniform_suite(std::size_t size) {
                                          }
                                          state.counters["segments"] = Segments;
                                          state.counters["size"] = static_cast<double>(data->size());
+                                         add_index_stats_counters(state, index);
                                      })
             ->Unit(benchmark::kNanosecond));
 
@@ -505,6 +572,7 @@ void register_uniform_suite(std::size_t size) {
                                          }
                                          state.counters["segments"] = Segments;
                                          state.counters["size"] = static_cast<double>(data->size());
+                                         add_index_stats_counters(state, index);
                                      })
             ->Unit(benchmark::kNanosecond));
 
@@ -518,6 +586,7 @@ void register_uniform_suite(std::size_t size) {
                                          }
                                          state.counters["segments"] = Segments;
                                          state.counters["size"] = static_cast<double>(data->size());
+                                         add_index_stats_counters(state, index);
                                      })
             ->Unit(benchmark::kNanosecond));
 
@@ -555,6 +624,7 @@ void register_distribution_suite(const std::string& name,
                                          }
                                          state.counters["segments"] = Segments;
                                          state.counters["size"] = static_cast<double>(data->size());
+                                         add_index_stats_counters(state, index);
                                      })
             ->Unit(benchmark::kNanosecond));
 
@@ -568,6 +638,7 @@ void register_distribution_suite(const std::string& name,
                                          }
                                          state.counters["segments"] = Segments;
                                          state.counters["size"] = static_cast<double>(data->size());
+                                         add_index_stats_counters(state, index);
                                      })
             ->Unit(benchmark::kNanosecond));
 
@@ -581,6 +652,7 @@ void register_distribution_suite(const std::string& name,
                                          }
                                          state.counters["segments"] = Segments;
                                          state.counters["size"] = static_cast<double>(data->size());
+                                         add_index_stats_counters(state, index);
                                      })
             ->Unit(benchmark::kNanosecond));
 
@@ -738,6 +810,575 @@ void register_keyvalue_suites() {
     }
 }
 
+// Batched lookup benchmarks: find_batch vs. a loop over find on the same key set
+template <std::size_t Segments, typename Generator>
+void register_batch_suite(const std::string& name,
+                          Generator&& generator,
+                          std::size_t size) {
+    auto data = get_or_generate_dataset(name, size, std::forward<Generator>(generator));
+    if (data->empty()) {
+        return;
+    }
+
+    auto queries = std::make_shared<std::vector<std::uint64_t>>(
+        qi::bench::make_random_queries(*data, qi::bench::kBatchQueryCount));
+
+    const std::string base = "JazzyIndexBatch/" + name + "/S" + std::to_string(Segments) +
+                             "/N" + std::to_string(size);
+
+    maybe_add_threads(
+        benchmark::RegisterBenchmark((base + "/FindLoop").c_str(),
+                                     [data, queries](benchmark::State& state) {
+                                         auto index = qi::bench::make_index<Segments>(*data);
+                                         std::vector<const std::uint64_t*> out(queries->size());
+                                         for (auto _ : state) {
+                                             for (std::size_t i = 0; i < queries->size(); ++i) {
+                                                 out[i] = index.find((*queries)[i]);
+                                             }
+                                             benchmark::DoNotOptimize(out.data());
+                                             benchmark::ClobberMemory();
+                                         }
+                                         state.SetItemsProcessed(state.iterations() *
+                                                                 static_cast<std::int64_t>(queries->size()));
+                                         state.counters["segments"] = Segments;
+                                         state.counters["size"] = static_cast<double>(data->size());
+                                     })
+            ->Unit(benchmark::kMicrosecond));
+
+    maybe_add_threads(
+        benchmark::RegisterBenchmark((base + "/FindBatch").c_str(),
+                                     [data, queries](benchmark::State& state) {
+                                         auto index = qi::bench::make_index<Segments>(*data);
+                                         std::vector<const std::uint64_t*> out(queries->size());
+                                         for (auto _ : state) {
+                                             index.find_batch(*queries, out);
+                                             benchmark::DoNotOptimize(out.data());
+                                             benchmark::ClobberMemory();
+                                         }
+                                         state.SetItemsProcessed(state.iterations() *
+                                                                 static_cast<std::int64_t>(queries->size()));
+                                         state.counters["segments"] = Segments;
+                                         state.counters["size"] = static_cast<double>(data->size());
+                                         state.SetLabel(jazzy::detail::simd::kernel_name());
+                                     })
+            ->Unit(benchmark::kMicrosecond));
+
+    maybe_add_threads(
+        benchmark::RegisterBenchmark((base + "/LowerBoundLoop").c_str(),
+                                     [data, queries](benchmark::State& state) {
+                                         auto index = qi::bench::make_index<Segments>(*data);
+                                         std::vector<const std::uint64_t*> out(queries->size());
+                                         for (auto _ : state) {
+                                             for (std::size_t i = 0; i < queries->size(); ++i) {
+                                                 out[i] = index.find_lower_bound((*queries)[i]);
+                                             }
+                                             benchmark::DoNotOptimize(out.data());
+                                             benchmark::ClobberMemory();
+                                         }
+                                         state.SetItemsProcessed(state.iterations() *
+                                                                 static_cast<std::int64_t>(queries->size()));
+                                         state.counters["segments"] = Segments;
+                                         state.counters["size"] = static_cast<double>(data->size());
+                                     })
+            ->Unit(benchmark::kMicrosecond));
+
+    maybe_add_threads(
+        benchmark::RegisterBenchmark((base + "/LowerBoundBatch").c_str(),
+                                     [data, queries](benchmark::State& state) {
+                                         auto index = qi::bench::make_index<Segments>(*data);
+                                         std::vector<const std::uint64_t*> out(queries->size());
+                                         for (auto _ : state) {
+                                             index.find_lower_bound_batch(*queries, out);
+                                             benchmark::DoNotOptimize(out.data());
+                                             benchmark::ClobberMemory();
+                                         }
+                                         state.SetItemsProcessed(state.iterations() *
+                                                                 static_cast<std::int64_t>(queries->size()));
+                                         state.counters["segments"] = Segments;
+                                         state.counters["size"] = static_cast<double>(data->size());
+                                         state.SetLabel(jazzy::detail::simd::kernel_name());
+                                     })
+            ->Unit(benchmark::kMicrosecond));
+
+    // Coroutine lookups interleaved round-robin, swept over the number in flight (G1 runs them
+    // one after another, so it measures the coroutine overhead on top of FindLoop)
+    for (const std::size_t group : qi::bench::kInterleaveGroupSizes) {
+        maybe_add_threads(
+            benchmark::RegisterBenchmark((base + "/FindInterleaved/G" + std::to_string(group)).c_str(),
+                                         [data, queries, group](benchmark::State& state) {
+                                             auto index = qi::bench::make_index<Segments>(*data);
+                                             std::vector<const std::uint64_t*> out(queries->size());
+                                             for (auto _ : state) {
+                                                 jazzy::interleave_lookups(*queries, out, group,
+                                                                           [&index](std::uint64_t key) {
+                                                                               return index.find_async(key);
+                                                                           });
+                                                 benchmark::DoNotOptimize(out.data());
+                                                 benchmark::ClobberMemory();
+                                             }
+                                             state.SetItemsProcessed(state.iterations() *
+                                                                     static_cast<std::int64_t>(queries->size()));
+                                             state.counters["segments"] = Segments;
+                                             state.counters["size"] = static_cast<double>(data->size());
+                                             state.counters["group"] = static_cast<double>(group);
+                                         })
+                ->Unit(benchmark::kMicrosecond));
+    }
+}
+
+void register_batch_suites() {
+    // Batching only pays off once the data no longer fits in cache: run on the 20M datasets
+    if (!use_20m_benchmarks && !use_full_benchmarks) {
+        return;
+    }
+
+    const std::size_t size = 20'000'000;
+    for_each_segment_count([size](auto seg_tag) {
+        constexpr std::size_t Segments = decltype(seg_tag)::value;
+        if constexpr (Segments >= 256) {
+            register_batch_suite<Segments>("Uniform", [](std::size_t s) {
+                return qi::bench::make_uniform_values(s);
+            }, size);
+            register_batch_suite<Segments>("Clustered", qi::bench::make_clustered_values, size);
+            register_batch_suite<Segments>("Lognormal", qi::bench::make_lognormal_values, size);
+            register_batch_suite<Segments>("Zipf", qi::bench::make_zipf_values, size);
+        }
+    });
+}
+
+// Workload-driven segmentation: the same skewed queries (90% on the newest 5% of keys) against
+// an equal-count index and one rebuilt from a separate sample of that workload
+template <std::size_t Segments, typename Generator>
+void register_workload_suite(const std::string& name, Generator&& generator, std::size_t size) {
+    auto data = get_or_generate_dataset(name, size, std::forward<Generator>(generator));
+    if (data->empty()) {
+        return;
+    }
+
+    auto queries = std::make_shared<std::vector<std::uint64_t>>(
+        qi::bench::make_recent_queries(*data, qi::bench::kBatchQueryCount));
+    auto sample = std::make_shared<std::vector<std::uint64_t>>(
+        qi::bench::make_recent_queries(*data, qi::bench::kBatchQueryCount, 0.9, 0.05, qi::bench::kRandomSeed + 1));
+
+    for (const bool adapted : {false, true}) {
+        const std::string bench_name = "JazzyIndexWorkload/" + name + (adapted ? "/Workload" : "/EqualCount") +
+                                       "/S" + std::to_string(Segments) + "/N" + std::to_string(size);
+        maybe_add_threads(
+            benchmark::RegisterBenchmark(bench_name.c_str(),
+                                         [data, queries, sample, adapted](benchmark::State& state) {
+                                             auto index = qi::bench::make_index<Segments>(*data);
+                                             if (adapted) {
+                                                 index.rebuild_for_workload(*sample);
+                                             }
+                                             std::size_t next = 0;
+                                             for (auto _ : state) {
+                                                 const auto* result = index.find((*queries)[next % queries->size()]);
+                                                 benchmark::DoNotOptimize(result);
+                                                 ++next;
+                                             }
+                                             state.counters["segments"] = Segments;
+                                             state.counters["size"] = static_cast<double>(data->size());
+                                         }));
+    }
+}
+
+void register_workload_suites() {
+    const std::size_t size = use_20m_benchmarks ? 20'000'000 : 100'000;
+    register_workload_suite<256>("Uniform", [](std::size_t s) { return qi::bench::make_uniform_values(s); }, size);
+    register_workload_suite<256>("Lognormal", qi::bench::make_lognormal_values, size);
+    register_workload_suite<256>("Zipf", qi::bench::make_zipf_values, size);
+}
+
+// String and composite keys: std::lower_bound over the keys against PrefixJazzyIndex, which
+// routes and predicts on 64-bit key prefixes
+template <typename Key>
+void register_prefix_suite(const std::string& name, std::shared_ptr<const std::vector<Key>> keys) {
+    if (keys->empty()) {
+        return;
+    }
+    auto queries = std::make_shared<std::vector<Key>>();
+    std::mt19937_64 rng(qi::bench::kRandomSeed);
+    for (std::size_t i = 0; i < qi::bench::kBatchQueryCount; ++i) {
+        queries->push_back((*keys)[rng() % keys->size()]);
+    }
+    const std::string base = "Prefix/" + name + "/N" + std::to_string(keys->size());
+
+    maybe_add_threads(
+        benchmark::RegisterBenchmark((base + "/LowerBound").c_str(),
+                                     [keys, queries](benchmark::State& state) {
+                                         std::size_t next = 0;
+                                         for (auto _ : state) {
+                                             const auto* result =
+                                                 find_with_lower_bound(*keys, (*queries)[next % queries->size()]);
+                                             benchmark::DoNotOptimize(result);
+                                             ++next;
+                                         }
+                                         state.counters["size"] = static_cast<double>(keys->size());
+                                     })
+            ->Unit(benchmark::kNanosecond));
+
+    maybe_add_threads(
+        benchmark::RegisterBenchmark((base + "/PrefixJazzyIndex").c_str(),
+                                     [keys, queries](benchmark::State& state) {
+                                         const jazzy::PrefixJazzyIndex<Key> index(keys->data(),
+                                                                                  keys->data() + keys->size());
+                                         std::size_t next = 0;
+                                         for (auto _ : state) {
+                                             const auto* result = index.find((*queries)[next % queries->size()]);
+                                             benchmark::DoNotOptimize(result);
+                                             ++next;
+                                         }
+                                         state.counters["size"] = static_cast<double>(keys->size());
+                                         state.counters["prefixes"] = static_cast<double>(index.num_prefixes());
+                                         state.counters["tie_levels"] = static_cast<double>(index.num_tie_levels());
+                                         state.counters["index_bytes"] = static_cast<double>(index.memory_usage());
+                                     })
+            ->Unit(benchmark::kNanosecond));
+}
+
+void register_prefix_suites() {
+    const std::size_t size = (use_20m_benchmarks || use_full_benchmarks) ? 1'000'000 : 100'000;
+    register_prefix_suite<std::string>(
+        "Words", std::make_shared<const std::vector<std::string>>(qi::bench::make_word_keys(size, "")));
+    register_prefix_suite<std::string>(
+        "Urls", std::make_shared<const std::vector<std::string>>(
+                    qi::bench::make_word_keys(size, "https://example.com/user/")));
+    using SymbolTime = std::tuple<std::string, std::uint64_t>;
+    register_prefix_suite<SymbolTime>(
+        "SymbolTime", std::make_shared<const std::vector<SymbolTime>>(qi::bench::make_symbol_time_keys(size, 20)));
+}
+
+// Model-selection policies on the same keys and queries: LINEAR models only, the default
+// thresholds, prefer_cubic, and the segment count and config autotune picks from a query sample
+template <std::size_t Segments, typename Generator>
+void register_build_config_suite(const std::string& name, Generator&& generator, std::size_t size) {
+    auto data = get_or_generate_dataset(name, size, std::forward<Generator>(generator));
+    if (data->empty()) {
+        return;
+    }
+    auto queries = std::make_shared<std::vector<std::uint64_t>>(
+        qi::bench::make_random_queries(*data, qi::bench::kBatchQueryCount));
+
+    const auto run = [data, queries](benchmark::State& state, const auto& index) {
+        std::size_t next = 0;
+        for (auto _ : state) {
+            const auto* result = index.find((*queries)[next % queries->size()]);
+            benchmark::DoNotOptimize(result);
+            ++next;
+        }
+        state.counters["segments"] = static_cast<double>(index.num_segments());
+        state.counters["size"] = static_cast<double>(data->size());
+        state.counters["index_bytes"] = static_cast<double>(index.memory_usage());
+        state.counters["max_error"] = static_cast<double>(index.max_segment_error());
+    };
+
+    const std::string base = "BuildConfig/" + name + "/N" + std::to_string(size);
+    const std::pair<const char*, jazzy::BuildConfig> configs[] = {
+        {"LinearOnly", jazzy::BuildConfig::linear_only()},
+        {"Default", jazzy::BuildConfig{}},
+        {"PreferCubic", jazzy::BuildConfig::prefer_cubic()},
+    };
+    for (const auto& [config_name, config] : configs) {
+        maybe_add_threads(
+            benchmark::RegisterBenchmark((base + "/" + config_name + "/S" + std::to_string(Segments)).c_str(),
+                                         [data, run, config](benchmark::State& state) {
+                                             jazzy::JazzyIndex<std::uint64_t, jazzy::to_segment_count<Segments>()> index;
+                                             index.set_build_config(config);
+                                             index.build(data->data(), data->data() + data->size());
+                                             run(state, index);
+                                         }));
+    }
+
+    // Tuned on a separate sample of the same query distribution
+    maybe_add_threads(
+        benchmark::RegisterBenchmark((base + "/Autotuned").c_str(),
+                                     [data, run](benchmark::State& state) {
+                                         const auto sample = qi::bench::make_random_queries(
+                                             *data, qi::bench::kBatchQueryCount, qi::bench::kRandomHitRatio, qi::bench::kRandomSeed + 1);
+                                         const auto tuned = jazzy::autotune<std::uint64_t>(*data, sample);
+                                         jazzy::DynamicJazzyIndex<std::uint64_t> index(tuned.best.sizing);
+                                         index.set_build_config(tuned.best.config);
+                                         index.build(data->data(), data->data() + data->size());
+                                         state.counters["model_limit"] =
+                                             static_cast<double>(tuned.best.config.model_limit);
+                                         run(state, index);
+                                     }));
+}
+
+void register_build_config_suites() {
+    const std::size_t size = use_20m_benchmarks ? 20'000'000 : 1'000'000;
+    register_build_config_suite<256>("Uniform", [](std::size_t s) { return qi::bench::make_uniform_values(s); }, size);
+    register_build_config_suite<256>("Lognormal", qi::bench::make_lognormal_values, size);
+    register_build_config_suite<256>("Zipf", qi::bench::make_zipf_values, size);
+}
+
+// find() accelerators on the same keys: no filter or cache, the blocked Bloom filter, the
+// hot-key cache, and both, against absent keys inside the key range, the default random queries
+// (90% hits) and a few Zipf-popular keys
+template <std::size_t Segments, typename Generator>
+void register_filter_suite(const std::string& name, Generator&& generator, std::size_t size) {
+    auto data = get_or_generate_dataset(name, size, std::forward<Generator>(generator));
+    if (data->empty()) {
+        return;
+    }
+    const std::pair<const char*, std::shared_ptr<const std::vector<std::uint64_t>>> workloads[] = {
+        {"NotFoundInside", std::make_shared<const std::vector<std::uint64_t>>(
+                               qi::bench::make_absent_queries(*data, qi::bench::kBatchQueryCount))},
+        {"Random", std::make_shared<const std::vector<std::uint64_t>>(
+                       qi::bench::make_random_queries(*data, qi::bench::kBatchQueryCount))},
+        {"HotKeys", std::make_shared<const std::vector<std::uint64_t>>(
+                        qi::bench::make_hot_key_queries(*data, qi::bench::kBatchQueryCount))},
+    };
+
+    const auto register_policy = [&](const std::string& policy, auto options) {
+        using Options = decltype(options);
+        for (const auto& [workload, queries] : workloads) {
+            if (queries->empty()) {
+                continue;
+            }
+            const std::string bench_name = "JazzyIndexFilter/" + name + "/" + policy + "/S" +
+                                           std::to_string(Segments) + "/N" + std::to_string(size) + "/" + workload;
+            maybe_add_threads(
+                benchmark::RegisterBenchmark(bench_name.c_str(),
+                                             [data, queries](benchmark::State& state) {
+                                                 const auto index = qi::bench::make_index<Segments, Options>(*data);
+                                                 std::size_t next = 0;
+                                                 for (auto _ : state) {
+                                                     const auto* result =
+                                                         index.find((*queries)[next % queries->size()]);
+                                                     benchmark::DoNotOptimize(result);
+                                                     ++next;
+                                                 }
+                                                 state.counters["size"] = static_cast<double>(data->size());
+                                                 state.counters["index_bytes"] =
+                                                     static_cast<double>(index.memory_usage());
+                                             }));
+        }
+    };
+    using jazzy::layout::Interleaved;
+    using jazzy::routing::Eytzinger;
+    using jazzy::stats::Disabled;
+    register_policy("None", jazzy::IndexOptions<>{});
+    register_policy("BlockedBloom", jazzy::IndexOptions<Interleaved, Eytzinger, Disabled, jazzy::filter::BlockedBloom<>>{});
+    register_policy("HotKeyCache", jazzy::IndexOptions<Interleaved, Eytzinger, Disabled, jazzy::filter::None,
+                                                       jazzy::cache::DirectMapped<>>{});
+    register_policy("Both", jazzy::IndexOptions<Interleaved, Eytzinger, Disabled, jazzy::filter::BlockedBloom<>,
+                                                jazzy::cache::DirectMapped<>>{});
+}
+
+void register_filter_suites() {
+    const std::size_t size = use_20m_benchmarks ? 20'000'000 : 1'000'000;
+    register_filter_suite<256>("UniformStep16",
+                               [](std::size_t s) { return qi::bench::make_uniform_values(s, 0, 16); }, size);
+    register_filter_suite<256>("Clustered", qi::bench::make_clustered_values, size);
+    register_filter_suite<256>("Zipf", qi::bench::make_zipf_values, size);  // No gaps: hits only
+}
+
+// Large probe sets: find_batch on one thread against parallel::find_many on the default thread
+// pool, for random probes (searched as given or radix-partitioned per chunk) and the same probes
+// sorted (merge-style, carrying the segment from key to key)
+template <std::size_t Segments, typename Generator>
+void register_find_many_suite(const std::string& name, Generator&& generator, std::size_t size) {
+    auto data = get_or_generate_dataset(name, size, std::forward<Generator>(generator));
+    if (data->empty()) {
+        return;
+    }
+    constexpr std::size_t probe_count = std::size_t{1} << 20;
+    auto random = std::make_shared<const std::vector<std::uint64_t>>(qi::bench::make_random_queries(*data, probe_count));
+    auto sorted = std::make_shared<std::vector<std::uint64_t>>(*random);
+    std::sort(sorted->begin(), sorted->end());
+
+    const std::string base = "JazzyIndexFindMany/" + name + "/S" + std::to_string(Segments) + "/N" + std::to_string(size);
+    const auto register_variant = [&](const std::string& variant, std::shared_ptr<const std::vector<std::uint64_t>> probes,
+                                      auto search) {
+        benchmark::RegisterBenchmark((base + "/" + variant).c_str(),
+                                     [data, probes, search](benchmark::State& state) {
+                                         const auto index = qi::bench::make_index<Segments>(*data);
+                                         std::vector<const std::uint64_t*> out(probes->size());
+                                         for (auto _ : state) {
+                                             search(index, *probes, out);
+                                             benchmark::DoNotOptimize(out.data());
+                                             benchmark::ClobberMemory();
+                                         }
+                                         state.SetItemsProcessed(state.iterations() *
+                                                                 static_cast<std::int64_t>(probes->size()));
+                                         state.counters["size"] = static_cast<double>(data->size());
+                                         state.counters["threads"] =
+                                             static_cast<double>(jazzy::parallel::default_thread_pool().concurrency());
+                                     })
+            ->Unit(benchmark::kMillisecond);
+    };
+
+    const auto find_batch = [](const auto& index, const auto& probes, auto& out) { index.find_batch(probes, out); };
+    const auto find_sorted_batch = [](const auto& index, const auto& probes, auto& out) {
+        index.find_sorted_batch(probes, out);
+    };
+    const auto find_many = [](const auto& index, const auto& probes, auto& out) {
+        jazzy::parallel::find_many(index, probes, out);
+    };
+    const auto find_many_partitioned = [](const auto& index, const auto& probes, auto& out) {
+        jazzy::parallel::find_many(index, probes, out, {.partition = true});
+    };
+    register_variant("Unsorted/FindBatch", random, find_batch);
+    register_variant("Unsorted/FindMany", random, find_many);
+    register_variant("Unsorted/FindManyPartitioned", random, find_many_partitioned);
+    register_variant("Sorted/FindBatch", sorted, find_batch);
+    register_variant("Sorted/FindSortedBatch", sorted, find_sorted_batch);
+    register_variant("Sorted/FindMany", sorted, find_many);
+}
+
+void register_find_many_suites() {
+    const std::size_t size = use_20m_benchmarks ? 20'000'000 : 1'000'000;
+    register_find_many_suite<1024>("Uniform", [](std::size_t s) { return qi::bench::make_uniform_values(s); }, size);
+    register_find_many_suite<1024>("Lognormal", qi::bench::make_lognormal_values, size);
+    register_find_many_suite<1024>("Zipf", qi::bench::make_zipf_values, size);
+}
+
+// Sorted probe streams (time-ordered replays, join inputs) through one Cursor against independent
+// find_lower_bound calls and find_lower_bound_batch, from about one probe per key (Dense) to one
+// per thousand keys (Sparse)
+template <std::size_t Segments, typename Generator>
+void register_cursor_suite(const std::string& name, Generator&& generator, std::size_t size) {
+    auto data = get_or_generate_dataset(name, size, std::forward<Generator>(generator));
+    if (data->empty()) {
+        return;
+    }
+    const std::pair<const char*, std::size_t> densities[] = {
+        {"Dense", size}, {"Every10", size / 10}, {"Sparse", std::max<std::size_t>(size / 1000, 1)}};
+    for (const auto& [density, count] : densities) {
+        auto probes = std::make_shared<std::vector<std::uint64_t>>(qi::bench::make_random_queries(*data, count, 1.0));
+        std::sort(probes->begin(), probes->end());
+        const std::string base = "JazzyIndexCursor/" + name + "/S" + std::to_string(Segments) + "/N" +
+                                 std::to_string(size) + "/" + density;
+        const auto register_variant = [&](const std::string& variant, auto search) {
+            benchmark::RegisterBenchmark((base + "/" + variant).c_str(),
+                                         [data, probes, search](benchmark::State& state) {
+                                             const auto index = qi::bench::make_index<Segments>(*data);
+                                             std::vector<const std::uint64_t*> out(probes->size());
+                                             for (auto _ : state) {
+                                                 search(index, *probes, out);
+                                                 benchmark::DoNotOptimize(out.data());
+                                                 benchmark::ClobberMemory();
+                                             }
+                                             state.SetItemsProcessed(state.iterations() *
+                                                                     static_cast<std::int64_t>(probes->size()));
+                                             state.counters["size"] = static_cast<double>(data->size());
+                                             state.counters["probes"] = static_cast<double>(probes->size());
+                                         })
+                ->Unit(benchmark::kMillisecond);
+        };
+        register_variant("FindLowerBound", [](const auto& index, const auto& probes, auto& out) {
+            for (std::size_t i = 0; i < probes.size(); ++i) {
+                out[i] = index.find_lower_bound(probes[i]);
+            }
+        });
+        register_variant("LowerBoundBatch", [](const auto& index, const auto& probes, auto& out) {
+            index.find_lower_bound_batch(probes, out);
+        });
+        register_variant("CursorSeek", [](const auto& index, const auto& probes, auto& out) {
+            auto cursor = index.cursor();
+            for (std::size_t i = 0; i < probes.size(); ++i) {
+                out[i] = cursor.seek(probes[i]);
+            }
+        });
+    }
+}
+
+void register_cursor_suites() {
+    const std::size_t size = use_20m_benchmarks ? 20'000'000 : 1'000'000;
+    register_cursor_suite<1024>("Uniform", [](std::size_t s) { return qi::bench::make_uniform_values(s); }, size);
+    register_cursor_suite<1024>("Zipf", qi::bench::make_zipf_values, size);
+    register_cursor_suite<1024>("Timestamps", qi::bench::make_timestamp_values, size);
+}
+
+// Segment layout benchmarks: several indexes queried round-robin, so the per-index segment
+// arrays compete for L1/L2 the way they do when many indexes share a core
+constexpr std::size_t kLayoutIndexCount = 8;
+
+template <std::size_t Segments, typename Options, typename Generator>
+void register_layout_suite(const std::string& layout_name,
+                           const std::string& name,
+                           Generator&& generator,
+                           std::size_t size) {
+    auto data = get_or_generate_dataset(name, size, std::forward<Generator>(generator));
+    if (data->empty()) {
+        return;
+    }
+
+    auto queries = std::make_shared<std::vector<std::uint64_t>>(
+        qi::bench::make_random_queries(*data, qi::bench::kBatchQueryCount));
+
+    const std::string bench_name = "JazzyIndexLayout/" + name + "/" + layout_name + "/S" +
+                                   std::to_string(Segments) + "/N" + std::to_string(size) +
+                                   "/Indexes" + std::to_string(kLayoutIndexCount);
+
+    maybe_add_threads(
+        benchmark::RegisterBenchmark(bench_name.c_str(),
+                                     [data, queries](benchmark::State& state) {
+                                         using Index = decltype(qi::bench::make_index<Segments, Options>(*data));
+                                         std::vector<Index> indexes;
+                                         indexes.reserve(kLayoutIndexCount);
+                                         for (std::size_t i = 0; i < kLayoutIndexCount; ++i) {
+                                             indexes.push_back(qi::bench::make_index<Segments, Options>(*data));
+                                         }
+                                         std::size_t next = 0;
+                                         for (auto _ : state) {
+                                             const auto& index = indexes[next % kLayoutIndexCount];
+                                             const auto* result = index.find((*queries)[next % queries->size()]);
+                                             benchmark::DoNotOptimize(result);
+                                             ++next;
+                                         }
+                                         state.counters["segments"] = Segments;
+                                         state.counters["size"] = static_cast<double>(data->size());
+                                         state.counters["index_bytes"] = static_cast<double>(indexes[0].memory_usage());
+                                         state.counters["max_error"] =
+                                             static_cast<double>(indexes[0].max_segment_error());
+                                         // Share of these queries answered outside the error window
+                                         // (float models over large keys predict past max_error)
+                                         using Counted = jazzy::IndexOptions<typename Options::layout_type,
+                                                                             typename Options::routing_type,
+                                                                             jazzy::stats::PerThread>;
+                                         const auto counted = qi::bench::make_index<Segments, Counted>(*data);
+                                         for (const std::uint64_t query : *queries) {
+                                             benchmark::DoNotOptimize(counted.find(query));
+                                         }
+                                         state.counters["window_miss_rate"] =
+                                             counted.query_stats().window_miss_rate();
+                                     }));
+}
+
+template <std::size_t Segments>
+void register_layout_pair(const std::string& name,
+                          const std::function<std::vector<std::uint64_t>(std::size_t)>& generator,
+                          std::size_t size) {
+    register_layout_suite<Segments, jazzy::IndexOptions<jazzy::layout::Interleaved>>(
+        "Interleaved", name, generator, size);
+    register_layout_suite<Segments, jazzy::IndexOptions<jazzy::layout::Split>>(
+        "Split", name, generator, size);
+    register_layout_suite<Segments, jazzy::IndexOptions<jazzy::layout::Compressed>>(
+        "Compressed", name, generator, size);
+    register_layout_suite<Segments, jazzy::IndexOptions<jazzy::layout::Precise>>(
+        "Precise", name, generator, size);
+}
+
+void register_layout_suites() {
+    const std::size_t size = use_20m_benchmarks ? 20'000'000 : 100'000;
+    const std::function<std::vector<std::uint64_t>(std::size_t)> uniform = [](std::size_t s) {
+        return qi::bench::make_uniform_values(s);
+    };
+    for (const auto& [name, generator] :
+         {std::pair{std::string("Uniform"), uniform},
+          std::pair{std::string("Lognormal"),
+                    std::function<std::vector<std::uint64_t>(std::size_t)>(qi::bench::make_lognormal_values)},
+          std::pair{std::string("Timestamps"),
+                    std::function<std::vector<std::uint64_t>(std::size_t)>(qi::bench::make_timestamp_values)}}) {
+        register_layout_pair<256>(name, generator, size);
+        register_layout_pair<512>(name, generator, size);
+        register_layout_pair<1024>(name, generator, size);
+        register_layout_pair<2048>(name, generator, size);
+    }
+}
+
 // Helper to create output directory
 bool ensure_directory_exists(const std::string& path) {
     struct stat info;
@@ -916,6 +1557,14 @@ int main(int argc, char** argv) {
             }
             --argc;
             --i;
+        } else if (arg == "--index-stats") {
+            record_index_stats = true;
+            // Remove this flag so benchmark library doesn't see it
+            for (int j = i; j < argc - 1; ++j) {
+                argv[j] = argv[j + 1];
+            }
+            --argc;
+            --i;
         } else if (arg.find("--benchmark_threads=") == 0) {
             try {
                 benchmark_threads = std::stoi(arg.substr(20));  // Length of "--benchmark_threads="
@@ -964,6 +1613,30 @@ int main(int argc, char** argv) {
     // Register key-value benchmarks (worst-case distributions)
     register_keyvalue_suites();
 
+    // Register batched lookup benchmarks (20M datasets only)
+    register_batch_suites();
+
+    // Register segment layout comparison (interleaved vs split)
+    register_layout_suites();
+
+    // Register workload-driven segmentation comparison
+    register_workload_suites();
+
+    // Register string and composite key benchmarks
+    register_prefix_suites();
+
+    // Register model-selection policy and autotune benchmarks
+    register_build_config_suites();
+
+    // Register negative filter and hot-key cache benchmarks
+    register_filter_suites();
+
+    // Register parallel batched query benchmarks
+    register_find_many_suites();
+
+    // Register sorted-probe cursor benchmarks
+    register_cursor_suites();
+
     // Register JazzyIndex build time benchmarks
     register_build_suites();
 
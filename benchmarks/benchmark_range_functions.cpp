@@ -9,6 +9,7 @@
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <random>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -35,7 +36,8 @@ static const std::unordered_map<std::string, GeneratorFunc> distribution_generat
     {"Mixed", [](std::size_t s) { return qi::bench::make_mixed_values(s); }},
     {"Quadratic", [](std::size_t s) { return qi::bench::make_quadratic_values(s); }},
     {"ExtremePoly", [](std::size_t s) { return qi::bench::make_extreme_polynomial_values(s); }},
-    {"InversePoly", [](std::size_t s) { return qi::bench::make_inverse_polynomial_values(s); }}
+    {"InversePoly", [](std::size_t s) { return qi::bench::make_inverse_polynomial_values(s); }},
+    {"HighDuplicate", [](std::size_t s) { return qi::bench::make_high_duplicate_values(s); }}
 };
 
 // Helper to optionally add threading to benchmarks
@@ -194,6 +196,172 @@ void BM_Std_UpperBound(benchmark::State& state, const std::string& distribution,
     state.counters["size"] = static_cast<double>(size);
 }
 
+// Benchmark find_lower_bound over random stored keys with a given routing policy.
+// Non-uniform distributions skip the O(1) uniform path, so segment routing dominates at
+// high segment counts.
+template <std::size_t Segments, typename Options>
+void BM_JazzyIndex_RoutedLowerBound(benchmark::State& state, const std::string& distribution) {
+    const std::size_t size = state.range(0);
+
+    auto it = distribution_generators.find(distribution);
+    if (it == distribution_generators.end()) {
+        state.SkipWithError("Unknown distribution");
+        return;
+    }
+
+    auto data = get_or_generate_range_dataset(distribution, size, it->second);
+    auto index = qi::bench::make_index<Segments, Options>(*data);
+
+    constexpr std::size_t kQueryCount = 4096;  // Power of two for cheap wrap-around
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<std::size_t> index_dist(0, data->size() - 1);
+    std::vector<std::uint64_t> queries(kQueryCount);
+    for (auto& q : queries) {
+        q = (*data)[index_dist(rng)];
+    }
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto* lower = index.find_lower_bound(queries[i]);
+        benchmark::DoNotOptimize(lower);
+        i = (i + 1) & (kQueryCount - 1);
+    }
+
+    state.counters["segments"] = Segments;
+    state.counters["size"] = static_cast<double>(size);
+}
+
+// Benchmark find_lower_bound over random stored keys on an index built with an epsilon corridor
+// (build_error_bounded). Compare with BM_JazzyIndex_Routing_Eytzinger_* at the same segment count.
+template <std::size_t Segments>
+void BM_JazzyIndex_ErrorBoundedLowerBound(benchmark::State& state, const std::string& distribution,
+                                          std::size_t epsilon) {
+    const std::size_t size = state.range(0);
+
+    auto it = distribution_generators.find(distribution);
+    if (it == distribution_generators.end()) {
+        state.SkipWithError("Unknown distribution");
+        return;
+    }
+
+    auto data = get_or_generate_range_dataset(distribution, size, it->second);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::to_segment_count<Segments>()> index;
+    index.build_error_bounded(data->data(), data->data() + data->size(), epsilon);
+
+    constexpr std::size_t kQueryCount = 4096;  // Power of two for cheap wrap-around
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<std::size_t> index_dist(0, data->size() - 1);
+    std::vector<std::uint64_t> queries(kQueryCount);
+    for (auto& q : queries) {
+        q = (*data)[index_dist(rng)];
+    }
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto* lower = index.find_lower_bound(queries[i]);
+        benchmark::DoNotOptimize(lower);
+        i = (i + 1) & (kQueryCount - 1);
+    }
+
+    state.counters["segments"] = static_cast<double>(index.num_segments());
+    state.counters["error_bound"] = static_cast<double>(index.error_bound().value_or(0));
+    state.counters["size"] = static_cast<double>(size);
+}
+
+// Random [lo, hi) ranges spanning about width keys, starting at stored keys (power-of-two count)
+std::vector<std::pair<std::uint64_t, std::uint64_t>> make_range_queries(const std::vector<std::uint64_t>& data,
+                                                                        std::size_t width) {
+    constexpr std::size_t kQueryCount = 4096;
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<std::size_t> index_dist(0, data.size() - 1);
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> queries(kQueryCount);
+    for (auto& q : queries) {
+        const std::size_t i = index_dist(rng);
+        q = {data[i], data[std::min(data.size() - 1, i + width)]};
+    }
+    return queries;
+}
+
+// Benchmark JazzyIndex::count_range: one full lookup for lo, hi routed forward from lo's segment
+template <std::size_t Segments>
+void BM_JazzyIndex_CountRange(benchmark::State& state, const std::string& distribution, std::size_t width) {
+    const std::size_t size = state.range(0);
+
+    auto it = distribution_generators.find(distribution);
+    if (it == distribution_generators.end()) {
+        state.SkipWithError("Unknown distribution");
+        return;
+    }
+
+    auto data = get_or_generate_range_dataset(distribution, size, it->second);
+    auto index = qi::bench::make_index<Segments>(*data);
+    const auto queries = make_range_queries(*data, width);
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const std::size_t count = index.count_range(queries[i].first, queries[i].second);
+        benchmark::DoNotOptimize(count);
+        i = (i + 1) & (queries.size() - 1);
+    }
+
+    state.counters["segments"] = Segments;
+    state.counters["width"] = static_cast<double>(width);
+    state.counters["size"] = static_cast<double>(size);
+}
+
+// The same ranges counted with two independent lookups (the approach count_range replaces)
+template <std::size_t Segments>
+void BM_JazzyIndex_CountTwoLookups(benchmark::State& state, const std::string& distribution, std::size_t width) {
+    const std::size_t size = state.range(0);
+
+    auto it = distribution_generators.find(distribution);
+    if (it == distribution_generators.end()) {
+        state.SkipWithError("Unknown distribution");
+        return;
+    }
+
+    auto data = get_or_generate_range_dataset(distribution, size, it->second);
+    auto index = qi::bench::make_index<Segments>(*data);
+    const auto queries = make_range_queries(*data, width);
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto* lower = index.find_lower_bound(queries[i].first);
+        const auto* upper = index.find_lower_bound(queries[i].second);
+        benchmark::DoNotOptimize(upper - lower);
+        i = (i + 1) & (queries.size() - 1);
+    }
+
+    state.counters["segments"] = Segments;
+    state.counters["width"] = static_cast<double>(width);
+    state.counters["size"] = static_cast<double>(size);
+}
+
+// std::lower_bound on both ends of the same ranges
+void BM_Std_CountRange(benchmark::State& state, const std::string& distribution, std::size_t width) {
+    const std::size_t size = state.range(0);
+
+    auto it = distribution_generators.find(distribution);
+    if (it == distribution_generators.end()) {
+        state.SkipWithError("Unknown distribution");
+        return;
+    }
+
+    auto data = get_or_generate_range_dataset(distribution, size, it->second);
+    const auto queries = make_range_queries(*data, width);
+
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto lower = std::lower_bound(data->begin(), data->end(), queries[i].first);
+        const auto upper = std::lower_bound(lower, data->end(), queries[i].second);
+        benchmark::DoNotOptimize(upper - lower);
+        i = (i + 1) & (queries.size() - 1);
+    }
+
+    state.counters["width"] = static_cast<double>(width);
+    state.counters["size"] = static_cast<double>(size);
+}
+
 }  // namespace
 
 // Helper to iterate over all segment counts (matching main benchmarks)
@@ -251,7 +419,7 @@ void register_benchmarks() {
     // Distributions to benchmark
     const std::vector<std::string> distributions = {
         "Uniform", "Exponential", "Clustered", "Lognormal", "Zipf",
-        "Mixed", "Quadratic", "ExtremePoly", "InversePoly"
+        "Mixed", "Quadratic", "ExtremePoly", "InversePoly", "HighDuplicate"
     };
 
     // Sizes to benchmark
@@ -345,6 +513,70 @@ void register_benchmarks() {
     }
 }
 
+// Eytzinger routing vs plain binary search over segment bounds on non-uniform data
+void register_routing_benchmarks() {
+    using BinarySearchOptions = jazzy::IndexOptions<jazzy::layout::Interleaved, jazzy::routing::BinarySearch>;
+    using EytzingerOptions = jazzy::IndexOptions<jazzy::layout::Interleaved, jazzy::routing::Eytzinger>;
+
+    for (const std::string distribution : {"Clustered", "Zipf"}) {
+        auto register_pair = [&](auto seg_tag) {
+            constexpr std::size_t Segments = decltype(seg_tag)::value;
+            maybe_add_threads(benchmark::RegisterBenchmark(
+                "BM_JazzyIndex_Routing_BinarySearch_" + std::to_string(Segments) + "_" + distribution + "/RandomHits",
+                [distribution](benchmark::State& s) {
+                    BM_JazzyIndex_RoutedLowerBound<Segments, BinarySearchOptions>(s, distribution);
+                })
+                ->RangeMultiplier(10)->Range(100'000, 1'000'000)->Unit(benchmark::kNanosecond));
+            maybe_add_threads(benchmark::RegisterBenchmark(
+                "BM_JazzyIndex_Routing_Eytzinger_" + std::to_string(Segments) + "_" + distribution + "/RandomHits",
+                [distribution](benchmark::State& s) {
+                    BM_JazzyIndex_RoutedLowerBound<Segments, EytzingerOptions>(s, distribution);
+                })
+                ->RangeMultiplier(10)->Range(100'000, 1'000'000)->Unit(benchmark::kNanosecond));
+        };
+        register_pair(std::integral_constant<std::size_t, 512>{});
+        register_pair(std::integral_constant<std::size_t, 1024>{});
+        register_pair(std::integral_constant<std::size_t, 2048>{});
+    }
+}
+
+// Error-bounded (epsilon corridor) segmentation on the same non-uniform data as the routing cases
+void register_error_bounded_benchmarks() {
+    for (const std::string distribution : {"Clustered", "Zipf"}) {
+        for (const std::size_t epsilon : {std::size_t{16}, std::size_t{64}}) {
+            maybe_add_threads(benchmark::RegisterBenchmark(
+                "BM_JazzyIndex_ErrorBounded_eps" + std::to_string(epsilon) + "_2048_" + distribution + "/RandomHits",
+                [distribution, epsilon](benchmark::State& s) {
+                    BM_JazzyIndex_ErrorBoundedLowerBound<2048>(s, distribution, epsilon);
+                })
+                ->RangeMultiplier(10)->Range(100'000, 1'000'000)->Unit(benchmark::kNanosecond));
+        }
+    }
+}
+
+// count_range over short and long random ranges vs two independent lookups and std::lower_bound
+void register_count_range_benchmarks() {
+    for (const std::string distribution : {"Uniform", "Clustered", "Zipf", "HighDuplicate"}) {
+        for (const std::size_t width : {std::size_t{16}, std::size_t{1024}}) {
+            const std::string suffix = "_" + distribution + "/width" + std::to_string(width);
+            maybe_add_threads(benchmark::RegisterBenchmark(
+                "BM_JazzyIndex_CountRange_256" + suffix,
+                [distribution, width](benchmark::State& s) { BM_JazzyIndex_CountRange<256>(s, distribution, width); })
+                ->RangeMultiplier(10)->Range(100'000, 1'000'000)->Unit(benchmark::kNanosecond));
+            maybe_add_threads(benchmark::RegisterBenchmark(
+                "BM_JazzyIndex_CountTwoLookups_256" + suffix,
+                [distribution, width](benchmark::State& s) {
+                    BM_JazzyIndex_CountTwoLookups<256>(s, distribution, width);
+                })
+                ->RangeMultiplier(10)->Range(100'000, 1'000'000)->Unit(benchmark::kNanosecond));
+            maybe_add_threads(benchmark::RegisterBenchmark(
+                "BM_Std_CountRange" + suffix,
+                [distribution, width](benchmark::State& s) { BM_Std_CountRange(s, distribution, width); })
+                ->RangeMultiplier(10)->Range(100'000, 1'000'000)->Unit(benchmark::kNanosecond));
+        }
+    }
+}
+
 int main(int argc, char** argv) {
     // Parse custom flags before initializing benchmark library
     for (int i = 1; i < argc; ++i) {
@@ -367,6 +599,9 @@ int main(int argc, char** argv) {
     }
 
     register_benchmarks();
+    register_routing_benchmarks();
+    register_error_bounded_benchmarks();
+    register_count_range_benchmarks();
 
     ::benchmark::Initialize(&argc, argv);
     if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
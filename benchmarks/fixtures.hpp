@@ -1,11 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <memory>
 #include <random>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "dataset_generators.hpp"
@@ -14,6 +17,8 @@
 namespace qi::bench {
 
 constexpr std::size_t kQueryCount = 1024;
+constexpr std::size_t kBatchQueryCount = 4096;
+constexpr std::array<std::size_t, 6> kInterleaveGroupSizes = {1, 2, 4, 8, 16, 32};
 constexpr double kRandomHitRatio = 0.9;
 constexpr unsigned kRandomSeed = 1337u;
 
@@ -60,6 +65,78 @@ inline std::vector<std::uint64_t> make_random_queries(const std::vector<std::uin
     return queries;
 }
 
+// Queries skewed toward the end of the keys (recent timestamps): hot_ratio of them hit the last
+// hot_fraction of the keys, the rest hit anywhere
+inline std::vector<std::uint64_t> make_recent_queries(const std::vector<std::uint64_t>& values,
+                                                      std::size_t count,
+                                                      double hot_ratio = 0.9,
+                                                      double hot_fraction = 0.05,
+                                                      unsigned seed = kRandomSeed) {
+    if (values.empty()) {
+        return {};
+    }
+
+    std::mt19937_64 rng(seed);
+    std::bernoulli_distribution hot_dist(hot_ratio);
+    const auto hot_keys = std::max<std::size_t>(1, static_cast<std::size_t>(values.size() * hot_fraction));
+    std::uniform_int_distribution<std::size_t> hot_index(values.size() - hot_keys, values.size() - 1);
+    std::uniform_int_distribution<std::size_t> any_index(0, values.size() - 1);
+
+    std::vector<std::uint64_t> queries(count);
+    for (auto& query : queries) {
+        query = values[hot_dist(rng) ? hot_index(rng) : any_index(rng)];
+    }
+    return queries;
+}
+
+// Queries inside [front, back] that are not keys (the lookups a negative filter answers), or
+// empty when the keys leave no gaps
+inline std::vector<std::uint64_t> make_absent_queries(const std::vector<std::uint64_t>& values,
+                                                      std::size_t count,
+                                                      unsigned seed = kRandomSeed) {
+    if (values.empty() || values.back() - values.front() < values.size()) {
+        return {};
+    }
+
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<std::uint64_t> value_dist(values.front(), values.back());
+    std::vector<std::uint64_t> queries;
+    queries.reserve(count);
+    while (queries.size() < count) {
+        const std::uint64_t query = value_dist(rng);
+        if (!std::binary_search(values.begin(), values.end(), query)) {
+            queries.push_back(query);
+        }
+    }
+    return queries;
+}
+
+// Queries drawn from hot_keys random keys with Zipf-like (1/rank) popularity
+inline std::vector<std::uint64_t> make_hot_key_queries(const std::vector<std::uint64_t>& values,
+                                                       std::size_t count,
+                                                       std::size_t hot_keys = 256,
+                                                       unsigned seed = kRandomSeed) {
+    if (values.empty()) {
+        return {};
+    }
+
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<std::size_t> any_index(0, values.size() - 1);
+    std::vector<std::uint64_t> hot(std::min(hot_keys, values.size()));
+    std::vector<double> weights(hot.size());
+    for (std::size_t rank = 0; rank < hot.size(); ++rank) {
+        hot[rank] = values[any_index(rng)];
+        weights[rank] = 1.0 / static_cast<double>(rank + 1);
+    }
+    std::discrete_distribution<std::size_t> rank_dist(weights.begin(), weights.end());
+
+    std::vector<std::uint64_t> queries(count);
+    for (auto& query : queries) {
+        query = hot[rank_dist(rng)];
+    }
+    return queries;
+}
+
 inline std::vector<std::uint64_t> make_exponential_values(std::size_t size) {
     return dataset::generate_exponential(size,
                                          dataset::kExponentialScale,
@@ -95,6 +172,18 @@ inline std::vector<std::uint64_t> make_zipf_values(std::size_t size) {
                                   static_cast<std::uint64_t>(size));
 }
 
+// Duplicate-heavy keys: key k repeats size / 2^(k + 1) times, so the middle of the array sits
+// at the start of a run a quarter of the keys long
+inline std::vector<std::uint64_t> make_high_duplicate_values(std::size_t size) {
+    std::vector<std::uint64_t> values;
+    values.reserve(size);
+    for (std::uint64_t key = 0; values.size() < size; ++key) {
+        const std::size_t repeats = std::max<std::size_t>(1, size >> (key + 1));
+        values.insert(values.end(), std::min(repeats, size - values.size()), key * 16);
+    }
+    return values;
+}
+
 inline std::vector<std::uint64_t> make_mixed_values(std::size_t size) {
     return dataset::generate_mixed(size,
                                    dataset::kMixedRatio,
@@ -127,10 +216,59 @@ inline std::vector<std::uint64_t> make_inverse_polynomial_values(std::size_t siz
                                                 static_cast<std::uint64_t>(size));
 }
 
-template <std::size_t Segments>
-inline jazzy::JazzyIndex<std::uint64_t, jazzy::to_segment_count<Segments>()> make_index(
-    const std::vector<std::uint64_t>& values) {
-    jazzy::JazzyIndex<std::uint64_t, jazzy::to_segment_count<Segments>()> index;
+// Nanosecond timestamps (~1.7e18, past the 2^53 where doubles stop holding every integer)
+// arriving in bursts: the mean gap changes every 1000 keys
+inline std::vector<std::uint64_t> make_timestamp_values(std::size_t size) {
+    std::vector<std::uint64_t> values(size);
+    std::mt19937_64 rng(kRandomSeed);
+    std::uint64_t t = 1'700'000'000'000'000'000ULL;
+    std::uint64_t max_gap = 1;
+    for (std::size_t i = 0; i < size; ++i) {
+        if (i % 1000 == 0) {
+            max_gap = std::uint64_t{250} << (rng() % 4);
+        }
+        t += 1 + rng() % max_gap;
+        values[i] = t;
+    }
+    return values;
+}
+
+// Sorted random lowercase words of 6-15 letters after a shared head (a URL path, a namespace)
+inline std::vector<std::string> make_word_keys(std::size_t size, const std::string& head) {
+    std::vector<std::string> keys(size);
+    std::mt19937_64 rng(kRandomSeed);
+    for (auto& key : keys) {
+        key = head;
+        const std::size_t length = 6 + rng() % 10;
+        for (std::size_t i = 0; i < length; ++i) {
+            key.push_back(static_cast<char>('a' + rng() % 26));
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+// (symbol, nanosecond timestamp) rows, sorted: symbols rows per symbol, each symbol's timestamps
+// increasing from the same start
+inline std::vector<std::tuple<std::string, std::uint64_t>> make_symbol_time_keys(std::size_t size,
+                                                                                 std::size_t symbols) {
+    std::vector<std::tuple<std::string, std::uint64_t>> keys;
+    keys.reserve(size);
+    std::mt19937_64 rng(kRandomSeed);
+    for (std::size_t s = 0; s < symbols; ++s) {
+        std::uint64_t t = 1'700'000'000'000'000'000ULL;
+        for (std::size_t i = s * size / symbols; i < (s + 1) * size / symbols; ++i) {
+            t += 1 + rng() % 100'000;
+            keys.emplace_back("SYM" + std::to_string(1000 + s), t);
+        }
+    }
+    return keys;
+}
+
+template <std::size_t Segments, typename Options = jazzy::IndexOptions<>>
+inline jazzy::JazzyIndex<std::uint64_t, jazzy::to_segment_count<Segments>(), std::less<>, jazzy::identity, Options>
+make_index(const std::vector<std::uint64_t>& values) {
+    jazzy::JazzyIndex<std::uint64_t, jazzy::to_segment_count<Segments>(), std::less<>, jazzy::identity, Options> index;
     if (!values.empty()) {
         index.build(values.data(), values.data() + values.size());
     }
@@ -0,0 +1,111 @@
+#pragma once
+
+// Hardware event counts of the calling thread around a measured region, through Linux
+// perf_event_open (user space only, so perf_event_paranoid up to 2 allows it): last-level cache
+// misses, data-TLB load misses and branch misses. Events the kernel or hypervisor refuses are
+// reported as unavailable, and other platforms have none
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace qi::bench {
+
+class PerfCounters {
+public:
+    enum Event : std::uint8_t { LLC_MISSES, DTLB_MISSES, BRANCH_MISSES, EVENT_COUNT };
+
+    static constexpr const char* name(Event event) {
+        constexpr std::array<const char*, EVENT_COUNT> names = {"llc_misses", "dtlb_misses", "branch_misses"};
+        return names[event];
+    }
+
+    PerfCounters() {
+#if defined(__linux__)
+        constexpr std::uint64_t dtlb_read_miss = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        fds_[LLC_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds_[DTLB_MISSES] = open_event(PERF_TYPE_HW_CACHE, dtlb_read_miss);
+        fds_[BRANCH_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (const int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    [[nodiscard]] bool any_available() const noexcept {
+        for (const int fd : fds_) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void start() noexcept {
+#if defined(__linux__)
+        for (const int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void stop() noexcept {
+#if defined(__linux__)
+        for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+            counts_[i].reset();
+            if (fds_[i] < 0) {
+                continue;
+            }
+            ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+            std::uint64_t count = 0;
+            if (read(fds_[i], &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count))) {
+                counts_[i] = count;
+            }
+        }
+#endif
+    }
+
+    // Count between the last start() and stop(), if the event could be opened
+    [[nodiscard]] std::optional<std::uint64_t> count(Event event) const noexcept { return counts_[event]; }
+
+private:
+#if defined(__linux__)
+    static int open_event(std::uint32_t type, std::uint64_t config) noexcept {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+
+    std::array<int, EVENT_COUNT> fds_{-1, -1, -1};
+    std::array<std::optional<std::uint64_t>, EVENT_COUNT> counts_{};
+};
+
+}  // namespace qi::bench
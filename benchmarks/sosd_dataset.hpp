@@ -0,0 +1,93 @@
+#pragma once
+
+// Readers for the SOSD benchmark file formats (https://github.com/learnedsystems/SOSD). A key
+// file is a little-endian uint64 count followed by that many uint32 or uint64 keys; a lookup
+// file is a uint64 count followed by {key, uint64 result} records, 16 bytes each for both key
+// widths (uint32 keys are padded)
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace qi::bench::sosd {
+
+enum class KeyWidth : std::uint8_t { U32, U64 };
+
+// SOSD names its files after the key type (books_200M_uint32, fb_200M_uint64, wiki_ts_200M_uint64)
+inline KeyWidth key_width_from_name(const std::string& path) {
+    return path.find("uint32") != std::string::npos ? KeyWidth::U32 : KeyWidth::U64;
+}
+
+inline std::string base_name(const std::string& path) {
+    const auto slash = path.find_last_of("/\\");
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+namespace detail {
+
+inline std::ifstream open(const std::string& path, std::uint64_t& count, std::size_t record_bytes) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("Cannot open SOSD file " + path);
+    }
+    const auto file_bytes = static_cast<std::uint64_t>(in.tellg());
+    in.seekg(0);
+    if (file_bytes < sizeof(count) || !in.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+        throw std::runtime_error("SOSD file " + path + " has no count header");
+    }
+    if ((file_bytes - sizeof(count)) / record_bytes < count) {
+        throw std::runtime_error("SOSD file " + path + " is shorter than its count of " + std::to_string(count));
+    }
+    return in;
+}
+
+}  // namespace detail
+
+// Keys widened to uint64; throws std::runtime_error on a missing, short or unsorted file
+inline std::vector<std::uint64_t> load_keys(const std::string& path, KeyWidth width) {
+    std::uint64_t count = 0;
+    const std::size_t key_bytes = width == KeyWidth::U32 ? sizeof(std::uint32_t) : sizeof(std::uint64_t);
+    std::ifstream in = detail::open(path, count, key_bytes);
+
+    std::vector<std::uint64_t> keys(count);
+    if (width == KeyWidth::U64) {
+        in.read(reinterpret_cast<char*>(keys.data()), static_cast<std::streamsize>(count * key_bytes));
+    } else {
+        std::vector<std::uint32_t> narrow(count);
+        in.read(reinterpret_cast<char*>(narrow.data()), static_cast<std::streamsize>(count * key_bytes));
+        keys.assign(narrow.begin(), narrow.end());
+    }
+    for (std::size_t i = 1; i < keys.size(); ++i) {
+        if (keys[i] < keys[i - 1]) {
+            throw std::runtime_error("SOSD file " + path + " is not sorted at key " + std::to_string(i));
+        }
+    }
+    return keys;
+}
+
+// The lookup keys of an equality-lookup file (the expected results are not needed: answers are
+// checked against std::lower_bound)
+inline std::vector<std::uint64_t> load_lookup_keys(const std::string& path, KeyWidth width) {
+    constexpr std::size_t record_bytes = 16;
+    std::uint64_t count = 0;
+    std::ifstream in = detail::open(path, count, record_bytes);
+
+    std::vector<char> records(count * record_bytes);
+    in.read(records.data(), static_cast<std::streamsize>(records.size()));
+    std::vector<std::uint64_t> keys(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        if (width == KeyWidth::U32) {
+            std::uint32_t key = 0;
+            std::memcpy(&key, records.data() + i * record_bytes, sizeof(key));
+            keys[i] = key;
+        } else {
+            std::memcpy(&keys[i], records.data() + i * record_bytes, sizeof(keys[i]));
+        }
+    }
+    return keys;
+}
+
+}  // namespace qi::bench::sosd
@@ -0,0 +1,437 @@
+// Trace-driven benchmark: real-shaped key sets (SOSD-format files, or synthetic stand-ins)
+// replayed with query traces of different skew and sortedness, against std::lower_bound and
+// several JazzyIndex configurations in one run. For every dataset, trace and index it reports
+// per-query latency percentiles, throughput per core and hardware event counts per query, and
+// writes them as Google Benchmark-style JSON for scripts/compare_parallel_results.py --diff
+//
+//   jazzy_trace_benchmark --dataset=books_200M_uint32 --lookups=books_200M_uint32_equality_lookups_10M
+//   jazzy_trace_benchmark --synthetic=10000000 --queries=1000000 --threads=4 --out=trace.json
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "fixtures.hpp"
+#include "perf_counters.hpp"
+#include "sosd_dataset.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile std::size_t g_sink = 0;
+
+struct Options {
+    std::vector<std::string> datasets;
+    std::vector<std::string> lookups;  // Paired with datasets by position
+    std::size_t synthetic_size = 10'000'000;
+    std::size_t queries = 1'000'000;
+    std::size_t threads = 1;
+    std::string out;
+};
+
+struct Dataset {
+    std::string name;
+    std::vector<std::uint64_t> keys;
+    std::vector<std::uint64_t> lookups;  // From an SOSD lookup file, if given
+};
+
+struct Trace {
+    std::string name;
+    std::vector<std::uint64_t> keys;
+    std::vector<std::size_t> expected;  // std::lower_bound position of every key
+};
+
+struct Result {
+    std::string name;
+    std::size_t queries = 0;
+    std::size_t threads = 1;
+    double mean_ns = 0.0;
+    double p50_ns = 0.0;
+    double p99_ns = 0.0;
+    double p999_ns = 0.0;
+    double queries_per_second_per_core = 0.0;
+    std::array<std::optional<double>, qi::bench::PerfCounters::EVENT_COUNT> events_per_query{};
+    std::size_t index_bytes = 0;
+    double build_ms = 0.0;
+    std::size_t dataset_keys = 0;
+};
+
+// Synthetic stand-ins when no files are given: smooth, heavy-tailed and bursty key sets
+std::vector<Dataset> make_synthetic_datasets(std::size_t size) {
+    std::vector<Dataset> datasets;
+    datasets.push_back({"synthetic_lognormal_uint64", qi::bench::make_lognormal_values(size), {}});
+    datasets.push_back({"synthetic_zipf_uint64", qi::bench::make_zipf_values(size), {}});
+    datasets.push_back({"synthetic_timestamps_uint64", qi::bench::make_timestamp_values(size), {}});
+    return datasets;
+}
+
+// Uniform: keys drawn uniformly by position. Skewed: 1/rank popularity over key positions
+// scattered by a multiplicative hash, so the hot keys sit all over the index. Sorted: the
+// uniform trace in ascending order (a time-ordered replay). Absent: values between keys.
+// Lookups: the SOSD lookup file's keys
+std::vector<Trace> make_traces(const Dataset& dataset, std::size_t count) {
+    const auto& keys = dataset.keys;
+    std::mt19937_64 rng(qi::bench::kRandomSeed);
+    std::uniform_int_distribution<std::size_t> position(0, keys.size() - 1);
+    std::vector<Trace> traces;
+
+    Trace uniform{"Uniform", std::vector<std::uint64_t>(count), {}};
+    for (auto& key : uniform.keys) {
+        key = keys[position(rng)];
+    }
+
+    Trace skewed{"Skewed", std::vector<std::uint64_t>(count), {}};
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double log_size = std::log(static_cast<double>(keys.size()));
+    for (auto& key : skewed.keys) {
+        const auto rank = static_cast<std::uint64_t>(std::exp(unit(rng) * log_size)) - 1;
+        key = keys[(rank * 0x9E3779B97F4A7C15ULL) % keys.size()];
+    }
+
+    Trace sorted{"Sorted", uniform.keys, {}};
+    std::sort(sorted.keys.begin(), sorted.keys.end());
+
+    Trace absent{"Absent", {}, {}};
+    absent.keys.reserve(count);
+    for (std::size_t attempt = 0; attempt < count * 8 && absent.keys.size() < count; ++attempt) {
+        const std::size_t i = position(rng);
+        if (i + 1 < keys.size() && keys[i + 1] - keys[i] > 1) {
+            absent.keys.push_back(keys[i] + 1 + rng() % (keys[i + 1] - keys[i] - 1));
+        }
+    }
+
+    traces.push_back(std::move(uniform));
+    traces.push_back(std::move(skewed));
+    traces.push_back(std::move(sorted));
+    if (absent.keys.size() >= count / 10) {  // Datasets without gaps have no absent trace
+        traces.push_back(std::move(absent));
+    }
+    if (!dataset.lookups.empty()) {
+        traces.push_back({"Lookups", dataset.lookups, {}});
+    }
+
+    for (auto& trace : traces) {
+        trace.expected.resize(trace.keys.size());
+        for (std::size_t i = 0; i < trace.keys.size(); ++i) {
+            trace.expected[i] = static_cast<std::size_t>(
+                std::lower_bound(keys.begin(), keys.end(), trace.keys[i]) - keys.begin());
+        }
+    }
+    return traces;
+}
+
+// Cost of a back-to-back clock read, subtracted from every timed query
+double clock_overhead_ns() {
+    std::vector<double> samples(10001);
+    for (auto& sample : samples) {
+        const auto t0 = Clock::now();
+        const auto t1 = Clock::now();
+        sample = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+double percentile(std::vector<double>& sorted_latencies, double fraction) {
+    const auto i = static_cast<std::size_t>(fraction * static_cast<double>(sorted_latencies.size() - 1));
+    return sorted_latencies[i];
+}
+
+// Replay trace through make_lookup() (a fresh lookup functor per thread, so cursors stay
+// per-thread): a checked warm-up pass, a pass timing every query, a counted single-thread pass
+// and, with more threads, a pass splitting the trace between them
+template <typename MakeLookup>
+Result run_trace(const Options& options, const Trace& trace, MakeLookup&& make_lookup, double clock_ns) {
+    Result result;
+    result.queries = trace.keys.size();
+    result.threads = options.threads;
+    const std::size_t n = trace.keys.size();
+
+    auto checked_lookup = make_lookup();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (checked_lookup(trace.keys[i]) != trace.expected[i]) {
+            throw std::runtime_error("Wrong answer for query " + std::to_string(i) + " of the " + trace.name +
+                                     " trace");
+        }
+    }
+
+    std::vector<double> latencies(n);
+    std::size_t sink = 0;
+    auto timed_lookup = make_lookup();
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto t0 = Clock::now();
+        sink += timed_lookup(trace.keys[i]);
+        const auto t1 = Clock::now();
+        latencies[i] = std::max(0.0, std::chrono::duration<double, std::nano>(t1 - t0).count() - clock_ns);
+    }
+    std::sort(latencies.begin(), latencies.end());
+    result.p50_ns = percentile(latencies, 0.5);
+    result.p99_ns = percentile(latencies, 0.99);
+    result.p999_ns = percentile(latencies, 0.999);
+
+    qi::bench::PerfCounters counters;
+    auto counted_lookup = make_lookup();
+    counters.start();
+    const auto start = Clock::now();
+    for (std::size_t i = 0; i < n; ++i) {
+        sink += counted_lookup(trace.keys[i]);
+    }
+    const double elapsed_ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    counters.stop();
+    result.mean_ns = elapsed_ns / static_cast<double>(n);
+    result.queries_per_second_per_core = 1e9 / result.mean_ns;
+    for (std::size_t e = 0; e < qi::bench::PerfCounters::EVENT_COUNT; ++e) {
+        if (const auto count = counters.count(static_cast<qi::bench::PerfCounters::Event>(e))) {
+            result.events_per_query[e] = static_cast<double>(*count) / static_cast<double>(n);
+        }
+    }
+
+    if (options.threads > 1) {
+        std::vector<std::size_t> sinks(options.threads);
+        std::vector<std::thread> workers;
+        const auto parallel_start = Clock::now();
+        for (std::size_t t = 0; t < options.threads; ++t) {
+            workers.emplace_back([&, t] {
+                auto thread_lookup = make_lookup();
+                for (std::size_t i = t * n / options.threads; i < (t + 1) * n / options.threads; ++i) {
+                    sinks[t] += thread_lookup(trace.keys[i]);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        const double wall_ns = std::chrono::duration<double, std::nano>(Clock::now() - parallel_start).count();
+        result.queries_per_second_per_core =
+            static_cast<double>(n) / (wall_ns * 1e-9) / static_cast<double>(options.threads);
+        for (const auto s : sinks) {
+            sink += s;
+        }
+    }
+
+    g_sink = sink;  // Keeps the lookups from being optimized away
+    return result;
+}
+
+// Every contender on every trace of one dataset. Another index joins the comparison with one more
+// contender() call: a build step and a lookup returning the lower-bound position
+void run_dataset(const Options& options, const Dataset& dataset, double clock_ns, std::vector<Result>& results) {
+    const auto& keys = dataset.keys;
+    const std::vector<Trace> traces = make_traces(dataset, options.queries);
+    const std::uint64_t* first = keys.data();
+    const std::uint64_t* last = keys.data() + keys.size();
+
+    const auto contender = [&](const std::string& name, auto build, auto make_lookup) {
+        const auto build_start = Clock::now();
+        const auto index = build();
+        const double build_ms = std::chrono::duration<double, std::milli>(Clock::now() - build_start).count();
+        for (const auto& trace : traces) {
+            Result result = run_trace(options, trace, [&] { return make_lookup(index); }, clock_ns);
+            result.name = "Trace/" + dataset.name + "/" + trace.name + "/" + name;
+            result.build_ms = build_ms;
+            result.dataset_keys = keys.size();
+            if constexpr (requires { index.memory_usage(); }) {
+                result.index_bytes = index.memory_usage();
+            }
+            std::printf("%-72s %8.1f ns  p50 %8.1f  p99 %8.1f  p999 %9.1f\n", result.name.c_str(), result.mean_ns,
+                        result.p50_ns, result.p99_ns, result.p999_ns);
+            results.push_back(std::move(result));
+        }
+    };
+
+    contender(
+        "StdLowerBound", [] { return 0; },
+        [&](int) {
+            return [&](std::uint64_t key) {
+                return static_cast<std::size_t>(std::lower_bound(first, last, key) - first);
+            };
+        });
+
+    const auto jazzy_lookup = [&](const auto& index) {
+        return [&index, first](std::uint64_t key) { return static_cast<std::size_t>(index.find_lower_bound(key) - first); };
+    };
+    contender("JazzyIndex/S256", [&] { return jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE>(first, last); },
+              jazzy_lookup);
+    contender("JazzyIndex/S1024",
+              [&] { return jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::XLARGE>(first, last); }, jazzy_lookup);
+    contender(
+        "JazzyIndex/ErrorBounded32",
+        [&] {
+            jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::DYNAMIC> index{jazzy::SegmentSizing{}};
+            index.build_error_bounded(first, last, 32);
+            return index;
+        },
+        jazzy_lookup);
+    contender(
+        "JazzyIndex/S1024/Cursor",
+        [&] { return jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::XLARGE>(first, last); },
+        [&](const auto& index) {
+            return [cursor = index.cursor(), first](std::uint64_t key) mutable {
+                return static_cast<std::size_t>(cursor.seek(key) - first);
+            };
+        });
+}
+
+std::string json_escape(const std::string& text) {
+    std::string escaped;
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(c);
+    }
+    return escaped;
+}
+
+// The layout of Google Benchmark's --benchmark_format=json, so existing tooling reads it:
+// cpu_time and real_time carry the mean latency of the single-thread pass
+void write_json(std::ostream& out, const Options& options, const std::vector<Result>& results, bool counters) {
+    char host[256] = {};
+    gethostname(host, sizeof(host) - 1);
+    char date[64] = {};
+    const std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+#ifdef NDEBUG
+    const char* build_type = "release";
+#else
+    const char* build_type = "debug";
+#endif
+
+    out << "{\n  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"host_name\": \"" << json_escape(host) << "\",\n";
+    out << "    \"executable\": \"jazzy_trace_benchmark\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "    \"library_build_type\": \"" << build_type << "\",\n";
+    out << "    \"queries\": " << options.queries << ",\n";
+    out << "    \"threads\": " << options.threads << ",\n";
+    out << "    \"seed\": " << qi::bench::kRandomSeed << ",\n";
+    out << "    \"perf_counters\": " << (counters ? "true" : "false") << "\n";
+    out << "  },\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\n";
+        out << "      \"name\": \"" << json_escape(r.name) << "\",\n";
+        out << "      \"run_name\": \"" << json_escape(r.name) << "\",\n";
+        out << "      \"run_type\": \"iteration\",\n";
+        out << "      \"iterations\": " << r.queries << ",\n";
+        out << "      \"threads\": " << r.threads << ",\n";
+        out << "      \"real_time\": " << r.mean_ns << ",\n";
+        out << "      \"cpu_time\": " << r.mean_ns << ",\n";
+        out << "      \"time_unit\": \"ns\",\n";
+        out << "      \"p50_ns\": " << r.p50_ns << ",\n";
+        out << "      \"p99_ns\": " << r.p99_ns << ",\n";
+        out << "      \"p999_ns\": " << r.p999_ns << ",\n";
+        out << "      \"items_per_second\": " << 1e9 / r.mean_ns << ",\n";
+        out << "      \"queries_per_second_per_core\": " << r.queries_per_second_per_core << ",\n";
+        for (std::size_t e = 0; e < qi::bench::PerfCounters::EVENT_COUNT; ++e) {
+            out << "      \"" << qi::bench::PerfCounters::name(static_cast<qi::bench::PerfCounters::Event>(e))
+                << "_per_query\": ";
+            if (r.events_per_query[e]) {
+                out << *r.events_per_query[e];
+            } else {
+                out << "null";
+            }
+            out << ",\n";
+        }
+        out << "      \"index_bytes\": " << r.index_bytes << ",\n";
+        out << "      \"build_ms\": " << r.build_ms << ",\n";
+        out << "      \"dataset_keys\": " << r.dataset_keys << "\n";
+        out << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+std::size_t parse_count(const std::string& arg, std::size_t prefix) {
+    return static_cast<std::size_t>(std::stoull(arg.substr(prefix)));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.rfind("--dataset=", 0) == 0) {
+            options.datasets.push_back(arg.substr(10));  // Length of "--dataset="
+        } else if (arg.rfind("--lookups=", 0) == 0) {
+            options.lookups.push_back(arg.substr(10));  // Length of "--lookups="
+        } else if (arg.rfind("--synthetic=", 0) == 0) {
+            options.synthetic_size = parse_count(arg, 12);  // Length of "--synthetic="
+        } else if (arg.rfind("--queries=", 0) == 0) {
+            options.queries = parse_count(arg, 10);  // Length of "--queries="
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            options.threads = std::max<std::size_t>(parse_count(arg, 10), 1);  // Length of "--threads="
+        } else if (arg.rfind("--out=", 0) == 0) {
+            options.out = arg.substr(6);  // Length of "--out="
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--dataset=SOSD_FILE [--lookups=SOSD_LOOKUP_FILE]]... [--synthetic=KEYS]"
+                         " [--queries=N] [--threads=N] [--out=FILE.json]\n";
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (options.lookups.size() > options.datasets.size()) {
+        std::cerr << "Each --lookups file needs a --dataset before it\n";
+        return 1;
+    }
+
+    try {
+        std::vector<Dataset> datasets;
+        for (std::size_t i = 0; i < options.datasets.size(); ++i) {
+            const std::string& path = options.datasets[i];
+            const auto width = qi::bench::sosd::key_width_from_name(path);
+            Dataset dataset{qi::bench::sosd::base_name(path), qi::bench::sosd::load_keys(path, width), {}};
+            if (i < options.lookups.size()) {
+                dataset.lookups = qi::bench::sosd::load_lookup_keys(options.lookups[i], width);
+            }
+            if (dataset.keys.empty()) {
+                throw std::runtime_error("SOSD file " + path + " has no keys");
+            }
+            datasets.push_back(std::move(dataset));
+        }
+        if (datasets.empty()) {
+            datasets = make_synthetic_datasets(options.synthetic_size);
+        }
+
+        const double clock_ns = clock_overhead_ns();
+        const bool counters = qi::bench::PerfCounters{}.any_available();
+        std::printf("Clock overhead %.1f ns per query (subtracted); perf counters %s; %zu thread(s)\n", clock_ns,
+                    counters ? "available" : "unavailable", options.threads);
+
+        std::vector<Result> results;
+        for (const auto& dataset : datasets) {
+            run_dataset(options, dataset, clock_ns, results);
+        }
+
+        if (!options.out.empty()) {
+            std::ofstream out(options.out);
+            write_json(out, options, results, counters);
+            if (!out) {
+                throw std::runtime_error("Cannot write " + options.out);
+            }
+            std::printf("Wrote %zu results to %s\n", results.size(), options.out.c_str());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "jazzy_trace_benchmark: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,17 +1,23 @@
 // Example demonstrating parallel build functionality in JazzyIndex
 //
-// This example shows three ways to use parallel builds:
+// This example shows several ways to use parallel builds:
 // 1. Simple parallel build with default threading (easiest)
 // 2. Custom threading model using prepare_build_tasks() and finalize_build()
 // 3. Performance comparison between single-threaded and parallel builds
+// 6. Scaling from 1 to 64 threads with explicit thread pools
+// 7. Plugging in an external scheduler through SchedulerExecutor
 
 #include "jazzy_index.hpp"
+#include "jazzy_index_executor.hpp"
 #include "jazzy_index_parallel.hpp"
 
 #include <algorithm>
 #include <chrono>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <numeric>
+#include <thread>
 #include <vector>
 
 // Helper to measure execution time
@@ -31,7 +37,7 @@ void example_simple_parallel_build() {
     std::vector<int> data(1'000'000);
     std::iota(data.begin(), data.end(), 0);
 
-    // Build index using parallel build (uses std::async internally)
+    // Build index using parallel build (runs on a process-wide thread pool)
     jazzy::JazzyIndex<int, jazzy::SegmentCount::LARGE> index;
 
     auto time = measure_time_ms([&]() {
@@ -211,6 +217,65 @@ void example_error_handling() {
     std::cout << "\n";
 }
 
+// Example 6: Scaling with the number of threads
+void example_thread_scaling() {
+    std::cout << "=== Example 6: Thread Scaling ===\n";
+
+    std::vector<int> data(4'000'000);
+    std::iota(data.begin(), data.end(), 0);
+
+    // Segments are grouped into tasks of a few thousand keys or more, so the thread count
+    // rather than the segment count decides how much parallelism the build gets
+    jazzy::JazzyIndex<int, jazzy::SegmentCount::MAX> index;
+    double time_st = measure_time_ms([&]() {
+        index.build(data.data(), data.data() + data.size());
+    });
+    std::cout << "Single-threaded build(): " << time_st << " ms\n";
+
+    const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1; threads <= 64; threads *= 2) {
+        if (threads > hardware) {
+            std::cout << "  " << threads << " threads: skipped (" << hardware << " hardware threads)\n";
+            continue;
+        }
+        jazzy::parallel::ThreadPool pool(threads);
+        index.build_parallel(data.data(), data.data() + data.size(), pool);  // Warm up the pool
+        double time_mt = measure_time_ms([&]() {
+            index.build_parallel(data.data(), data.data() + data.size(), pool);
+        });
+        std::cout << "  " << threads << " threads: " << time_mt << " ms (speedup "
+                  << time_st / time_mt << "x)\n";
+    }
+
+    std::cout << "\n";
+}
+
+// Example 7: Running the build on another scheduler
+void example_external_scheduler() {
+    std::cout << "=== Example 7: External Scheduler ===\n";
+
+    std::vector<int> data(1'000'000);
+    std::iota(data.begin(), data.end(), 0);
+
+    // Any callable that accepts a std::function<void()> works: tbb::task_arena::enqueue,
+    // a job system's submit, an asio post... Here each task simply gets a std::thread
+    std::vector<std::thread> threads;
+    jazzy::parallel::SchedulerExecutor scheduler([&threads](std::function<void()> task) {
+        threads.emplace_back(std::move(task));
+    });
+
+    jazzy::JazzyIndex<int, jazzy::SegmentCount::LARGE> index;
+    auto time = measure_time_ms([&]() {
+        index.build_parallel(data.data(), data.data() + data.size(), scheduler);
+    });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::cout << "Built " << index.num_segments() << " segments with " << threads.size()
+              << " scheduled tasks in " << time << " ms\n\n";
+}
+
 int main() {
     std::cout << "JazzyIndex Parallel Build Examples\n";
     std::cout << "===================================\n\n";
@@ -220,6 +285,8 @@ int main() {
     example_performance_comparison();
     example_different_distributions();
     example_error_handling();
+    example_thread_scaling();
+    example_external_scheduler();
 
     std::cout << "All examples completed!\n";
     return 0;
@@ -2,20 +2,32 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <chrono>
 #include <cmath>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <iosfwd>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
-#include "jazzy_index_utility.hpp"  // detail::clamp_value and arithmetic trait
+#include "jazzy_index_utility.hpp"  // detail::clamp_value, prefetch_read and arithmetic trait
 #include "jazzy_index_debug.hpp"    // DEBUG_LOG macro (conditional compilation)
+#include "jazzy_index_simd.hpp"     // PackedModel and vector kernels for batched lookups
+#include "jazzy_index_stats.hpp"    // QueryStats and the per-thread collector behind stats::PerThread
+#include "jazzy_index_filter.hpp"   // Blocked Bloom filter and hot-key cache behind filter:: and cache::
 
 namespace jazzy {
 
@@ -56,18 +68,62 @@ inline constexpr std::size_t MAX_ACCEPTABLE_QUADRATIC_ERROR = 6;
 inline constexpr std::size_t MAX_CUBIC_WORTHWHILE_ERROR = 50;
 // If quadratic error >50, likely a discontinuity; cubic won't help, skip computation
 
+inline constexpr std::size_t FUSED_CUBIC_MIN_KEYS = 1024;
+// Segments with at least this many keys fit the cubic speculatively and measure it in the same pass
+// as the quadratic; shorter ones are still in cache, so a separate pass is cheaper than the solve
+
 inline constexpr std::size_t SEARCH_RADIUS_MARGIN = 2;
-// Extra margin added to max_error for exponential search bounds
+// Extra margin added to max_error for the last-mile search window
+
+inline constexpr std::size_t LAST_MILE_SCAN_WINDOW = 32;
+// Windows of at most this many arithmetic keys (ordered by std::less) are counted with vector
+// compares instead of halved further: 32 uint64_t keys are four cache lines
 
-inline constexpr std::size_t MIN_SEARCH_RADIUS = 4;
-// Minimum radius for exponential search to ensure reasonable coverage
+inline constexpr std::size_t LAST_MILE_SCAN_WINDOW_GENERIC = 8;
+// The same cut-over for other key types and comparators, where every comparison is a call
 
-inline constexpr std::size_t INITIAL_SEARCH_RADIUS = 2;
-// Starting radius for exponential search (doubles each iteration: 2,4,8,16...)
+inline constexpr std::size_t MIN_TABLED_RUN = 64;
+// Runs of equivalent keys at least this long that cross a segment boundary are recorded at build
+// time; bound queries for such a key read their answer from the run table
+
+inline constexpr std::size_t RANGE_SCAN_PREFETCH_LINES = 8;
+// for_each_in_range prefetches this many cache lines ahead of the key it visits
 
 inline constexpr double UNIFORMITY_TOLERANCE = 0.30;
 // Allow 30% deviation in segment spacing for uniformity detection
 
+inline constexpr std::size_t UNBOUNDED_ERROR = std::numeric_limits<std::size_t>::max();
+// Error target meaning "no bound": segments are cut by count and fitted by analyze_segment alone
+
+inline constexpr std::size_t MAX_SEGMENTS = 4096;
+// Upper bound on segments per index, for the fixed presets and runtime-sized builds alike
+
+inline constexpr std::size_t DEFAULT_KEYS_PER_SEGMENT = 64;
+// Runtime-sized indexes (SegmentCount::DYNAMIC) get one equal-count segment per 64 keys by default
+
+inline constexpr double WORKLOAD_QUERY_SHARE = 0.75;
+// Workload rebuilds place 3/4 of the segment budget by query density and 1/4 by key count,
+// so key ranges the sample never touched still get segments
+
+inline constexpr std::size_t BATCH_GROUP_SIZE = 32;
+// Keys processed per pipeline stage in batched lookups; keeps ~32 cache misses in flight
+
+inline constexpr std::size_t CURSOR_GALLOP_KEYS = 8;
+// A cursor seek gallops about one cache line of 8-byte keys past its position before asking the
+// model; longer gallops chain cache misses that a model lookup would issue independently
+
+inline constexpr std::size_t PARALLEL_MIN_CHUNK_ELEMENTS = 4096;
+// Parallel builds group consecutive segments into tasks of at least this many keys
+
+inline constexpr std::size_t PARALLEL_CHUNKS_PER_THREAD = 4;
+// ...and aim for about 4 tasks per executor thread so work stealing can even out skewed segments
+
+inline constexpr std::size_t FIND_MANY_CHUNK_KEYS = 8192;
+// parallel::find_many hands each task this many probes (64 KiB of 8-byte keys plus their results)
+
+inline constexpr std::size_t FIND_MANY_PARTITION_BUCKETS = 256;
+// ...and, when asked to, partitions an unsorted chunk into this many key ranges before searching it
+
 // Numerical stability and tolerance constants
 inline constexpr double ZERO_RANGE_THRESHOLD = std::numeric_limits<double>::epsilon();
 // Threshold for detecting zero range (constant segments) in floating-point comparisons
@@ -78,6 +134,66 @@ inline constexpr double NUMERICAL_TOLERANCE = 1e-10;
 inline constexpr double MIN_DISTRIBUTION_SCALE = 1e-6;
 // Minimum scale parameter for distributions to prevent division by zero
 
+}  // namespace detail
+
+// Most complex model a build may fit to a segment; each allows the ones before it
+enum class ModelLimit : uint8_t {
+    LINEAR,     // LINEAR (and CONSTANT) only: the cheapest prediction, O(1) lookups on uniform data
+    QUADRATIC,
+    CUBIC       // Default
+};
+
+// Runtime model-selection policy for builds (set_build_config on JazzyIndex, MutableJazzyIndex and
+// StreamingIndexWriter). The defaults are the detail constants of the same names; see
+// analyze_segment for how each threshold is used
+struct BuildConfig {
+    ModelLimit model_limit = ModelLimit::CUBIC;
+    std::size_t max_acceptable_linear_error = detail::MAX_ACCEPTABLE_LINEAR_ERROR;
+    double quadratic_improvement_threshold = detail::QUADRATIC_IMPROVEMENT_THRESHOLD;
+    double cubic_improvement_threshold = detail::CUBIC_IMPROVEMENT_THRESHOLD;
+    std::size_t max_acceptable_quadratic_error = detail::MAX_ACCEPTABLE_QUADRATIC_ERROR;
+    std::size_t max_cubic_worthwhile_error = detail::MAX_CUBIC_WORTHWHILE_ERROR;
+    double uniformity_tolerance = detail::UNIFORMITY_TOLERANCE;
+
+    // LINEAR models only: one FMA per prediction, usually paired with more segments
+    [[nodiscard]] static constexpr BuildConfig linear_only() noexcept {
+        BuildConfig config;
+        config.model_limit = ModelLimit::LINEAR;
+        return config;
+    }
+
+    // Fit the most accurate model any segment allows: a higher-degree model is kept whenever it
+    // lowers the error, so fewer segments reach a given error window
+    [[nodiscard]] static constexpr BuildConfig prefer_cubic() noexcept {
+        BuildConfig config;
+        config.max_acceptable_linear_error = 0;
+        config.quadratic_improvement_threshold = 1.0;
+        config.cubic_improvement_threshold = 1.0;
+        config.max_acceptable_quadratic_error = 0;
+        config.max_cubic_worthwhile_error = std::numeric_limits<std::size_t>::max();
+        return config;
+    }
+
+    // Throws std::invalid_argument unless the thresholds are positive and finite (the
+    // uniformity tolerance may be 0) and the model limit is known
+    void validate() const {
+        if (model_limit > ModelLimit::CUBIC) {
+            throw std::invalid_argument("BuildConfig::model_limit is not a ModelLimit value");
+        }
+        if (!(quadratic_improvement_threshold > 0.0) || !std::isfinite(quadratic_improvement_threshold) ||
+            !(cubic_improvement_threshold > 0.0) || !std::isfinite(cubic_improvement_threshold)) {
+            throw std::invalid_argument("BuildConfig improvement thresholds must be positive and finite");
+        }
+        if (!(uniformity_tolerance >= 0.0) || !std::isfinite(uniformity_tolerance)) {
+            throw std::invalid_argument("BuildConfig::uniformity_tolerance must be non-negative and finite");
+        }
+    }
+
+    friend constexpr bool operator==(const BuildConfig&, const BuildConfig&) = default;
+};
+
+namespace detail {
+
 // Segment descriptor with optimal model
 template <typename T>
 struct alignas(64) Segment {  // Cache line aligned
@@ -114,9 +230,10 @@ struct alignas(64) Segment {  // Cache line aligned
     std::size_t start_idx;
     std::size_t end_idx;
 
-    template <typename KeyExtractor = jazzy::identity>
-    [[nodiscard]] std::size_t predict(const T& value, KeyExtractor key_extract = KeyExtractor{}) const
-        noexcept(std::is_nothrow_invocable_v<KeyExtractor, const T&>) {
+    // value is the indexed record (T here is the bound type, which may be just its key)
+    template <typename V = T, typename KeyExtractor = jazzy::identity>
+    [[nodiscard]] std::size_t predict(const V& value, KeyExtractor key_extract = KeyExtractor{}) const
+        noexcept(std::is_nothrow_invocable_v<KeyExtractor, const V&>) {
         const double key_val = (model_type != ModelType::CONSTANT) ?
                                static_cast<double>(std::invoke(key_extract, value)) : 0.0;
 
@@ -161,6 +278,100 @@ struct alignas(64) Segment {  // Cache line aligned
                 return start_idx;  // Fallback
         }
     }
+
+    // predict() for a LINEAR segment, without the model switch
+    [[nodiscard]] std::size_t predict_linear(double key_val) const noexcept {
+        const double pred = std::fma(key_val, params.linear.slope, params.linear.intercept);
+        const std::size_t result = static_cast<std::size_t>(std::max(0.0, pred));
+        DEBUG_LOG("predict[%zu-%zu]: LINEAR - key=%.4f, pred=%.2f, result=%zu (slope=%.4f, intercept=%.4f)",
+                  start_idx, end_idx, key_val, pred, result, params.linear.slope, params.linear.intercept);
+        return result;
+    }
+};
+
+// Compact segment record for the split layout: model in cubic form plus the segment extent
+// (40 bytes instead of a 64-byte line; the routing keys live in a separate dense array)
+struct CompactSegment {
+    PackedModel model;  // LINEAR (0,0,slope,intercept), QUADRATIC (0,a,b,c), CUBIC (a,b,c,d)
+    std::size_t start_idx;
+    std::size_t end_idx;
+    uint32_t max_error;
+    ModelType model_type;
+
+    // Same arithmetic as Segment::predict, so both layouts predict identical positions
+    template <typename T, typename KeyExtractor = jazzy::identity>
+    [[nodiscard]] std::size_t predict(const T& value, KeyExtractor key_extract = KeyExtractor{}) const
+        noexcept(std::is_nothrow_invocable_v<KeyExtractor, const T&>) {
+        if (model_type == ModelType::CONSTANT) {
+            DEBUG_LOG("predict[%zu-%zu]: CONSTANT - returning %zu", start_idx, end_idx, start_idx);
+            return start_idx;
+        }
+
+        const double key_val = static_cast<double>(std::invoke(key_extract, value));
+        double pred = 0.0;
+        switch (model_type) {
+            case ModelType::LINEAR:
+                pred = std::fma(key_val, model.c, model.d);
+                break;
+            case ModelType::QUADRATIC:
+                pred = std::fma(key_val, std::fma(key_val, model.b, model.c), model.d);
+                break;
+            case ModelType::CUBIC:
+                pred = std::fma(key_val, std::fma(key_val, std::fma(key_val, model.a, model.b), model.c), model.d);
+                break;
+            default:
+                return start_idx;  // Fallback
+        }
+        const std::size_t result = static_cast<std::size_t>(std::max(0.0, pred));
+        DEBUG_LOG("predict[%zu-%zu]: compact model %d - key=%.4f, pred=%.2f, result=%zu",
+                  start_idx, end_idx, static_cast<int>(model_type), key_val, pred, result);
+        return result;
+    }
+
+    // predict() for a LINEAR segment, without the model switch
+    [[nodiscard]] std::size_t predict_linear(double key_val) const noexcept {
+        const double pred = std::fma(key_val, model.c, model.d);
+        const std::size_t result = static_cast<std::size_t>(std::max(0.0, pred));
+        DEBUG_LOG("predict[%zu-%zu]: compact model %d - key=%.4f, pred=%.2f, result=%zu",
+                  start_idx, end_idx, static_cast<int>(ModelType::LINEAR), key_val, pred, result);
+        return result;
+    }
+};
+
+// Segment record for the compressed layout (32 bytes, two per cache line). The model is a cubic
+// in t = (key - origin) * inv_range, where origin is the previous segment's max key (the first
+// key for segment 0), so t runs over (0, 1] inside the segment. The predicted offset from
+// start_idx is scale * (((q[3] * t + q[2]) * t + q[1]) * t + q[0]); the store evaluates it
+// because only the store knows the origin.
+struct QuantizedSegment {
+    std::array<std::int16_t, 4> q;  // Fixed-point coefficients of t^0..t^3, in units of scale
+    float scale;
+    float inv_range;
+    std::uint32_t start_idx;
+    std::uint32_t end_idx;
+    std::uint32_t max_error;
+    ModelType model_type;
+};
+static_assert(sizeof(QuantizedSegment) == 32, "QuantizedSegment should pack two records per cache line");
+
+// Segment record for the precise layout. The model gives the offset from start_idx as a cubic in
+// the key's offset from min_val, with double coefficients. Bounds, model and extent fill the first
+// cache line for 64-bit keys; max_error, read only by window searches, starts the second
+template <typename T>
+struct alignas(64) PreciseSegment {
+    T min_val;
+    T max_val;
+    std::array<double, 4> coeffs;  // Offset = ((coeffs[3] * x + coeffs[2]) * x + coeffs[1]) * x + coeffs[0]
+    std::size_t start_idx;
+    std::size_t end_idx;
+    uint32_t max_error;
+    ModelType model_type;
+};
+
+// Positions [first, last) of a run of equivalent keys, recorded at build time (see MIN_TABLED_RUN)
+struct KeyRun {
+    std::size_t first;
+    std::size_t last;
 };
 
 // Analyze segment to choose best model
@@ -174,13 +385,204 @@ struct SegmentAnalysis {
     double mean_error;
 };
 
-// Fit linear model to segment: index = slope * value + intercept
+// key - origin as a double. Integer keys are subtracted in the key type first, so keys past 2^53
+// (where a double is coarser than 1) keep their exact offset within a segment
+template <typename K, typename T>
+[[nodiscard]] double key_offset(const K& key, const T& origin) noexcept {
+    if constexpr (std::is_integral_v<K> && std::is_integral_v<T>) {
+        if (std::cmp_less(key, origin)) {
+            return -static_cast<double>(static_cast<std::uint64_t>(origin) - static_cast<std::uint64_t>(key));
+        }
+        return static_cast<double>(static_cast<std::uint64_t>(key) - static_cast<std::uint64_t>(origin));
+    } else {
+        return static_cast<double>(key) - static_cast<double>(origin);
+    }
+}
+
+// Float coefficients in cubic form, exactly as the segment stores and evaluates them
+template <typename T>
+[[nodiscard]] PackedModel pack_model(const SegmentAnalysis<T>& analysis) noexcept {
+    switch (analysis.best_model) {
+        case ModelType::LINEAR:
+            return {0.0f, 0.0f, static_cast<float>(analysis.linear_a), static_cast<float>(analysis.linear_b)};
+        case ModelType::QUADRATIC:
+            return {0.0f, static_cast<float>(analysis.quad_a), static_cast<float>(analysis.quad_b),
+                    static_cast<float>(analysis.quad_c)};
+        case ModelType::CUBIC:
+            return {static_cast<float>(analysis.cubic_a), static_cast<float>(analysis.cubic_b),
+                    static_cast<float>(analysis.cubic_c), static_cast<float>(analysis.cubic_d)};
+        default:
+            return {0.0f, 0.0f, 0.0f, 0.0f};  // CONSTANT: evaluates to 0, clamped to start_idx
+    }
+}
+
+// Normal-equation sums for the polynomial fits, over x normalized to [0, 1] and y = index
+struct PowerSums {
+    double x = 0.0, x2 = 0.0, x3 = 0.0, x4 = 0.0, x5 = 0.0, x6 = 0.0;
+    double y = 0.0, xy = 0.0, x2y = 0.0, x3y = 0.0;
+
+    void add(double xn, double yi) noexcept {
+        const double p2 = xn * xn;
+        const double p3 = p2 * xn;
+        const double p4 = p2 * p2;
+        x += xn;
+        x2 += p2;
+        x3 += p3;
+        x4 += p4;
+        x5 += p4 * xn;
+        x6 += p3 * p3;
+        y += yi;
+        xy += xn * yi;
+        x2y += p2 * yi;
+        x3y += p3 * yi;
+    }
+};
+
+// Least-squares polynomial coefficients in normalized x (highest power first; a is 0 for quadratics)
+struct PolynomialFit {
+    double a = 0.0, b = 0.0, c = 0.0, d = 0.0;
+};
+
+// Solve the 3x3 normal equations by Cramer's rule. Returns the determinant; the fit
+// (b, c, d) is only written when it is not singular
+[[nodiscard]] inline double solve_quadratic(const PowerSums& s, double n, PolynomialFit& fit) noexcept {
+    // System: [Σx⁴  Σx³  Σx²] [a]   [Σx²y]
+    //         [Σx³  Σx²  Σx ] [b] = [Σxy ]
+    //         [Σx²  Σx   n  ] [c]   [Σy  ]
+    const double det = s.x4 * (s.x2 * n - s.x * s.x)
+                     - s.x3 * (s.x3 * n - s.x * s.x2)
+                     + s.x2 * (s.x3 * s.x - s.x2 * s.x2);
+    if (std::abs(det) <= NUMERICAL_TOLERANCE) {
+        return det;
+    }
+
+    const double det_a = s.x2y * (s.x2 * n - s.x * s.x)
+                       - s.xy * (s.x3 * n - s.x * s.x2)
+                       + s.y * (s.x3 * s.x - s.x2 * s.x2);
+
+    const double det_b = s.x4 * (s.xy * n - s.y * s.x)
+                       - s.x3 * (s.x2y * n - s.y * s.x2)
+                       + s.x2 * (s.x2y * s.x - s.xy * s.x2);
+
+    const double det_c = s.x4 * (s.x2 * s.y - s.x * s.xy)
+                       - s.x3 * (s.x3 * s.y - s.x * s.x2y)
+                       + s.x2 * (s.x3 * s.xy - s.x2 * s.x2y);
+
+    fit = {0.0, det_a / det, det_b / det, det_c / det};
+    return det;
+}
+
+// Solve the 4x4 normal equations by cofactor expansion and Cramer's rule.
+// Returns false (fit untouched) when the system is singular
+[[nodiscard]] inline bool solve_cubic(const PowerSums& s, double n, PolynomialFit& fit) noexcept {
+    // System: [Σx⁶  Σx⁵  Σx⁴  Σx³] [a]   [Σx³y]
+    //         [Σx⁵  Σx⁴  Σx³  Σx²] [b] = [Σx²y]
+    //         [Σx⁴  Σx³  Σx²  Σx ] [c]   [Σxy ]
+    //         [Σx³  Σx²  Σx   n  ] [d]   [Σy  ]
+    auto det3x3 = [](double a11, double a12, double a13,
+                    double a21, double a22, double a23,
+                    double a31, double a32, double a33) -> double {
+        return a11 * (a22 * a33 - a23 * a32)
+             - a12 * (a21 * a33 - a23 * a31)
+             + a13 * (a21 * a32 - a22 * a31);
+    };
+
+    // 4x4 determinant by expanding along first row
+    const double det4 =
+        s.x6 * det3x3(s.x4, s.x3, s.x2,
+                      s.x3, s.x2, s.x,
+                      s.x2, s.x, n)
+        - s.x5 * det3x3(s.x5, s.x3, s.x2,
+                        s.x4, s.x2, s.x,
+                        s.x3, s.x, n)
+        + s.x4 * det3x3(s.x5, s.x4, s.x2,
+                        s.x4, s.x3, s.x,
+                        s.x3, s.x2, n)
+        - s.x3 * det3x3(s.x5, s.x4, s.x3,
+                        s.x4, s.x3, s.x2,
+                        s.x3, s.x2, s.x);
+
+    if (std::abs(det4) <= NUMERICAL_TOLERANCE) {
+        return false;
+    }
+
+    // Determinants for Cramer's rule (replace each column with RHS)
+    const double det_a =
+        s.x3y * det3x3(s.x4, s.x3, s.x2,
+                       s.x3, s.x2, s.x,
+                       s.x2, s.x, n)
+        - s.x5 * det3x3(s.x2y, s.x3, s.x2,
+                        s.xy, s.x2, s.x,
+                        s.y, s.x, n)
+        + s.x4 * det3x3(s.x2y, s.x4, s.x2,
+                        s.xy, s.x3, s.x,
+                        s.y, s.x2, n)
+        - s.x3 * det3x3(s.x2y, s.x4, s.x3,
+                        s.xy, s.x3, s.x2,
+                        s.y, s.x2, s.x);
+
+    const double det_b =
+        s.x6 * det3x3(s.x2y, s.x3, s.x2,
+                      s.xy, s.x2, s.x,
+                      s.y, s.x, n)
+        - s.x3y * det3x3(s.x5, s.x3, s.x2,
+                         s.x4, s.x2, s.x,
+                         s.x3, s.x, n)
+        + s.x4 * det3x3(s.x5, s.x2y, s.x2,
+                        s.x4, s.xy, s.x,
+                        s.x3, s.y, n)
+        - s.x3 * det3x3(s.x5, s.x2y, s.x3,
+                        s.x4, s.xy, s.x2,
+                        s.x3, s.y, s.x);
+
+    const double det_c =
+        s.x6 * det3x3(s.x4, s.x2y, s.x2,
+                      s.x3, s.xy, s.x,
+                      s.x2, s.y, n)
+        - s.x5 * det3x3(s.x5, s.x2y, s.x2,
+                        s.x4, s.xy, s.x,
+                        s.x3, s.y, n)
+        + s.x3y * det3x3(s.x5, s.x4, s.x2,
+                         s.x4, s.x3, s.x,
+                         s.x3, s.x2, n)
+        - s.x3 * det3x3(s.x5, s.x4, s.x2y,
+                        s.x4, s.x3, s.xy,
+                        s.x3, s.x2, s.y);
+
+    const double det_d =
+        s.x6 * det3x3(s.x4, s.x3, s.x2y,
+                      s.x3, s.x2, s.xy,
+                      s.x2, s.x, s.y)
+        - s.x5 * det3x3(s.x5, s.x3, s.x2y,
+                        s.x4, s.x2, s.xy,
+                        s.x3, s.x, s.y)
+        + s.x4 * det3x3(s.x5, s.x4, s.x2y,
+                        s.x4, s.x3, s.xy,
+                        s.x3, s.x2, s.y)
+        - s.x3y * det3x3(s.x5, s.x4, s.x3,
+                         s.x4, s.x3, s.x2,
+                         s.x3, s.x2, s.x);
+
+    fit = {det_a / det4, det_b / det4, det_c / det4, det_d / det4};
+    return true;
+}
+
+// Choose the cheapest model that fits a segment, in stages so each key is read as few times
+// as the segment needs:
+//   1. linear error only, stopping at the first key that rules LINEAR out (most segments end here)
+//   2. power sums for the polynomial fits, finishing the linear error on the way
+//   3. the quadratic error, stopping once quadratic cannot beat linear; long segments measure
+//      the cubic in the same pass, short (cache-resident) ones only when it is worth trying
+// Errors are accumulated in key order, so the chosen models match a straightforward per-model scan.
+// config sets the thresholds and the most complex model allowed; with ModelLimit::LINEAR stage 1
+// measures the whole segment and nothing else is fitted
 template <typename T, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity>
 [[nodiscard]] SegmentAnalysis<T> analyze_segment(const T* data,
                                                    std::size_t start,
                                                    std::size_t end,
                                                    Compare comp = Compare{},
-                                                   KeyExtractor key_extract = KeyExtractor{})
+                                                   KeyExtractor key_extract = KeyExtractor{},
+                                                   const BuildConfig& config = BuildConfig{})
     noexcept(std::is_nothrow_invocable_v<KeyExtractor, const T&> &&
              std::is_nothrow_invocable_v<Compare, const T&, const T&>) {
     SegmentAnalysis<T> result{};
@@ -198,14 +600,17 @@ template <typename T, typename Compare = std::less<>, typename KeyExtractor = ja
         return make_constant();
 
     const std::size_t n = end - start;
+    const double n_double = static_cast<double>(n);
 
     // For sorted data, min/max are at endpoints (extract keys for comparison)
     const double min_val = static_cast<double>(std::invoke(key_extract, data[start]));
     const double max_val = static_cast<double>(std::invoke(key_extract, data[end - 1]));
     const double value_range = max_val - min_val;
 
-    // Check for constant segment (zero range)
-    if (value_range < detail::ZERO_RANGE_THRESHOLD) {
+    // Check for constant segment (zero range), or keys that are all equivalent under comp:
+    // equivalent keys are contiguous in sorted data, so comparing the endpoints covers the run
+    if (value_range < detail::ZERO_RANGE_THRESHOLD ||
+        (!comp(data[start], data[end - 1]) && !comp(data[end - 1], data[start]))) {
         return make_constant();
     }
 
@@ -216,497 +621,2196 @@ template <typename T, typename Compare = std::less<>, typename KeyExtractor = ja
     result.linear_a = slope;
     result.linear_b = intercept;
 
-    // Single pass: compute linear error AND quadratic/cubic sums simultaneously
-    std::size_t linear_max_error = 0;
+    auto key_at = [data, &key_extract](std::size_t i) {
+        return static_cast<double>(std::invoke(key_extract, data[i]));
+    };
+
+    // Stage 1: linear error. Worst errors are tracked unrounded (ceil is monotonic, so
+    // ceil(max) == max(ceil)); ceil(e) > max_acceptable_linear_error exactly when e exceeds it
+    const double linear_limit = config.model_limit == ModelLimit::LINEAR
+        ? std::numeric_limits<double>::infinity()
+        : static_cast<double>(config.max_acceptable_linear_error);
+    double linear_worst = 0.0;
     double linear_total_error = 0.0;
+    std::size_t i = start;
+    for (; i < end && linear_worst <= linear_limit; ++i) {
+        const double error = std::abs(std::fma(key_at(i), slope, intercept) - static_cast<double>(i));
+        linear_worst = std::max(linear_worst, error);
+        linear_total_error += error;
+    }
 
-    double sum_x = 0.0, sum_x2 = 0.0, sum_x3 = 0.0, sum_x4 = 0.0, sum_x5 = 0.0, sum_x6 = 0.0;
-    double sum_y = 0.0, sum_xy = 0.0, sum_x2y = 0.0, sum_x3y = 0.0;
+    if (linear_worst <= linear_limit) {
+        const auto linear_max_error = static_cast<std::size_t>(std::ceil(linear_worst));
+        result.best_model = ModelType::LINEAR;
+        result.max_error = linear_max_error;
+        result.mean_error = linear_total_error / n_double;
+        DEBUG_LOG("analyze_segment[%zu-%zu]: n=%zu, linear_max_error=%zu, linear_mean_error=%.2f, slope=%.4f, intercept=%.4f",
+                  start, end, n, linear_max_error, result.mean_error, slope, intercept);
+        DEBUG_LOG("analyze_segment[%zu-%zu]: Selected LINEAR model (max_error=%zu <= threshold=%zu)",
+                  start, end, linear_max_error, config.max_acceptable_linear_error);
+        return result;
+    }
 
+    // Stage 2: power sums over the whole segment (normalized x for numerical stability),
+    // finishing the linear error from where stage 1 stopped
     const double x_min = min_val;
     const double x_scale = value_range;
-
-    bool all_same = true;
-    const T first_val = data[start];
-
-    // Helper for equality check using comparator (a == b iff !(a < b) && !(b < a))
-    auto equal = [&comp](const T& a, const T& b) {
-        return !comp(a, b) && !comp(b, a);
-    };
-
-    for (std::size_t i = start; i < end; ++i) {
-        const T current_val = data[i];
-        const double key_val = static_cast<double>(std::invoke(key_extract, current_val));
-
-        // Check if all values are identical using comparator
-        if (all_same && !equal(current_val, first_val)) {
-            all_same = false;
-        }
-
-        // Compute linear error
-        const double pred_double = std::fma(key_val, slope, intercept);
-        const double error = std::abs(pred_double - static_cast<double>(i));
-        linear_max_error = std::max(linear_max_error, static_cast<std::size_t>(std::ceil(error)));
+    PowerSums sums;
+    const std::size_t linear_stop = i;
+    for (std::size_t j = start; j < linear_stop; ++j) {
+        sums.add((key_at(j) - x_min) / x_scale, static_cast<double>(j));
+    }
+    for (std::size_t j = linear_stop; j < end; ++j) {
+        const double key_val = key_at(j);
+        const double error = std::abs(std::fma(key_val, slope, intercept) - static_cast<double>(j));
+        linear_worst = std::max(linear_worst, error);
         linear_total_error += error;
-
-        // Accumulate quadratic/cubic sums (normalized x for numerical stability)
-        const double x_normalized = (key_val - x_min) / x_scale;
-        const double y = static_cast<double>(i);
-        const double x2 = x_normalized * x_normalized;
-        const double x3 = x2 * x_normalized;
-        const double x4 = x2 * x2;
-        const double x5 = x4 * x_normalized;
-        const double x6 = x3 * x3;
-
-        sum_x += x_normalized;
-        sum_x2 += x2;
-        sum_x3 += x3;
-        sum_x4 += x4;
-        sum_x5 += x5;
-        sum_x6 += x6;
-        sum_y += y;
-        sum_xy += x_normalized * y;
-        sum_x2y += x2 * y;
-        sum_x3y += x3 * y;
-    }
-
-    // If all values are identical, use constant model
-    if (all_same) {
-        return make_constant();
+        sums.add((key_val - x_min) / x_scale, static_cast<double>(j));
     }
 
-    const double linear_mean_error = linear_total_error / static_cast<double>(n);
+    const auto linear_max_error = static_cast<std::size_t>(std::ceil(linear_worst));
+    const double linear_mean_error = linear_total_error / n_double;
 
     DEBUG_LOG("analyze_segment[%zu-%zu]: n=%zu, linear_max_error=%zu, linear_mean_error=%.2f, slope=%.4f, intercept=%.4f",
               start, end, n, linear_max_error, linear_mean_error, slope, intercept);
+    DEBUG_LOG("analyze_segment[%zu-%zu]: Linear error too high (%zu > %zu), trying QUADRATIC",
+              start, end, linear_max_error, config.max_acceptable_linear_error);
 
-    // If linear is good enough, use it
-    if (linear_max_error <= MAX_ACCEPTABLE_LINEAR_ERROR) {
+    auto use_linear = [&]() {
         result.best_model = ModelType::LINEAR;
         result.max_error = linear_max_error;
         result.mean_error = linear_mean_error;
-        DEBUG_LOG("analyze_segment[%zu-%zu]: Selected LINEAR model (max_error=%zu <= threshold=%zu)",
-                  start, end, linear_max_error, MAX_ACCEPTABLE_LINEAR_ERROR);
+        DEBUG_LOG("analyze_segment[%zu-%zu]: Defaulted to LINEAR model (max_error=%zu)",
+                  start, end, linear_max_error);
         return result;
+    };
+
+    PolynomialFit quad;
+    const double det = solve_quadratic(sums, n_double, quad);
+    if (std::abs(det) <= NUMERICAL_TOLERANCE) {
+        DEBUG_LOG("analyze_segment[%zu-%zu]: Quadratic matrix singular (det=%.6f), using LINEAR", start, end, det);
+        return use_linear();
     }
 
-    DEBUG_LOG("analyze_segment[%zu-%zu]: Linear error too high (%zu > %zu), trying QUADRATIC",
-              start, end, linear_max_error, MAX_ACCEPTABLE_LINEAR_ERROR);
+    // Quadratic is only accepted below quadratic_improvement_threshold * linear error, i.e. while
+    // ceil(error) < limit, which is error <= ceil(limit) - 1. Cubic is only tried for an accepted
+    // quadratic error above max_acceptable_quadratic_error, so it is skipped entirely when no
+    // integer error fits between the two (or the model limit rules it out)
+    const double quad_error_limit = static_cast<double>(linear_max_error) * config.quadratic_improvement_threshold;
+    const double quad_reject_above = std::ceil(quad_error_limit) - 1.0;
+    const bool cubic_possible = config.model_limit == ModelLimit::CUBIC &&
+                                static_cast<double>(config.max_acceptable_quadratic_error) + 1.0 < quad_error_limit;
+
+    // Long segments measure the cubic in the same pass as the quadratic; short ones are still in
+    // cache, so their cubic is only fitted once the quadratic error shows it is worth trying
+    PolynomialFit cubic;
+    bool cubic_measured = cubic_possible && n >= FUSED_CUBIC_MIN_KEYS && solve_cubic(sums, n_double, cubic);
+
+    double quad_worst = 0.0;
+    double quad_total_error = 0.0;
+    double cubic_worst = 0.0;
+    double cubic_total_error = 0.0;
+    bool quad_rejected = false;
+
+    // Stage 3: quadratic error (stopping as soon as it can no longer beat linear), plus the cubic
+    // error when fused
+    auto scan_quadratic = [&](auto with_cubic) {
+        for (std::size_t j = start; j < end; ++j) {
+            const double x_norm = (key_at(j) - x_min) / x_scale;
+            const double y = static_cast<double>(j);
+            const double quad_error = std::abs(std::fma(x_norm, std::fma(x_norm, quad.b, quad.c), quad.d) - y);
+            quad_worst = std::max(quad_worst, quad_error);
+            quad_total_error += quad_error;
+            if constexpr (decltype(with_cubic)::value) {
+                const double cubic_pred =
+                    std::fma(x_norm, std::fma(x_norm, std::fma(x_norm, cubic.a, cubic.b), cubic.c), cubic.d);
+                const double cubic_error = std::abs(cubic_pred - y);
+                cubic_worst = std::max(cubic_worst, cubic_error);
+                cubic_total_error += cubic_error;
+            }
+            if (quad_worst > quad_reject_above) {
+                quad_rejected = true;
+                return;
+            }
+        }
+    };
+    if (cubic_measured) {
+        scan_quadratic(std::true_type{});
+    } else {
+        scan_quadratic(std::false_type{});
+    }
 
-    // Try quadratic model: we already have the sums from the single pass above
+    const auto quad_max_error = static_cast<std::size_t>(std::ceil(quad_worst));
+    const double quad_mean_error = quad_total_error / n_double;
 
-    const double n_double = static_cast<double>(n);
+    // Choose quadratic only if it's significantly better
+    if (quad_rejected) {
+        DEBUG_LOG("analyze_segment[%zu-%zu]: QUADRATIC not good enough (error>=%zu >= threshold=%.0f), using LINEAR",
+                  start, end, quad_max_error, quad_error_limit);
+        return use_linear();
+    }
 
-    // Solve normal equations using Cramer's rule for 3x3 system
-    // System: [Σx⁴  Σx³  Σx²] [a]   [Σx²y]
-    //         [Σx³  Σx²  Σx ] [b] = [Σxy ]
-    //         [Σx²  Σx   n  ] [c]   [Σy  ]
+    DEBUG_LOG("analyze_segment[%zu-%zu]: QUADRATIC: max_error=%zu, mean_error=%.2f, improvement_threshold=%.0f",
+              start, end, quad_max_error, quad_mean_error, quad_error_limit);
+
+    // Transform coefficients from normalized space back to original space
+    // Original: index = a*x_norm^2 + b*x_norm + c, where x_norm = (x - x_min) / x_scale
+    // Want: index = a'*x^2 + b'*x + c'
+    const double a = quad.b;
+    const double b = quad.c;
+    const double c = quad.d;
+    const double x_scale_sq = x_scale * x_scale;
+    const double quad_a_transformed = a / x_scale_sq;
+    const double quad_b_transformed = b / x_scale - 2.0 * a * x_min / x_scale_sq;
+    const double quad_c_transformed = a * x_min * x_min / x_scale_sq - b * x_min / x_scale + c;
+
+    // Check monotonicity: derivative f'(x) = 2*a*x + b must be non-negative over [min_val, max_val]
+    // For a search index, predictions must be monotonically INCREASING
+    // Since f'(x) is linear, we just need to check both endpoints
+    const double derivative_at_min = 2.0 * quad_a_transformed * min_val + quad_b_transformed;
+    const double derivative_at_max = 2.0 * quad_a_transformed * max_val + quad_b_transformed;
+    const bool is_monotonic = (derivative_at_min >= 0.0) && (derivative_at_max >= 0.0);
+
+    DEBUG_LOG("analyze_segment[%zu-%zu]: QUADRATIC monotonicity: deriv_at_min=%.4f, deriv_at_max=%.4f, is_monotonic=%d",
+              start, end, derivative_at_min, derivative_at_max, is_monotonic);
+
+    // If non-monotonic, use the linear model instead
+    if (!is_monotonic) {
+        DEBUG_LOG("analyze_segment[%zu-%zu]: QUADRATIC not monotonic, falling back to LINEAR", start, end);
+        return use_linear();
+    }
+
+    // Try cubic only if the quadratic error is in the "sweet spot" (6 < error < 50 by default)
+    // High error (>50) likely indicates discontinuity where cubic won't help
+    if (cubic_possible &&
+        quad_max_error > config.max_acceptable_quadratic_error &&
+        quad_max_error < config.max_cubic_worthwhile_error &&
+        (cubic_measured || solve_cubic(sums, n_double, cubic))) {
+        DEBUG_LOG("analyze_segment[%zu-%zu]: Quad error in sweet spot (%zu), trying CUBIC",
+                  start, end, quad_max_error);
+        if (!cubic_measured) {
+            for (std::size_t j = start; j < end; ++j) {
+                const double x_norm = (key_at(j) - x_min) / x_scale;
+                const double cubic_pred =
+                    std::fma(x_norm, std::fma(x_norm, std::fma(x_norm, cubic.a, cubic.b), cubic.c), cubic.d);
+                const double cubic_error = std::abs(cubic_pred - static_cast<double>(j));
+                cubic_worst = std::max(cubic_worst, cubic_error);
+                cubic_total_error += cubic_error;
+            }
+            cubic_measured = true;
+        }
+        const auto cubic_max_error = static_cast<std::size_t>(std::ceil(cubic_worst));
+        DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC: max_error=%zu, improvement_threshold=%.0f",
+                  start, end, cubic_max_error, quad_max_error * config.cubic_improvement_threshold);
+
+        // Choose cubic if it's significantly better than quadratic
+        if (cubic_max_error < quad_max_error * config.cubic_improvement_threshold) {
+            // Transform coefficients from normalized space to original space
+            // Original: y = a*x_norm^3 + b*x_norm^2 + c*x_norm + d
+            // where x_norm = (x - x_min) / x_scale
+            // Expand: y = a*((x-x_min)/s)^3 + b*((x-x_min)/s)^2 + c*((x-x_min)/s) + d
+            const double s = x_scale;
+            const double s2 = s * s;
+            const double s3 = s2 * s;
+            const double m = x_min;
+            const double m2 = m * m;
+            const double m3 = m2 * m;
+
+            // Coefficients in original space (after algebraic expansion)
+            const double cubic_a_orig = cubic.a / s3;
+            const double cubic_b_orig = cubic.b / s2 - 3.0 * cubic.a * m / s3;
+            const double cubic_c_orig = cubic.c / s
+                                      - 2.0 * cubic.b * m / s2
+                                      + 3.0 * cubic.a * m2 / s3;
+            const double cubic_d_orig = cubic.d
+                                      - cubic.c * m / s
+                                      + cubic.b * m2 / s2
+                                      - cubic.a * m3 / s3;
+
+            // Check monotonicity: f'(x) = 3*a*x^2 + 2*b*x + c must be >= 0 over [min_val, max_val]
+            // For cubic, derivative is quadratic, so we check at critical points and endpoints
+            auto cubic_derivative = [&](double x) -> double {
+                return 3.0 * cubic_a_orig * x * x + 2.0 * cubic_b_orig * x + cubic_c_orig;
+            };
+
+            bool cubic_is_monotonic = true;
+            const double cubic_deriv_at_min = cubic_derivative(min_val);
+            const double cubic_deriv_at_max = cubic_derivative(max_val);
+
+            DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC monotonicity check: deriv_at_min=%.4f, deriv_at_max=%.4f",
+                      start, end, cubic_deriv_at_min, cubic_deriv_at_max);
+
+            // Check endpoints
+            if (cubic_deriv_at_min < 0.0 || cubic_deriv_at_max < 0.0) {
+                cubic_is_monotonic = false;
+                DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC failed endpoint monotonicity check", start, end);
+            }
 
-    // Determinant of coefficient matrix
-    const double det = sum_x4 * (sum_x2 * n_double - sum_x * sum_x)
-                     - sum_x3 * (sum_x3 * n_double - sum_x * sum_x2)
-                     + sum_x2 * (sum_x3 * sum_x - sum_x2 * sum_x2);
-
-    if (std::abs(det) > NUMERICAL_TOLERANCE) {
-        // Cramer's rule for a, b, c
-        const double det_a = sum_x2y * (sum_x2 * n_double - sum_x * sum_x)
-                           - sum_xy * (sum_x3 * n_double - sum_x * sum_x2)
-                           + sum_y * (sum_x3 * sum_x - sum_x2 * sum_x2);
-
-        const double det_b = sum_x4 * (sum_xy * n_double - sum_y * sum_x)
-                           - sum_x3 * (sum_x2y * n_double - sum_y * sum_x2)
-                           + sum_x2 * (sum_x2y * sum_x - sum_xy * sum_x2);
-
-        const double det_c = sum_x4 * (sum_x2 * sum_y - sum_x * sum_xy)
-                           - sum_x3 * (sum_x3 * sum_y - sum_x * sum_x2y)
-                           + sum_x2 * (sum_x3 * sum_xy - sum_x2 * sum_x2y);
-
-        const double a = det_a / det;
-        const double b = det_b / det;
-        const double c = det_c / det;
-
-        // Measure quadratic error using normalized x
-        std::size_t quad_max_error = 0;
-        double quad_total_error = 0.0;
-
-        for (std::size_t i = start; i < end; ++i) {
-            const double key_val = static_cast<double>(std::invoke(key_extract, data[i]));
-            const double x_normalized = (key_val - x_min) / x_scale;
-            const double pred_double = std::fma(x_normalized, std::fma(x_normalized, a, b), c);
-            const double error = std::abs(pred_double - static_cast<double>(i));
-            quad_max_error = std::max(quad_max_error, static_cast<std::size_t>(std::ceil(error)));
-            quad_total_error += error;
-        }
-
-        const double quad_mean_error = quad_total_error / n_double;
-
-        DEBUG_LOG("analyze_segment[%zu-%zu]: QUADRATIC: max_error=%zu, mean_error=%.2f, improvement_threshold=%.0f",
-                  start, end, quad_max_error, quad_mean_error, linear_max_error * QUADRATIC_IMPROVEMENT_THRESHOLD);
-
-        // Choose quadratic if it's significantly better
-        if (quad_max_error < linear_max_error * QUADRATIC_IMPROVEMENT_THRESHOLD) {
-            // Transform coefficients from normalized space back to original space
-            // Original: index = a*x_norm^2 + b*x_norm + c, where x_norm = (x - x_min) / x_scale
-            // Want: index = a'*x^2 + b'*x + c'
-            const double x_scale_sq = x_scale * x_scale;
-            const double quad_a_transformed = a / x_scale_sq;
-            const double quad_b_transformed = b / x_scale - 2.0 * a * x_min / x_scale_sq;
-            const double quad_c_transformed = a * x_min * x_min / x_scale_sq - b * x_min / x_scale + c;
-
-            // Check monotonicity: derivative f'(x) = 2*a*x + b must be non-negative over [min_val, max_val]
-            // For a search index, predictions must be monotonically INCREASING
-            // Since f'(x) is linear, we just need to check both endpoints
-            const double derivative_at_min = 2.0 * quad_a_transformed * min_val + quad_b_transformed;
-            const double derivative_at_max = 2.0 * quad_a_transformed * max_val + quad_b_transformed;
-            const bool is_monotonic = (derivative_at_min >= 0.0) && (derivative_at_max >= 0.0);
-
-            DEBUG_LOG("analyze_segment[%zu-%zu]: QUADRATIC monotonicity: deriv_at_min=%.4f, deriv_at_max=%.4f, is_monotonic=%d",
-                      start, end, derivative_at_min, derivative_at_max, is_monotonic);
-
-            // Only accept quadratic if it's monotonic
-            if (is_monotonic) {
-                // Check if we should try cubic for even better fit
-                // Only try cubic if error is in "sweet spot" (6 < error < 50)
-                // High error (>50) likely indicates discontinuity where cubic won't help
-                if (quad_max_error > MAX_ACCEPTABLE_QUADRATIC_ERROR &&
-                    quad_max_error < MAX_CUBIC_WORTHWHILE_ERROR) {
-                    DEBUG_LOG("analyze_segment[%zu-%zu]: Quad error in sweet spot (%zu), trying CUBIC",
-                              start, end, quad_max_error);
-                    // Try cubic model using same normalized sums
-                    // System: [Σx⁶  Σx⁵  Σx⁴  Σx³] [a]   [Σx³y]
-                    //         [Σx⁵  Σx⁴  Σx³  Σx²] [b] = [Σx²y]
-                    //         [Σx⁴  Σx³  Σx²  Σx ] [c]   [Σxy ]
-                    //         [Σx³  Σx²  Σx   n  ] [d]   [Σy  ]
-
-                    // Compute determinant of 4x4 coefficient matrix using cofactor expansion
-                    // For numerical stability and code brevity, we use a helper for 3x3 determinants
-                    auto det3x3 = [](double a11, double a12, double a13,
-                                    double a21, double a22, double a23,
-                                    double a31, double a32, double a33) -> double {
-                        return a11 * (a22 * a33 - a23 * a32)
-                             - a12 * (a21 * a33 - a23 * a31)
-                             + a13 * (a21 * a32 - a22 * a31);
-                    };
-
-                    // 4x4 determinant by expanding along first row
-                    const double det4 =
-                        sum_x6 * det3x3(sum_x4, sum_x3, sum_x2,
-                                       sum_x3, sum_x2, sum_x,
-                                       sum_x2, sum_x, n_double)
-                        - sum_x5 * det3x3(sum_x5, sum_x3, sum_x2,
-                                         sum_x4, sum_x2, sum_x,
-                                         sum_x3, sum_x, n_double)
-                        + sum_x4 * det3x3(sum_x5, sum_x4, sum_x2,
-                                         sum_x4, sum_x3, sum_x,
-                                         sum_x3, sum_x2, n_double)
-                        - sum_x3 * det3x3(sum_x5, sum_x4, sum_x3,
-                                         sum_x4, sum_x3, sum_x2,
-                                         sum_x3, sum_x2, sum_x);
-
-                    if (std::abs(det4) > NUMERICAL_TOLERANCE) {
-                        // Compute determinants for Cramer's rule (replace each column with RHS)
-                        const double det_a =
-                            sum_x3y * det3x3(sum_x4, sum_x3, sum_x2,
-                                           sum_x3, sum_x2, sum_x,
-                                           sum_x2, sum_x, n_double)
-                            - sum_x5 * det3x3(sum_x2y, sum_x3, sum_x2,
-                                             sum_xy, sum_x2, sum_x,
-                                             sum_y, sum_x, n_double)
-                            + sum_x4 * det3x3(sum_x2y, sum_x4, sum_x2,
-                                             sum_xy, sum_x3, sum_x,
-                                             sum_y, sum_x2, n_double)
-                            - sum_x3 * det3x3(sum_x2y, sum_x4, sum_x3,
-                                             sum_xy, sum_x3, sum_x2,
-                                             sum_y, sum_x2, sum_x);
-
-                        const double det_b =
-                            sum_x6 * det3x3(sum_x2y, sum_x3, sum_x2,
-                                           sum_xy, sum_x2, sum_x,
-                                           sum_y, sum_x, n_double)
-                            - sum_x3y * det3x3(sum_x5, sum_x3, sum_x2,
-                                              sum_x4, sum_x2, sum_x,
-                                              sum_x3, sum_x, n_double)
-                            + sum_x4 * det3x3(sum_x5, sum_x2y, sum_x2,
-                                             sum_x4, sum_xy, sum_x,
-                                             sum_x3, sum_y, n_double)
-                            - sum_x3 * det3x3(sum_x5, sum_x2y, sum_x3,
-                                             sum_x4, sum_xy, sum_x2,
-                                             sum_x3, sum_y, sum_x);
-
-                        const double det_c =
-                            sum_x6 * det3x3(sum_x4, sum_x2y, sum_x2,
-                                           sum_x3, sum_xy, sum_x,
-                                           sum_x2, sum_y, n_double)
-                            - sum_x5 * det3x3(sum_x5, sum_x2y, sum_x2,
-                                             sum_x4, sum_xy, sum_x,
-                                             sum_x3, sum_y, n_double)
-                            + sum_x3y * det3x3(sum_x5, sum_x4, sum_x2,
-                                              sum_x4, sum_x3, sum_x,
-                                              sum_x3, sum_x2, n_double)
-                            - sum_x3 * det3x3(sum_x5, sum_x4, sum_x2y,
-                                             sum_x4, sum_x3, sum_xy,
-                                             sum_x3, sum_x2, sum_y);
-
-                        const double det_d =
-                            sum_x6 * det3x3(sum_x4, sum_x3, sum_x2y,
-                                           sum_x3, sum_x2, sum_xy,
-                                           sum_x2, sum_x, sum_y)
-                            - sum_x5 * det3x3(sum_x5, sum_x3, sum_x2y,
-                                             sum_x4, sum_x2, sum_xy,
-                                             sum_x3, sum_x, sum_y)
-                            + sum_x4 * det3x3(sum_x5, sum_x4, sum_x2y,
-                                             sum_x4, sum_x3, sum_xy,
-                                             sum_x3, sum_x2, sum_y)
-                            - sum_x3y * det3x3(sum_x5, sum_x4, sum_x3,
-                                              sum_x4, sum_x3, sum_x2,
-                                              sum_x3, sum_x2, sum_x);
-
-                        const double cubic_a_norm = det_a / det4;
-                        const double cubic_b_norm = det_b / det4;
-                        const double cubic_c_norm = det_c / det4;
-                        const double cubic_d_norm = det_d / det4;
-
-                        // Measure cubic error in normalized space
-                        std::size_t cubic_max_error = 0;
-                        double cubic_total_error = 0.0;
-
-                        for (std::size_t i = start; i < end; ++i) {
-                            const double key_value = static_cast<double>(std::invoke(key_extract, data[i]));
-                            const double x_norm = (key_value - x_min) / x_scale;
-                            const double pred = std::fma(x_norm,
-                                                        std::fma(x_norm,
-                                                                std::fma(x_norm, cubic_a_norm, cubic_b_norm),
-                                                                cubic_c_norm),
-                                                        cubic_d_norm);
-                            const double error = std::abs(pred - static_cast<double>(i));
-                            cubic_max_error = std::max(cubic_max_error, static_cast<std::size_t>(std::ceil(error)));
-                            cubic_total_error += error;
-                        }
-
-                        DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC: max_error=%zu, improvement_threshold=%.0f",
-                                  start, end, cubic_max_error, quad_max_error * CUBIC_IMPROVEMENT_THRESHOLD);
-
-                        // Choose cubic if it's significantly better than quadratic
-                        if (cubic_max_error < quad_max_error * CUBIC_IMPROVEMENT_THRESHOLD) {
-                            // Transform coefficients from normalized space to original space
-                            // Original: y = a*x_norm^3 + b*x_norm^2 + c*x_norm + d
-                            // where x_norm = (x - x_min) / x_scale
-                            // Expand: y = a*((x-x_min)/s)^3 + b*((x-x_min)/s)^2 + c*((x-x_min)/s) + d
-
-                            const double s = x_scale;
-                            const double s2 = s * s;
-                            const double s3 = s2 * s;
-                            const double m = x_min;
-                            const double m2 = m * m;
-                            const double m3 = m2 * m;
-
-                            // Coefficients in original space (after algebraic expansion)
-                            const double cubic_a_orig = cubic_a_norm / s3;
-                            const double cubic_b_orig = cubic_b_norm / s2 - 3.0 * cubic_a_norm * m / s3;
-                            const double cubic_c_orig = cubic_c_norm / s
-                                                      - 2.0 * cubic_b_norm * m / s2
-                                                      + 3.0 * cubic_a_norm * m2 / s3;
-                            const double cubic_d_orig = cubic_d_norm
-                                                      - cubic_c_norm * m / s
-                                                      + cubic_b_norm * m2 / s2
-                                                      - cubic_a_norm * m3 / s3;
-
-                            // Check monotonicity: f'(x) = 3*a*x^2 + 2*b*x + c must be >= 0 over [min_val, max_val]
-                            // For cubic, derivative is quadratic, so we check at critical points and endpoints
-                            auto cubic_derivative = [&](double x) -> double {
-                                return 3.0 * cubic_a_orig * x * x + 2.0 * cubic_b_orig * x + cubic_c_orig;
-                            };
-
-                            bool cubic_is_monotonic = true;
-                            const double cubic_deriv_at_min = cubic_derivative(min_val);
-                            const double cubic_deriv_at_max = cubic_derivative(max_val);
-
-                            DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC monotonicity check: deriv_at_min=%.4f, deriv_at_max=%.4f",
-                                      start, end, cubic_deriv_at_min, cubic_deriv_at_max);
-
-                            // Check endpoints
-                            if (cubic_deriv_at_min < 0.0 || cubic_deriv_at_max < 0.0) {
-                                cubic_is_monotonic = false;
-                                DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC failed endpoint monotonicity check", start, end);
-                            }
-
-                            // Check critical points (where f''(x) = 0)
-                            // f''(x) = 6*a*x + 2*b = 0 => x = -b/(3*a)
-                            if (cubic_is_monotonic && std::abs(cubic_a_orig) > NUMERICAL_TOLERANCE) {
-                                const double critical_x = -cubic_b_orig / (3.0 * cubic_a_orig);
-                                DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC critical point at x=%.4f (range: [%.4f, %.4f])",
-                                          start, end, critical_x, min_val, max_val);
-                                if (critical_x >= min_val && critical_x <= max_val) {
-                                    const double deriv_at_critical = cubic_derivative(critical_x);
-                                    DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC deriv at critical point: %.4f",
-                                              start, end, deriv_at_critical);
-                                    if (deriv_at_critical < 0.0) {
-                                        cubic_is_monotonic = false;
-                                        DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC failed critical point monotonicity", start, end);
-                                    }
-                                }
-                            }
-
-                            if (cubic_is_monotonic) {
-                                result.best_model = ModelType::CUBIC;
-                                result.cubic_a = cubic_a_orig;
-                                result.cubic_b = cubic_b_orig;
-                                result.cubic_c = cubic_c_orig;
-                                result.cubic_d = cubic_d_orig;
-                                result.max_error = cubic_max_error;
-                                result.mean_error = cubic_total_error / n_double;
-                                DEBUG_LOG("analyze_segment[%zu-%zu]: Selected CUBIC model (max_error=%zu, improved from quad_error=%zu)",
-                                          start, end, cubic_max_error, quad_max_error);
-                                return result;
-                            }
-                        }
+            // Check critical points (where f''(x) = 0)
+            // f''(x) = 6*a*x + 2*b = 0 => x = -b/(3*a)
+            if (cubic_is_monotonic && std::abs(cubic_a_orig) > NUMERICAL_TOLERANCE) {
+                const double critical_x = -cubic_b_orig / (3.0 * cubic_a_orig);
+                DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC critical point at x=%.4f (range: [%.4f, %.4f])",
+                          start, end, critical_x, min_val, max_val);
+                if (critical_x >= min_val && critical_x <= max_val) {
+                    const double deriv_at_critical = cubic_derivative(critical_x);
+                    DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC deriv at critical point: %.4f",
+                              start, end, deriv_at_critical);
+                    if (deriv_at_critical < 0.0) {
+                        cubic_is_monotonic = false;
+                        DEBUG_LOG("analyze_segment[%zu-%zu]: CUBIC failed critical point monotonicity", start, end);
                     }
                 }
+            }
 
-                // Use quadratic if cubic didn't work out
-                result.best_model = ModelType::QUADRATIC;
-                result.quad_a = quad_a_transformed;
-                result.quad_b = quad_b_transformed;
-                result.quad_c = quad_c_transformed;
-                result.max_error = quad_max_error;
-                result.mean_error = quad_mean_error;
-                DEBUG_LOG("analyze_segment[%zu-%zu]: Selected QUADRATIC model (max_error=%zu, improved from linear_error=%zu, cubic failed/not worthwhile)",
-                          start, end, quad_max_error, linear_max_error);
+            if (cubic_is_monotonic) {
+                result.best_model = ModelType::CUBIC;
+                result.cubic_a = cubic_a_orig;
+                result.cubic_b = cubic_b_orig;
+                result.cubic_c = cubic_c_orig;
+                result.cubic_d = cubic_d_orig;
+                result.max_error = cubic_max_error;
+                result.mean_error = cubic_total_error / n_double;
+                DEBUG_LOG("analyze_segment[%zu-%zu]: Selected CUBIC model (max_error=%zu, improved from quad_error=%zu)",
+                          start, end, cubic_max_error, quad_max_error);
                 return result;
-            } else {
-                DEBUG_LOG("analyze_segment[%zu-%zu]: QUADRATIC not monotonic, falling back to LINEAR", start, end);
             }
-            // If non-monotonic, fall through to use linear model instead
-        } else {
-            DEBUG_LOG("analyze_segment[%zu-%zu]: QUADRATIC not good enough (error=%zu >= threshold=%.0f), using LINEAR",
-                      start, end, quad_max_error, linear_max_error * QUADRATIC_IMPROVEMENT_THRESHOLD);
         }
-    } else {
-        DEBUG_LOG("analyze_segment[%zu-%zu]: Quadratic matrix singular (det=%.6f), using LINEAR", start, end, det);
     }
 
-    // Default to linear
-    result.best_model = ModelType::LINEAR;
-    result.max_error = linear_max_error;
-    result.mean_error = linear_mean_error;
-    DEBUG_LOG("analyze_segment[%zu-%zu]: Defaulted to LINEAR model (max_error=%zu)",
-              start, end, linear_max_error);
+    // Use quadratic if cubic didn't work out
+    result.best_model = ModelType::QUADRATIC;
+    result.quad_a = quad_a_transformed;
+    result.quad_b = quad_b_transformed;
+    result.quad_c = quad_c_transformed;
+    result.max_error = quad_max_error;
+    result.mean_error = quad_mean_error;
+    DEBUG_LOG("analyze_segment[%zu-%zu]: Selected QUADRATIC model (max_error=%zu, improved from linear_error=%zu, cubic failed/not worthwhile)",
+              start, end, quad_max_error, linear_max_error);
     return result;
 }
 
-}  // namespace detail
+// Shrinking cone (FITing-tree): the slopes of lines through a segment's first point that keep
+// every point added so far within epsilon positions of its index
+struct ShrinkingCone {
+    double epsilon;
+    double lo = -std::numeric_limits<double>::infinity();
+    double hi = std::numeric_limits<double>::infinity();
+
+    // Narrow the cone to cover the point (dx, dy) relative to the first point.
+    // Returns false and leaves the cone unchanged if no line can cover it
+    bool add(double dx, double dy) noexcept {
+        if (dx == 0.0) {
+            return dy <= epsilon;  // Duplicate keys: only the intercept can absorb the offset
+        }
+        double first = (dy - epsilon) / dx;
+        double second = (dy + epsilon) / dx;
+        if (first > second) {
+            std::swap(first, second);  // Keys descending as doubles (e.g. std::greater)
+        }
+        const double new_lo = std::max(lo, first);
+        const double new_hi = std::min(hi, second);
+        if (new_lo > new_hi) {
+            return false;
+        }
+        lo = new_lo;
+        hi = new_hi;
+        return true;
+    }
 
-// Recommended segment count presets
-enum class SegmentCount : std::size_t {
-    SINGLE = 1,      // No segmentation: full dataset in one segment
-    MINIMAL = 2,     // Binary split: extreme coarse indexing
-    PICO = 4,        // Debugging tiny datasets; almost no segmentation
-    NANO = 8,        // Extremely small datasets; coarse segmentation
-    MICRO = 16,      // Minimal segmentation for testing larger segment sizes
-    TINY = 32,       // Very small datasets or minimal memory footprint
-    SMALL = 64,      // Small datasets (thousands of elements)
-    MEDIUM = 128,    // Medium datasets
-    LARGE = 256,     // Default: good balance for most use cases
-    XLARGE = 512,    // Large datasets with complex distributions
-    XXLARGE = 1024,  // Very large datasets requiring high precision
-    MAX = 2048       // Maximum precision for huge datasets
+    [[nodiscard]] double slope() const noexcept {
+        return (std::isfinite(lo) && std::isfinite(hi)) ? lo + (hi - lo) / 2.0 : 0.0;
+    }
 };
 
-// Helper to convert std::size_t to SegmentCount for generic code
-template <std::size_t N>
-inline constexpr SegmentCount to_segment_count() {
-    return static_cast<SegmentCount>(N);
+// Largest distance between the predicted and true index over [start, end), evaluating the model
+// exactly as lookups do: float coefficients, truncation and the segment clamp
+template <typename T, typename KeyExtractor>
+[[nodiscard]] std::size_t stored_model_error(const T* data, std::size_t start, std::size_t end,
+                                             const PackedModel& model, const KeyExtractor& key_extract) {
+    std::size_t max_error = 0;
+    for (std::size_t i = start; i < end; ++i) {
+        const double key_val = static_cast<double>(std::invoke(key_extract, data[i]));
+        const std::size_t predicted = clamp_value<std::size_t>(
+            static_cast<std::size_t>(simd::predict_one(model, key_val)), start, end - 1);
+        max_error = std::max(max_error, predicted > i ? predicted - i : i - predicted);
+    }
+    return max_error;
 }
 
-// Forward declarations for parallel build support
-namespace parallel {
-template <typename T, typename Compare, typename KeyExtractor>
-struct BuildTask;
+// LINEAR model with the given slope (rounded to float first) and the intercept centred on the
+// residuals, so the float intercept is the only rounding left after truncation
+template <typename T, typename KeyExtractor>
+[[nodiscard]] SegmentAnalysis<T> corridor_line(const T* data, std::size_t start, std::size_t end,
+                                               double slope, const KeyExtractor& key_extract) {
+    const double slope_f = static_cast<double>(static_cast<float>(slope));
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = -std::numeric_limits<double>::infinity();
+    for (std::size_t i = start; i < end; ++i) {
+        const double key_val = static_cast<double>(std::invoke(key_extract, data[i]));
+        const double residual = static_cast<double>(i) - slope_f * key_val;
+        lo = std::min(lo, residual);
+        hi = std::max(hi, residual);
+    }
 
-template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor>
-class ParallelBuilder;
-}  // namespace parallel
+    SegmentAnalysis<T> line{};
+    line.best_model = ModelType::LINEAR;
+    line.linear_a = slope_f;
+    line.linear_b = lo + (hi - lo) / 2.0 + 0.5;  // +0.5: predictions are truncated
+    line.max_error = stored_model_error(data, start, end, pack_model(line), key_extract);
+    return line;
+}
 
-template <typename T, SegmentCount Segments = SegmentCount::LARGE, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity>
-class JazzyIndex {
-    static constexpr std::size_t NumSegments = static_cast<std::size_t>(Segments);
+// Greedy shrinking-cone step: end of the longest segment starting at start whose corridor line
+// predicts within corridor positions. Narrower cones are tried when float rounding of the line
+// pushes it past the corridor; a single-key segment always fits
+template <typename T, typename KeyExtractor>
+[[nodiscard]] std::size_t corridor_segment_end(const T* data, std::size_t start, std::size_t size,
+                                               std::size_t corridor, const KeyExtractor& key_extract) {
+    const double x0 = static_cast<double>(std::invoke(key_extract, data[start]));
+    for (std::size_t width = corridor;; width /= 2) {
+        ShrinkingCone cone{static_cast<double>(width)};
+        std::size_t end = start + 1;
+        while (end < size &&
+               cone.add(static_cast<double>(std::invoke(key_extract, data[end])) - x0,
+                        static_cast<double>(end - start))) {
+            ++end;
+        }
+        if (end - start == 1 || corridor_line(data, start, end, cone.slope(), key_extract).max_error <= corridor) {
+            return end;
+        }
+        if (width == 0) {
+            return start + 1;
+        }
+    }
+}
 
-    static_assert(NumSegments > 0 && NumSegments <= 4096,
-                  "NumSegments must be in range [1, 4096]");
+// analyze_segment for segments cut by corridor_segment_end: keeps the selected model when its
+// stored form predicts within the corridor, otherwise uses the corridor line (repeating the
+// cone widths tried while cutting, so a fitting line is always found)
+template <typename T, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity>
+[[nodiscard]] SegmentAnalysis<T> fit_error_bounded_segment(const T* data,
+                                                           std::size_t start,
+                                                           std::size_t end,
+                                                           std::size_t corridor,
+                                                           Compare comp = Compare{},
+                                                           KeyExtractor key_extract = KeyExtractor{},
+                                                           const BuildConfig& config = BuildConfig{}) {
+    SegmentAnalysis<T> result = analyze_segment(data, start, end, comp, key_extract, config);
+    if (end - start < 2) {
+        return result;
+    }
+    const std::size_t model_error = stored_model_error(data, start, end, pack_model(result), key_extract);
+    if (model_error <= corridor) {
+        return result;
+    }
 
-    // Type constraint: KeyExtractor must be callable with const T&
-    static_assert(std::is_invocable_v<KeyExtractor, const T&>,
-                  "KeyExtractor must be callable with const T&");
+    const double x0 = static_cast<double>(std::invoke(key_extract, data[start]));
+    for (std::size_t width = corridor;; width /= 2) {
+        ShrinkingCone cone{static_cast<double>(width)};
+        bool feasible = true;
+        for (std::size_t i = start + 1; i < end && feasible; ++i) {
+            feasible = cone.add(static_cast<double>(std::invoke(key_extract, data[i])) - x0,
+                                static_cast<double>(i - start));
+        }
+        if (feasible) {
+            SegmentAnalysis<T> line = corridor_line(data, start, end, cone.slope(), key_extract);
+            if (line.max_error <= corridor || width == 0) {
+                DEBUG_LOG("analyze_segment[%zu-%zu]: Stored model error %zu exceeds corridor %zu, using corridor "
+                          "LINEAR (max_error=%zu, slope=%.4f)", start, end, model_error, corridor,
+                          line.max_error, line.linear_a);
+                return line.max_error < model_error ? line : result;
+            }
+        }
+        if (width == 0) {
+            return result;  // Segment was not cut by corridor_segment_end
+        }
+    }
+}
 
-    // Type constraint: KeyExtractor must return an arithmetic type
-    using KeyType = std::invoke_result_t<KeyExtractor, const T&>;
-    using KeyTypeClean = typename std::remove_cv<typename std::remove_reference<KeyType>::type>::type;
-    static_assert(std::is_arithmetic_v<KeyTypeClean>,
-                  "KeyExtractor must return an arithmetic type (int, double, etc.)");
+// Key extractor giving each key's offset from origin (see key_offset)
+template <typename KeyExtractor, typename Key>
+struct OffsetKey {
+    KeyExtractor key_extract;
+    Key origin;
 
-    // Type constraint: Compare must be callable with two const T& and return bool
-    static_assert(std::is_invocable_r_v<bool, Compare, const T&, const T&>,
-                  "Compare must be callable with (const T&, const T&) and return bool");
+    template <typename U>
+    [[nodiscard]] double operator()(const U& value) const
+        noexcept(std::is_nothrow_invocable_v<const KeyExtractor&, const U&>) {
+        return key_offset(std::invoke(key_extract, value), origin);
+    }
+};
 
-public:
-    // Iterator type aliases
-    using iterator = const T*;
-    using const_iterator = const T*;
-    using value_type = T;
-    using size_type = std::size_t;
-    using difference_type = std::ptrdiff_t;
-    using reference = const T&;
-    using const_reference = const T&;
-    using pointer = const T*;
-    using const_pointer = const T*;
+// Model for the keys in [start, end): analyze_segment, or fit_error_bounded_segment within
+// corridor unless it is UNBOUNDED_ERROR. With OffsetKeys the model is fitted over each key's
+// offset from the segment's first key, as OFFSET_MODELS segment stores keep it
+template <bool OffsetKeys, typename T, typename Compare, typename KeyExtractor>
+[[nodiscard]] SegmentAnalysis<T> fit_segment(const T* data, std::size_t start, std::size_t end, std::size_t corridor,
+                                             const Compare& comp, const KeyExtractor& key_extract,
+                                             const BuildConfig& config = BuildConfig{}) {
+    if constexpr (OffsetKeys) {
+        if (start < end) {
+            using Key = std::decay_t<std::invoke_result_t<const KeyExtractor&, const T&>>;
+            const OffsetKey<KeyExtractor, Key> offsets{key_extract, std::invoke(key_extract, data[start])};
+            return fit_segment<false>(data, start, end, corridor, comp, offsets, config);
+        }
+    }
+    if (corridor == UNBOUNDED_ERROR) {
+        return analyze_segment(data, start, end, comp, key_extract, config);
+    }
+    return fit_error_bounded_segment(data, start, end, corridor, comp, key_extract, config);
+}
 
-    JazzyIndex() = default;
+}  // namespace detail
 
-    JazzyIndex(const T* first, const T* last, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
-        build(first, last, comp, key_extract);
-    }
+// Segment storage layouts (selected through IndexOptions)
+namespace layout {
 
-    // Iterator-based constructor
-    template <typename Iterator>
-        requires std::random_access_iterator<Iterator> &&
-                 std::contiguous_iterator<Iterator> &&
-                 (!std::is_pointer_v<Iterator>) &&
-                 std::same_as<typename std::iterator_traits<Iterator>::value_type, T>
-    JazzyIndex(Iterator first, Iterator last, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
-        build(first, last, comp, key_extract);
-    }
+// One cache-line-aligned descriptor per segment: bounds, model and extent together
+struct Interleaved {};
 
-    void build(const T* first, const T* last, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
-        base_ = first;
-        size_ = static_cast<std::size_t>(last - first);
-        key_extract_ = key_extract;
-        comp_ = comp;
+// Structure of arrays: a dense array of segment max keys for routing and a separate array
+// of CompactSegment records for prediction, so routing probes touch only key cache lines
+struct Split {};
 
-        DEBUG_LOG("JazzyIndex::build: Building index for %zu elements with %zu segments", size_, NumSegments);
+// Split layout with 32-byte QuantizedSegment records: 32-bit extents and the model as 16-bit
+// fixed-point coefficients over the key offset from the previous segment's max key. Half the
+// size of Split at some cost in precision (each stored model's error is re-measured)
+struct Compressed {};
 
-        if (size_ == 0) {
-            return;
-        }
+// Interleaved layout with double-precision models fitted over each key's offset from its
+// segment's first key (taken in the key type for integer keys). Two cache lines per segment
+// instead of one, for keys whose magnitude defeats float models over absolute keys: past 2^53
+// (64-bit nanosecond timestamps) a double cannot even hold every key
+struct Precise {};
 
-        min_ = base_[0];
-        max_ = base_[size_ - 1];
+}  // namespace layout
 
-        if (size_ == 1) {
-            // Single element
-            segments_[0].min_val = min_;
-            segments_[0].max_val = max_;
-            segments_[0].start_idx = 0;
-            segments_[0].end_idx = 1;
-            segments_[0].model_type = detail::ModelType::CONSTANT;
-            segments_[0].max_error = 0;
-            segments_[0].params.constant.constant_idx = 0;
-            num_segments_ = 1;
-            return;
-        }
+// Segment routing for non-uniform data (and for failed O(1) uniform guesses)
+namespace routing {
 
-        // Build quantile-based segments with single-pass uniformity detection
-        const std::size_t actual_segments = std::min(NumSegments, size_);
-        num_segments_ = actual_segments;
+// Textbook binary search over the segment max keys (no extra memory)
+struct BinarySearch {};
+
+// Eytzinger (BFS-ordered) copy of the segment max keys: branchless descent that prefetches
+// the cache line holding the node's descendants a few levels down
+struct Eytzinger {};
+
+}  // namespace routing
+
+// Query statistics (read with query_stats())
+namespace stats {
+
+// No counters: the hot path is unchanged and the index is no larger
+struct Disabled {};
+
+// Per-thread counters of segment hits, prediction errors, galloping and uniform-route misses,
+// summed when read (see detail::StatsCollector)
+struct PerThread {};
+
+}  // namespace stats
+
+// Negative filters consulted by find()
+namespace filter {
+
+// No filter: every absent key is searched for
+struct None {};
+
+// Blocked Bloom filter over the keys, built with each build at about BitsPerKey bits per key. Its
+// cache line is fetched while find() routes the key, and most absent keys are rejected before any
+// key is read (about 1% pass at 10 bits per key). Keys that compare equal must have equal
+// extracted keys, as the models already assume
+template <std::size_t BitsPerKey = 10>
+struct BlockedBloom {
+    static_assert(BitsPerKey > 0, "filter::BlockedBloom needs at least one bit per key");
+    static constexpr std::size_t bits_per_key = BitsPerKey;
+};
+
+}  // namespace filter
+
+// Hot-key caches consulted by find()
+namespace cache {
+
+// No cache
+struct None {};
+
+// Direct-mapped cache of Slots (a power of two) positions found by find(), picked by key hash:
+// a repeated key is answered with one slot read and one key comparison. Every build clears it
+template <std::size_t Slots = 1024>
+struct DirectMapped {
+    static constexpr std::size_t slots = Slots;
+};
+
+}  // namespace cache
+
+// Query path chosen by each build (read with query_path())
+enum class QueryPath : uint8_t {
+    GENERAL,        // Any index: emptiness checks, O(1) or searched routing, per-segment model switch
+    LINEAR_UNIFORM  // Built, non-empty, uniformly routed, every segment LINEAR: no checks, no switch
+};
+
+// Wall-clock time of each phase of the last build (see IndexStats)
+struct BuildTimings {
+    std::uint64_t partition_ns = 0;  // Placing segment boundaries (error-bounded, workload and parallel builds)
+    std::uint64_t analyze_ns = 0;    // Checking order and fitting every segment's model (across threads for
+                                     // build_parallel; not timed when the caller runs the tasks)
+    std::uint64_t finalize_ns = 0;   // Routing, batch and run tables and filter (parallel builds add
+                                     // storing the task results; loading a file redoes only this)
+
+    [[nodiscard]] std::uint64_t total_ns() const noexcept { return partition_ns + analyze_ns + finalize_ns; }
+};
+
+// Size and shape of a built index, read with index_stats(): the summary export_index_metadata()
+// spells out segment by segment, without the keys
+struct IndexStats {
+    std::size_t num_keys = 0;
+    std::size_t num_segments = 0;
+    std::size_t memory_bytes = 0;  // memory_usage()
+
+    // Segments per model type
+    std::size_t constant_segments = 0;
+    std::size_t linear_segments = 0;
+    std::size_t quadratic_segments = 0;
+    std::size_t cubic_segments = 0;
+
+    std::size_t max_error = 0;                // max_segment_error()
+    double mean_error = 0.0;                  // Segment max_error averaged over the keys
+    QueryStats::Histogram error_histogram{};  // Segments per max_error bucket (QueryStats::bucket_of)
+
+    bool uniform = false;                      // Segments routed in O(1)
+    QueryPath query_path = QueryPath::GENERAL;
+    double expected_probes = 0.0;              // Routing and error-window probes per lookup for queries
+                                               // spread like the keys
+    BuildTimings build{};
+};
+
+namespace detail {
+
+using BuildClock = std::chrono::steady_clock;
+
+[[nodiscard]] inline std::uint64_t nanoseconds_since(BuildClock::time_point start) noexcept {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(BuildClock::now() - start).count());
+}
+
+}  // namespace detail
+
+// Compile-time policies for JazzyIndex
+template <typename Layout = layout::Interleaved, typename Routing = routing::Eytzinger,
+          typename Stats = stats::Disabled, typename Filter = filter::None, typename Cache = cache::None>
+struct IndexOptions {
+    using layout_type = Layout;
+    using routing_type = Routing;
+    using stats_type = Stats;
+    using filter_type = Filter;
+    using cache_type = Cache;
+};
+
+namespace detail {
+
+// Storage for a filter:: or cache:: policy
+template <typename Filter>
+struct filter_storage {
+    using type = NoFilter;
+};
+
+template <std::size_t BitsPerKey>
+struct filter_storage<filter::BlockedBloom<BitsPerKey>> {
+    using type = BlockedBloomFilter;
+};
+
+template <typename Cache>
+struct cache_storage {
+    using type = NoCache;
+};
+
+template <std::size_t Slots>
+struct cache_storage<cache::DirectMapped<Slots>> {
+    using type = HotKeyCache<Slots>;
+};
+
+}  // namespace detail
+
+namespace detail {
+
+// Per-segment storage: inline std::array for a fixed segment count, or a pmr::vector sized at
+// build time when N == 0 (SegmentCount::DYNAMIC)
+template <typename U, std::size_t N>
+using SegmentArray = std::conditional_t<N == 0, std::pmr::vector<U>, std::array<U, N>>;
+
+// Make room for count entries (fixed arrays always hold N)
+template <typename U, std::size_t N>
+void resize_segment_array(std::array<U, N>& /*array*/, std::size_t /*count*/) noexcept {}
+
+template <typename U>
+void resize_segment_array(std::pmr::vector<U>& array, std::size_t count) {
+    array.resize(count);
+}
+
+// Bytes a segment array holds outside the owning object (fixed arrays are inline)
+template <typename U, std::size_t N>
+[[nodiscard]] constexpr std::size_t segment_array_heap_bytes(const std::array<U, N>& /*array*/) noexcept {
+    return 0;
+}
+
+template <typename U>
+[[nodiscard]] std::size_t segment_array_heap_bytes(const std::pmr::vector<U>& array) noexcept {
+    return array.capacity() * sizeof(U);
+}
+
+// Type of the segment bounds (max keys, and min keys in the interleaved layout). When a
+// KeyExtractor is given and Compare can order the extracted keys directly (std::less<>,
+// std::greater<> and other transparent comparators), the tables hold only the key, so records
+// with strings or other payload are never copied into them. Compare must then order keys the
+// way it orders records. Otherwise the bounds are full T copies.
+template <typename T, typename Compare, typename KeyExtractor>
+struct SegmentBound {
+    using type = T;
+};
+
+template <typename T, typename Compare, typename KeyExtractor>
+    requires(!std::is_same_v<KeyExtractor, jazzy::identity> &&
+             std::is_invocable_r_v<bool, const Compare&,
+                                   const std::remove_cvref_t<std::invoke_result_t<KeyExtractor, const T&>>&,
+                                   const std::remove_cvref_t<std::invoke_result_t<KeyExtractor, const T&>>&>)
+struct SegmentBound<T, Compare, KeyExtractor> {
+    using type = std::remove_cvref_t<std::invoke_result_t<KeyExtractor, const T&>>;
+};
+
+template <typename T, typename Compare, typename KeyExtractor>
+using segment_bound_t = typename SegmentBound<T, Compare, KeyExtractor>::type;
+
+// Per-layout segment storage, keyed by the bound type (see SegmentBound). Every specialization
+// exposes the same interface: operator[] / data() for the segment records (start_idx, end_idx,
+// max_error, model_type), max_key(i) for routing, owns(i, bound, comp) for verifying an O(1)
+// uniform guess, set_extent / set_model for the builders, packed_model(i) for the batch tables
+// and heap_bytes() for memory_usage(). Records predict by themselves unless RELATIVE_MODELS (the
+// model is over the key's offset from an origin the record may not hold), in which case the
+// store's predict(seg, key) does. OFFSET_MODELS stores fit their models over each key's offset
+// from its segment's first key (see fit_segment). Runtime-sized stores (N == 0) allocate from a memory
+// resource and are resized per build.
+template <typename T, std::size_t N, typename Layout>
+class SegmentStore;
+
+template <typename T, std::size_t N>
+class SegmentStore<T, N, layout::Interleaved> {
+public:
+    using segment_type = Segment<T>;
+    static constexpr bool RELATIVE_MODELS = false;
+    static constexpr bool OFFSET_MODELS = false;
+
+    SegmentStore() = default;
+    explicit SegmentStore(std::pmr::memory_resource* resource) requires(N == 0) : segments_(resource) {}
+
+    void resize(std::size_t count) { resize_segment_array(segments_, count); }
+
+    [[nodiscard]] const segment_type& operator[](std::size_t i) const noexcept { return segments_[i]; }
+    [[nodiscard]] const segment_type* data() const noexcept { return segments_.data(); }
+    [[nodiscard]] const T& max_key(std::size_t i) const noexcept { return segments_[i].max_val; }
+
+    // Uniform guess is accepted when value lies within the segment's [min, max]
+    template <typename Compare>
+    [[nodiscard]] bool owns(std::size_t i, const T& value, const Compare& comp) const {
+        return !comp(value, segments_[i].min_val) && !comp(segments_[i].max_val, value);
+    }
+
+    void set_extent(std::size_t i, const T& min_val, const T& max_val, std::size_t start, std::size_t end) {
+        auto& seg = segments_[i];
+        seg.min_val = min_val;
+        seg.max_val = max_val;
+        seg.start_idx = start;
+        seg.end_idx = end;
+    }
+
+    template <typename U>
+    void set_model(std::size_t i, const SegmentAnalysis<U>& analysis, uint32_t max_error) noexcept {
+        auto& seg = segments_[i];
+        seg.model_type = analysis.best_model;
+        seg.max_error = max_error;
+
+        switch (analysis.best_model) {
+            case ModelType::LINEAR:
+                seg.params.linear.slope = static_cast<float>(analysis.linear_a);
+                seg.params.linear.intercept = static_cast<float>(analysis.linear_b);
+                break;
+            case ModelType::QUADRATIC:
+                seg.params.quadratic.a = static_cast<float>(analysis.quad_a);
+                seg.params.quadratic.b = static_cast<float>(analysis.quad_b);
+                seg.params.quadratic.c = static_cast<float>(analysis.quad_c);
+                break;
+            case ModelType::CUBIC:
+                seg.params.cubic.a = static_cast<float>(analysis.cubic_a);
+                seg.params.cubic.b = static_cast<float>(analysis.cubic_b);
+                seg.params.cubic.c = static_cast<float>(analysis.cubic_c);
+                seg.params.cubic.d = static_cast<float>(analysis.cubic_d);
+                break;
+            case ModelType::CONSTANT:
+                seg.params.constant.constant_idx = seg.start_idx;
+                break;
+            default:
+                break;
+        }
+    }
+
+    [[nodiscard]] PackedModel packed_model(std::size_t i) const noexcept {
+        const auto& seg = segments_[i];
+        switch (seg.model_type) {
+            case ModelType::LINEAR:
+                return {0.0f, 0.0f, seg.params.linear.slope, seg.params.linear.intercept};
+            case ModelType::QUADRATIC:
+                return {0.0f, seg.params.quadratic.a, seg.params.quadratic.b, seg.params.quadratic.c};
+            case ModelType::CUBIC:
+                return {seg.params.cubic.a, seg.params.cubic.b, seg.params.cubic.c, seg.params.cubic.d};
+            default:
+                return {0.0f, 0.0f, 0.0f, 0.0f};  // CONSTANT: evaluates to 0, clamped to start_idx
+        }
+    }
+
+    [[nodiscard]] std::size_t heap_bytes() const noexcept { return segment_array_heap_bytes(segments_); }
+
+private:
+    SegmentArray<Segment<T>, N> segments_{};
+};
+
+template <typename T, std::size_t N>
+class SegmentStore<T, N, layout::Split> {
+public:
+    using segment_type = CompactSegment;
+    static constexpr bool RELATIVE_MODELS = false;
+    static constexpr bool OFFSET_MODELS = false;
+
+    SegmentStore() = default;
+    explicit SegmentStore(std::pmr::memory_resource* resource) requires(N == 0)
+        : route_keys_(resource), records_(resource) {}
+
+    void resize(std::size_t count) {
+        resize_segment_array(route_keys_, count);
+        resize_segment_array(records_, count);
+    }
+
+    [[nodiscard]] const segment_type& operator[](std::size_t i) const noexcept { return records_[i]; }
+    [[nodiscard]] const segment_type* data() const noexcept { return records_.data(); }
+    [[nodiscard]] const T& max_key(std::size_t i) const noexcept { return route_keys_[i]; }
+
+    // Uniform guess is accepted when it is the segment the max-key search would pick
+    // (max[i-1] < value <= max[i]); only the dense key array is read
+    template <typename Compare>
+    [[nodiscard]] bool owns(std::size_t i, const T& value, const Compare& comp) const {
+        return !comp(route_keys_[i], value) && (i == 0 || comp(route_keys_[i - 1], value));
+    }
+
+    void set_extent(std::size_t i, const T& /*min_val*/, const T& max_val, std::size_t start, std::size_t end) {
+        route_keys_[i] = max_val;
+        records_[i].start_idx = start;
+        records_[i].end_idx = end;
+    }
+
+    template <typename U>
+    void set_model(std::size_t i, const SegmentAnalysis<U>& analysis, uint32_t max_error) noexcept {
+        auto& rec = records_[i];
+        rec.model_type = analysis.best_model;
+        rec.max_error = max_error;
+
+        rec.model = pack_model(analysis);
+    }
+
+    [[nodiscard]] PackedModel packed_model(std::size_t i) const noexcept { return records_[i].model; }
+
+    [[nodiscard]] std::size_t heap_bytes() const noexcept {
+        return segment_array_heap_bytes(route_keys_) + segment_array_heap_bytes(records_);
+    }
+
+private:
+    alignas(64) SegmentArray<T, N> route_keys_{};
+    SegmentArray<CompactSegment, N> records_{};
+};
+
+template <typename T, std::size_t N>
+class SegmentStore<T, N, layout::Compressed> {
+    static_assert(std::is_arithmetic_v<T>,
+                  "layout::Compressed needs arithmetic segment bounds: index arithmetic keys, or give a "
+                  "KeyExtractor and a Compare that orders the keys (std::less<>, std::greater<>)");
+
+public:
+    using segment_type = QuantizedSegment;
+    static constexpr bool RELATIVE_MODELS = true;
+    static constexpr bool OFFSET_MODELS = false;
+
+    SegmentStore() = default;
+    explicit SegmentStore(std::pmr::memory_resource* resource) requires(N == 0)
+        : route_keys_(resource), records_(resource) {}
+
+    void resize(std::size_t count) {
+        resize_segment_array(route_keys_, count);
+        resize_segment_array(records_, count);
+    }
+
+    [[nodiscard]] const segment_type& operator[](std::size_t i) const noexcept { return records_[i]; }
+    [[nodiscard]] const segment_type* data() const noexcept { return records_.data(); }
+    [[nodiscard]] const T& max_key(std::size_t i) const noexcept { return route_keys_[i]; }
+
+    template <typename Compare>
+    [[nodiscard]] bool owns(std::size_t i, const T& value, const Compare& comp) const {
+        return !comp(route_keys_[i], value) && (i == 0 || comp(route_keys_[i - 1], value));
+    }
+
+    // Extents are set in segment order, each before its model (the model is relative to the
+    // previous segment's max key)
+    void set_extent(std::size_t i, const T& min_val, const T& max_val, std::size_t start, std::size_t end) {
+        if (end > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error("layout::Compressed stores 32-bit positions; index fewer than 2^32 keys");
+        }
+        if (i == 0) {
+            first_key_ = min_val;
+        }
+        route_keys_[i] = max_val;
+        records_[i].start_idx = static_cast<std::uint32_t>(start);
+        records_[i].end_idx = static_cast<std::uint32_t>(end);
+    }
+
+    // Re-express the fitted model (absolute position as a polynomial in the key) over
+    // t in [0, 1] by interpolating it at evenly spaced t, then round the coefficients to
+    // 16-bit fixed point sharing one scale
+    template <typename U>
+    void set_model(std::size_t i, const SegmentAnalysis<U>& analysis, uint32_t max_error) noexcept {
+        auto& rec = records_[i];
+        rec.model_type = analysis.best_model;
+        rec.max_error = max_error;
+        rec.q = {0, 0, 0, 0};
+        rec.scale = 0.0f;
+
+        const double origin = origin_of(i);
+        const double range = static_cast<double>(route_keys_[i]) - origin;
+        rec.inv_range = range != 0.0 ? static_cast<float>(1.0 / range) : 0.0f;
+
+        const std::size_t degree = analysis.best_model == ModelType::LINEAR ? 1
+                                 : analysis.best_model == ModelType::QUADRATIC ? 2
+                                 : analysis.best_model == ModelType::CUBIC ? 3 : 0;
+        if (degree == 0 || rec.inv_range == 0.0f) {
+            return;  // CONSTANT (or a single key value): every prediction is start_idx
+        }
+
+        // Newton divided differences at t_k = k / degree, expanded into powers of t
+        const double inv_range = static_cast<double>(rec.inv_range);
+        std::array<double, 4> nodes{};
+        std::array<double, 4> diffs{};
+        for (std::size_t k = 0; k <= degree; ++k) {
+            nodes[k] = static_cast<double>(k) / static_cast<double>(degree);
+            diffs[k] = evaluate(analysis, origin + nodes[k] / inv_range) - static_cast<double>(rec.start_idx);
+        }
+        for (std::size_t level = 1; level <= degree; ++level) {
+            for (std::size_t k = degree; k >= level; --k) {
+                diffs[k] = (diffs[k] - diffs[k - 1]) / (nodes[k] - nodes[k - level]);
+            }
+        }
+        std::array<double, 4> coeffs{};
+        coeffs[0] = diffs[degree];
+        for (std::size_t k = degree; k-- > 0;) {
+            // coeffs = coeffs * (t - nodes[k]) + diffs[k]
+            for (std::size_t j = degree - k; j > 0; --j) {
+                coeffs[j] = coeffs[j - 1] - nodes[k] * coeffs[j];
+            }
+            coeffs[0] = diffs[k] - nodes[k] * coeffs[0];
+        }
+
+        double largest = 0.0;
+        for (const double c : coeffs) {
+            largest = std::max(largest, std::abs(c));
+        }
+        if (!(largest > 0.0) || !std::isfinite(largest)) {
+            return;
+        }
+        rec.scale = static_cast<float>(largest / static_cast<double>(std::numeric_limits<std::int16_t>::max()));
+        for (std::size_t k = 0; k < 4; ++k) {
+            const double units = std::round(coeffs[k] / static_cast<double>(rec.scale));
+            rec.q[k] = static_cast<std::int16_t>(clamp_value<double>(units, std::numeric_limits<std::int16_t>::min(),
+                                                                    std::numeric_limits<std::int16_t>::max()));
+        }
+    }
+
+    // Predicted position of key (unclamped, at least start_idx)
+    [[nodiscard]] std::size_t predict(const segment_type& seg, double key) const noexcept {
+        const std::size_t i = static_cast<std::size_t>(&seg - records_.data());
+        const double t = (key - origin_of(i)) * static_cast<double>(seg.inv_range);
+        const double offset = static_cast<double>(seg.scale) *
+            std::fma(t, std::fma(t, std::fma(t, static_cast<double>(seg.q[3]), static_cast<double>(seg.q[2])),
+                                 static_cast<double>(seg.q[1])),
+                     static_cast<double>(seg.q[0]));
+        // Round to nearest (rounded coefficients land just either side of exact positions), clamping
+        // in double first so keys far outside the segment (or infinite) cannot overflow the cast
+        const double last = static_cast<double>(seg.end_idx - seg.start_idx);
+        const std::size_t result = seg.start_idx +
+            (offset > 0.0 ? static_cast<std::size_t>(std::min(offset + 0.5, last)) : std::size_t{0});
+        DEBUG_LOG("predict[%u-%u]: quantized model %d - key=%.4f, t=%.6f, result=%zu",
+                  seg.start_idx, seg.end_idx, static_cast<int>(seg.model_type), key, t, result);
+        return result;
+    }
+
+    // The same polynomial in absolute cubic form (float; batch tables and index files)
+    [[nodiscard]] PackedModel packed_model(std::size_t i) const noexcept {
+        const auto& rec = records_[i];
+        const double o = origin_of(i);
+        const double r = static_cast<double>(rec.inv_range);
+        const double s = static_cast<double>(rec.scale);
+        // c_k * (r * (x - o))^k expanded in powers of x
+        const double c0 = s * rec.q[0];
+        const double c1 = s * rec.q[1] * r;
+        const double c2 = s * rec.q[2] * r * r;
+        const double c3 = s * rec.q[3] * r * r * r;
+        const double a = c3;
+        const double b = c2 - 3.0 * c3 * o;
+        const double c = c1 - 2.0 * c2 * o + 3.0 * c3 * o * o;
+        const double d = c0 - c1 * o + c2 * o * o - c3 * o * o * o + static_cast<double>(rec.start_idx);
+        return {static_cast<float>(a), static_cast<float>(b), static_cast<float>(c), static_cast<float>(d)};
+    }
+
+    [[nodiscard]] std::size_t heap_bytes() const noexcept {
+        return segment_array_heap_bytes(route_keys_) + segment_array_heap_bytes(records_);
+    }
+
+private:
+    [[nodiscard]] double origin_of(std::size_t i) const noexcept {
+        return static_cast<double>(i == 0 ? first_key_ : route_keys_[i - 1]);
+    }
+
+    template <typename U>
+    [[nodiscard]] static double evaluate(const SegmentAnalysis<U>& analysis, double x) noexcept {
+        switch (analysis.best_model) {
+            case ModelType::LINEAR:
+                return std::fma(x, analysis.linear_a, analysis.linear_b);
+            case ModelType::QUADRATIC:
+                return std::fma(x, std::fma(x, analysis.quad_a, analysis.quad_b), analysis.quad_c);
+            case ModelType::CUBIC:
+                return std::fma(x, std::fma(x, std::fma(x, analysis.cubic_a, analysis.cubic_b), analysis.cubic_c),
+                                analysis.cubic_d);
+            default:
+                return 0.0;
+        }
+    }
+
+    alignas(64) SegmentArray<T, N> route_keys_{};
+    SegmentArray<QuantizedSegment, N> records_{};
+    T first_key_{};
+};
+
+template <typename T, std::size_t N>
+class SegmentStore<T, N, layout::Precise> {
+    static_assert(std::is_arithmetic_v<T>,
+                  "layout::Precise needs arithmetic segment bounds: index arithmetic keys, or give a "
+                  "KeyExtractor and a Compare that orders the keys (std::less<>, std::greater<>)");
+
+public:
+    using segment_type = PreciseSegment<T>;
+    static constexpr bool RELATIVE_MODELS = true;
+    static constexpr bool OFFSET_MODELS = true;
+
+    SegmentStore() = default;
+    explicit SegmentStore(std::pmr::memory_resource* resource) requires(N == 0) : segments_(resource) {}
+
+    void resize(std::size_t count) { resize_segment_array(segments_, count); }
+
+    [[nodiscard]] const segment_type& operator[](std::size_t i) const noexcept { return segments_[i]; }
+    [[nodiscard]] const segment_type* data() const noexcept { return segments_.data(); }
+    [[nodiscard]] const T& max_key(std::size_t i) const noexcept { return segments_[i].max_val; }
+
+    template <typename Compare>
+    [[nodiscard]] bool owns(std::size_t i, const T& value, const Compare& comp) const {
+        return !comp(value, segments_[i].min_val) && !comp(segments_[i].max_val, value);
+    }
+
+    void set_extent(std::size_t i, const T& min_val, const T& max_val, std::size_t start, std::size_t end) {
+        auto& seg = segments_[i];
+        seg.min_val = min_val;
+        seg.max_val = max_val;
+        seg.start_idx = start;
+        seg.end_idx = end;
+    }
+
+    // analysis is over key offsets from min_val (OFFSET_MODELS), so its coefficients are kept as
+    // they are, less start_idx
+    template <typename U>
+    void set_model(std::size_t i, const SegmentAnalysis<U>& analysis, uint32_t max_error) noexcept {
+        auto& seg = segments_[i];
+        seg.model_type = analysis.best_model;
+        seg.max_error = max_error;
+        const double start = static_cast<double>(seg.start_idx);
+        switch (analysis.best_model) {
+            case ModelType::LINEAR:
+                seg.coeffs = {analysis.linear_b - start, analysis.linear_a, 0.0, 0.0};
+                break;
+            case ModelType::QUADRATIC:
+                seg.coeffs = {analysis.quad_c - start, analysis.quad_b, analysis.quad_a, 0.0};
+                break;
+            case ModelType::CUBIC:
+                seg.coeffs = {analysis.cubic_d - start, analysis.cubic_c, analysis.cubic_b, analysis.cubic_a};
+                break;
+            default:
+                seg.coeffs = {0.0, 0.0, 0.0, 0.0};
+                break;
+        }
+    }
+
+    // Predicted position of key (unclamped, at least start_idx)
+    template <typename K>
+    [[nodiscard]] std::size_t predict(const segment_type& seg, const K& key) const noexcept {
+        const double x = key_offset(key, seg.min_val);
+        const double offset =
+            std::fma(x, std::fma(x, std::fma(x, seg.coeffs[3], seg.coeffs[2]), seg.coeffs[1]), seg.coeffs[0]);
+        // Truncated like Segment::predict, clamping in double first so keys far outside the
+        // segment (or infinite) cannot overflow the cast
+        const double last = static_cast<double>(seg.end_idx - seg.start_idx);
+        const std::size_t result =
+            seg.start_idx + (offset > 0.0 ? static_cast<std::size_t>(std::min(offset, last)) : std::size_t{0});
+        DEBUG_LOG("predict[%zu-%zu]: precise model %d - offset=%.4f, pred=%.2f, result=%zu",
+                  seg.start_idx, seg.end_idx, static_cast<int>(seg.model_type), x, offset, result);
+        return result;
+    }
+
+    // The same polynomial in absolute cubic form (float; index files and metadata export)
+    [[nodiscard]] PackedModel packed_model(std::size_t i) const noexcept {
+        const auto& seg = segments_[i];
+        const double o = static_cast<double>(seg.min_val);
+        const auto& [c0, c1, c2, c3] = seg.coeffs;
+        // c_k * (x - o)^k expanded in powers of x
+        const double a = c3;
+        const double b = c2 - 3.0 * c3 * o;
+        const double c = c1 - 2.0 * c2 * o + 3.0 * c3 * o * o;
+        const double d = c0 - c1 * o + c2 * o * o - c3 * o * o * o + static_cast<double>(seg.start_idx);
+        return {static_cast<float>(a), static_cast<float>(b), static_cast<float>(c), static_cast<float>(d)};
+    }
+
+    [[nodiscard]] std::size_t heap_bytes() const noexcept { return segment_array_heap_bytes(segments_); }
+
+private:
+    SegmentArray<PreciseSegment<T>, N> segments_{};
+};
+
+// Per-policy routing structure over the segment max keys, rebuilt at the end of every build
+template <typename T, std::size_t N, typename Routing>
+class SegmentRouter;
+
+template <typename T, std::size_t N>
+class SegmentRouter<T, N, routing::BinarySearch> {
+public:
+    SegmentRouter() = default;
+    explicit SegmentRouter(std::pmr::memory_resource* /*resource*/) requires(N == 0) {}
+
+    template <typename KeyAt>
+    void build(std::size_t /*count*/, KeyAt&& /*key_at*/) noexcept {}
+
+    [[nodiscard]] static constexpr std::size_t heap_bytes() noexcept { return 0; }
+};
+
+// Keys per 64-byte cache line (at least one)
+template <typename T>
+inline constexpr std::size_t KEYS_PER_CACHE_LINE = sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+
+// Keys per line in an Eytzinger array; with slot 0 unused, node s*k starts a line for every k
+template <typename T>
+inline constexpr std::size_t EYTZINGER_PREFETCH_STRIDE = KEYS_PER_CACHE_LINE<T>;
+
+// Rank of the first of count keys not less than value, or count if every key is less. keys and
+// ranks are 1-based Eytzinger arrays (slot 0 unused): keys[k] in BFS order, ranks[k] its sorted rank
+template <typename T, typename Compare>
+[[nodiscard]] std::size_t eytzinger_lower_bound(const T* keys, const std::uint32_t* ranks, std::size_t count,
+                                                const T& value, const Compare& comp) {
+    std::size_t k = 1;
+#ifdef JAZZY_DEBUG_LOGGING
+    // Rank interval implied by the descent, logged like the plain binary search
+    std::size_t left = 0;
+    std::size_t right = count;
+    int iteration = 0;
+#endif
+    while (k <= count) {
+        // Descendants PREFETCH_STRIDE * k .. PREFETCH_STRIDE * k + PREFETCH_STRIDE - 1 share one line
+        prefetch_read(keys + std::min(k * EYTZINGER_PREFETCH_STRIDE<T>, count));
+        const bool go_right = comp(keys[k], value);
+#ifdef JAZZY_DEBUG_LOGGING
+        const std::size_t mid = ranks[k];
+        DEBUG_LOG("find_segment: Binary search iter %d - left=%zu, mid=%zu, right=%zu, node=%zu",
+                  iteration++, left, mid, right, k);
+        if (go_right) {
+            left = mid + 1;
+        } else {
+            right = mid;
+        }
+#endif
+        k = 2 * k + (go_right ? 1 : 0);
+    }
+    // Undo the right turns taken after the last left turn: that node is the answer
+    k >>= std::countr_one(k) + 1;
+    return k == 0 ? count : static_cast<std::size_t>(ranks[k]);
+}
+
+template <typename T, std::size_t N>
+class SegmentRouter<T, N, routing::Eytzinger> {
+public:
+    SegmentRouter() = default;
+    explicit SegmentRouter(std::pmr::memory_resource* resource) requires(N == 0)
+        : keys_(resource), ranks_(resource) {}
+
+    // Lay out key_at(0..count-1) (ascending under the index comparator) in Eytzinger order
+    template <typename KeyAt>
+    void build(std::size_t count, KeyAt&& key_at) {
+        count_ = count;
+        resize_segment_array(keys_, count + 1);
+        resize_segment_array(ranks_, count + 1);
+        std::size_t next = 0;
+        fill(1, next, key_at);
+    }
+
+    // Rank of the first key not less than value, or count if every key is less
+    template <typename Compare>
+    [[nodiscard]] std::size_t lower_bound(const T& value, const Compare& comp) const {
+        return eytzinger_lower_bound(keys_.data(), ranks_.data(), count_, value, comp);
+    }
+
+    // The 1-based arrays (count() + 1 entries, slot 0 unused), for serialization
+    [[nodiscard]] std::size_t count() const noexcept { return count_; }
+    [[nodiscard]] const T* keys() const noexcept { return keys_.data(); }
+    [[nodiscard]] const std::uint32_t* ranks() const noexcept { return ranks_.data(); }
+
+    [[nodiscard]] std::size_t heap_bytes() const noexcept {
+        return segment_array_heap_bytes(keys_) + segment_array_heap_bytes(ranks_);
+    }
+
+private:
+    template <typename KeyAt>
+    void fill(std::size_t k, std::size_t& next, KeyAt& key_at) {
+        if (k > count_) {
+            return;
+        }
+        fill(2 * k, next, key_at);
+        keys_[k] = key_at(next);
+        ranks_[k] = static_cast<std::uint32_t>(next);
+        ++next;
+        fill(2 * k + 1, next, key_at);
+    }
+
+    // 1-based; slot 0 unused (N + 1 entries, or count + 1 for runtime-sized routers)
+    alignas(64) SegmentArray<T, N == 0 ? 0 : N + 1> keys_{};
+    SegmentArray<std::uint32_t, N == 0 ? 0 : N + 1> ranks_{};
+    std::size_t count_{0};
+};
+
+// Whether key lies before the bound being searched for: key < value for a lower bound, and
+// !(value < key) for an upper bound
+template <bool Upper, typename T, typename Compare>
+[[nodiscard]] bool before_bound(const T& key, const T& value, const Compare& comp) {
+    if constexpr (Upper) {
+        return !comp(value, key);
+    } else {
+        return comp(key, value);
+    }
+}
+
+// Last-mile search: the first key in sorted [first, last) not less than value (Upper: greater
+// than value). A branchless binary search halves the window, prefetching both keys the next step
+// may probe, down to LAST_MILE_SCAN_WINDOW keys; those are counted with vector compares.
+template <bool Upper, typename T, typename Compare>
+[[nodiscard]] const T* last_mile_search(const T* first, const T* last, const T& value, const Compare& comp) {
+    constexpr bool native = IS_STRICTLY_ARITHMETIC_V<T> && IS_ASCENDING_COMPARE_V<Compare>;
+    constexpr std::size_t scan_window = native ? LAST_MILE_SCAN_WINDOW : LAST_MILE_SCAN_WINDOW_GENERIC;
+
+    // The bound lies in [base, base + n] throughout
+    const T* base = first;
+    auto n = static_cast<std::size_t>(last - first);
+    while (n > scan_window) {
+        const std::size_t half = n / 2;
+        const std::size_t next_half = (n - half) / 2;
+        prefetch_read(base + next_half);
+        prefetch_read(base + half + next_half);
+        base = before_bound<Upper>(base[half], value, comp) ? base + half : base;
+        n -= half;
+    }
+
+    if constexpr (native) {
+        return base + simd::count_before<Upper>(base, n, value);
+    } else {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            count += before_bound<Upper>(base[i], value, comp) ? 1 : 0;
+        }
+        return base + count;
+    }
+}
+
+// Bound of value over sorted [begin, end), searched in the window [lo, hi) around a model's
+// prediction. The keys just outside the window show whether the bound lies beyond it (a run of
+// duplicates, or an error the model did not account for); only then does the search gallop
+// outward from that edge, so the cost grows with the log of the miss, not of the array.
+template <bool Upper, typename T, typename Compare>
+[[nodiscard]] const T* windowed_search(const T* begin, const T* end, const T* lo, const T* hi, const T& value,
+                                       const Compare& comp) {
+    const T* result = last_mile_search<Upper>(lo, hi, value, comp);
+    if (result == lo && lo != begin && !before_bound<Upper>(*(lo - 1), value, comp)) {
+        // The bound is in [begin, right] and *right is not before it
+        const T* right = lo - 1;
+        for (std::size_t step = 1;; step *= 2) {
+            if (static_cast<std::size_t>(right - begin) <= step) {
+                return last_mile_search<Upper>(begin, right, value, comp);
+            }
+            const T* probe = right - step;
+            if (before_bound<Upper>(*probe, value, comp)) {
+                return last_mile_search<Upper>(probe + 1, right, value, comp);
+            }
+            right = probe;
+        }
+    }
+    if (result == hi && hi != end && before_bound<Upper>(*hi, value, comp)) {
+        // The bound is in [left, end]
+        const T* left = hi + 1;
+        for (std::size_t step = 1;; step *= 2) {
+            if (static_cast<std::size_t>(end - left) <= step) {
+                return last_mile_search<Upper>(left, end, value, comp);
+            }
+            const T* probe = left + step;
+            if (!before_bound<Upper>(*probe, value, comp)) {
+                return last_mile_search<Upper>(left, probe, value, comp);
+            }
+            left = probe + 1;
+        }
+    }
+    return result;
+}
+
+}  // namespace detail
+
+// Recommended segment count presets
+enum class SegmentCount : std::size_t {
+    SINGLE = 1,      // No segmentation: full dataset in one segment
+    MINIMAL = 2,     // Binary split: extreme coarse indexing
+    PICO = 4,        // Debugging tiny datasets; almost no segmentation
+    NANO = 8,        // Extremely small datasets; coarse segmentation
+    MICRO = 16,      // Minimal segmentation for testing larger segment sizes
+    TINY = 32,       // Very small datasets or minimal memory footprint
+    SMALL = 64,      // Small datasets (thousands of elements)
+    MEDIUM = 128,    // Medium datasets
+    LARGE = 256,     // Default: good balance for most use cases
+    XLARGE = 512,    // Large datasets with complex distributions
+    XXLARGE = 1024,  // Very large datasets requiring high precision
+    MAX = 2048,      // Maximum precision for huge datasets
+    DYNAMIC = 0      // Chosen per build from the data; heap storage (see DynamicJazzyIndex)
+};
+
+// Segment count policy for runtime-sized indexes (SegmentCount::DYNAMIC): equal-count builds use
+// one segment per keys_per_segment keys, and no build uses more than max_segments
+struct SegmentSizing {
+    std::size_t keys_per_segment = detail::DEFAULT_KEYS_PER_SEGMENT;
+    std::size_t max_segments = detail::MAX_SEGMENTS;
+};
+
+// Helper to convert std::size_t to SegmentCount for generic code
+template <std::size_t N>
+inline constexpr SegmentCount to_segment_count() {
+    return static_cast<SegmentCount>(N);
+}
+
+// Whether a saved index file carries a copy of the keys (needed by JazzyIndexView) or only the
+// segment table, for data that is stored elsewhere
+enum class KeyData : uint8_t {
+    EMBEDDED,
+    EXTERNAL
+};
+
+// Forward declaration for coroutine lookups (jazzy_index_coroutine.hpp)
+template <typename T>
+class LookupTask;
+
+// Forward declaration for serialization support (jazzy_index_serialize.hpp)
+namespace serialize {
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+class IndexSerializer;
+}  // namespace serialize
+
+// Forward declarations for parallel build support
+namespace parallel {
+template <typename T, typename Compare, typename KeyExtractor>
+struct BuildTask;
+
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+class ParallelBuilder;
+
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+class ParallelProber;
+
+// Anything that can run a bulk of independent tasks: bulk_execute(count, fn) calls fn(i) for every
+// i in [0, count), possibly concurrently, and returns once all calls have finished. ThreadPool,
+// InlineExecutor and SchedulerExecutor (jazzy_index_executor.hpp) model it
+template <typename E>
+concept Executor = requires(E& executor, std::size_t count, const std::function<void(std::size_t)>& fn) {
+    executor.bulk_execute(count, fn);
+};
+}  // namespace parallel
+
+template <typename T, SegmentCount Segments = SegmentCount::LARGE, typename Compare = std::less<>,
+          typename KeyExtractor = jazzy::identity, typename Options = IndexOptions<>>
+class JazzyIndex {
+    static constexpr std::size_t NumSegments = static_cast<std::size_t>(Segments);
+    static constexpr bool IsDynamic = Segments == SegmentCount::DYNAMIC;
+
+    using Routing = typename Options::routing_type;
+    static constexpr bool CollectsStats = std::is_same_v<typename Options::stats_type, stats::PerThread>;
+
+    // filter:: and cache:: policies (consulted by find() only)
+    using FilterType = typename detail::filter_storage<typename Options::filter_type>::type;
+    using CacheType = typename detail::cache_storage<typename Options::cache_type>::type;
+    static constexpr bool UsesFilter = !std::is_same_v<FilterType, detail::NoFilter>;
+    static constexpr bool UsesCache = !std::is_same_v<CacheType, detail::NoCache>;
+
+    // Integer keys indexed directly in ascending order: a range check is one unsigned comparison
+    static constexpr bool PlainIntegerKeys = std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                                             std::is_same_v<KeyExtractor, jazzy::identity> &&
+                                             (std::is_same_v<Compare, std::less<>> ||
+                                              std::is_same_v<Compare, std::less<T>>);
+
+    static_assert(IsDynamic || NumSegments <= detail::MAX_SEGMENTS,
+                  "NumSegments must be in range [1, 4096] (or SegmentCount::DYNAMIC)");
+
+    // Type constraint: KeyExtractor must be callable with const T&
+    static_assert(std::is_invocable_v<KeyExtractor, const T&>,
+                  "KeyExtractor must be callable with const T&");
+
+    // Type constraint: KeyExtractor must return an arithmetic type
+    using KeyType = std::invoke_result_t<KeyExtractor, const T&>;
+    using KeyTypeClean = typename std::remove_cv<typename std::remove_reference<KeyType>::type>::type;
+    static_assert(std::is_arithmetic_v<KeyTypeClean>,
+                  "KeyExtractor must return an arithmetic type (int, double, etc.); index string and "
+                  "tuple keys with PrefixJazzyIndex (jazzy_index_prefix.hpp)");
+
+    // Type constraint: Compare must be callable with two const T& and return bool
+    static_assert(std::is_invocable_r_v<bool, Compare, const T&, const T&>,
+                  "Compare must be callable with (const T&, const T&) and return bool");
+
+    // Segment tables hold Bound (the extracted key where possible, see detail::SegmentBound)
+    using Bound = detail::segment_bound_t<T, Compare, KeyExtractor>;
+    using SegmentStore = detail::SegmentStore<Bound, NumSegments, typename Options::layout_type>;
+    using SegmentType = typename SegmentStore::segment_type;
+
+public:
+    // Iterator type aliases
+    using iterator = const T*;
+    using const_iterator = const T*;
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const T&;
+    using const_reference = const T&;
+    using pointer = const T*;
+    using const_pointer = const T*;
+
+    JazzyIndex() = default;
+
+    // Runtime-sized index (SegmentCount::DYNAMIC): segment storage is allocated from resource
+    // and sized by each build according to sizing
+    explicit JazzyIndex(SegmentSizing sizing,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        requires IsDynamic
+        : sizing_(sizing), segments_(resource), router_(resource), batch_bounds_(resource), batch_models_(resource),
+          runs_(resource) {
+        if (sizing_.keys_per_segment == 0 || sizing_.max_segments == 0 ||
+            sizing_.max_segments > detail::MAX_SEGMENTS) {
+            throw std::invalid_argument(
+                "SegmentSizing needs keys_per_segment >= 1 and max_segments in range [1, 4096]");
+        }
+    }
+
+    explicit JazzyIndex(std::pmr::memory_resource* resource) requires IsDynamic
+        : JazzyIndex(SegmentSizing{}, resource) {}
+
+    JazzyIndex(const T* first, const T* last, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
+        build(first, last, comp, key_extract);
+    }
+
+    // Iterator-based constructor
+    template <typename Iterator>
+        requires std::random_access_iterator<Iterator> &&
+                 std::contiguous_iterator<Iterator> &&
+                 (!std::is_pointer_v<Iterator>) &&
+                 std::same_as<typename std::iterator_traits<Iterator>::value_type, T>
+    JazzyIndex(Iterator first, Iterator last, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
+        build(first, last, comp, key_extract);
+    }
+
+    // Model selection used by every later build, parallel build and workload rebuild; the index
+    // keeps its current segments until then. Throws std::invalid_argument for an invalid config
+    void set_build_config(const BuildConfig& config) {
+        config.validate();
+        config_ = config;
+    }
+
+    [[nodiscard]] const BuildConfig& build_config() const noexcept { return config_; }
+
+    void build(const T* first, const T* last, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
+        base_ = first;
+        size_ = static_cast<std::size_t>(last - first);
+        query_path_ = QueryPath::GENERAL;
+        key_extract_ = key_extract;
+        comp_ = comp;
+        error_bound_.reset();
+        timings_ = {};
+
+        DEBUG_LOG("JazzyIndex::build: Building index for %zu elements with %zu segments", size_, segment_budget());
+
+        if (size_ == 0) {
+            return;
+        }
+
+        min_ = base_[0];
+        max_ = base_[size_ - 1];
+
+        if (size_ == 1) {
+            // Single element
+            init_single_segment();
+            return;
+        }
+
+        // Build quantile-based segments with single-pass uniformity detection
+        const std::size_t actual_segments = equal_count_segments();
+        build_segments(
+            actual_segments,
+            [this, actual_segments](std::size_t i) { return ((i + 1) * size_) / actual_segments; },
+            [this](std::size_t start, std::size_t end) {
+                return detail::fit_segment<SegmentStore::OFFSET_MODELS>(base_, start, end, detail::UNBOUNDED_ERROR,
+                                                                        comp_, key_extract_, config_);
+            });
+        DEBUG_LOG("JazzyIndex::build: Build complete with %zu segments", num_segments_);
+    }
+
+    // Iterator-based build method
+    template <typename Iterator>
+        requires std::random_access_iterator<Iterator> &&
+                 std::contiguous_iterator<Iterator> &&
+                 (!std::is_pointer_v<Iterator>) &&
+                 std::same_as<typename std::iterator_traits<Iterator>::value_type, T>
+    void build(Iterator first, Iterator last, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
+        // Convert contiguous iterators to pointers for internal use
+        build(std::to_address(first), std::to_address(last), comp, key_extract);
+    }
+
+    // Build with segment boundaries placed by an epsilon corridor instead of equal counts:
+    // each segment's model predicts every key within epsilon positions of its index, so
+    // lookups search a bounded window. If the data needs more than the segment budget,
+    // the corridor is widened (2e+1 each round) until it fits; error_bound() reports the result
+    void build_error_bounded(const T* first, const T* last, std::size_t epsilon,
+                             Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
+        base_ = first;
+        size_ = static_cast<std::size_t>(last - first);
+        query_path_ = QueryPath::GENERAL;
+        key_extract_ = key_extract;
+        comp_ = comp;
+        error_bound_ = 0;
+        timings_ = {};
+
+        DEBUG_LOG("JazzyIndex::build_error_bounded: Building index for %zu elements, epsilon=%zu, budget=%zu segments",
+                  size_, epsilon, segment_budget());
+
+        if (size_ == 0) {
+            return;
+        }
+
+        min_ = base_[0];
+        max_ = base_[size_ - 1];
+
+        if (size_ == 1) {
+            init_single_segment();
+            return;
+        }
+
+        const auto partition_start = detail::BuildClock::now();
+        detail::SegmentArray<std::size_t, NumSegments> ends;
+        const std::size_t corridor = plan_error_bounded_segments(epsilon, ends);
+        timings_.partition_ns = detail::nanoseconds_since(partition_start);
+        build_segments(
+            num_segments_,
+            [&ends](std::size_t i) { return ends[i]; },
+            [this, corridor](std::size_t start, std::size_t end) {
+                return detail::fit_segment<SegmentStore::OFFSET_MODELS>(base_, start, end, corridor, comp_,
+                                                                        key_extract_, config_);
+            });
+        DEBUG_LOG("JazzyIndex::build_error_bounded: Build complete with %zu segments, error_bound=%zu",
+                  num_segments_, *error_bound_);
+    }
+
+    template <typename Iterator>
+        requires std::random_access_iterator<Iterator> &&
+                 std::contiguous_iterator<Iterator> &&
+                 (!std::is_pointer_v<Iterator>) &&
+                 std::same_as<typename std::iterator_traits<Iterator>::value_type, T>
+    void build_error_bounded(Iterator first, Iterator last, std::size_t epsilon,
+                             Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
+        build_error_bounded(std::to_address(first), std::to_address(last), epsilon, comp, key_extract);
+    }
+
+    // Rebuild over the same keys with segment boundaries placed by a sample of the query workload
+    // instead of by key count. query_share of the segment budget follows the sample's keys, so hot
+    // ranges are cut into short segments with tight error windows; the rest follows the key count,
+    // merging cold ranges into long segments. The segment count (and memory) is what build() uses.
+    // The current segments are kept if the sample would not get cheaper (see workload_cost), as
+    // for evenly spaced keys, which lose O(1) uniform routing when their segments are reshaped
+    void rebuild_for_workload(std::span<const T> query_sample, double query_share = detail::WORKLOAD_QUERY_SHARE) {
+        check_query_share(query_share);
+        if (size_ < 2) {
+            return;
+        }
+        // Position each query lands on (queries past the last key count against the last key)
+        std::vector<std::size_t> positions;
+        positions.reserve(query_sample.size());
+        for (const T& query : query_sample) {
+            positions.push_back(std::min(static_cast<std::size_t>(find_lower_bound(query) - base_), size_ - 1));
+        }
+        std::sort(positions.begin(), positions.end());
+        DEBUG_LOG("JazzyIndex::rebuild_for_workload: %zu sampled queries, query_share=%.2f", positions.size(),
+                  query_share);
+        if (positions.empty()) {
+            build_workload_segments(0.0, [](std::size_t) { return 0.0; });
+            return;
+        }
+        rebuild_if_cheaper(query_share, [&positions](std::size_t p) {
+            const auto before = std::lower_bound(positions.begin(), positions.end(), p) - positions.begin();
+            return static_cast<double>(before) / static_cast<double>(positions.size());
+        });
+    }
+
+    // rebuild_for_workload with the segment hits counted since the last build as the workload
+    // (IndexOptions<..., stats::PerThread>); each segment's hits are spread evenly over its keys.
+    // Does nothing until a query has been counted; the rebuild starts the counts over
+    void adapt(double query_share = detail::WORKLOAD_QUERY_SHARE) requires CollectsStats {
+        check_query_share(query_share);
+        const QueryStats stats = stats_.snapshot();
+        const std::uint64_t total = std::accumulate(stats.segment_hits.begin(), stats.segment_hits.end(),
+                                                    std::uint64_t{0});
+        if (size_ < 2 || total == 0) {
+            return;
+        }
+        // Segment starts and the share of queries before each (copied: the rebuild replaces segments_)
+        std::vector<std::size_t> starts(num_segments_ + 1, size_);
+        std::vector<double> before(num_segments_ + 1, 1.0);
+        std::uint64_t running = 0;
+        for (std::size_t i = 0; i < num_segments_; ++i) {
+            starts[i] = segments_[i].start_idx;
+            before[i] = static_cast<double>(running) / static_cast<double>(total);
+            running += stats.segment_hits[i];
+        }
+        DEBUG_LOG("JazzyIndex::adapt: %llu counted searches over %zu segments",
+                  static_cast<unsigned long long>(total), num_segments_);
+        rebuild_if_cheaper(query_share, [&starts, &before](std::size_t p) {
+            if (p >= starts.back()) {
+                return 1.0;
+            }
+            const std::size_t i = static_cast<std::size_t>(std::upper_bound(starts.begin(), starts.end(), p) -
+                                                           starts.begin()) - 1;
+            const double within = static_cast<double>(p - starts[i]) / static_cast<double>(starts[i + 1] - starts[i]);
+            return before[i] + (before[i + 1] - before[i]) * within;
+        });
+    }
+
+    [[nodiscard]] const_iterator find(const T& key) const {
+        DEBUG_LOG("JazzyIndex::find: Called (size=%zu, is_built=%d)", size_, is_built());
+
+        if constexpr (UsesFilter || UsesCache) {
+            return find_accelerated(key);
+        } else {
+            if (query_path_ == QueryPath::LINEAR_UNIFORM) {
+                if (outside_keys(key)) {
+                    DEBUG_LOG("JazzyIndex::find: Key out of bounds, returning end()");
+                    return base_ + size_;
+                }
+                const auto [seg, predicted] = locate_linear_uniform(key);
+                DEBUG_LOG("JazzyIndex::find: Predicted index %zu for key in segment [%zu-%zu]",
+                          predicted, seg->start_idx, seg->end_idx);
+                return search_exact(*seg, predicted, key);
+            }
+
+            // Return end iterator if index not built or empty
+            if (!is_built() || size_ == 0) {
+                DEBUG_LOG("JazzyIndex::find: Index not built or empty, returning end()");
+                return base_ + size_;
+            }
+
+            // Bounds check
+            if (outside_keys(key)) {
+                DEBUG_LOG("JazzyIndex::find: Key out of bounds, returning end()");
+                return base_ + size_;
+            }
+
+            // Find segment using binary search
+            const auto seg = find_segment(key);
+            if (seg == nullptr) {
+                DEBUG_LOG("JazzyIndex::find: find_segment returned nullptr, returning end()");
+                return base_ + size_;
+            }
+
+            // Predict index using segment's model
+            const std::size_t predicted = predict_index(*seg, key);
+
+            DEBUG_LOG("JazzyIndex::find: Predicted index %zu for key in segment [%zu-%zu]",
+                      predicted, seg->start_idx, seg->end_idx);
+
+            return search_exact(*seg, predicted, key);
+        }
+    }
+
+    // Find the range of elements equal to the given value
+    // Returns a pair of iterators [lower, upper) where all elements in the range are equivalent to value
+    // For missing values, returns [position, position) where position is where the value would be inserted
+    // Both bounds share one segment lookup and prediction; the upper search starts from the lower bound
+    [[nodiscard]] std::pair<const_iterator, const_iterator> equal_range(const T& value) const {
+        DEBUG_LOG("JazzyIndex::equal_range: Called for value");
+        const_iterator end = base_ + size_;
+
+        const auto [seg, predicted] = locate(value);
+        if (seg == nullptr) {
+            DEBUG_LOG("JazzyIndex::equal_range: Empty index, returning [end, end)");
+            return std::make_pair(end, end);
+        }
+        const_iterator lower = search_bound<false>(*seg, predicted, value);
+
+        // If value is not found, both lower and upper point to insertion position
+        // This matches std::equal_range behavior
+        if (lower == end || !are_equivalent(*lower, value)) {
+            DEBUG_LOG("JazzyIndex::equal_range: Value not found, returning empty range");
+            return std::make_pair(lower, lower);
+        }
+
+        // The lower bound of a present key lies in its segment, and the upper bound after it
+        const auto lower_idx = static_cast<std::size_t>(lower - base_);
+        const_iterator upper = search_bound<true>(*seg, std::max(predicted, lower_idx), value);
+
+        DEBUG_LOG("JazzyIndex::equal_range: Found range [%zu, %zu)",
+                  lower_idx, static_cast<std::size_t>(upper - base_));
+        return std::make_pair(lower, upper);
+    }
+
+    // Keys in [lo, hi): not less than lo and less than hi (empty, at lo's lower bound, unless lo < hi).
+    // hi is routed by galloping forward from lo's segment, so a short range costs one full lookup
+    // and a few more comparisons
+    [[nodiscard]] std::span<const T> range(const T& lo, const T& hi) const {
+        const auto [seg, predicted] = locate(lo);
+        if (seg == nullptr) {
+            return {};
+        }
+        const_iterator lower = search_bound<false>(*seg, predicted, lo);
+        if (!comp_(lo, hi)) {
+            DEBUG_LOG("JazzyIndex::range: Empty range at %zu", static_cast<std::size_t>(lower - base_));
+            return {lower, std::size_t{0}};
+        }
+
+        const auto* hi_seg = find_segment_from(static_cast<std::size_t>(seg - segments_.data()), hi);
+        const_iterator upper = search_bound<false>(*hi_seg, predict_index(*hi_seg, hi), hi);
+        DEBUG_LOG("JazzyIndex::range: Range [%zu, %zu) over segments %zu-%zu",
+                  static_cast<std::size_t>(lower - base_), static_cast<std::size_t>(upper - base_),
+                  static_cast<std::size_t>(seg - segments_.data()), static_cast<std::size_t>(hi_seg - segments_.data()));
+        return {lower, upper};
+    }
+
+    // Number of keys in [lo, hi)
+    [[nodiscard]] std::size_t count_range(const T& lo, const T& hi) const { return range(lo, hi).size(); }
+
+    // Call fn(key) for every key in [lo, hi) in order, prefetching RANGE_SCAN_PREFETCH_LINES cache
+    // lines ahead of the visitor
+    template <typename Fn>
+    void for_each_in_range(const T& lo, const T& hi, Fn&& fn) const {
+        constexpr std::size_t line = detail::KEYS_PER_CACHE_LINE<T>;
+        constexpr std::size_t ahead = detail::RANGE_SCAN_PREFETCH_LINES * line;
+        const std::span<const T> keys = range(lo, hi);
+        const T* p = keys.data();
+        const T* last = p + keys.size();
+        for (std::size_t i = 0; i < std::min(ahead, keys.size()); i += line) {
+            detail::prefetch_read(p + i);
+        }
+        while (static_cast<std::size_t>(last - p) > ahead) {
+            detail::prefetch_read(p + ahead);
+            for (const T* block = p + line; p != block; ++p) {
+                fn(*p);
+            }
+        }
+        for (; p != last; ++p) {
+            fn(*p);
+        }
+    }
+
+    // Find the first occurrence of a value (lower bound)
+    [[nodiscard]] const_iterator find_lower_bound(const T& value) const {
+        DEBUG_LOG("JazzyIndex::find_lower_bound: Called");
+        const_iterator end = base_ + size_;
+
+        // Use the existing prediction mechanism to get close
+        const auto [seg, predicted_index] = locate(value);
+        if (seg == nullptr) {
+            DEBUG_LOG("JazzyIndex::find_lower_bound: Segment not found, returning end()");
+            return end;
+        }
+
+        DEBUG_LOG("JazzyIndex::find_lower_bound: Predicted index %zu in segment [%zu-%zu]",
+                  predicted_index, seg->start_idx, seg->end_idx);
+
+        return search_lower_bound(*seg, predicted_index, value);
+    }
+
+    // Find one past the last occurrence of a value (upper bound)
+    [[nodiscard]] const_iterator find_upper_bound(const T& value) const {
+        DEBUG_LOG("JazzyIndex::find_upper_bound: Called");
+        const_iterator end = base_ + size_;
+
+        // Similar to lower_bound, but finds one past the last occurrence
+        const auto [seg, predicted_index] = locate(value);
+        if (seg == nullptr) {
+            DEBUG_LOG("JazzyIndex::find_upper_bound: Segment not found, returning end()");
+            return end;
+        }
+
+        DEBUG_LOG("JazzyIndex::find_upper_bound: Predicted index %zu in segment [%zu-%zu]",
+                  predicted_index, seg->start_idx, seg->end_idx);
+
+        return search_upper_bound(*seg, predicted_index, value);
+    }
+
+    // Batched lookups: out[i] receives the result of find(keys[i])
+    // Keys are processed in groups; each stage (routing, prediction, prefetch of the predicted
+    // cache line, local search) runs across the whole group so the memory misses overlap
+    void find_batch(std::span<const T> keys, std::span<const_iterator> out) const {
+        run_batch<BatchOp::FIND>(keys, out);
+    }
+
+    // Batched find_lower_bound: out[i] receives find_lower_bound(keys[i])
+    void find_lower_bound_batch(std::span<const T> keys, std::span<const_iterator> out) const {
+        run_batch<BatchOp::LOWER_BOUND>(keys, out);
+    }
+
+    // Batched find_upper_bound: out[i] receives find_upper_bound(keys[i])
+    void find_upper_bound_batch(std::span<const T> keys, std::span<const_iterator> out) const {
+        run_batch<BatchOp::UPPER_BOUND>(keys, out);
+    }
+
+    // find_batch for keys in ascending order, as a merge join against the index: each key's
+    // segment is found by galloping forward from the previous key's segment rather than routed
+    // from scratch, so dense sorted probes cost a comparison or two each to route. A key ordered
+    // before the previous one is routed afresh, so any order gives find()'s answers
+    void find_sorted_batch(std::span<const T> keys, std::span<const_iterator> out) const {
+        if (out.size() < keys.size()) {
+            throw std::invalid_argument("Batch output span is smaller than the key span");
+        }
+
+        const_iterator end = base_ + size_;
+        if (num_segments_ == 0) {
+            std::fill_n(out.begin(), keys.size(), end);
+            return;
+        }
+
+        std::size_t seg_idx = 0;
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            const T& key = keys[i];
+            if (outside_keys(key)) {
+                out[i] = end;
+                continue;
+            }
+            const bool backwards = seg_idx > 0 && !comp_(segments_.max_key(seg_idx - 1), bound_of(key));
+            const SegmentType* seg = backwards ? find_segment(key) : find_segment_from(seg_idx, key);
+            seg_idx = static_cast<std::size_t>(seg - segments_.data());
+            out[i] = search_exact(*seg, predict_index(*seg, key), key);
+        }
+    }
+
+    // Forward cursor for monotone probe streams (time-ordered replays, sorted join inputs). It
+    // remembers the position and segment of its last answer: seek(value) gallops forward from
+    // that position (1, 2, 4, ... keys), and only a jump past CURSOR_GALLOP_KEYS keys asks the
+    // model, galloping over the segment bounds from the remembered segment instead of routing
+    // from scratch. Uniform indexes compute the segment directly, so their seeks are plain
+    // lookups. Seeking backwards is allowed and costs a full lookup. Rebuilding the index
+    // invalidates its cursors (reset() them)
+    class Cursor {
+    public:
+        explicit Cursor(const JazzyIndex& index) noexcept : index_(&index) {}
+
+        // find_lower_bound(value)
+        [[nodiscard]] const_iterator seek(const T& value) {
+            const JazzyIndex& index = *index_;
+            const std::size_t n = index.size_;
+            if (index.num_segments_ == 0) {
+                return index.base_ + n;
+            }
+            if (pos_ > n || seg_idx_ >= index.num_segments_) {
+                reset();
+            }
+
+            if (index.is_uniform_) {
+                return settle(index.find_lower_bound(value));
+            }
+
+            const T* base = index.base_;
+            if (pos_ > 0 && !index.comp_(base[pos_ - 1], value)) {
+                DEBUG_LOG("JazzyIndex::Cursor::seek: Backwards from %zu, full lookup", pos_);
+                const auto [seg, predicted] = index.locate(value);
+                seg_idx_ = static_cast<std::size_t>(seg - index.segments_.data());
+                return settle(index.search_lower_bound(*seg, predicted, value));
+            }
+
+            // Every key before lo is less than value; gallop hi until base[hi] is not
+            std::size_t lo = pos_;
+            std::size_t hi = pos_;
+            for (std::size_t step = 1; hi < n && index.comp_(base[hi], value); step *= 2) {
+                lo = hi + 1;
+                if (hi - pos_ >= detail::CURSOR_GALLOP_KEYS) {
+                    return settle(model_seek(value, lo));
+                }
+                hi = std::min(n, hi + step);
+            }
+            DEBUG_LOG("JazzyIndex::Cursor::seek: Galloped from %zu to [%zu-%zu]", pos_, lo, hi);
+            return settle(std::lower_bound(base + lo, base + hi, value, index.comp_));
+        }
+
+        // find(key): seek(key) when it holds key, end() otherwise
+        [[nodiscard]] const_iterator find(const T& key) {
+            const_iterator end = index_->base_ + index_->size_;
+            const_iterator found = seek(key);
+            return found != end && index_->are_equivalent(*found, key) ? found : end;
+        }
+
+        // The last answer (the first key before any seek)
+        [[nodiscard]] const_iterator position() const noexcept { return index_->base_ + pos_; }
+
+        // Back to the first key, for a new probe stream or a rebuilt index
+        void reset() noexcept {
+            pos_ = 0;
+            seg_idx_ = 0;
+        }
+
+    private:
+        // A far jump: keys before lo are less than value, so no segment before the remembered one
+        // can hold its lower bound
+        [[nodiscard]] const_iterator model_seek(const T& value, std::size_t lo) {
+            const JazzyIndex& index = *index_;
+            if (lo >= index.size_ || index.comp_(index.base_[index.size_ - 1], value)) {
+                return index.base_ + index.size_;
+            }
+            const SegmentType* seg = index.find_segment_from(seg_idx_, value);
+            seg_idx_ = static_cast<std::size_t>(seg - index.segments_.data());
+            DEBUG_LOG("JazzyIndex::Cursor::seek: Jump past %zu keys, routed to segment %zu",
+                      detail::CURSOR_GALLOP_KEYS, seg_idx_);
+            return index.search_lower_bound(*seg, index.predict_index(*seg, value), value);
+        }
+
+        const_iterator settle(const_iterator result) noexcept {
+            pos_ = static_cast<std::size_t>(result - index_->base_);
+            return result;
+        }
+
+        const JazzyIndex* index_;
+        std::size_t pos_ = 0;      // Position of the last answer
+        std::size_t seg_idx_ = 0;  // A segment at or before the one holding pos_
+    };
+
+    // A cursor at the first key
+    [[nodiscard]] Cursor cursor() const noexcept { return Cursor(*this); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] std::size_t num_segments() const noexcept { return num_segments_; }
+
+    // Most segments a build may use: the SegmentCount preset, or SegmentSizing::max_segments
+    // for runtime-sized indexes
+    [[nodiscard]] std::size_t segment_budget() const noexcept {
+        if constexpr (IsDynamic) {
+            return sizing_.max_segments;
+        } else {
+            return NumSegments;
+        }
+    }
+    [[nodiscard]] bool is_built() const noexcept { return base_ != nullptr; }
+
+    // Bytes held by the index itself: segment tables, routing layer, batch tables, run table and any
+    // filter or cache (not the keys). Fixed-size indexes hold every table but those three inline
+    [[nodiscard]] std::size_t memory_usage() const noexcept {
+        return sizeof(*this) + segments_.heap_bytes() + router_.heap_bytes() +
+               detail::segment_array_heap_bytes(batch_bounds_) + detail::segment_array_heap_bytes(batch_models_) +
+               detail::segment_array_heap_bytes(runs_) + filter_.heap_bytes() + cache_.heap_bytes();
+    }
+
+    // Runs of equivalent keys answered from the run table (see detail::MIN_TABLED_RUN)
+    [[nodiscard]] std::size_t num_tabled_runs() const noexcept { return runs_.size(); }
+
+    // Widest error window over the segments: the largest distance between a key's predicted
+    // and actual position (0 for an empty index)
+    [[nodiscard]] std::size_t max_segment_error() const noexcept {
+        std::size_t widest = 0;
+        for (std::size_t i = 0; i < num_segments_; ++i) {
+            widest = std::max<std::size_t>(widest, segments_[i].max_error);
+        }
+        return widest;
+    }
+
+    // Query path chosen by the last build (see QueryPath)
+    [[nodiscard]] QueryPath query_path() const noexcept { return query_path_; }
+
+    // Memory, model mix, error spread, routing and build time of the last build (see IndexStats)
+    [[nodiscard]] IndexStats index_stats() const {
+        IndexStats stats;
+        stats.num_keys = size_;
+        stats.num_segments = num_segments_;
+        stats.memory_bytes = memory_usage();
+        stats.uniform = is_uniform_;
+        stats.query_path = query_path_;
+        stats.build = timings_;
+        double weighted_error = 0.0;
+        for (std::size_t i = 0; i < num_segments_; ++i) {
+            const auto& seg = segments_[i];
+            switch (seg.model_type) {
+                case detail::ModelType::CONSTANT: ++stats.constant_segments; break;
+                case detail::ModelType::LINEAR: ++stats.linear_segments; break;
+                case detail::ModelType::QUADRATIC: ++stats.quadratic_segments; break;
+                case detail::ModelType::CUBIC: ++stats.cubic_segments; break;
+            }
+            stats.max_error = std::max<std::size_t>(stats.max_error, seg.max_error);
+            ++stats.error_histogram[QueryStats::bucket_of(seg.max_error)];
+            weighted_error += static_cast<double>(seg.max_error) * static_cast<double>(seg.end_idx - seg.start_idx);
+        }
+        if (size_ > 0) {
+            stats.mean_error = weighted_error / static_cast<double>(size_);
+            stats.expected_probes = workload_cost(
+                [this](std::size_t p) { return static_cast<double>(p) / static_cast<double>(size_); });
+        }
+        return stats;
+    }
+
+    // Query counters from every thread since the last build or reset_query_stats()
+    // (IndexOptions<..., stats::PerThread> only)
+    [[nodiscard]] QueryStats query_stats() const requires CollectsStats { return stats_.snapshot(); }
+
+    // Zero the query counters; queries running meanwhile may leave a few counts behind
+    void reset_query_stats() const noexcept requires CollectsStats { stats_.clear(); }
+
+    // Worst-case distance between a key's predicted and actual position, measured against the
+    // stored models after an error-bounded build (std::nullopt for equal-count builds)
+    [[nodiscard]] std::optional<std::size_t> error_bound() const noexcept { return error_bound_; }
+
+    // Parallel build API - requires #include "jazzy_index_parallel.hpp"
+    // Prepare independent build tasks for custom threading model
+    std::vector<parallel::BuildTask<T, Compare, KeyExtractor>>
+    prepare_build_tasks(const T* first, const T* last,
+                       Compare comp = Compare{},
+                       KeyExtractor key_extract = KeyExtractor{});
+
+    // Finalize build after executing tasks
+    void finalize_build(const std::vector<detail::SegmentAnalysis<T>>& results);
+
+    // Parallel build on the process-wide default thread pool (convenience method)
+    void build_parallel(const T* first, const T* last,
+                       Compare comp = Compare{},
+                       KeyExtractor key_extract = KeyExtractor{});
+
+    // Parallel build on a caller-supplied executor (thread pool, scheduler adapter, inline)
+    template <parallel::Executor Exec>
+    void build_parallel(const T* first, const T* last, Exec& executor,
+                       Compare comp = Compare{},
+                       KeyExtractor key_extract = KeyExtractor{});
+
+    // Error-bounded variants (see build_error_bounded)
+    std::vector<parallel::BuildTask<T, Compare, KeyExtractor>>
+    prepare_error_bounded_tasks(const T* first, const T* last, std::size_t epsilon,
+                                Compare comp = Compare{},
+                                KeyExtractor key_extract = KeyExtractor{});
+
+    void build_parallel_error_bounded(const T* first, const T* last, std::size_t epsilon,
+                                      Compare comp = Compare{},
+                                      KeyExtractor key_extract = KeyExtractor{});
+
+    template <parallel::Executor Exec>
+    void build_parallel_error_bounded(const T* first, const T* last, std::size_t epsilon, Exec& executor,
+                                      Compare comp = Compare{},
+                                      KeyExtractor key_extract = KeyExtractor{});
+
+    // Iterator-based parallel build method
+    template <typename Iterator>
+        requires std::random_access_iterator<Iterator> &&
+                 std::contiguous_iterator<Iterator> &&
+                 (!std::is_pointer_v<Iterator>) &&
+                 std::same_as<typename std::iterator_traits<Iterator>::value_type, T>
+    void build_parallel(Iterator first, Iterator last, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
+        // Convert contiguous iterators to pointers for internal use
+        build_parallel(std::to_address(first), std::to_address(last), comp, key_extract);
+    }
+
+    // Serialization API - requires #include "jazzy_index_serialize.hpp"
+    // Write the segment table, routing layer and uniformity parameters (plus the keys, unless
+    // KeyData::EXTERNAL) in the binary format read by load() and JazzyIndexView
+    void save(std::ostream& out, KeyData keys = KeyData::EMBEDDED) const;
+
+    // Restore an index saved over the same sorted data [first, last) instead of rebuilding it
+    void load(std::istream& in, const T* first, const T* last,
+              Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{});
+
+    // Coroutine API - requires #include "jazzy_index_coroutine.hpp"
+    // find, find_lower_bound and find_upper_bound as suspended lookups that prefetch the segment
+    // and then the predicted key before touching them, for interleaving with other lookups
+    // (interleave_lookups). The key is copied into the lookup
+    [[nodiscard]] LookupTask<T> find_async(T key) const;
+    [[nodiscard]] LookupTask<T> find_lower_bound_async(T value) const;
+    [[nodiscard]] LookupTask<T> find_upper_bound_async(T value) const;
+
+    // Friend declarations
+    template <typename U, SegmentCount S, typename C, typename K, typename O>
+    friend std::string export_index_metadata(const JazzyIndex<U, S, C, K, O>& index);
+
+    template <typename U, SegmentCount S, typename C, typename K, typename O>
+    friend class parallel::ParallelBuilder;
+
+    template <typename U, SegmentCount S, typename C, typename K, typename O>
+    friend class parallel::ParallelProber;
+
+    template <typename U, SegmentCount S, typename C, typename K, typename O>
+    friend class serialize::IndexSerializer;
+
+private:
+    enum class BatchOp : uint8_t { FIND, LOWER_BOUND, UPPER_BOUND };
+
+    template <BatchOp Op>
+    LookupTask<T> lookup_async(T key) const;
+
+    template <BatchOp Op>
+    void run_batch(std::span<const T> keys, std::span<const_iterator> out) const {
+        if (out.size() < keys.size()) {
+            throw std::invalid_argument("Batch output span is smaller than the key span");
+        }
+
+        const_iterator end = base_ + size_;
+        if (num_segments_ == 0) {
+            std::fill_n(out.begin(), keys.size(), end);
+            return;
+        }
+
+        constexpr std::size_t group_size = detail::BATCH_GROUP_SIZE;
+        alignas(64) std::array<double, group_size> key_vals;
+        alignas(64) std::array<double, group_size> model_preds;
+        alignas(64) std::array<std::uint32_t, group_size> seg_idx;
+        std::array<std::size_t, group_size> predicted;
+        std::array<bool, group_size> active;
+
+        const double min_key = static_cast<double>(std::invoke(key_extract_, min_));
+
+        for (std::size_t group_start = 0; group_start < keys.size(); group_start += group_size) {
+            const std::size_t count = std::min(group_size, keys.size() - group_start);
+            const T* group_keys = keys.data() + group_start;
+
+            // Stage 1: bounds check (find only) and model inputs
+            for (std::size_t i = 0; i < count; ++i) {
+                const T& key = group_keys[i];
+                if constexpr (Op == BatchOp::FIND) {
+                    active[i] = !comp_(key, base_[0]) && !comp_(base_[size_ - 1], key);
+                } else {
+                    active[i] = true;
+                }
+                key_vals[i] = static_cast<double>(std::invoke(key_extract_, key));
+            }
+
+            // Stage 2: vector routing (uniform arithmetic or lane-parallel search over the
+            // packed segment bounds), then prefetch the candidate segment descriptors
+            bool routed = true;
+            if (is_uniform_) {
+                detail::simd::route_uniform(key_vals.data(), count, min_key, segment_scale_,
+                                            num_segments_, seg_idx.data());
+            } else if constexpr (detail::IS_ASCENDING_COMPARE_V<Compare>) {
+                detail::simd::route_sorted(batch_bounds_.data(), num_segments_, key_vals.data(), count,
+                                           seg_idx.data());
+            } else {
+                routed = false;
+            }
+
+            if (routed) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    detail::prefetch_read(segments_.data() + seg_idx[i]);
+                }
+            }
+
+            // Stage 3: confirm each candidate with comp_ (doubles can round); rare misses take the scalar path
+            // (which records their uniform guess, so only confirmed vector guesses are recorded here)
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!active[i]) {
+                    seg_idx[i] = 0;
+                } else if (!routed || !routed_segment_matches(seg_idx[i], group_keys[i])) {
+                    seg_idx[i] = static_cast<std::uint32_t>(find_segment(group_keys[i]) - segments_.data());
+                } else if constexpr (CollectsStats) {
+                    if (is_uniform_) {
+                        stats_.record_route(true);
+                    }
+                }
+            }
+
+            // Stage 4: evaluate all models in vector registers, clamp, prefetch the predicted data line
+            // (relative models need their segment's origin, so the store evaluates them one by one)
+            if constexpr (!SegmentStore::RELATIVE_MODELS) {
+                detail::simd::predict(batch_models_.data(), seg_idx.data(), key_vals.data(), count,
+                                      model_preds.data());
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                if (!active[i]) {
+                    continue;
+                }
+                const auto& seg = segments_[seg_idx[i]];
+                if constexpr (SegmentStore::RELATIVE_MODELS) {
+                    predicted[i] = predict_index(seg, group_keys[i]);
+                } else {
+                    bool finite_key = true;
+                    if constexpr (std::is_floating_point_v<KeyTypeClean>) {
+                        finite_key = std::isfinite(key_vals[i]);
+                    }
+                    if (finite_key) {
+                        // CONSTANT segments evaluate to 0 and clamp to start_idx (== constant_idx)
+                        predicted[i] = detail::clamp_value<std::size_t>(static_cast<std::size_t>(model_preds[i]),
+                                                                        seg.start_idx,
+                                                                        seg.end_idx > 0 ? seg.end_idx - 1 : 0);
+                    } else {
+                        // Zero coefficients times an infinite key is NaN; keep the scalar model's answer
+                        predicted[i] = predict_index(seg, group_keys[i]);
+                    }
+                }
+                detail::prefetch_read(base_ + predicted[i]);
+            }
+
+            // Stage 5: local search from the (now cached) predicted position
+            for (std::size_t i = 0; i < count; ++i) {
+                const_iterator& result = out[group_start + i];
+                const auto& seg = segments_[seg_idx[i]];
+                if (!active[i]) {
+                    result = end;
+                } else if constexpr (Op == BatchOp::FIND) {
+                    result = search_exact(seg, predicted[i], group_keys[i]);
+                } else if constexpr (Op == BatchOp::LOWER_BOUND) {
+                    result = search_lower_bound(seg, predicted[i], group_keys[i]);
+                } else {
+                    result = search_upper_bound(seg, predicted[i], group_keys[i]);
+                }
+            }
+        }
+    }
+
+    // Check a vector-routed segment against the segment find_segment would pick for value
+    [[nodiscard]] bool routed_segment_matches(std::size_t seg_idx, const T& value) const {
+        decltype(auto) bound = bound_of(value);
+        if (is_uniform_) {
+            return segments_.owns(seg_idx, bound, comp_);
+        }
+        // First segment whose max is not less than value (last segment catches keys past the end)
+        const bool within = !comp_(segments_.max_key(seg_idx), bound) || seg_idx + 1 == num_segments_;
+        return within && (seg_idx == 0 || comp_(segments_.max_key(seg_idx - 1), bound));
+    }
+
+    // Single-element index: one CONSTANT segment
+    void init_single_segment() {
+        allocate_segments(1);
+        segments_.set_extent(0, bound_of(min_), bound_of(max_), 0, 1);
+        detail::SegmentAnalysis<T> constant{};
+        constant.best_model = detail::ModelType::CONSTANT;
+        store_segment_model(0, constant);
+        num_segments_ = 1;
+        build_routing_tables();
+    }
+
+    // Cut [0, size_) into count segments ending at end_of(i), checking sortedness and
+    // uniformity on the way, and store fit(start, end) as each segment's model
+    template <typename EndOf, typename Fit>
+    void build_segments(std::size_t count, EndOf end_of, Fit fit) {
+        allocate_segments(count);
+        num_segments_ = count;
 
         // Precompute uniformity parameters before loop
         const double total_range = static_cast<double>(std::invoke(key_extract_, max_)) -
@@ -714,21 +2818,21 @@ public:
         const double expected_spacing = (num_segments_ > 1 && total_range >= detail::ZERO_RANGE_THRESHOLD)
             ? total_range / static_cast<double>(num_segments_)
             : 0.0;
-        const double tolerance = expected_spacing * detail::UNIFORMITY_TOLERANCE;
+        const double tolerance = expected_spacing * config_.uniformity_tolerance;
         is_uniform_ = true;  // Assume uniform until proven otherwise
 
-        for (std::size_t i = 0; i < actual_segments; ++i) {
-            const std::size_t start = (i * size_) / actual_segments;
-            const std::size_t end = ((i + 1) * size_) / actual_segments;
+        const auto analyze_start = detail::BuildClock::now();
+        std::size_t start = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t end = end_of(i);
 
-            auto& seg = segments_[i];
-            seg.min_val = base_[start];
-            seg.max_val = base_[end - 1];
-            seg.start_idx = start;
-            seg.end_idx = end;
+            const T& seg_min = base_[start];
+            const T& seg_max = base_[end - 1];
+            segments_.set_extent(i, bound_of(seg_min), bound_of(seg_max), start, end);
 
             // Verify monotonicity: check that this segment's min is >= previous segment's max
-            if (i > 0 && comp_(seg.min_val, segments_[i - 1].max_val)) {
+            // (and that its own endpoints are ordered)
+            if (comp_(seg_max, seg_min) || (i > 0 && comp_(seg_min, base_[start - 1]))) {
                 throw std::runtime_error(
                     "Input data is not sorted. JazzyIndex requires sorted data. "
                     "Please sort your data before building the index."
@@ -737,51 +2841,18 @@ public:
 
             // Check uniformity inline (while min/max values are hot in cache)
             if (is_uniform_ && num_segments_ > 1 && total_range >= detail::ZERO_RANGE_THRESHOLD) {
-                const double segment_range = static_cast<double>(std::invoke(key_extract_, seg.max_val)) -
-                                            static_cast<double>(std::invoke(key_extract_, seg.min_val));
+                const double segment_range = static_cast<double>(std::invoke(key_extract_, seg_max)) -
+                                            static_cast<double>(std::invoke(key_extract_, seg_min));
                 if (std::abs(segment_range - expected_spacing) > tolerance) {
                     is_uniform_ = false;
                 }
             }
 
             // Analyze segment and choose best model
-            const auto analysis = detail::analyze_segment(base_, start, end, comp_, key_extract_);
-
-            seg.model_type = analysis.best_model;
-
-            // Check if prediction error exceeds uint32_t limit
-            if (analysis.max_error > std::numeric_limits<uint32_t>::max()) {
-                throw std::runtime_error(
-                    "Segment prediction error exceeds uint32_t limit. "
-                    "Data distribution is too extreme for indexing. "
-                    "Consider using fewer segments or preprocessing the data."
-                );
-            }
-            seg.max_error = static_cast<uint32_t>(analysis.max_error);
-
-            switch (analysis.best_model) {
-                case detail::ModelType::LINEAR:
-                    seg.params.linear.slope = static_cast<float>(analysis.linear_a);
-                    seg.params.linear.intercept = static_cast<float>(analysis.linear_b);
-                    break;
-                case detail::ModelType::QUADRATIC:
-                    seg.params.quadratic.a = static_cast<float>(analysis.quad_a);
-                    seg.params.quadratic.b = static_cast<float>(analysis.quad_b);
-                    seg.params.quadratic.c = static_cast<float>(analysis.quad_c);
-                    break;
-                case detail::ModelType::CUBIC:
-                    seg.params.cubic.a = static_cast<float>(analysis.cubic_a);
-                    seg.params.cubic.b = static_cast<float>(analysis.cubic_b);
-                    seg.params.cubic.c = static_cast<float>(analysis.cubic_c);
-                    seg.params.cubic.d = static_cast<float>(analysis.cubic_d);
-                    break;
-                case detail::ModelType::CONSTANT:
-                    seg.params.constant.constant_idx = start;
-                    break;
-                default:
-                    break;
-            }
+            store_segment_model(i, fit(start, end));
+            start = end;
         }
+        timings_.analyze_ns = detail::nanoseconds_since(analyze_start);
 
         // Compute scale factor for O(1) segment lookup if data is uniform
         if (is_uniform_ && total_range >= detail::ZERO_RANGE_THRESHOLD) {
@@ -791,300 +2862,325 @@ public:
             DEBUG_LOG("JazzyIndex::build: Data is NON-UNIFORM (is_uniform=%d, total_range=%.4f)",
                       is_uniform_, total_range);
         }
-        DEBUG_LOG("JazzyIndex::build: Build complete with %zu segments", num_segments_);
+        build_routing_tables();
     }
 
-    // Iterator-based build method
-    template <typename Iterator>
-        requires std::random_access_iterator<Iterator> &&
-                 std::contiguous_iterator<Iterator> &&
-                 (!std::is_pointer_v<Iterator>) &&
-                 std::same_as<typename std::iterator_traits<Iterator>::value_type, T>
-    void build(Iterator first, Iterator last, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
-        // Convert contiguous iterators to pointers for internal use
-        build(std::to_address(first), std::to_address(last), comp, key_extract);
+    // Greedy shrinking-cone segmentation: each segment grows until no line through its first
+    // key keeps every key within the corridor. Fills ends[0..num_segments_) and returns the
+    // corridor used (epsilon, widened until the segments fit in the segment budget)
+    std::size_t plan_error_bounded_segments(std::size_t epsilon, detail::SegmentArray<std::size_t, NumSegments>& ends) {
+        const std::size_t budget = segment_budget();
+        detail::resize_segment_array(ends, budget);
+        std::size_t corridor = epsilon;
+        for (;;) {
+            std::size_t count = 0;
+            std::size_t start = 0;
+            while (start < size_ && count < budget) {
+                start = detail::corridor_segment_end(base_, start, size_, corridor, key_extract_);
+                ends[count++] = start;
+            }
+            if (start == size_) {
+                num_segments_ = count;
+                DEBUG_LOG("JazzyIndex::build_error_bounded: corridor=%zu gives %zu segments", corridor, count);
+                return corridor;
+            }
+            // A corridor of size_ positions always fits in one segment, so this terminates
+            DEBUG_LOG("JazzyIndex::build_error_bounded: corridor=%zu needs more than %zu segments, widening",
+                      corridor, budget);
+            corridor = corridor * 2 + 1;
+        }
     }
 
-    [[nodiscard]] const_iterator find(const T& key) const {
-        DEBUG_LOG("JazzyIndex::find: Called (size=%zu, is_built=%d)", size_, is_built());
-
-        // Return end iterator if index not built or empty
-        if (!is_built() || size_ == 0) {
-            DEBUG_LOG("JazzyIndex::find: Index not built or empty, returning end()");
-            return base_ + size_;
+    // Rebuild with segment ends at equal steps of a blend of key count and query mass, where
+    // query_cdf(p) is the share of the workload landing on keys before position p (monotone,
+    // 0 at 0 and 1 at size_). Each end is the last position whose blended weight is within its step
+    // (with no queries, the equal-count ends), kept past the previous end and short of the keys
+    // the later segments need
+    template <typename QueryCdf>
+    void build_workload_segments(double query_share, QueryCdf query_cdf) {
+        error_bound_.reset();
+        timings_ = {};
+        const auto partition_start = detail::BuildClock::now();
+        const std::size_t count = equal_count_segments();
+        const double key_share = 1.0 - query_share;
+        const auto weight = [&](std::size_t p) {
+            const double keys = key_share * static_cast<double>(p) / static_cast<double>(size_);
+            return query_share > 0.0 ? keys + query_share * query_cdf(p) : keys;
+        };
+
+        std::vector<std::size_t> ends(count);
+        std::size_t previous = 0;
+        for (std::size_t i = 0; i + 1 < count; ++i) {
+            const double target = static_cast<double>(i + 1) / static_cast<double>(count);
+            std::size_t lo = previous + 1;
+            std::size_t hi = size_ - (count - 1 - i);
+            while (lo < hi) {
+                const std::size_t mid = lo + (hi - lo + 1) / 2;
+                if (weight(mid) <= target) {
+                    lo = mid;
+                } else {
+                    hi = mid - 1;
+                }
+            }
+            ends[i] = previous = lo;
         }
+        ends[count - 1] = size_;
+        timings_.partition_ns = detail::nanoseconds_since(partition_start);
+
+        build_segments(
+            count,
+            [&ends](std::size_t i) { return ends[i]; },
+            [this](std::size_t start, std::size_t end) {
+                return detail::fit_segment<SegmentStore::OFFSET_MODELS>(base_, start, end, detail::UNBOUNDED_ERROR,
+                                                                        comp_, key_extract_, config_);
+            });
+        DEBUG_LOG("JazzyIndex::build_workload_segments: Rebuilt %zu segments (query_share=%.2f)", count,
+                  query_share);
+    }
 
-        // Bounds check
-        const T& first_value = base_[0];
-        const T& last_value = base_[size_ - 1];
-        if (comp_(key, first_value) || comp_(last_value, key)) {
-            DEBUG_LOG("JazzyIndex::find: Key out of bounds, returning end()");
-            return base_ + size_;
+    // build_workload_segments, unless the workload's estimated cost under the new segments is
+    // higher than under the current ones (then the current segments are restored)
+    template <typename QueryCdf>
+    void rebuild_if_cheaper(double query_share, QueryCdf query_cdf) {
+        // On the heap: a fixed-size index holds its segment table inline (200 KB at SegmentCount::MAX)
+        auto previous = std::make_unique<JazzyIndex>(*this);
+        const double previous_cost = workload_cost(query_cdf);
+        build_workload_segments(query_share, query_cdf);
+        const double cost = workload_cost(query_cdf);
+        DEBUG_LOG("JazzyIndex::rebuild_if_cheaper: Estimated probes per query %.2f -> %.2f", previous_cost, cost);
+        if (cost > previous_cost) {
+            *this = std::move(*previous);
         }
+    }
 
-        // Find segment using binary search
-        const auto seg = find_segment(key);
-        if (seg == nullptr) {
-            DEBUG_LOG("JazzyIndex::find: find_segment returned nullptr, returning end()");
-            return base_ + size_;
+    // Expected probes per query for a workload whose share landing before position p is
+    // query_cdf(p): routing (one guess when uniform, a search of the segment bounds otherwise)
+    // plus a search of the error window in the segment the query lands in
+    template <typename QueryCdf>
+    [[nodiscard]] double workload_cost(QueryCdf query_cdf) const {
+        const double routing = is_uniform_ ? 1.0 : std::log2(static_cast<double>(num_segments_) + 1.0);
+        double cost = 0.0;
+        for (std::size_t i = 0; i < num_segments_; ++i) {
+            const auto& seg = segments_[i];
+            const double radius = static_cast<double>(seg.max_error) + detail::SEARCH_RADIUS_MARGIN;
+            const double window = std::min(2.0 * radius + 1.0, static_cast<double>(seg.end_idx - seg.start_idx));
+            cost += (query_cdf(seg.end_idx) - query_cdf(seg.start_idx)) * (routing + std::log2(window + 1.0));
         }
+        return cost;
+    }
 
-        // Predict index using segment's model
-        std::size_t predicted = seg->predict(key, key_extract_);
-        predicted = detail::clamp_value<std::size_t>(predicted, seg->start_idx,
-                                                      seg->end_idx > 0 ? seg->end_idx - 1 : 0);
-
-        DEBUG_LOG("JazzyIndex::find: Predicted index %zu for key in segment [%zu-%zu]",
-                  predicted, seg->start_idx, seg->end_idx);
-
-        const T* begin = base_;
-
-        // Check predicted position first
-        if (equal(begin[predicted], key)) {
-            DEBUG_LOG("JazzyIndex::find: Found exact match at predicted index %zu", predicted);
-            return begin + predicted;
+    static void check_query_share(double query_share) {
+        if (!(query_share >= 0.0 && query_share <= 1.0)) {
+            throw std::invalid_argument("query_share must be in range [0, 1]");
         }
+    }
 
-        // Determine search direction using one comparison
-        const bool search_left = comp_(key, begin[predicted]);
-        const std::size_t max_radius = std::max<std::size_t>(seg->max_error + detail::SEARCH_RADIUS_MARGIN, detail::MIN_SEARCH_RADIUS);
-
-        DEBUG_LOG("JazzyIndex::find: Search direction: %s, max_radius: %zu",
-                  search_left ? "LEFT" : "RIGHT", max_radius);
-
-        if (search_left) {
-            // Key is less than predicted value, search leftward
-            // Track the rightmost position we've searched to avoid overlaps
-            std::size_t right_boundary = predicted;  // We've checked predicted, don't search it again
-
-            // Exponentially expand leftward: check radii 1, 2, 4, 8...
-            for (std::size_t radius = 1; radius <= max_radius; radius <<= 1) {
-                const std::size_t left_pos = predicted > radius ? predicted - radius : seg->start_idx;
-
-                // If left_pos >= right_boundary, no unexplored region remains
-                if (left_pos >= right_boundary) break;
-
-                // Search the new range [left_pos, right_boundary)
-                const T* found = std::lower_bound(begin + left_pos, begin + right_boundary, key, comp_);
-                if (found != begin + right_boundary && equal(*found, key)) {
-                    DEBUG_LOG("JazzyIndex::find: Found match at index %zu (left search, radius=%zu)",
-                              static_cast<std::size_t>(found - begin), radius);
-                    return found;
-                }
-
-                right_boundary = left_pos;  // Update boundary for next iteration
-            }
-
-            // Fallback: search any remaining unsearched left region
-            if (right_boundary > seg->start_idx) {
-                DEBUG_LOG("JazzyIndex::find: Left fallback search [%zu-%zu)", seg->start_idx, right_boundary);
-                const T* found = std::lower_bound(begin + seg->start_idx, begin + right_boundary, key, comp_);
-                if (found != begin + right_boundary && equal(*found, key)) {
-                    DEBUG_LOG("JazzyIndex::find: Found match at index %zu (left fallback)",
-                              static_cast<std::size_t>(found - begin));
-                    return found;
-                }
-            }
+    // Equal-count segments for size_ keys: the preset (one per key for tiny inputs), or one per
+    // SegmentSizing::keys_per_segment keys within the budget for runtime-sized indexes
+    [[nodiscard]] std::size_t equal_count_segments() const noexcept {
+        if constexpr (IsDynamic) {
+            const std::size_t wanted = (size_ + sizing_.keys_per_segment - 1) / sizing_.keys_per_segment;
+            return std::min(wanted, sizing_.max_segments);
         } else {
-            // Key is greater than predicted value, search rightward
-            // Track the leftmost position we've searched to avoid overlaps
-            std::size_t left_boundary = predicted + 1;  // We've checked predicted, start after it
-
-            // Exponentially expand rightward: check radii 1, 2, 4, 8...
-            for (std::size_t radius = 1; radius <= max_radius; radius <<= 1) {
-                const std::size_t right_pos = std::min<std::size_t>(predicted + radius + 1, seg->end_idx);
-
-                // If right_pos <= left_boundary, no unexplored region remains
-                if (right_pos <= left_boundary) break;
-
-                // Search the new range [left_boundary, right_pos)
-                const T* found = std::lower_bound(begin + left_boundary, begin + right_pos, key, comp_);
-                if (found != begin + right_pos && equal(*found, key)) {
-                    DEBUG_LOG("JazzyIndex::find: Found match at index %zu (right search, radius=%zu)",
-                              static_cast<std::size_t>(found - begin), radius);
-                    return found;
-                }
-
-                left_boundary = right_pos;  // Update boundary for next iteration
-            }
-
-            // Fallback: search any remaining unsearched right region
-            if (left_boundary < seg->end_idx) {
-                DEBUG_LOG("JazzyIndex::find: Right fallback search [%zu-%zu)", left_boundary, seg->end_idx);
-                const T* found = std::lower_bound(begin + left_boundary, begin + seg->end_idx, key, comp_);
-                if (found != begin + seg->end_idx && equal(*found, key)) {
-                    DEBUG_LOG("JazzyIndex::find: Found match at index %zu (right fallback)",
-                              static_cast<std::size_t>(found - begin));
-                    return found;
-                }
-            }
+            return std::min(NumSegments, size_);
         }
-
-        DEBUG_LOG("JazzyIndex::find: Not found after exhaustive search, returning end()");
-        return base_ + size_;
     }
 
-    // Find the range of elements equal to the given value
-    // Returns a pair of iterators [lower, upper) where all elements in the range are equivalent to value
-    // For missing values, returns [position, position) where position is where the value would be inserted
-    [[nodiscard]] std::pair<const_iterator, const_iterator> equal_range(const T& value) const {
-        DEBUG_LOG("JazzyIndex::equal_range: Called for value");
-        const_iterator end = base_ + size_;
-
-        // Handle empty index
-        if (size_ == 0) {
-            DEBUG_LOG("JazzyIndex::equal_range: Empty index, returning [end, end)");
-            return std::make_pair(end, end);
+    // Size segment storage for count segments (no-op for fixed segment counts)
+    void allocate_segments(std::size_t count) {
+        segments_.resize(count);
+        detail::resize_segment_array(batch_bounds_, count);
+        if constexpr (!SegmentStore::RELATIVE_MODELS) {
+            detail::resize_segment_array(batch_models_, count);
         }
+    }
 
-        // Find lower and upper bounds
-        const_iterator lower = find_lower_bound(value);
-        const_iterator upper = find_upper_bound(value);
-
-        // If value is not found, both lower and upper point to insertion position
-        // This matches std::equal_range behavior
-        if (lower == end || !are_equivalent(*lower, value)) {
-            DEBUG_LOG("JazzyIndex::equal_range: Value not found, returning empty range");
-            return std::make_pair(lower, lower);
+    // Copy an analysis result into segment i
+    void store_segment_model(std::size_t i, const detail::SegmentAnalysis<T>& analysis) {
+        store_segment_model(i, analysis, analysis.max_error);
+        if (error_bound_) {
+            // Error-bounded builds promise a search window, so record the error of the stored
+            // (float) model exactly as lookups evaluate it
+            const std::size_t measured = measure_segment_error(i);
+            store_segment_model(i, analysis, measured);
+            error_bound_ = std::max(*error_bound_, measured);
         }
-
-        DEBUG_LOG("JazzyIndex::equal_range: Found range [%zu, %zu)",
-                  static_cast<std::size_t>(lower - base_), static_cast<std::size_t>(upper - base_));
-        return std::make_pair(lower, upper);
     }
 
-    // Find the first occurrence of a value (lower bound)
-    [[nodiscard]] const_iterator find_lower_bound(const T& value) const {
-        DEBUG_LOG("JazzyIndex::find_lower_bound: Called");
-        const_iterator end = base_ + size_;
-
-        // Use the existing prediction mechanism to get close
-        const auto* seg = find_segment(value);
-        if (seg == nullptr) {
-            DEBUG_LOG("JazzyIndex::find_lower_bound: Segment not found, returning end()");
-            return end;
+    void store_segment_model(std::size_t i, const detail::SegmentAnalysis<T>& analysis, std::size_t max_error) {
+        // Check if prediction error exceeds uint32_t limit
+        if (max_error > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error(
+                "Segment prediction error exceeds uint32_t limit. "
+                "Data distribution is too extreme for indexing. "
+                "Consider using fewer segments or preprocessing the data."
+            );
         }
-
-        std::size_t predicted_index = seg->predict(value, key_extract_);
-
-        // Clamp to segment bounds
-        predicted_index = detail::clamp_value<std::size_t>(predicted_index, seg->start_idx,
-                                                           seg->end_idx > 0 ? seg->end_idx - 1 : 0);
-
-        DEBUG_LOG("JazzyIndex::find_lower_bound: Predicted index %zu in segment [%zu-%zu]",
-                  predicted_index, seg->start_idx, seg->end_idx);
-
-        // Now perform a local search to find the exact lower bound
-        const T* ptr = base_ + predicted_index;
-
-        // Check if we're at a matching value (using comp_ for equivalence)
-        if (are_equivalent(*ptr, value)) {
-            // Scan backward to find the first occurrence
-            while (ptr > base_ && are_equivalent(*(ptr - 1), value)) {
-                --ptr;
+        segments_.set_model(i, analysis, static_cast<uint32_t>(max_error));
+        if constexpr (SegmentStore::RELATIVE_MODELS) {
+            // Re-expressing (or rounding) the coefficients moves predictions, so keep the error of
+            // the stored model
+            const std::size_t measured = measure_segment_error(i);
+            if (measured > std::numeric_limits<uint32_t>::max()) {
+                throw std::runtime_error(
+                    "Segment prediction error exceeds uint32_t limit. "
+                    "Data distribution is too extreme for indexing. "
+                    "Consider using fewer segments or preprocessing the data."
+                );
             }
-            std::size_t result_idx = static_cast<std::size_t>(ptr - base_);
-            DEBUG_LOG("JazzyIndex::find_lower_bound: Found lower bound at index %zu (scanned backward)", result_idx);
-            return ptr;
+            segments_.set_model(i, analysis, static_cast<uint32_t>(measured));
         }
-
-        // Otherwise, use binary search in a local range
-        std::size_t search_radius = seg->max_error + detail::SEARCH_RADIUS_MARGIN;
-        const T* search_begin = (ptr >= base_ + search_radius) ? (ptr - search_radius) : base_;
-        const T* search_end = std::min(end, ptr + search_radius + 1);
-
-        const T* result = std::lower_bound(search_begin, search_end, value, comp_);
-        DEBUG_LOG("JazzyIndex::find_lower_bound: Binary search result at index %zu",
-                  static_cast<std::size_t>(result - base_));
-        return result;
     }
 
-    // Find one past the last occurrence of a value (upper bound)
-    [[nodiscard]] const_iterator find_upper_bound(const T& value) const {
-        DEBUG_LOG("JazzyIndex::find_upper_bound: Called");
-        const_iterator end = base_ + size_;
-
-        // Similar to lower_bound, but finds one past the last occurrence
-        const auto* seg = find_segment(value);
-        if (seg == nullptr) {
-            DEBUG_LOG("JazzyIndex::find_upper_bound: Segment not found, returning end()");
-            return end;
+    // Largest distance between predict_index and the true index over segment i's keys
+    [[nodiscard]] std::size_t measure_segment_error(std::size_t i) const {
+        const auto& seg = segments_[i];
+        std::size_t measured = 0;
+        for (std::size_t j = seg.start_idx; j < seg.end_idx; ++j) {
+            const std::size_t predicted = predict_index(seg, base_[j]);
+            measured = std::max(measured, predicted > j ? predicted - j : j - predicted);
         }
+        return measured;
+    }
 
-        std::size_t predicted_index = seg->predict(value, key_extract_);
-
-        // Clamp to segment bounds
-        predicted_index = detail::clamp_value<std::size_t>(predicted_index, seg->start_idx,
-                                                           seg->end_idx > 0 ? seg->end_idx - 1 : 0);
-
-        DEBUG_LOG("JazzyIndex::find_upper_bound: Predicted index %zu in segment [%zu-%zu]",
-                  predicted_index, seg->start_idx, seg->end_idx);
-
-        // Perform local search for upper bound
-        const_iterator ptr = base_ + predicted_index;
-
-        // Check if we're at a matching value using comp_ for equivalence
-        if (are_equivalent(*ptr, value)) {
-            // Scan forward to find one past the last occurrence
-            while (ptr < end && are_equivalent(*ptr, value)) {
-                ++ptr;
+    // Build the routing structure, pack segment bounds and models into the dense tables read by
+    // the batch kernels, and record long key runs (called once segment extents and models are final)
+    void build_routing_tables() {
+        const auto finalize_start = detail::BuildClock::now();
+        runs_.clear();
+        stats_.reset(num_segments_);
+        query_path_ = QueryPath::GENERAL;
+        if (num_segments_ == 0) {
+            return;
+        }
+        // The last segment catches every key past the end, so only the first n-1 keys are searched
+        router_.build(num_segments_ - 1, [this](std::size_t i) -> const Bound& { return segments_.max_key(i); });
+        for (std::size_t i = 0; i < num_segments_; ++i) {
+            batch_bounds_[i] = bound_key(segments_.max_key(i));
+            if constexpr (!SegmentStore::RELATIVE_MODELS) {
+                batch_models_[i] = segments_.packed_model(i);
             }
-            std::size_t result_idx = static_cast<std::size_t>(ptr - base_);
-            DEBUG_LOG("JazzyIndex::find_upper_bound: Found upper bound at index %zu (scanned forward)", result_idx);
-            return ptr;
         }
+        build_run_table();
+        build_filter();
+        choose_query_path();
+        timings_.finalize_ns = detail::nanoseconds_since(finalize_start);
+    }
 
-        // Otherwise, use binary search in a local range
-        std::size_t search_radius = seg->max_error + detail::SEARCH_RADIUS_MARGIN;
-        const T* search_begin = (ptr >= base_ + search_radius) ? (ptr - search_radius) : base_;
-        const T* search_end = std::min(end, ptr + search_radius + 1);
+    // Hash every key into the filter and empty the cache (no-ops without those policies)
+    void build_filter() {
+        if constexpr (UsesFilter) {
+            filter_.build(size_, Options::filter_type::bits_per_key, [this](std::size_t i) {
+                return detail::filter_hash(std::invoke(key_extract_, base_[i]));
+            });
+        }
+        cache_.clear();
+    }
 
-        const T* result = std::upper_bound(search_begin, search_end, value, comp_);
-        DEBUG_LOG("JazzyIndex::find_upper_bound: Binary search result at index %zu",
-                  static_cast<std::size_t>(result - base_));
-        return result;
+    // QueryPath::LINEAR_UNIFORM when every lookup routes in O(1) and predicts with a line
+    void choose_query_path() {
+        bool linear = is_uniform_ && size_ > 0;
+        for (std::size_t i = 0; linear && i < num_segments_; ++i) {
+            linear = segments_[i].model_type == detail::ModelType::LINEAR;
+        }
+        query_path_ = linear ? QueryPath::LINEAR_UNIFORM : QueryPath::GENERAL;
+        DEBUG_LOG("JazzyIndex::choose_query_path: %s", linear ? "LINEAR_UNIFORM" : "GENERAL");
     }
 
-    [[nodiscard]] std::size_t size() const noexcept { return size_; }
-    [[nodiscard]] std::size_t num_segments() const noexcept { return num_segments_; }
-    [[nodiscard]] bool is_built() const noexcept { return base_ != nullptr; }
+    // Record every run of at least MIN_TABLED_RUN equivalent keys that crosses a segment boundary.
+    // Routing sends a query for such a key to a segment whose max key it is, and the run's far end
+    // lies outside that segment's search window; the table answers it without galloping.
+    void build_run_table() {
+        const T* end = base_ + size_;
+        for (std::size_t i = 0; i + 1 < num_segments_; ++i) {
+            const std::size_t boundary = segments_[i].end_idx;  // First key of segment i + 1
+            if (boundary == 0 || boundary >= size_ || (!runs_.empty() && runs_.back().last > boundary)) {
+                continue;
+            }
+            const T& key = base_[boundary - 1];
+            if (comp_(key, base_[boundary])) {
+                continue;
+            }
+            // One-key windows either side of the boundary: windowed_search gallops to the run's ends
+            const T* first = detail::windowed_search<false>(base_, end, base_ + boundary - 1, base_ + boundary, key, comp_);
+            const T* last = detail::windowed_search<true>(base_, end, base_ + boundary, base_ + boundary + 1, key, comp_);
+            if (static_cast<std::size_t>(last - first) >= detail::MIN_TABLED_RUN) {
+                runs_.push_back(detail::KeyRun{static_cast<std::size_t>(first - base_),
+                                               static_cast<std::size_t>(last - base_)});
+            }
+        }
+        runs_.shrink_to_fit();
+        DEBUG_LOG("JazzyIndex::build_run_table: %zu runs of at least %zu keys", runs_.size(), detail::MIN_TABLED_RUN);
+    }
 
-    // Parallel build API - requires #include "jazzy_index_parallel.hpp"
-    // Prepare independent build tasks for custom threading model
-    std::vector<parallel::BuildTask<T, Compare, KeyExtractor>>
-    prepare_build_tasks(const T* first, const T* last,
-                       Compare comp = Compare{},
-                       KeyExtractor key_extract = KeyExtractor{});
+    // The tabled run holding the last key of seg, when that key is equivalent to value
+    [[nodiscard]] const detail::KeyRun* tabled_run(const SegmentType& seg, const T& value) const {
+        if (runs_.empty()) {
+            return nullptr;
+        }
+        const Bound& max_key = segments_.max_key(static_cast<std::size_t>(&seg - segments_.data()));
+        const auto& bound = bound_of(value);
+        if (comp_(max_key, bound) || comp_(bound, max_key)) {
+            return nullptr;
+        }
+        const std::size_t tail = seg.end_idx - 1;
+        const auto it = std::upper_bound(runs_.begin(), runs_.end(), tail,
+                                         [](std::size_t pos, const detail::KeyRun& run) { return pos < run.first; });
+        if (it == runs_.begin() || tail >= std::prev(it)->last) {
+            return nullptr;
+        }
+        return &*std::prev(it);
+    }
 
-    // Finalize build after executing tasks
-    void finalize_build(const std::vector<detail::SegmentAnalysis<T>>& results);
+    // O(1) segment guess for uniform data (caller must verify the segment bounds)
+    [[nodiscard]] std::size_t uniform_segment_index(const T& value) const noexcept {
+        const double key_val = static_cast<double>(std::invoke(key_extract_, value));
+        const double min_key = static_cast<double>(std::invoke(key_extract_, min_));
+        const double offset = key_val - min_key;
+        std::size_t seg_idx = static_cast<std::size_t>(offset * segment_scale_);
 
-    // Parallel build using std::async (convenience method)
-    void build_parallel(const T* first, const T* last,
-                       Compare comp = Compare{},
-                       KeyExtractor key_extract = KeyExtractor{});
+        DEBUG_LOG("find_segment: UNIFORM path - key_val=%.4f, offset=%.4f, segment_scale=%.6f, seg_idx=%zu",
+                  key_val, offset, segment_scale_, seg_idx);
 
-    // Iterator-based parallel build method
-    template <typename Iterator>
-        requires std::random_access_iterator<Iterator> &&
-                 std::contiguous_iterator<Iterator> &&
-                 (!std::is_pointer_v<Iterator>) &&
-                 std::same_as<typename std::iterator_traits<Iterator>::value_type, T>
-    void build_parallel(Iterator first, Iterator last, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
-        // Convert contiguous iterators to pointers for internal use
-        build_parallel(std::to_address(first), std::to_address(last), comp, key_extract);
+        // Clamp to valid range
+        if (seg_idx >= num_segments_) {
+            seg_idx = num_segments_ - 1;
+            DEBUG_LOG("find_segment: Clamped seg_idx to %zu", seg_idx);
+        }
+        return seg_idx;
     }
 
-    // Friend declarations
-    template <typename U, SegmentCount S, typename C, typename K>
-    friend std::string export_index_metadata(const JazzyIndex<U, S, C, K>& index);
+    // Predict position with the segment's model, clamped to the segment bounds
+    [[nodiscard]] std::size_t predict_index(const SegmentType& seg, const T& value) const {
+        std::size_t predicted = 0;
+        if constexpr (SegmentStore::RELATIVE_MODELS) {
+            predicted = segments_.predict(seg, std::invoke(key_extract_, value));
+        } else {
+            predicted = seg.predict(value, key_extract_);
+        }
+        return detail::clamp_value<std::size_t>(predicted, seg.start_idx,
+                                                seg.end_idx > 0 ? seg.end_idx - 1 : 0);
+    }
 
-    template <typename U, SegmentCount S, typename C, typename K>
-    friend class parallel::ParallelBuilder;
+    // value as the segment tables store it: the record itself, or its extracted key
+    [[nodiscard]] decltype(auto) bound_of(const T& value) const {
+        if constexpr (std::is_same_v<Bound, T>) {
+            return (value);
+        } else {
+            return static_cast<Bound>(std::invoke(key_extract_, value));
+        }
+    }
 
-private:
+    // Numeric key of a segment bound (for the batch tables)
+    [[nodiscard]] double bound_key(const Bound& bound) const {
+        if constexpr (std::is_same_v<Bound, T>) {
+            return static_cast<double>(std::invoke(key_extract_, bound));
+        } else {
+            return static_cast<double>(bound);
+        }
+    }
 
-    [[nodiscard]] const detail::Segment<T>* find_segment(const T& value) const noexcept {
+    [[nodiscard]] const SegmentType* find_segment(const T& value) const noexcept {
         DEBUG_LOG("find_segment: Called with is_uniform=%d, num_segments=%zu", is_uniform_, num_segments_);
 
         if (num_segments_ == 0) {
@@ -1094,23 +3190,15 @@ private:
 
         // Fast path: O(1) arithmetic lookup for uniform data
         if (is_uniform_) {
-            const double key_val = static_cast<double>(std::invoke(key_extract_, value));
-            const double min_key = static_cast<double>(std::invoke(key_extract_, min_));
-            const double offset = key_val - min_key;
-            std::size_t seg_idx = static_cast<std::size_t>(offset * segment_scale_);
-
-            DEBUG_LOG("find_segment: UNIFORM path - key_val=%.4f, offset=%.4f, segment_scale=%.6f, seg_idx=%zu",
-                      key_val, offset, segment_scale_, seg_idx);
-
-            // Clamp to valid range
-            if (seg_idx >= num_segments_) {
-                seg_idx = num_segments_ - 1;
-                DEBUG_LOG("find_segment: Clamped seg_idx to %zu", seg_idx);
-            }
+            const std::size_t seg_idx = uniform_segment_index(value);
 
             // Verify we got the right segment (should always be true for uniform data)
             const auto& seg = segments_[seg_idx];
-            if (!comp_(value, seg.min_val) && !comp_(seg.max_val, value)) {
+            const bool owned = segments_.owns(seg_idx, bound_of(value), comp_);
+            if constexpr (CollectsStats) {
+                stats_.record_route(owned);
+            }
+            if (owned) {
                 DEBUG_LOG("find_segment: UNIFORM succeeded, returning segment %zu [%zu-%zu]",
                           seg_idx, seg.start_idx, seg.end_idx);
                 return &seg;
@@ -1119,45 +3207,240 @@ private:
             DEBUG_LOG("find_segment: UNIFORM verification failed, falling back to binary search");
             // Fallback to binary search if arithmetic failed (rare)
         }
+        return search_segments(value);
+    }
+
+    // Segment routing without the O(1) uniform guess: the first segment whose max key is not
+    // ordered before value (the last segment when there is none)
+    [[nodiscard]] const SegmentType* search_segments(const T& value) const noexcept {
+        if constexpr (std::is_same_v<Routing, routing::Eytzinger>) {
+            // Slow path: branchless descent of the Eytzinger-ordered max keys for skewed data
+            DEBUG_LOG("find_segment: Using Eytzinger binary search (non-uniform or fallback)");
+            const std::size_t seg_idx = router_.lower_bound(bound_of(value), comp_);
+            DEBUG_LOG("find_segment: Found segment %zu [%zu-%zu]", seg_idx,
+                      segments_[seg_idx].start_idx, segments_[seg_idx].end_idx);
+            return segments_.data() + seg_idx;
+        } else {
+            // Slow path: Binary search through segments for skewed data
+            // Returns the first segment whose max is not less than value, so keys equal to a
+            // boundary shared by several segments always resolve to the same (leftmost) segment
+            // (the last segment catches keys past the end, so it never needs probing)
+            DEBUG_LOG("find_segment: Using binary search (non-uniform or fallback)");
+            decltype(auto) bound = bound_of(value);
+            std::size_t left = 0;
+            std::size_t right = num_segments_ - 1;
+            int iterations = 0;
+
+            while (left < right) {
+                const std::size_t mid = left + (right - left) / 2;
+                ++iterations;
+
+                DEBUG_LOG("find_segment: Binary search iter %d - left=%zu, mid=%zu, right=%zu",
+                          iterations, left, mid, right);
+
+                if (comp_(segments_.max_key(mid), bound)) {
+                    DEBUG_LOG("find_segment: Value > seg[%zu].max, searching right", mid);
+                    left = mid + 1;
+                } else {
+                    DEBUG_LOG("find_segment: Value <= seg[%zu].max, searching left", mid);
+                    right = mid;
+                }
+            }
 
-        // Slow path: Binary search through segments for skewed data
-        DEBUG_LOG("find_segment: Using binary search (non-uniform or fallback)");
-        std::size_t left = 0;
-        std::size_t right = num_segments_;
-        int iterations = 0;
+            DEBUG_LOG("find_segment: Found segment %zu [%zu-%zu]", left, segments_[left].start_idx, segments_[left].end_idx);
+            return segments_.data() + left;
+        }
+    }
 
-        while (left < right) {
-            const std::size_t mid = left + (right - left) / 2;
-            ++iterations;
+    // Segment of value and the clamped prediction in it ({nullptr, 0} for an empty index)
+    [[nodiscard]] std::pair<const SegmentType*, std::size_t> locate(const T& value) const {
+        if (query_path_ == QueryPath::LINEAR_UNIFORM) {
+            return locate_linear_uniform(value);
+        }
+        const SegmentType* seg = find_segment(value);
+        if (seg == nullptr) {
+            return {nullptr, 0};
+        }
+        return {seg, predict_index(*seg, value)};
+    }
+
+    // locate() on QueryPath::LINEAR_UNIFORM: the O(1) segment guess, searched for only when
+    // verification fails, and the segment's line evaluated without the model switch. The
+    // compressed layout evaluates every model the same way, so it keeps its own prediction
+    [[nodiscard]] std::pair<const SegmentType*, std::size_t> locate_linear_uniform(const T& value) const {
+        DEBUG_LOG("find_segment: Called with is_uniform=%d, num_segments=%zu (linear-uniform path)",
+                  is_uniform_, num_segments_);
+        const std::size_t seg_idx = uniform_segment_index(value);
+        const bool owned = segments_.owns(seg_idx, bound_of(value), comp_);
+        if constexpr (CollectsStats) {
+            stats_.record_route(owned);
+        }
+        const SegmentType* seg = owned ? segments_.data() + seg_idx : search_segments(value);
+        DEBUG_LOG("find_segment: UNIFORM %s, returning segment %zu [%zu-%zu]",
+                  owned ? "succeeded" : "verification failed", static_cast<std::size_t>(seg - segments_.data()),
+                  seg->start_idx, seg->end_idx);
+        if constexpr (SegmentStore::RELATIVE_MODELS) {
+            return {seg, predict_index(*seg, value)};
+        } else {
+            const double key_val = static_cast<double>(std::invoke(key_extract_, value));
+            return {seg, detail::clamp_value<std::size_t>(seg->predict_linear(key_val), seg->start_idx,
+                                                          seg->end_idx - 1)};
+        }
+    }
 
-            DEBUG_LOG("find_segment: Binary search iter %d - left=%zu, mid=%zu, right=%zu",
-                      iterations, left, mid, right);
+    // Whether key is ordered before the first key or after the last (index must not be empty)
+    [[nodiscard]] bool outside_keys(const T& key) const {
+        if constexpr (PlainIntegerKeys) {
+            using Unsigned = std::make_unsigned_t<T>;
+            const auto offset = static_cast<Unsigned>(static_cast<Unsigned>(key) - static_cast<Unsigned>(base_[0]));
+            const auto span = static_cast<Unsigned>(static_cast<Unsigned>(base_[size_ - 1]) -
+                                                    static_cast<Unsigned>(base_[0]));
+            return offset > span;
+        } else {
+            return comp_(key, base_[0]) || comp_(base_[size_ - 1], key);
+        }
+    }
 
-            if (comp_(value, segments_[mid].min_val)) {
-                DEBUG_LOG("find_segment: Value < seg[%zu].min, searching left", mid);
-                right = mid;
-            } else if (comp_(segments_[mid].max_val, value)) {
-                DEBUG_LOG("find_segment: Value > seg[%zu].max, searching right", mid);
+    // find_segment for a value not ordered before any key of segment from, such as the end of a
+    // range starting there: gallops forward over the segment max keys (1, 2, 4, ... segments), then
+    // binary searches the last step. Uniform indexes compute the segment directly instead
+    [[nodiscard]] const SegmentType* find_segment_from(std::size_t from, const T& value) const noexcept {
+        if (is_uniform_) {
+            return find_segment(value);
+        }
+        decltype(auto) bound = bound_of(value);
+        const std::size_t last = num_segments_ - 1;
+        std::size_t left = from;
+        std::size_t right = from;
+        for (std::size_t step = 1; right < last && comp_(segments_.max_key(right), bound); step *= 2) {
+            left = right + 1;
+            right = std::min(last, right + step);
+        }
+        while (left < right) {
+            const std::size_t mid = left + (right - left) / 2;
+            if (comp_(segments_.max_key(mid), bound)) {
                 left = mid + 1;
             } else {
-                // value is within this segment
-                DEBUG_LOG("find_segment: Found segment %zu [%zu-%zu]", mid, segments_[mid].start_idx, segments_[mid].end_idx);
-                return &segments_[mid];
+                right = mid;
+            }
+        }
+        DEBUG_LOG("find_segment_from: Segment %zu from %zu", left, from);
+        return segments_.data() + left;
+    }
+
+    // Keys within the segment's error window (plus margin) of a prediction, clipped to the segment
+    [[nodiscard]] std::pair<const T*, const T*> search_window(const SegmentType& seg, std::size_t predicted) const {
+        const std::size_t radius = seg.max_error + detail::SEARCH_RADIUS_MARGIN;
+        const std::size_t lo = predicted - seg.start_idx > radius ? predicted - radius : seg.start_idx;
+        const std::size_t hi = std::min<std::size_t>(predicted + radius + 1, seg.end_idx);
+        DEBUG_LOG("JazzyIndex: Search window [%zu-%zu) max_radius: %zu (segment_start=%zu, segment_end=%zu)",
+                  lo, hi, radius, seg.start_idx, seg.end_idx);
+        return {base_ + lo, base_ + hi};
+    }
+
+    // Last-mile search around a predicted position for the bound of value (see detail::windowed_search).
+    // An exact prediction, the common case for well-fitted segments, costs two comparisons: the
+    // lower bound of a present key is its predicted slot, and the upper bound the slot after it.
+    template <bool Upper>
+    [[nodiscard]] const_iterator search_bound(const SegmentType& seg, std::size_t predicted, const T& value) const {
+        if (const detail::KeyRun* run = tabled_run(seg, value)) {
+            DEBUG_LOG("JazzyIndex: Bound from run table [%zu-%zu)", run->first, run->last);
+            if constexpr (CollectsStats) {
+                stats_.record_run_table(static_cast<std::size_t>(&seg - segments_.data()));
+            }
+            return base_ + (Upper ? run->last : run->first);
+        }
+        const T* end = base_ + size_;
+        const T* guess = base_ + predicted + (Upper ? 1 : 0);
+        if ((guess == end || !detail::before_bound<Upper>(*guess, value, comp_)) &&
+            (guess == base_ || detail::before_bound<Upper>(*(guess - 1), value, comp_))) {
+            DEBUG_LOG("JazzyIndex: Bound at predicted index %zu", predicted);
+            record_search(seg, guess, guess, guess, guess);
+            return guess;
+        }
+        const auto [lo, hi] = search_window(seg, predicted);
+        const T* result = detail::windowed_search<Upper>(base_, end, lo, hi, value, comp_);
+        record_search(seg, guess, result, lo, hi);
+        return result;
+    }
+
+    // find() with a filter:: or cache:: policy. A cached position is used once its key is checked;
+    // otherwise the filter's line is fetched while the key is routed, and a key the filter rejects
+    // returns end() before any key is read. Found keys' positions are cached
+    [[nodiscard]] const_iterator find_accelerated(const T& key) const {
+        const_iterator end = base_ + size_;
+        if (!is_built() || size_ == 0 || outside_keys(key)) {
+            DEBUG_LOG("JazzyIndex::find: Index empty or key out of bounds, returning end()");
+            return end;
+        }
+        const std::uint64_t hash = detail::filter_hash(std::invoke(key_extract_, key));
+        if constexpr (UsesCache) {
+            const std::size_t cached = cache_.get(hash);
+            if (cached != 0 && cached <= size_ && are_equivalent(base_[cached - 1], key)) {
+                DEBUG_LOG("JazzyIndex::find: Cached at index %zu", cached - 1);
+                return base_ + (cached - 1);
             }
         }
+        const auto probe = filter_.prepare(hash);
+        const auto [seg, predicted] = locate(key);
+        if (!filter_.may_contain(probe)) {
+            DEBUG_LOG("JazzyIndex::find: Rejected by the filter, returning end()");
+            return end;
+        }
+        const_iterator found = search_exact(*seg, predicted, key);
+        if (found != end) {
+            cache_.put(hash, static_cast<std::size_t>(found - base_));
+        }
+        return found;
+    }
 
-        // Edge case: if we're past all segments, return last segment
-        if (left > 0 && left >= num_segments_) {
-            DEBUG_LOG("find_segment: Past all segments, returning last segment %zu", num_segments_ - 1);
-            return &segments_[num_segments_ - 1];
+    // Last-mile search around a predicted position for an exact match. Any equivalent element will
+    // do, so a hit at the prediction returns at once even inside a run of duplicates.
+    [[nodiscard]] const_iterator search_exact(const SegmentType& seg, std::size_t predicted, const T& key) const {
+        const_iterator end = base_ + size_;
+        const T* guess = base_ + predicted;
+        if (are_equivalent(*guess, key)) {
+            DEBUG_LOG("JazzyIndex::find: Found exact match at predicted index %zu", predicted);
+            record_search(seg, guess, guess, guess, guess);
+            return guess;
         }
+        const auto [lo, hi] = search_window(seg, predicted);
+        const T* result = detail::windowed_search<false>(base_, end, lo, hi, key, comp_);
+        record_search(seg, guess, result, lo, hi);
+        if (result != end && !comp_(key, *result)) {
+            DEBUG_LOG("JazzyIndex::find: Found exact match at index %zu (predicted %zu)",
+                      static_cast<std::size_t>(result - base_), predicted);
+            return result;
+        }
+        DEBUG_LOG("JazzyIndex::find: Not found, returning end()");
+        return end;
+    }
+
+    // Last-mile search around a predicted position for the first element not less than value
+    [[nodiscard]] const_iterator search_lower_bound(const SegmentType& seg, std::size_t predicted_index,
+                                                    const T& value) const {
+        const T* result = search_bound<false>(seg, predicted_index, value);
+        DEBUG_LOG("JazzyIndex::find_lower_bound: Lower bound at index %zu", static_cast<std::size_t>(result - base_));
+        return result;
+    }
 
-        DEBUG_LOG("find_segment: Returning segment %zu or nullptr (left=%zu)", left, left);
-        return left < num_segments_ ? &segments_[left] : nullptr;
+    // Last-mile search around a predicted position for the first element greater than value
+    [[nodiscard]] const_iterator search_upper_bound(const SegmentType& seg, std::size_t predicted_index,
+                                                    const T& value) const {
+        const T* result = search_bound<true>(seg, predicted_index, value);
+        DEBUG_LOG("JazzyIndex::find_upper_bound: Upper bound at index %zu", static_cast<std::size_t>(result - base_));
+        return result;
     }
 
-    [[nodiscard]] bool equal(const T& lhs, const T& rhs) const {
-        return !comp_(lhs, rhs) && !comp_(rhs, lhs);
+    // Count a last-mile search in seg that answered result for a prediction of guess, searching the
+    // window [lo, hi] first (no-op unless CollectsStats)
+    void record_search(const SegmentType& seg, const T* guess, const T* result, const T* lo,
+                       const T* hi) const noexcept {
+        if constexpr (CollectsStats) {
+            const auto error = static_cast<std::size_t>(result > guess ? result - guess : guess - result);
+            const auto gallop = static_cast<std::size_t>(result < lo ? lo - result : result > hi ? result - hi : 0);
+            stats_.record_search(static_cast<std::size_t>(&seg - segments_.data()), error, gallop);
+        }
     }
 
     // Check if two values are equivalent according to the comparator
@@ -1173,8 +3456,30 @@ private:
     Compare comp_{};
     std::size_t num_segments_{0};
     bool is_uniform_{false};
+    QueryPath query_path_{QueryPath::GENERAL};
     double segment_scale_{0.0};
-    std::array<detail::Segment<T>, NumSegments> segments_{};
+    std::optional<std::size_t> error_bound_{};  // Set by error-bounded builds
+    SegmentSizing sizing_{};                     // Used by runtime-sized indexes only
+    BuildConfig config_{};                       // Model selection for every build and rebuild
+    BuildTimings timings_{};                     // Phases of the last build (index_stats())
+    SegmentStore segments_{};
+    detail::SegmentRouter<Bound, NumSegments, Routing> router_{};
+    // Dense copies of segment max keys and models for the vector batch kernels
+    alignas(64) detail::SegmentArray<double, NumSegments> batch_bounds_{};
+    // (unused by layouts with relative models, which the store evaluates)
+    alignas(64) std::conditional_t<SegmentStore::RELATIVE_MODELS && !IsDynamic, std::array<detail::PackedModel, 0>,
+                                   detail::SegmentArray<detail::PackedModel, NumSegments>> batch_models_{};
+    detail::SegmentArray<detail::KeyRun, 0> runs_{};  // Sorted by position; heap-allocated only when runs exist
+    [[no_unique_address]] mutable std::conditional_t<CollectsStats, detail::StatsCollector, detail::NoStats> stats_{};
+    [[no_unique_address]] FilterType filter_{};
+    [[no_unique_address]] CacheType cache_{};
 };
 
+// Runtime-sized JazzyIndex: the segment count is chosen by each build (from the data size, or by
+// build_error_bounded from the error target) and segment storage lives in a pmr memory resource,
+// so an index over a few keys costs a few hundred bytes instead of a fixed inline array
+template <typename T, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity,
+          typename Options = IndexOptions<>>
+using DynamicJazzyIndex = JazzyIndex<T, SegmentCount::DYNAMIC, Compare, KeyExtractor, Options>;
+
 }  // namespace jazzy
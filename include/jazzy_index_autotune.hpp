@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "jazzy_index.hpp"
+
+namespace jazzy {
+namespace detail {
+
+inline constexpr std::size_t AUTOTUNE_MIN_SEGMENTS = 16;
+// Default segment counts tried by autotune: powers of two from here up to MAX_SEGMENTS
+
+}  // namespace detail
+
+// Candidates and budget for autotune. Empty lists take the defaults: segment counts in powers of
+// two from 16 to 4096 (no more than the key count) and the linear_only, default and
+// prefer_cubic configs
+struct TuningOptions {
+    std::vector<std::size_t> segment_counts{};
+    std::vector<BuildConfig> configs{};
+    std::size_t rounds = 3;  // Each trial's queries are timed this many times; the fastest round counts
+    std::size_t max_memory_bytes = std::numeric_limits<std::size_t>::max();  // JazzyIndex::memory_usage
+};
+
+// One measured candidate: a DynamicJazzyIndex built with sizing and config
+struct TuningTrial {
+    SegmentSizing sizing{};
+    BuildConfig config{};
+    std::size_t num_segments = 0;  // Segments the build used
+    std::size_t memory_bytes = 0;
+    double ns_per_query = 0.0;
+};
+
+// The fastest trial within the memory budget (the smallest one if none fits), and every trial
+// in the order run
+struct TuningResult {
+    TuningTrial best{};
+    std::vector<TuningTrial> trials{};
+};
+
+// Build a DynamicJazzyIndex over the sorted keys for every segment count and config in options,
+// time find() over the query sample on each, and pick the fastest. Build with the result as
+//     DynamicJazzyIndex<T, ...> index(result.best.sizing);
+//     index.set_build_config(result.best.config);
+// The timings are wall-clock and only as steady as the machine running them; pass the queries
+// in the order the service sees them, since that decides how much of the index stays cached
+template <typename T, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity,
+          typename Options = IndexOptions<>>
+[[nodiscard]] TuningResult autotune(std::span<const T> keys, std::span<const T> queries,
+                                    const TuningOptions& options = TuningOptions{}, Compare comp = Compare{},
+                                    KeyExtractor key_extract = KeyExtractor{}) {
+    if (keys.empty() || queries.empty()) {
+        throw std::invalid_argument("autotune needs at least one key and one query");
+    }
+    if (options.rounds == 0) {
+        throw std::invalid_argument("TuningOptions::rounds must be at least 1");
+    }
+
+    std::vector<std::size_t> segment_counts = options.segment_counts;
+    if (segment_counts.empty()) {
+        for (std::size_t count = detail::AUTOTUNE_MIN_SEGMENTS; count <= detail::MAX_SEGMENTS; count *= 2) {
+            segment_counts.push_back(std::min(count, keys.size()));
+        }
+        segment_counts.erase(std::unique(segment_counts.begin(), segment_counts.end()), segment_counts.end());
+    }
+    for (const std::size_t count : segment_counts) {
+        if (count == 0 || count > detail::MAX_SEGMENTS) {
+            throw std::invalid_argument("TuningOptions::segment_counts must be in range [1, 4096]");
+        }
+    }
+    std::vector<BuildConfig> configs = options.configs;
+    if (configs.empty()) {
+        configs = {BuildConfig::linear_only(), BuildConfig{}, BuildConfig::prefer_cubic()};
+    }
+    for (const BuildConfig& config : configs) {
+        config.validate();
+    }
+
+    TuningResult result;
+    result.trials.reserve(segment_counts.size() * configs.size());
+    std::size_t hits = 0;
+    for (const std::size_t count : segment_counts) {
+        const SegmentSizing sizing{(keys.size() + count - 1) / count, count};
+        for (const BuildConfig& config : configs) {
+            DynamicJazzyIndex<T, Compare, KeyExtractor, Options> index(sizing);
+            index.set_build_config(config);
+            index.build(keys.data(), keys.data() + keys.size(), comp, key_extract);
+
+            auto fastest = std::chrono::steady_clock::duration::max();
+            for (std::size_t round = 0; round < options.rounds; ++round) {
+                const auto start = std::chrono::steady_clock::now();
+                for (const T& query : queries) {
+                    hits += index.find(query) != keys.data() + keys.size() ? 1 : 0;
+                }
+                fastest = std::min(fastest, std::chrono::steady_clock::now() - start);
+            }
+
+            TuningTrial trial{sizing, config, index.num_segments(), index.memory_usage(),
+                              std::chrono::duration<double, std::nano>(fastest).count() /
+                                  static_cast<double>(queries.size())};
+            DEBUG_LOG("autotune: %zu segments, model limit %d: %.1f ns/query, %zu bytes", trial.num_segments,
+                      static_cast<int>(config.model_limit), trial.ns_per_query, trial.memory_bytes);
+            result.trials.push_back(trial);
+        }
+    }
+    volatile std::size_t sink = hits;  // Keeps the lookups from being optimized out
+    static_cast<void>(sink);
+
+    const auto fits = [&options](const TuningTrial& trial) { return trial.memory_bytes <= options.max_memory_bytes; };
+    const auto within_budget = std::find_if(result.trials.begin(), result.trials.end(), fits);
+    if (within_budget == result.trials.end()) {
+        result.best = *std::min_element(result.trials.begin(), result.trials.end(),
+                                        [](const TuningTrial& a, const TuningTrial& b) {
+                                            return a.memory_bytes < b.memory_bytes;
+                                        });
+        return result;
+    }
+    result.best = *within_budget;
+    for (const TuningTrial& trial : result.trials) {
+        if (fits(trial) && trial.ns_per_query < result.best.ns_per_query) {
+            result.best = trial;
+        }
+    }
+    return result;
+}
+
+}  // namespace jazzy
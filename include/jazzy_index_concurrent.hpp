@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_parallel.hpp"  // JazzyIndex::build_parallel
+
+namespace jazzy {
+namespace detail {
+
+// Reader slots per EpochDomain: at most this many snapshots can be held at once (a reader that
+// finds every slot taken spins until one is released)
+inline constexpr std::size_t EPOCH_READER_SLOTS = 256;
+
+// Epoch-based reclamation. A reader pins itself by writing the current global epoch into a free
+// slot before it loads the published pointer, and clears the slot when done. A writer swaps the
+// pointer first and then advances the epoch; the old object is retired with the new epoch and may
+// be freed once every pinned slot shows that epoch or later, because such readers loaded the
+// pointer after the swap. Readers never block; only writers take a lock.
+class EpochDomain {
+public:
+    // Claim a slot (starting at this thread's last one) and return its index
+    [[nodiscard]] std::size_t pin() noexcept {
+        thread_local std::size_t hint = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        for (;;) {
+            for (std::size_t i = 0; i < EPOCH_READER_SLOTS; ++i) {
+                const std::size_t slot = (hint + i) % EPOCH_READER_SLOTS;
+                std::uint64_t expected = IDLE;
+                if (slots_[slot].epoch.compare_exchange_strong(expected, global_.load())) {
+                    hint = slot;
+                    return slot;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void unpin(std::size_t slot) noexcept { slots_[slot].epoch.store(IDLE, std::memory_order_release); }
+
+    // Advance the epoch after a pointer swap; objects unlinked before the call retire with the result
+    [[nodiscard]] std::uint64_t advance() noexcept { return global_.fetch_add(1) + 1; }
+
+    // Objects retired with an epoch no later than this are unreachable by every reader
+    [[nodiscard]] std::uint64_t safe_epoch() const noexcept {
+        std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+        for (const Slot& slot : slots_) {
+            const std::uint64_t epoch = slot.epoch.load();
+            if (epoch != IDLE) {
+                oldest = std::min(oldest, epoch);
+            }
+        }
+        return oldest;
+    }
+
+private:
+    static constexpr std::uint64_t IDLE = 0;  // The global epoch starts at 1, so 0 never names one
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> epoch{IDLE};
+    };
+
+    alignas(64) std::atomic<std::uint64_t> global_{1};
+    std::array<Slot, EPOCH_READER_SLOTS> slots_{};
+};
+
+}  // namespace detail
+
+// Readers query while writers rebuild. Each rebuild builds a fresh JazzyIndex over a key snapshot
+// it takes ownership of, off to the side, and publishes it with one atomic pointer swap. Readers
+// pin an epoch and load the pointer: no lock, and never a half-built segment table. Replaced
+// versions are freed once no reader can still hold them (see detail::EpochDomain).
+template <typename T, SegmentCount Segments = SegmentCount::LARGE, typename Compare = std::less<>,
+          typename KeyExtractor = jazzy::identity, typename Options = IndexOptions<>>
+class ConcurrentJazzyIndex {
+public:
+    using index_type = JazzyIndex<T, Segments, Compare, KeyExtractor, Options>;
+
+private:
+    struct Version {
+        std::vector<T> keys;
+        index_type index;
+        std::uint64_t number = 0;
+    };
+
+public:
+    // A pinned version: its index and keys stay valid until the snapshot is destroyed, whatever
+    // is published meanwhile. Hold it only as long as a query needs it, since it delays reclamation.
+    class Snapshot {
+    public:
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        Snapshot(Snapshot&& other) noexcept
+            : domain_(std::exchange(other.domain_, nullptr)), slot_(other.slot_), version_(other.version_) {}
+
+        Snapshot& operator=(Snapshot&& other) noexcept {
+            if (this != &other) {
+                release();
+                domain_ = std::exchange(other.domain_, nullptr);
+                slot_ = other.slot_;
+                version_ = other.version_;
+            }
+            return *this;
+        }
+
+        ~Snapshot() { release(); }
+
+        [[nodiscard]] const index_type& operator*() const noexcept { return version_->index; }
+        [[nodiscard]] const index_type* operator->() const noexcept { return &version_->index; }
+        [[nodiscard]] const index_type& index() const noexcept { return version_->index; }
+        [[nodiscard]] std::span<const T> keys() const noexcept { return version_->keys; }
+
+        // 0 before the first publish, then 1, 2, ... in publish order
+        [[nodiscard]] std::uint64_t version() const noexcept { return version_->number; }
+
+    private:
+        friend class ConcurrentJazzyIndex;
+
+        Snapshot(detail::EpochDomain& domain, std::size_t slot, const Version* version) noexcept
+            : domain_(&domain), slot_(slot), version_(version) {}
+
+        void release() noexcept {
+            if (domain_ != nullptr) {
+                domain_->unpin(slot_);
+                domain_ = nullptr;
+            }
+        }
+
+        detail::EpochDomain* domain_;
+        std::size_t slot_;
+        const Version* version_;
+    };
+
+    ConcurrentJazzyIndex() : current_(new Version{}) {}
+
+    ConcurrentJazzyIndex(const ConcurrentJazzyIndex&) = delete;
+    ConcurrentJazzyIndex& operator=(const ConcurrentJazzyIndex&) = delete;
+
+    // No snapshot may outlive the index
+    ~ConcurrentJazzyIndex() {
+        delete current_.load();
+        for (const Retired& retired : retired_) {
+            delete retired.version;
+        }
+    }
+
+    [[nodiscard]] Snapshot snapshot() const noexcept {
+        const std::size_t slot = domain_.pin();
+        return Snapshot(domain_, slot, current_.load());
+    }
+
+    [[nodiscard]] bool contains(const T& key) const {
+        const Snapshot snap = snapshot();
+        return snap->find(key) != snap.keys().data() + snap.keys().size();
+    }
+
+    // Build over keys (sorted; the index takes ownership) on the calling thread, then publish
+    void rebuild(std::vector<T> keys, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
+        publish(std::move(keys), [&](index_type& index, const T* first, const T* last) {
+            index.build(first, last, comp, key_extract);
+        });
+    }
+
+    // As rebuild, with the segment analysis spread over executor
+    template <parallel::Executor Exec>
+    void rebuild_parallel(std::vector<T> keys, Exec& executor, Compare comp = Compare{},
+                          KeyExtractor key_extract = KeyExtractor{}) {
+        publish(std::move(keys), [&](index_type& index, const T* first, const T* last) {
+            index.build_parallel(first, last, executor, comp, key_extract);
+        });
+    }
+
+    // Run build(index, first, last) over keys on a fresh index, then publish it. Builds run
+    // concurrently with readers and with other writers; only the swap itself is serialized. If
+    // build throws, nothing is published.
+    template <typename BuildFn>
+    void publish(std::vector<T> keys, BuildFn&& build) {
+        auto* next = new Version{};
+        next->keys = std::move(keys);
+        try {
+            const T* first = next->keys.data();
+            build(next->index, first, first + next->keys.size());
+        } catch (...) {
+            delete next;
+            throw;
+        }
+
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        next->number = ++published_;
+        Version* previous = current_.exchange(next);
+        retired_.push_back(Retired{previous, domain_.advance()});
+        DEBUG_LOG("ConcurrentJazzyIndex::publish: version %llu (%zu keys), %zu retired",
+                  static_cast<unsigned long long>(next->number), next->keys.size(), retired_.size());
+        reclaim_locked();
+    }
+
+    // Free replaced versions no snapshot can still reach; returns how many remain retired.
+    // publish() does this too, so call it only to release memory between rebuilds.
+    std::size_t reclaim() {
+        std::lock_guard<std::mutex> lock(writer_mutex_);
+        reclaim_locked();
+        return retired_.size();
+    }
+
+    // Number of publishes so far
+    [[nodiscard]] std::uint64_t version() const noexcept { return snapshot().version(); }
+
+private:
+    struct Retired {
+        Version* version;
+        std::uint64_t epoch;
+    };
+
+    void reclaim_locked() {
+        const std::uint64_t safe = domain_.safe_epoch();
+        const auto kept = std::partition(retired_.begin(), retired_.end(),
+                                         [safe](const Retired& r) { return r.epoch > safe; });
+        for (auto it = kept; it != retired_.end(); ++it) {
+            delete it->version;
+        }
+        retired_.erase(kept, retired_.end());
+    }
+
+    std::atomic<Version*> current_;
+    mutable detail::EpochDomain domain_{};
+    std::mutex writer_mutex_{};
+    std::vector<Retired> retired_{};  // Guarded by writer_mutex_
+    std::uint64_t published_{0};      // Guarded by writer_mutex_
+};
+
+}  // namespace jazzy
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "jazzy_index.hpp"
+
+namespace jazzy {
+namespace detail {
+
+inline constexpr std::size_t COROUTINE_FRAME_POOL_CAPACITY = 256;
+// Frames kept per thread for reuse; more than any useful number of lookups in flight
+
+// Recycles coroutine frames of one size per thread: interleaved lookups create and destroy a
+// frame for every key, and going to the allocator each time would cost more than a cache miss.
+// Frames of another size (another lookup kind or key type) are allocated normally
+class CoroutineFramePool {
+public:
+    CoroutineFramePool() { free_.reserve(COROUTINE_FRAME_POOL_CAPACITY); }
+
+    CoroutineFramePool(const CoroutineFramePool&) = delete;
+    CoroutineFramePool& operator=(const CoroutineFramePool&) = delete;
+
+    ~CoroutineFramePool() {
+        for (void* frame : free_) {
+            ::operator delete(frame);
+        }
+    }
+
+    [[nodiscard]] void* allocate(std::size_t bytes) {
+        if (bytes == frame_bytes_ && !free_.empty()) {
+            void* frame = free_.back();
+            free_.pop_back();
+            return frame;
+        }
+        return ::operator new(bytes);
+    }
+
+    void deallocate(void* frame, std::size_t bytes) noexcept {
+        if (free_.empty()) {
+            frame_bytes_ = bytes;  // Follow the size in use
+        }
+        if (bytes == frame_bytes_ && free_.size() < COROUTINE_FRAME_POOL_CAPACITY) {
+            free_.push_back(frame);  // Within the reserved capacity, so it cannot throw
+        } else {
+            ::operator delete(frame);
+        }
+    }
+
+    [[nodiscard]] static CoroutineFramePool& local() {
+        thread_local CoroutineFramePool pool;
+        return pool;
+    }
+
+private:
+    std::vector<void*> free_;
+    std::size_t frame_bytes_{0};
+};
+
+}  // namespace detail
+
+// One lookup run as a coroutine (JazzyIndex::find_async and the bound variants). The lookup
+// starts suspended; every resume() runs it up to its next memory access, which it prefetches
+// before suspending, so a caller can interleave many lookups and overlap their cache misses
+// (interleave_lookups does this round-robin). result() is the lookup's answer once done().
+template <typename T>
+class LookupTask {
+public:
+    struct promise_type {
+        const T* result = nullptr;
+
+        LookupTask get_return_object() noexcept {
+            return LookupTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+        void return_value(const T* value) noexcept { result = value; }
+        void unhandled_exception() { throw; }  // Out of resume(); the lookup is then done
+
+        static void* operator new(std::size_t bytes) { return detail::CoroutineFramePool::local().allocate(bytes); }
+        static void operator delete(void* frame, std::size_t bytes) noexcept {
+            detail::CoroutineFramePool::local().deallocate(frame, bytes);
+        }
+    };
+
+    LookupTask() = default;
+
+    LookupTask(const LookupTask&) = delete;
+    LookupTask& operator=(const LookupTask&) = delete;
+
+    LookupTask(LookupTask&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    LookupTask& operator=(LookupTask&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    ~LookupTask() { destroy(); }
+
+    [[nodiscard]] bool done() const noexcept { return handle_ == nullptr || handle_.done(); }
+
+    // Run the lookup to its next suspension (or its end)
+    void resume() const {
+        if (!done()) {
+            handle_.resume();
+        }
+    }
+
+    // The answer of a finished lookup
+    [[nodiscard]] const T* result() const {
+        if (handle_ == nullptr || !handle_.done()) {
+            throw std::logic_error("LookupTask::result called before the lookup finished");
+        }
+        return handle_.promise().result;
+    }
+
+    // Run the lookup to its end without interleaving it
+    [[nodiscard]] const T* get() const {
+        while (!done()) {
+            handle_.resume();
+        }
+        return result();
+    }
+
+private:
+    explicit LookupTask(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    void destroy() noexcept {
+        if (handle_ != nullptr) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle_{};
+};
+
+// out[i] = the result of make(keys[i]), a LookupTask such as index.find_async(keys[i]), with up to
+// group_size lookups in flight: each is resumed in turn, so one lookup's prefetch has the other
+// lookups' stages to complete behind. A finished lookup's slot takes the next key
+template <std::ranges::random_access_range Keys, typename MakeTask>
+void interleave_lookups(const Keys& keys, std::span<const std::ranges::range_value_t<Keys>*> out,
+                        std::size_t group_size, MakeTask&& make) {
+    using T = std::ranges::range_value_t<Keys>;
+    const auto first = std::ranges::begin(keys);
+    const auto count = static_cast<std::size_t>(std::ranges::size(keys));
+    if (out.size() < count) {
+        throw std::invalid_argument("Batch output span is smaller than the key span");
+    }
+    if (group_size == 0) {
+        throw std::invalid_argument("interleave_lookups needs a group size of at least 1");
+    }
+    std::vector<LookupTask<T>> tasks;
+    std::vector<std::size_t> positions;
+    const std::size_t in_flight = std::min(group_size, count);
+    tasks.reserve(in_flight);
+    positions.reserve(in_flight);
+    std::size_t next = 0;
+    for (; next < in_flight; ++next) {
+        tasks.push_back(make(first[static_cast<std::ptrdiff_t>(next)]));
+        positions.push_back(next);
+    }
+    while (!tasks.empty()) {
+        for (std::size_t slot = 0; slot < tasks.size();) {
+            tasks[slot].resume();
+            if (!tasks[slot].done()) {
+                ++slot;
+                continue;
+            }
+            out[positions[slot]] = tasks[slot].result();
+            if (next < count) {
+                tasks[slot] = make(first[static_cast<std::ptrdiff_t>(next)]);
+                positions[slot] = next++;
+                ++slot;
+            } else {
+                tasks[slot] = std::move(tasks.back());
+                positions[slot] = positions.back();
+                tasks.pop_back();
+                positions.pop_back();
+            }
+        }
+    }
+}
+
+// Stages of a coroutine lookup: route (the segment's line prefetched), predict (the predicted
+// key's line prefetched), then the last-mile search. Routing tables and models are small and
+// usually cached; the segment record and the keys are the misses this hides
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+template <typename JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::BatchOp Op>
+LookupTask<T> JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::lookup_async(T key) const {
+    const_iterator end = base_ + size_;
+    if (num_segments_ == 0 || (Op == BatchOp::FIND && outside_keys(key))) {
+        co_return end;
+    }
+
+    const SegmentType* seg = nullptr;
+    std::size_t predicted = 0;
+    if (is_uniform_) {
+        detail::prefetch_read(segments_.data() + uniform_segment_index(key));
+        co_await std::suspend_always{};
+        std::tie(seg, predicted) = locate(key);
+    } else {
+        seg = find_segment(key);
+        detail::prefetch_read(seg);
+        co_await std::suspend_always{};
+        predicted = predict_index(*seg, key);
+    }
+    DEBUG_LOG("JazzyIndex::lookup_async: Predicted index %zu in segment [%zu-%zu]",
+              predicted, seg->start_idx, seg->end_idx);
+    detail::prefetch_read(base_ + predicted);
+    co_await std::suspend_always{};
+
+    if constexpr (Op == BatchOp::FIND) {
+        co_return search_exact(*seg, predicted, key);
+    } else if constexpr (Op == BatchOp::LOWER_BOUND) {
+        co_return search_lower_bound(*seg, predicted, key);
+    } else {
+        co_return search_upper_bound(*seg, predicted, key);
+    }
+}
+
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+inline LookupTask<T> JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::find_async(T key) const {
+    return lookup_async<BatchOp::FIND>(std::move(key));
+}
+
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+inline LookupTask<T> JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::find_lower_bound_async(T value) const {
+    return lookup_async<BatchOp::LOWER_BOUND>(std::move(value));
+}
+
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+inline LookupTask<T> JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::find_upper_bound_async(T value) const {
+    return lookup_async<BatchOp::UPPER_BOUND>(std::move(value));
+}
+
+}  // namespace jazzy
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "jazzy_index.hpp"  // parallel::Executor concept
+
+namespace jazzy {
+namespace parallel {
+
+// Runs every task on the calling thread (debugging, or builds nested inside an outer parallel loop)
+class InlineExecutor {
+public:
+    [[nodiscard]] std::size_t concurrency() const noexcept { return 1; }
+
+    void bulk_execute(std::size_t count, const std::function<void(std::size_t)>& fn) const {
+        for (std::size_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+    }
+};
+
+// Fixed pool of worker threads with one deque per worker. bulk_execute deals tasks round-robin
+// across the deques; a worker pops its own deque from the back and, once it is empty, steals from
+// the front of the others. The calling thread runs tasks too while it waits, so concurrency() is
+// workers + 1 and bulk_execute may be called from inside a task without deadlocking.
+class ThreadPool {
+public:
+    // Total threads including the caller; the default uses every hardware thread
+    explicit ThreadPool(std::size_t num_threads = std::thread::hardware_concurrency()) {
+        const std::size_t workers = std::max<std::size_t>(num_threads, 1) - 1;
+        queues_.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i) {
+            queues_.push_back(std::make_unique<WorkQueue>());
+        }
+        threads_.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i) {
+            threads_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    [[nodiscard]] std::size_t concurrency() const noexcept { return threads_.size() + 1; }
+
+    // Call fn(i) for every i in [0, count) and return once all calls have finished.
+    // fn must not throw (ParallelBuilder captures exceptions inside its tasks)
+    void bulk_execute(std::size_t count, const std::function<void(std::size_t)>& fn) {
+        if (count == 0) {
+            return;
+        }
+        if (queues_.empty() || count == 1) {
+            InlineExecutor{}.bulk_execute(count, fn);
+            return;
+        }
+
+        Batch batch{&fn, count};
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            pending_ += count;
+        }
+        const std::size_t start = next_queue_.fetch_add(1, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < count; ++i) {
+            queues_[(start + i) % queues_.size()]->push({&batch, i});
+        }
+        wake_.notify_all();
+
+        // Help until no queued work is left, then sleep until the workers finish the batch
+        while (batch.remaining.load(std::memory_order_acquire) != 0 && run_one(start)) {
+        }
+        std::unique_lock<std::mutex> lock(batch.mutex);
+        batch.finished.wait(lock, [&batch] { return batch.done; });
+    }
+
+private:
+    // Lives on the submitter's stack; it returns only after the last task set done under mutex
+    struct Batch {
+        const std::function<void(std::size_t)>* fn;
+        std::atomic<std::size_t> remaining;
+        std::mutex mutex{};
+        std::condition_variable finished{};
+        bool done{false};
+    };
+
+    struct Job {
+        Batch* batch;
+        std::size_t index;
+    };
+
+    class WorkQueue {
+    public:
+        void push(Job job) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(job);
+        }
+
+        bool pop_back(Job& job) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (jobs_.empty()) {
+                return false;
+            }
+            job = jobs_.back();
+            jobs_.pop_back();
+            return true;
+        }
+
+        bool steal_front(Job& job) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (jobs_.empty()) {
+                return false;
+            }
+            job = jobs_.front();
+            jobs_.pop_front();
+            return true;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::deque<Job> jobs_;
+    };
+
+    // Take a job from queue home (back) or steal one from the others (front) and run it
+    bool run_one(std::size_t home) {
+        const std::size_t n = queues_.size();
+        Job job{};
+        bool found = queues_[home % n]->pop_back(job);
+        for (std::size_t k = 1; !found && k < n; ++k) {
+            found = queues_[(home + k) % n]->steal_front(job);
+        }
+        if (!found) {
+            return false;
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            --pending_;
+        }
+
+        Batch& batch = *job.batch;
+        (*batch.fn)(job.index);
+        if (batch.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(batch.mutex);
+            batch.done = true;
+            batch.finished.notify_all();
+        }
+        return true;
+    }
+
+    void worker_loop(std::size_t self) {
+        for (;;) {
+            if (run_one(self)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+            if (stop_) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> next_queue_{0};
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::size_t pending_{0};  // Jobs queued but not yet taken (guarded by sleep_mutex_)
+    bool stop_{false};
+};
+
+// Adapts a scheduler that runs void() callables (tbb::task_arena::enqueue, a job system's submit,
+// an asio post...) to the Executor interface. Each task is handed to submit and bulk_execute
+// blocks until all of them have run, so the scheduler needs threads other than the caller's.
+template <typename Submit>
+class SchedulerExecutor {
+public:
+    explicit SchedulerExecutor(Submit submit, std::size_t concurrency = std::thread::hardware_concurrency())
+        : submit_(std::move(submit)), concurrency_(std::max<std::size_t>(concurrency, 1)) {}
+
+    [[nodiscard]] std::size_t concurrency() const noexcept { return concurrency_; }
+
+    void bulk_execute(std::size_t count, const std::function<void(std::size_t)>& fn) {
+        std::latch done(static_cast<std::ptrdiff_t>(count));
+        for (std::size_t i = 0; i < count; ++i) {
+            submit_([&fn, &done, i] {
+                fn(i);
+                done.count_down();
+            });
+        }
+        done.wait();
+    }
+
+private:
+    Submit submit_;
+    std::size_t concurrency_;
+};
+
+// Process-wide pool used by build_parallel when no executor is given. Created on first use
+// with one thread per hardware thread
+inline ThreadPool& default_thread_pool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+}  // namespace parallel
+}  // namespace jazzy
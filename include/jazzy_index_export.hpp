@@ -1,14 +1,92 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include "jazzy_index.hpp"
 
 namespace jazzy {
 
+namespace detail {
+
+inline void write_json_array(std::ostream& out, const std::uint64_t* values, std::size_t count) {
+    out << "[";
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i > 0) out << ", ";
+        out << values[i];
+    }
+    out << "]";
+}
+
+// QueryStats as a JSON object, each line after the first indented by indent spaces
+inline void write_query_stats(std::ostream& out, const QueryStats& stats, std::size_t indent) {
+    const std::string pad(indent, ' ');
+    out << "{\n";
+    out << pad << "  \"searches\": " << stats.searches << ",\n";
+    out << pad << "  \"run_table_hits\": " << stats.run_table_hits << ",\n";
+    out << pad << "  \"window_misses\": " << stats.window_misses << ",\n";
+    out << pad << "  \"uniform_routes\": " << stats.uniform_routes << ",\n";
+    out << pad << "  \"uniform_misses\": " << stats.uniform_misses << ",\n";
+    out << pad << "  \"error_histogram\": ";
+    write_json_array(out, stats.error_histogram.data(), stats.error_histogram.size());
+    out << ",\n" << pad << "  \"gallop_histogram\": ";
+    write_json_array(out, stats.gallop_histogram.data(), stats.gallop_histogram.size());
+    out << ",\n" << pad << "  \"segment_hits\": ";
+    write_json_array(out, stats.segment_hits.data(), stats.segment_hits.size());
+    out << "\n" << pad << "}";
+}
+
+// IndexStats as a JSON object
+inline void write_index_stats(std::ostream& out, const IndexStats& stats) {
+    out << "{\n";
+    out << "  \"num_keys\": " << stats.num_keys << ",\n";
+    out << "  \"num_segments\": " << stats.num_segments << ",\n";
+    out << "  \"memory_bytes\": " << stats.memory_bytes << ",\n";
+    out << "  \"models\": {\"CONSTANT\": " << stats.constant_segments << ", \"LINEAR\": " << stats.linear_segments
+        << ", \"QUADRATIC\": " << stats.quadratic_segments << ", \"CUBIC\": " << stats.cubic_segments << "},\n";
+    out << "  \"max_error\": " << stats.max_error << ",\n";
+    out << "  \"mean_error\": " << stats.mean_error << ",\n";
+    out << "  \"error_histogram\": ";
+    write_json_array(out, stats.error_histogram.data(), stats.error_histogram.size());
+    out << ",\n";
+    out << "  \"uniform\": " << (stats.uniform ? "true" : "false") << ",\n";
+    out << "  \"query_path\": \""
+        << (stats.query_path == QueryPath::LINEAR_UNIFORM ? "LINEAR_UNIFORM" : "GENERAL") << "\",\n";
+    out << "  \"expected_probes\": " << stats.expected_probes << ",\n";
+    out << "  \"build_ns\": {\"partition\": " << stats.build.partition_ns << ", \"analyze\": " << stats.build.analyze_ns
+        << ", \"finalize\": " << stats.build.finalize_ns << "}\n";
+    out << "}";
+}
+
+}  // namespace detail
+
+// Export index_stats() as JSON: the index's size and shape without its keys or segment list
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+std::string export_index_stats(const JazzyIndex<T, Segments, Compare, KeyExtractor, Options>& index) {
+    std::ostringstream oss;
+    detail::write_index_stats(oss, index.index_stats());
+    oss << "\n";
+    return oss.str();
+}
+
+// Export the query counters of an index built with IndexOptions<..., stats::PerThread> as JSON
+// (the same object export_index_metadata() writes under "query_stats")
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+    requires std::is_same_v<typename Options::stats_type, stats::PerThread>
+std::string export_query_stats(const JazzyIndex<T, Segments, Compare, KeyExtractor, Options>& index) {
+    std::ostringstream oss;
+    detail::write_query_stats(oss, index.query_stats(), 0);
+    oss << "\n";
+    return oss.str();
+}
+
 // Export JazzyIndex metadata as JSON for visualization
-template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor = jazzy::identity>
-std::string export_index_metadata(const JazzyIndex<T, Segments, Compare, KeyExtractor>& index) {
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor = jazzy::identity,
+          typename Options = IndexOptions<>>
+std::string export_index_metadata(const JazzyIndex<T, Segments, Compare, KeyExtractor, Options>& index) {
     std::ostringstream oss;
     oss << std::scientific;
     oss.precision(17);  // Full double precision
@@ -42,8 +120,8 @@ std::string export_index_metadata(const JazzyIndex<T, Segments, Compare, KeyExtr
         oss << "      \"index\": " << i << ",\n";
         oss << "      \"start_idx\": " << seg.start_idx << ",\n";
         oss << "      \"end_idx\": " << seg.end_idx << ",\n";
-        oss << "      \"min_val\": " << static_cast<double>(seg.min_val) << ",\n";
-        oss << "      \"max_val\": " << static_cast<double>(seg.max_val) << ",\n";
+        oss << "      \"min_val\": " << static_cast<double>(index.base_[seg.start_idx]) << ",\n";
+        oss << "      \"max_val\": " << static_cast<double>(index.segments_.max_key(i)) << ",\n";
         oss << "      \"max_error\": " << static_cast<int>(seg.max_error) << ",\n";
 
         // Model type
@@ -64,33 +142,40 @@ std::string export_index_metadata(const JazzyIndex<T, Segments, Compare, KeyExtr
         }
         oss << "\",\n";
 
-        // Model parameters
+        // Model parameters (read from the cubic-form packing, valid for every layout)
+        const auto model = index.segments_.packed_model(i);
         oss << "      \"params\": {";
         switch (seg.model_type) {
             case detail::ModelType::LINEAR:
-                oss << "\"slope\": " << seg.params.linear.slope << ", "
-                    << "\"intercept\": " << seg.params.linear.intercept;
+                oss << "\"slope\": " << model.c << ", "
+                    << "\"intercept\": " << model.d;
                 break;
             case detail::ModelType::QUADRATIC:
-                oss << "\"a\": " << seg.params.quadratic.a << ", "
-                    << "\"b\": " << seg.params.quadratic.b << ", "
-                    << "\"c\": " << seg.params.quadratic.c;
+                oss << "\"a\": " << model.b << ", "
+                    << "\"b\": " << model.c << ", "
+                    << "\"c\": " << model.d;
                 break;
             case detail::ModelType::CUBIC:
-                oss << "\"a\": " << seg.params.cubic.a << ", "
-                    << "\"b\": " << seg.params.cubic.b << ", "
-                    << "\"c\": " << seg.params.cubic.c << ", "
-                    << "\"d\": " << seg.params.cubic.d;
+                oss << "\"a\": " << model.a << ", "
+                    << "\"b\": " << model.b << ", "
+                    << "\"c\": " << model.c << ", "
+                    << "\"d\": " << model.d;
                 break;
             case detail::ModelType::CONSTANT:
-                oss << "\"constant_idx\": " << seg.params.constant.constant_idx;
+                oss << "\"constant_idx\": " << seg.start_idx;
                 break;
         }
         oss << "}\n";
         oss << "    }";
     }
-    oss << "\n  ]\n";
-    oss << "}\n";
+    oss << "\n  ]";
+
+    // Query counters, for indexes that collect them
+    if constexpr (std::is_same_v<typename Options::stats_type, stats::PerThread>) {
+        oss << ",\n  \"query_stats\": ";
+        detail::write_query_stats(oss, index.query_stats(), 2);
+    }
+    oss << "\n}\n";
 
     return oss.str();
 }
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "jazzy_index_utility.hpp"  // detail::prefetch_read
+
+namespace jazzy {
+namespace detail {
+
+inline constexpr std::size_t BLOOM_BLOCK_WORDS = 8;
+// Words per blocked Bloom filter block: one 64-byte cache line, one bit set per word (k = 8)
+
+// 64-bit hash of an extracted key. Keys that compare equal hash equal: integers by value, and
+// floating-point keys as doubles with -0.0 folded into 0.0
+template <typename Key>
+[[nodiscard]] inline std::uint64_t filter_hash(Key key) noexcept {
+    std::uint64_t x = 0;
+    if constexpr (std::is_integral_v<Key>) {
+        x = static_cast<std::uint64_t>(key);
+    } else {
+        const double value = static_cast<double>(key);
+        x = value == 0.0 ? 0 : std::bit_cast<std::uint64_t>(value);
+    }
+    // MurmurHash3 finalizer
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Split-block Bloom filter: a key's hash picks one cache-line block and sets one bit in each of
+// its eight words, so a probe is one cache line and never a false negative. With 10 bits per key
+// about 1% of absent keys pass
+class BlockedBloomFilter {
+public:
+    struct alignas(64) Block {
+        std::uint64_t words[BLOOM_BLOCK_WORDS];
+    };
+
+    // The block for a hash (prefetched) and the hash, for may_contain
+    struct Probe {
+        const Block* block;
+        std::uint64_t hash;
+    };
+
+    // Insert hash_of(i) for i in [0, count), with about bits_per_key bits per key
+    template <typename HashOf>
+    void build(std::size_t count, std::size_t bits_per_key, HashOf hash_of) {
+        const std::size_t bits = std::max<std::size_t>(count * bits_per_key, 1);
+        blocks_.assign((bits + sizeof(Block) * 8 - 1) / (sizeof(Block) * 8), Block{});
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::uint64_t hash = hash_of(i);
+            Block& block = blocks_[block_index(hash)];
+            for (std::size_t w = 0; w < BLOOM_BLOCK_WORDS; ++w) {
+                block.words[w] |= bit_mask(hash, w);
+            }
+        }
+    }
+
+    // Start a probe: the block's line is fetched while the caller routes the key
+    [[nodiscard]] Probe prepare(std::uint64_t hash) const noexcept {
+        const Block* block = blocks_.data() + block_index(hash);
+        prefetch_read(block);
+        return {block, hash};
+    }
+
+    // False only if the hashed key was not inserted
+    [[nodiscard]] bool may_contain(const Probe& probe) const noexcept {
+        std::uint64_t missing = 0;
+        for (std::size_t w = 0; w < BLOOM_BLOCK_WORDS; ++w) {
+            const std::uint64_t mask = bit_mask(probe.hash, w);
+            missing |= mask & ~probe.block->words[w];
+        }
+        return missing == 0;
+    }
+
+    [[nodiscard]] std::size_t heap_bytes() const noexcept { return blocks_.capacity() * sizeof(Block); }
+
+private:
+    [[nodiscard]] std::size_t block_index(std::uint64_t hash) const noexcept {
+        // High 32 bits scaled onto the block count (no division)
+        return static_cast<std::size_t>(((hash >> 32) * static_cast<std::uint64_t>(blocks_.size())) >> 32);
+    }
+
+    // Bit of word w for a hash: the top 6 bits of the low half times an odd per-word salt
+    [[nodiscard]] static std::uint64_t bit_mask(std::uint64_t hash, std::size_t w) noexcept {
+        constexpr std::uint32_t SALTS[BLOOM_BLOCK_WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                                            0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+        const auto low = static_cast<std::uint32_t>(hash);
+        return std::uint64_t{1} << (static_cast<std::uint32_t>(low * SALTS[w]) >> 26);
+    }
+
+    std::vector<Block> blocks_;
+};
+
+// filter::None: every key may be present
+struct NoFilter {
+    struct Probe {};
+
+    template <typename HashOf>
+    void build(std::size_t /*count*/, std::size_t /*bits_per_key*/, HashOf /*hash_of*/) noexcept {}
+    [[nodiscard]] Probe prepare(std::uint64_t /*hash*/) const noexcept { return {}; }
+    [[nodiscard]] static constexpr bool may_contain(const Probe& /*probe*/) noexcept { return true; }
+    [[nodiscard]] static constexpr std::size_t heap_bytes() noexcept { return 0; }
+};
+
+// Direct-mapped cache of the positions find() returned, Slots entries picked by key hash. Lookups
+// fill it, so entries are relaxed atomics: a racing reader sees an old or new position, and every
+// position is checked against the key before it is used. Copies start empty
+template <std::size_t Slots>
+class HotKeyCache {
+    static_assert(std::has_single_bit(Slots), "cache::DirectMapped needs a power-of-two slot count");
+
+public:
+    HotKeyCache() = default;
+    HotKeyCache(const HotKeyCache& other) {
+        if (other.slots_) {
+            clear();
+        }
+    }
+    HotKeyCache(HotKeyCache&&) noexcept = default;
+    HotKeyCache& operator=(const HotKeyCache& other) {
+        if (this != &other) {
+            clear();
+        }
+        return *this;
+    }
+    HotKeyCache& operator=(HotKeyCache&&) noexcept = default;
+
+    // Forget every entry (each build moves positions)
+    void clear() {
+        if (!slots_) {
+            slots_ = std::make_unique<std::atomic<std::size_t>[]>(Slots);
+        }
+        for (std::size_t i = 0; i < Slots; ++i) {
+            slots_[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Position cached for the hash's slot plus one, or 0
+    [[nodiscard]] std::size_t get(std::uint64_t hash) const noexcept {
+        return slots_ ? slots_[slot(hash)].load(std::memory_order_relaxed) : 0;
+    }
+
+    void put(std::uint64_t hash, std::size_t position) const noexcept {
+        if (slots_) {
+            auto& entry = slots_[slot(hash)];
+            if (entry.load(std::memory_order_relaxed) != position + 1) {  // Hot keys only read
+                entry.store(position + 1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t heap_bytes() const noexcept {
+        return slots_ ? Slots * sizeof(std::atomic<std::size_t>) : 0;
+    }
+
+private:
+    [[nodiscard]] static std::size_t slot(std::uint64_t hash) noexcept {
+        return static_cast<std::size_t>(hash & (Slots - 1));
+    }
+
+    std::unique_ptr<std::atomic<std::size_t>[]> slots_;
+};
+
+// cache::None
+struct NoCache {
+    void clear() noexcept {}
+    [[nodiscard]] static constexpr std::size_t get(std::uint64_t /*hash*/) noexcept { return 0; }
+    void put(std::uint64_t /*hash*/, std::size_t /*position*/) const noexcept {}
+    [[nodiscard]] static constexpr std::size_t heap_bytes() noexcept { return 0; }
+};
+
+}  // namespace detail
+}  // namespace jazzy
@@ -0,0 +1,366 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "jazzy_index.hpp"
+
+namespace jazzy {
+
+// When a MutableJazzyIndex segment is refitted, and how large segments grow
+struct UpdatePolicy {
+    std::size_t keys_per_segment = 1024;  // Segment size after a build or split
+    std::size_t max_buffered = 64;        // Inserts buffered per segment before it is merged and refitted
+    std::size_t max_drift = 32;           // Deletes (or appended-key error growth) tolerated before a refit
+};
+
+namespace detail {
+
+// One segment of a MutableJazzyIndex: the keys its model was fitted to, plus the changes since
+template <typename T>
+struct MutableSegment {
+    std::vector<T> keys;           // Sorted; appends go straight here, deletes are removed here
+    std::vector<T> inserts;        // Sorted keys inserted since the last fit (searched separately)
+    CompactSegment model{};        // Fitted over keys: start_idx 0, end_idx keys.size()
+    std::size_t fitted_error = 0;  // model.max_error right after the last fit
+    std::size_t drift = 0;         // Deletes from keys since the last fit; each shifts positions by at most 1
+};
+
+}  // namespace detail
+
+// Updatable learned index over keys it owns. Each segment keeps its fitted key array and a small
+// sorted insert buffer; lookups search the model's window in the array and binary search the
+// buffer. A segment whose buffer or error drift passes the UpdatePolicy limits is merged and
+// refitted on its own (split when it has grown past twice keys_per_segment); the other segments
+// are not touched. Keys appended at the end go straight into the last segment's array.
+// Duplicates are allowed, as in JazzyIndex.
+template <typename T, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity>
+class MutableJazzyIndex {
+    using Segment = detail::MutableSegment<T>;
+
+    static_assert(std::is_invocable_v<KeyExtractor, const T&>,
+                  "KeyExtractor must be callable with const T&");
+    static_assert(std::is_arithmetic_v<std::remove_cvref_t<std::invoke_result_t<KeyExtractor, const T&>>>,
+                  "KeyExtractor must return an arithmetic type (int, double, etc.)");
+    static_assert(std::is_invocable_r_v<bool, Compare, const T&, const T&>,
+                  "Compare must be callable with (const T&, const T&) and return bool");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    explicit MutableJazzyIndex(UpdatePolicy policy = UpdatePolicy{}, Compare comp = Compare{},
+                               KeyExtractor key_extract = KeyExtractor{})
+        : policy_(policy), comp_(comp), key_extract_(key_extract) {
+        if (policy_.keys_per_segment == 0 || policy_.max_buffered == 0) {
+            throw std::invalid_argument("UpdatePolicy needs keys_per_segment >= 1 and max_buffered >= 1");
+        }
+    }
+
+    // Replace the contents with a copy of the sorted range [first, last)
+    void build(const T* first, const T* last) {
+        if (std::is_sorted_until(first, last, comp_) != last) {
+            throw std::runtime_error(
+                "Input data is not sorted. JazzyIndex requires sorted data. "
+                "Please sort your data before building the index."
+            );
+        }
+        segments_.clear();
+        bounds_.clear();
+        size_ = static_cast<std::size_t>(last - first);
+        std::vector<T> keys(first, last);
+        if (!keys.empty()) {
+            segments_.emplace_back();
+            bounds_.push_back(keys.back());
+            refit_split(0, std::move(keys));
+        }
+        DEBUG_LOG("MutableJazzyIndex::build: %zu keys in %zu segments", size_, segments_.size());
+    }
+
+    void insert(const T& value) {
+        ++size_;
+        if (segments_.empty()) {
+            segments_.emplace_back();
+            bounds_.push_back(value);
+            refit_split(0, std::vector<T>{value});
+            return;
+        }
+
+        const std::size_t i = route(value);
+        Segment& seg = segments_[i];
+        if (i + 1 == segments_.size() && (seg.keys.empty() || !comp_(value, seg.keys.back()))) {
+            append(i, value);
+            return;
+        }
+
+        seg.inserts.insert(std::upper_bound(seg.inserts.begin(), seg.inserts.end(), value, comp_), value);
+        if (seg.inserts.size() > policy_.max_buffered) {
+            DEBUG_LOG("MutableJazzyIndex::insert: segment %zu buffer full (%zu), refitting", i, seg.inserts.size());
+            refit(i);
+        }
+    }
+
+    // Remove one key equivalent to value; false if there is none
+    bool erase(const T& value) {
+        if (segments_.empty()) {
+            return false;
+        }
+        const std::size_t i = route(value);
+        Segment& seg = segments_[i];
+
+        const auto buffered = std::lower_bound(seg.inserts.begin(), seg.inserts.end(), value, comp_);
+        if (buffered != seg.inserts.end() && !comp_(value, *buffered)) {
+            seg.inserts.erase(buffered);
+        } else {
+            const T* found = lower_bound_in_keys(seg, value);
+            if (found == seg.keys.data() + seg.keys.size() || comp_(value, *found)) {
+                return false;
+            }
+            seg.keys.erase(seg.keys.begin() + (found - seg.keys.data()));
+            ++seg.drift;
+        }
+        --size_;
+
+        if (seg.keys.empty() && seg.inserts.empty()) {
+            remove_segment(i);
+        } else if (seg.drift > policy_.max_drift) {
+            DEBUG_LOG("MutableJazzyIndex::erase: segment %zu drift %zu, refitting", i, seg.drift);
+            refit(i);
+        }
+        return true;
+    }
+
+    // A stored key equivalent to key, or nullptr
+    [[nodiscard]] const T* find(const T& key) const {
+        if (segments_.empty()) {
+            return nullptr;
+        }
+        const Segment& seg = segments_[route(key)];
+        const T* found = lower_bound_in_keys(seg, key);
+        if (found != seg.keys.data() + seg.keys.size() && !comp_(key, *found)) {
+            return found;
+        }
+        const auto buffered = std::lower_bound(seg.inserts.begin(), seg.inserts.end(), key, comp_);
+        if (buffered != seg.inserts.end() && !comp_(key, *buffered)) {
+            return &*buffered;
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] bool contains(const T& key) const { return find(key) != nullptr; }
+
+    // Smallest stored key not less than value, or nullptr
+    [[nodiscard]] const T* find_lower_bound(const T& value) const {
+        return first_from(value, [this](const T& key, const T& v) { return !comp_(key, v); });
+    }
+
+    // Smallest stored key greater than value, or nullptr
+    [[nodiscard]] const T* find_upper_bound(const T& value) const {
+        return first_from(value, [this](const T& key, const T& v) { return comp_(v, key); });
+    }
+
+    // Visit every key in ascending order
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const Segment& seg : segments_) {
+            auto a = seg.keys.begin();
+            auto b = seg.inserts.begin();
+            while (a != seg.keys.end() || b != seg.inserts.end()) {
+                if (b == seg.inserts.end() || (a != seg.keys.end() && !comp_(*b, *a))) {
+                    fn(*a++);
+                } else {
+                    fn(*b++);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] std::size_t num_segments() const noexcept { return segments_.size(); }
+
+    // Model fitted to segment i at its last fit (i < num_segments())
+    [[nodiscard]] detail::ModelType segment_model(std::size_t i) const noexcept { return segments_[i].model.model_type; }
+
+    // Segment fits since construction (each build, split piece and refit counts one)
+    [[nodiscard]] std::size_t fit_count() const noexcept { return fit_count_; }
+
+    // Model selection for every later build, split and refit; segments keep their current models
+    // until refitted. Throws std::invalid_argument for an invalid config
+    void set_build_config(const BuildConfig& config) {
+        config.validate();
+        config_ = config;
+    }
+
+    [[nodiscard]] const BuildConfig& build_config() const noexcept { return config_; }
+
+private:
+    // First segment whose upper bound is not less than value (the last segment takes the rest)
+    [[nodiscard]] std::size_t route(const T& value) const {
+        return static_cast<std::size_t>(
+            std::lower_bound(bounds_.begin(), bounds_.end() - 1, value, comp_) - bounds_.begin());
+    }
+
+    // Position in seg.keys of the first key not less than value: last-mile search in the model's
+    // window (widened by the drift since the fit), extended to the whole array if the answer is outside
+    [[nodiscard]] const T* lower_bound_in_keys(const Segment& seg, const T& value) const {
+        const T* begin = seg.keys.data();
+        const T* end = begin + seg.keys.size();
+        if (begin == end) {
+            return end;
+        }
+        const std::size_t predicted = detail::clamp_value<std::size_t>(
+            seg.model.predict(value, key_extract_), 0, seg.keys.size() - 1);
+        const std::size_t radius = seg.model.max_error + seg.drift + detail::SEARCH_RADIUS_MARGIN;
+        const T* lo = begin + (predicted > radius ? predicted - radius : 0);
+        const T* hi = begin + std::min(seg.keys.size(), predicted + radius + 1);
+        return detail::windowed_search<false>(begin, end, lo, hi, value, comp_);
+    }
+
+    // Smallest key k with accept(k, value) (a monotonic predicate over sorted keys), or nullptr
+    template <typename Accept>
+    [[nodiscard]] const T* first_from(const T& value, Accept accept) const {
+        if (segments_.empty()) {
+            return nullptr;
+        }
+        for (std::size_t i = route(value); i < segments_.size(); ++i) {
+            const Segment& seg = segments_[i];
+            const T* candidate = lower_bound_in_keys(seg, value);
+            const T* keys_end = seg.keys.data() + seg.keys.size();
+            while (candidate != keys_end && !accept(*candidate, value)) {
+                ++candidate;  // Skip the run of keys equivalent to value (upper bound only)
+            }
+            const auto buffered = std::find_if(
+                std::lower_bound(seg.inserts.begin(), seg.inserts.end(), value, comp_), seg.inserts.end(),
+                [&](const T& key) { return accept(key, value); });
+
+            const T* best = candidate != keys_end ? candidate : nullptr;
+            if (buffered != seg.inserts.end() && (best == nullptr || comp_(*buffered, *best))) {
+                best = &*buffered;
+            }
+            if (best != nullptr) {
+                return best;
+            }
+        }
+        return nullptr;
+    }
+
+    // Append value (not less than any key in the last segment's array) without refitting unless
+    // the model's error on the new key has drifted too far or the segment has outgrown its size
+    void append(std::size_t i, const T& value) {
+        Segment& seg = segments_[i];
+        seg.keys.push_back(value);
+        seg.model.end_idx = seg.keys.size();
+        if (comp_(bounds_[i], value)) {
+            bounds_[i] = value;
+        }
+
+        const std::size_t position = seg.keys.size() - 1;
+        const std::size_t predicted = seg.model.predict(value, key_extract_);
+        const std::size_t error = predicted > position ? predicted - position : position - predicted;
+        if (error > seg.model.max_error) {
+            seg.model.max_error = static_cast<std::uint32_t>(
+                std::min<std::size_t>(error, std::numeric_limits<std::uint32_t>::max()));
+        }
+
+        if (seg.model.max_error > seg.fitted_error + policy_.max_drift ||
+            seg.keys.size() >= 2 * policy_.keys_per_segment) {
+            DEBUG_LOG("MutableJazzyIndex::insert: appended segment %zu (%zu keys, error %u), refitting",
+                      i, seg.keys.size(), seg.model.max_error);
+            refit(i);
+        }
+    }
+
+    // Merge segment i's buffer into its keys and refit it (splitting it if it has outgrown its size)
+    void refit(std::size_t i) {
+        Segment& seg = segments_[i];
+        std::vector<T> merged;
+        merged.reserve(seg.keys.size() + seg.inserts.size());
+        std::merge(seg.keys.begin(), seg.keys.end(), seg.inserts.begin(), seg.inserts.end(),
+                   std::back_inserter(merged), comp_);
+        refit_split(i, std::move(merged));
+    }
+
+    // Store keys as segment i, cut into keys_per_segment pieces when there are more than twice that
+    // many (never inside a run of equivalent keys, so each run stays in one segment)
+    void refit_split(std::size_t i, std::vector<T> keys) {
+        const std::size_t target = policy_.keys_per_segment;
+        if (keys.size() < 2 * target) {
+            fit(segments_[i], std::move(keys));
+            return;
+        }
+
+        std::vector<Segment> pieces;
+        std::vector<T> piece_bounds;
+        std::size_t start = 0;
+        while (start < keys.size()) {
+            std::size_t end = keys.size();
+            if (keys.size() - start >= 2 * target) {
+                const auto cut = keys.begin() + static_cast<std::ptrdiff_t>(start + target);
+                end = static_cast<std::size_t>(std::upper_bound(cut - 1, keys.end(), *(cut - 1), comp_) - keys.begin());
+            }
+            Segment piece;
+            fit(piece, std::vector<T>(keys.begin() + static_cast<std::ptrdiff_t>(start),
+                                      keys.begin() + static_cast<std::ptrdiff_t>(end)));
+            piece_bounds.push_back(keys[end - 1]);
+            pieces.push_back(std::move(piece));
+            start = end;
+        }
+        // The last piece keeps the segment's routing bound (it may lie past its largest key)
+        piece_bounds.back() = bounds_[i];
+
+        DEBUG_LOG("MutableJazzyIndex: split segment %zu (%zu keys) into %zu segments", i, keys.size(), pieces.size());
+        const auto at = static_cast<std::ptrdiff_t>(i);
+        segments_.erase(segments_.begin() + at);
+        segments_.insert(segments_.begin() + at, std::make_move_iterator(pieces.begin()),
+                         std::make_move_iterator(pieces.end()));
+        bounds_.erase(bounds_.begin() + at);
+        bounds_.insert(bounds_.begin() + at, piece_bounds.begin(), piece_bounds.end());
+    }
+
+    // Fit a model to keys with analyze_segment and make them seg's array
+    void fit(Segment& seg, std::vector<T> keys) {
+        const auto analysis = detail::analyze_segment(keys.data(), 0, keys.size(), comp_, key_extract_, config_);
+        seg.keys = std::move(keys);
+        seg.inserts.clear();
+        seg.drift = 0;
+        seg.model.model = detail::pack_model(analysis);
+        seg.model.model_type = analysis.best_model;
+        seg.model.start_idx = 0;
+        seg.model.end_idx = seg.keys.size();
+        // Saturate: lookups fall back past the window, so a huge error only costs search time
+        seg.model.max_error = static_cast<std::uint32_t>(
+            std::min<std::size_t>(analysis.max_error, std::numeric_limits<std::uint32_t>::max()));
+        seg.fitted_error = seg.model.max_error;
+        ++fit_count_;
+    }
+
+    // Drop an emptied segment. Its keys route to the next segment, or, for the last segment, to the
+    // previous one, which takes over its upper bound
+    void remove_segment(std::size_t i) {
+        const auto at = static_cast<std::ptrdiff_t>(i);
+        if (i + 1 == segments_.size() && i > 0) {
+            bounds_[i - 1] = bounds_[i];
+        }
+        segments_.erase(segments_.begin() + at);
+        bounds_.erase(bounds_.begin() + at);
+    }
+
+    UpdatePolicy policy_{};
+    Compare comp_{};
+    KeyExtractor key_extract_{};
+    BuildConfig config_{};
+    std::vector<Segment> segments_{};
+    std::vector<T> bounds_{};  // bounds_[i]: largest key routed to segment i (the last one takes all above)
+    std::size_t size_{0};
+    std::size_t fit_count_{0};
+};
+
+}  // namespace jazzy
@@ -1,16 +1,21 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
 #include <functional>
-#include <future>
+#include <limits>
+#include <span>
 #include <stdexcept>
 #include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "jazzy_index.hpp"
+#include "jazzy_index_executor.hpp"
 
 namespace jazzy {
 namespace parallel {
@@ -24,18 +29,25 @@ struct BuildTask {
     const T* data;
     Compare comp;
     KeyExtractor key_extract;
+    std::size_t error_bound = detail::UNBOUNDED_ERROR;  // Corridor for error-bounded builds
+    bool offset_keys = false;  // Fit over key offsets (the layout's SegmentStore::OFFSET_MODELS)
+    BuildConfig config{};      // The index's model selection (JazzyIndex::set_build_config)
 
     // Execute the segment analysis
     detail::SegmentAnalysis<T> execute() const {
-        return detail::analyze_segment(data, start_idx, end_idx, comp, key_extract);
+        if (offset_keys) {
+            return detail::fit_segment<true>(data, start_idx, end_idx, error_bound, comp, key_extract, config);
+        }
+        return detail::fit_segment<false>(data, start_idx, end_idx, error_bound, comp, key_extract, config);
     }
 };
 
 // Helper class for parallel build operations
-template <typename T, SegmentCount Segments, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity>
+template <typename T, SegmentCount Segments, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity,
+          typename Options = IndexOptions<>>
 class ParallelBuilder {
-    using IndexType = JazzyIndex<T, Segments, Compare, KeyExtractor>;
-    static constexpr std::size_t NumSegments = static_cast<std::size_t>(Segments);
+    using IndexType = JazzyIndex<T, Segments, Compare, KeyExtractor, Options>;
+    static constexpr std::size_t NumSegments = static_cast<std::size_t>(Segments);  // 0 for DYNAMIC
 
 public:
     // Prepare independent build tasks for each segment
@@ -46,71 +58,38 @@ public:
                        const T* last,
                        Compare comp = Compare{},
                        KeyExtractor key_extract = KeyExtractor{}) {
-        // Initialize basic index state
-        index.base_ = first;
-        index.size_ = static_cast<std::size_t>(last - first);
-        index.key_extract_ = key_extract;
-        index.comp_ = comp;
-
-        if (index.size_ == 0) {
-            return {};
-        }
-
-        index.min_ = index.base_[0];
-        index.max_ = index.base_[index.size_ - 1];
-
-        // Handle single element case immediately
-        if (index.size_ == 1) {
-            auto& seg = index.segments_[0];
-            seg.min_val = index.min_;
-            seg.max_val = index.max_;
-            seg.start_idx = 0;
-            seg.end_idx = 1;
-            seg.model_type = detail::ModelType::CONSTANT;
-            seg.max_error = 0;
-            seg.params.constant.constant_idx = 0;
-            index.num_segments_ = 1;
+        const auto partition_start = detail::BuildClock::now();
+        if (!init_index(index, first, last, comp, key_extract, false)) {
             return {};
         }
 
         // Determine actual number of segments
-        const std::size_t actual_segments = std::min(NumSegments, index.size_);
-        index.num_segments_ = actual_segments;
-
-        // Verify data is sorted and initialize segment boundaries
-        std::vector<BuildTask<T, Compare, KeyExtractor>> tasks;
-        tasks.reserve(actual_segments);
-
-        for (std::size_t i = 0; i < actual_segments; ++i) {
-            const std::size_t start = (i * index.size_) / actual_segments;
-            const std::size_t end = ((i + 1) * index.size_) / actual_segments;
-
-            auto& seg = index.segments_[i];
-            seg.min_val = index.base_[start];
-            seg.max_val = index.base_[end - 1];
-            seg.start_idx = start;
-            seg.end_idx = end;
-
-            // Verify monotonicity (must be done sequentially)
-            if (i > 0 && comp(seg.min_val, index.segments_[i - 1].max_val)) {
-                throw std::runtime_error(
-                    "Input data is not sorted. JazzyIndex requires sorted data. "
-                    "Please sort your data before building the index."
-                );
-            }
-
-            // Create task for this segment
-            BuildTask<T, Compare, KeyExtractor> task;
-            task.segment_index = i;
-            task.start_idx = start;
-            task.end_idx = end;
-            task.data = index.base_;
-            task.comp = comp;
-            task.key_extract = key_extract;
+        const std::size_t actual_segments = index.equal_count_segments();
+        auto tasks = make_tasks(index, actual_segments,
+                                [&index, actual_segments](std::size_t i) { return ((i + 1) * index.size_) / actual_segments; },
+                                detail::UNBOUNDED_ERROR);
+        index.timings_.partition_ns = detail::nanoseconds_since(partition_start);
+        return tasks;
+    }
 
-            tasks.push_back(std::move(task));
+    // Same as prepare_build_tasks, with boundaries placed by an epsilon corridor
+    // (see JazzyIndex::build_error_bounded). The cut points are found sequentially in one pass
+    static std::vector<BuildTask<T, Compare, KeyExtractor>>
+    prepare_error_bounded_tasks(IndexType& index,
+                                const T* first,
+                                const T* last,
+                                std::size_t epsilon,
+                                Compare comp = Compare{},
+                                KeyExtractor key_extract = KeyExtractor{}) {
+        const auto partition_start = detail::BuildClock::now();
+        if (!init_index(index, first, last, comp, key_extract, true)) {
+            return {};
         }
 
+        detail::SegmentArray<std::size_t, NumSegments> ends;
+        const std::size_t corridor = index.plan_error_bounded_segments(epsilon, ends);
+        auto tasks = make_tasks(index, index.num_segments_, [&ends](std::size_t i) { return ends[i]; }, corridor);
+        index.timings_.partition_ns = detail::nanoseconds_since(partition_start);
         return tasks;
     }
 
@@ -120,47 +99,11 @@ public:
         if (results.size() != index.num_segments_) {
             throw std::runtime_error("Result count does not match number of segments");
         }
+        const auto finalize_start = detail::BuildClock::now();
 
         // Store analysis results in segments
         for (std::size_t i = 0; i < index.num_segments_; ++i) {
-            const auto& analysis = results[i];
-            auto& seg = index.segments_[i];
-
-            seg.model_type = analysis.best_model;
-
-            // Check if prediction error exceeds uint32_t limit
-            if (analysis.max_error > std::numeric_limits<uint32_t>::max()) {
-                throw std::runtime_error(
-                    "Segment prediction error exceeds uint32_t limit. "
-                    "Data distribution is too extreme for indexing. "
-                    "Consider using fewer segments or preprocessing the data."
-                );
-            }
-            seg.max_error = static_cast<uint32_t>(analysis.max_error);
-
-            // Store model coefficients
-            switch (analysis.best_model) {
-                case detail::ModelType::LINEAR:
-                    seg.params.linear.slope = static_cast<float>(analysis.linear_a);
-                    seg.params.linear.intercept = static_cast<float>(analysis.linear_b);
-                    break;
-                case detail::ModelType::QUADRATIC:
-                    seg.params.quadratic.a = static_cast<float>(analysis.quad_a);
-                    seg.params.quadratic.b = static_cast<float>(analysis.quad_b);
-                    seg.params.quadratic.c = static_cast<float>(analysis.quad_c);
-                    break;
-                case detail::ModelType::CUBIC:
-                    seg.params.cubic.a = static_cast<float>(analysis.cubic_a);
-                    seg.params.cubic.b = static_cast<float>(analysis.cubic_b);
-                    seg.params.cubic.c = static_cast<float>(analysis.cubic_c);
-                    seg.params.cubic.d = static_cast<float>(analysis.cubic_d);
-                    break;
-                case detail::ModelType::CONSTANT:
-                    seg.params.constant.constant_idx = seg.start_idx;
-                    break;
-                default:
-                    break;
-            }
+            index.store_segment_model(i, results[i]);
         }
 
         // Compute uniformity and segment scale for O(1) lookups
@@ -169,14 +112,15 @@ public:
         const double expected_spacing = (index.num_segments_ > 1 && total_range >= detail::ZERO_RANGE_THRESHOLD)
             ? total_range / static_cast<double>(index.num_segments_)
             : 0.0;
-        const double tolerance = expected_spacing * detail::UNIFORMITY_TOLERANCE;
+        const double tolerance = expected_spacing * index.config_.uniformity_tolerance;
 
         index.is_uniform_ = true;
         if (index.num_segments_ > 1 && total_range >= detail::ZERO_RANGE_THRESHOLD) {
             for (std::size_t i = 0; i < index.num_segments_; ++i) {
                 const auto& seg = index.segments_[i];
-                const double segment_range = static_cast<double>(std::invoke(index.key_extract_, seg.max_val)) -
-                                            static_cast<double>(std::invoke(index.key_extract_, seg.min_val));
+                const double segment_range =
+                    static_cast<double>(std::invoke(index.key_extract_, index.base_[seg.end_idx - 1])) -
+                    static_cast<double>(std::invoke(index.key_extract_, index.base_[seg.start_idx]));
                 if (std::abs(segment_range - expected_spacing) > tolerance) {
                     index.is_uniform_ = false;
                     break;
@@ -188,86 +132,384 @@ public:
         if (index.is_uniform_ && total_range >= detail::ZERO_RANGE_THRESHOLD) {
             index.segment_scale_ = static_cast<double>(index.num_segments_) / total_range;
         }
+
+        index.build_routing_tables();
+        index.timings_.finalize_ns = detail::nanoseconds_since(finalize_start);
     }
 
-    // Convenience method: parallel build using std::async
+    // Convenience method: parallel build on the default thread pool
     static void build_parallel(IndexType& index,
                               const T* first,
                               const T* last,
                               Compare comp = Compare{},
                               KeyExtractor key_extract = KeyExtractor{}) {
-        // Prepare tasks
-        auto tasks = prepare_build_tasks(index, first, last, comp, key_extract);
+        build_parallel(index, first, last, default_thread_pool(), comp, key_extract);
+    }
 
-        // Handle trivial cases (empty or single element)
+    // Parallel build on a caller-supplied executor
+    template <Executor Exec>
+    static void build_parallel(IndexType& index,
+                              const T* first,
+                              const T* last,
+                              Exec& executor,
+                              Compare comp = Compare{},
+                              KeyExtractor key_extract = KeyExtractor{}) {
+        run_tasks(index, prepare_build_tasks(index, first, last, comp, key_extract), executor);
+    }
+
+    // Convenience method: error-bounded parallel build on the default thread pool
+    static void build_parallel_error_bounded(IndexType& index,
+                                             const T* first,
+                                             const T* last,
+                                             std::size_t epsilon,
+                                             Compare comp = Compare{},
+                                             KeyExtractor key_extract = KeyExtractor{}) {
+        build_parallel_error_bounded(index, first, last, epsilon, default_thread_pool(), comp, key_extract);
+    }
+
+    template <Executor Exec>
+    static void build_parallel_error_bounded(IndexType& index,
+                                             const T* first,
+                                             const T* last,
+                                             std::size_t epsilon,
+                                             Exec& executor,
+                                             Compare comp = Compare{},
+                                             KeyExtractor key_extract = KeyExtractor{}) {
+        run_tasks(index, prepare_error_bounded_tasks(index, first, last, epsilon, comp, key_extract), executor);
+    }
+
+    // Group consecutive per-segment tasks into chunks sized by element count: at least
+    // PARALLEL_MIN_CHUNK_ELEMENTS keys each, about PARALLEL_CHUNKS_PER_THREAD chunks per thread.
+    // Returns the exclusive end task index of each chunk
+    static std::vector<std::size_t> plan_chunks(const std::vector<BuildTask<T, Compare, KeyExtractor>>& tasks,
+                                                std::size_t concurrency) {
+        std::vector<std::size_t> chunk_ends;
         if (tasks.empty()) {
-            return;
+            return chunk_ends;
+        }
+
+        const std::size_t total = tasks.back().end_idx - tasks.front().start_idx;
+        const std::size_t wanted_chunks = std::max<std::size_t>(concurrency, 1) * detail::PARALLEL_CHUNKS_PER_THREAD;
+        const std::size_t target = std::max(detail::PARALLEL_MIN_CHUNK_ELEMENTS,
+                                            (total + wanted_chunks - 1) / wanted_chunks);
+
+        std::size_t elements = 0;
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            elements += tasks[i].end_idx - tasks[i].start_idx;
+            if (elements >= target) {
+                chunk_ends.push_back(i + 1);
+                elements = 0;
+            }
+        }
+        if (elements > 0) {
+            chunk_ends.push_back(tasks.size());
         }
+        return chunk_ends;
+    }
 
-        // Launch all tasks asynchronously using std::async
-        std::vector<std::future<detail::SegmentAnalysis<T>>> futures;
-        futures.reserve(tasks.size());
+private:
+    // Initialize basic index state; returns false when the input was empty or a single
+    // element (already fully handled)
+    static bool init_index(IndexType& index, const T* first, const T* last,
+                           Compare comp, KeyExtractor key_extract, bool error_bounded) {
+        index.base_ = first;
+        index.size_ = static_cast<std::size_t>(last - first);
+        index.query_path_ = QueryPath::GENERAL;
+        index.key_extract_ = key_extract;
+        index.comp_ = comp;
+        index.error_bound_.reset();
+        index.timings_ = {};
+        if (error_bounded) {
+            index.error_bound_ = 0;
+        }
 
-        for (auto& task : tasks) {
-            futures.push_back(std::async(std::launch::async, [task]() {
-                return task.execute();
-            }));
+        if (index.size_ == 0) {
+            return false;
         }
 
-        // Collect results (preserving order)
-        std::vector<detail::SegmentAnalysis<T>> results;
-        results.reserve(tasks.size());
+        index.min_ = index.base_[0];
+        index.max_ = index.base_[index.size_ - 1];
 
-        // Track first exception if any
-        std::exception_ptr first_exception;
+        // Handle single element case immediately
+        if (index.size_ == 1) {
+            index.init_single_segment();
+            return false;
+        }
+        return true;
+    }
 
-        for (auto& future : futures) {
+    // Set segment extents [end_of(i-1), end_of(i)) and create one analysis task per segment
+    template <typename EndOf>
+    static std::vector<BuildTask<T, Compare, KeyExtractor>>
+    make_tasks(IndexType& index, std::size_t count, EndOf end_of, std::size_t error_bound) {
+        index.allocate_segments(count);
+        index.num_segments_ = count;
+
+        // Verify data is sorted and initialize segment boundaries
+        std::vector<BuildTask<T, Compare, KeyExtractor>> tasks;
+        tasks.reserve(count);
+
+        std::size_t start = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t end = end_of(i);
+
+            index.segments_.set_extent(i, index.bound_of(index.base_[start]), index.bound_of(index.base_[end - 1]),
+                                       start, end);
+
+            // Verify monotonicity (must be done sequentially)
+            if (i > 0 && index.comp_(index.base_[start], index.base_[start - 1])) {
+                throw std::runtime_error(
+                    "Input data is not sorted. JazzyIndex requires sorted data. "
+                    "Please sort your data before building the index."
+                );
+            }
+
+            // Create task for this segment
+            BuildTask<T, Compare, KeyExtractor> task;
+            task.segment_index = i;
+            task.start_idx = start;
+            task.end_idx = end;
+            task.data = index.base_;
+            task.comp = index.comp_;
+            task.key_extract = index.key_extract_;
+            task.error_bound = error_bound;
+            task.offset_keys = IndexType::SegmentStore::OFFSET_MODELS;
+            task.config = index.config_;
+
+            tasks.push_back(std::move(task));
+            start = end;
+        }
+
+        return tasks;
+    }
+
+    template <Executor Exec>
+    static std::size_t executor_concurrency(const Exec& executor) {
+        if constexpr (requires { executor.concurrency(); }) {
+            return executor.concurrency();
+        } else {
+            return std::thread::hardware_concurrency();
+        }
+    }
+
+    template <Executor Exec>
+    static void run_tasks(IndexType& index, const std::vector<BuildTask<T, Compare, KeyExtractor>>& tasks,
+                          Exec& executor) {
+        // Handle trivial cases (empty or single element)
+        if (tasks.empty()) {
+            return;
+        }
+
+        const auto analyze_start = detail::BuildClock::now();
+        const std::vector<std::size_t> chunk_ends = plan_chunks(tasks, executor_concurrency(executor));
+
+        // Each chunk writes its own slice of results (preserving order)
+        std::vector<detail::SegmentAnalysis<T>> results(tasks.size());
+        std::vector<std::exception_ptr> errors(chunk_ends.size());
+
+        executor.bulk_execute(chunk_ends.size(), [&](std::size_t chunk) {
+            const std::size_t begin = chunk == 0 ? 0 : chunk_ends[chunk - 1];
             try {
-                results.push_back(future.get());
-            } catch (...) {
-                // Store first exception, continue collecting to avoid deadlock
-                if (!first_exception) {
-                    first_exception = std::current_exception();
+                for (std::size_t i = begin; i < chunk_ends[chunk]; ++i) {
+                    results[i] = tasks[i].execute();
                 }
-                // Push a dummy result to maintain vector size
-                results.push_back(detail::SegmentAnalysis<T>{});
+            } catch (...) {
+                errors[chunk] = std::current_exception();
             }
-        }
+        });
 
-        // Re-throw first exception if any occurred
-        if (first_exception) {
-            std::rethrow_exception(first_exception);
+        // Re-throw the first exception (in segment order) if any occurred
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
         }
 
         // Finalize the index
+        index.timings_.analyze_ns = detail::nanoseconds_since(analyze_start);
         finalize_build(index, results);
     }
 };
 
+// Options for find_many
+struct FindManyOptions {
+    std::size_t chunk_size = detail::FIND_MANY_CHUNK_KEYS;  // Probes per task
+    bool partition = false;  // Radix-partition unsorted chunks by key value before searching them
+};
+
+// Helper class for parallel batched queries (find_many)
+template <typename T, SegmentCount Segments, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity,
+          typename Options = IndexOptions<>>
+class ParallelProber {
+    using IndexType = JazzyIndex<T, Segments, Compare, KeyExtractor, Options>;
+
+public:
+    // Search one chunk: sorted keys take the merge-style find_sorted_batch, unsorted ones the
+    // staged find_batch, after radix partitioning when partition is set. Uniform indexes compute
+    // each segment directly, so a sorted chunk gains nothing from carrying it and keeps find_batch
+    static void find_chunk(const IndexType& index, std::span<const T> keys, std::span<const T*> out,
+                           bool partition) {
+        const bool sorted = std::is_sorted(keys.begin(), keys.end(), index.comp_);
+        if (sorted && !index.is_uniform_) {
+            index.find_sorted_batch(keys, out);
+        } else if (!sorted && partition) {
+            find_partitioned(index, keys, out);
+        } else {
+            index.find_batch(keys, out);
+        }
+    }
+
+private:
+    // One counting-sort pass over FIND_MANY_PARTITION_BUCKETS equal slices of the index's key range,
+    // so neighbouring probes in the batch read neighbouring keys; results are scattered back
+    static void find_partitioned(const IndexType& index, std::span<const T> keys, std::span<const T*> out) {
+        constexpr std::size_t buckets = detail::FIND_MANY_PARTITION_BUCKETS;
+        static_assert(buckets <= 256, "Bucket numbers are stored as bytes");
+        const double lo = static_cast<double>(std::invoke(index.key_extract_, index.min_));
+        const double range = static_cast<double>(std::invoke(index.key_extract_, index.max_)) - lo;
+        const double scale = range >= detail::ZERO_RANGE_THRESHOLD ? static_cast<double>(buckets) / range : 0.0;
+
+        std::vector<std::uint8_t> bucket_of(keys.size());
+        std::array<std::size_t, buckets + 1> starts{};
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            const double slot = (static_cast<double>(std::invoke(index.key_extract_, keys[i])) - lo) * scale;
+            // Keys outside the range (and NaN) go to the end buckets; find_batch rejects them
+            const std::size_t bucket = !(slot > 0.0) ? 0
+                                     : slot >= static_cast<double>(buckets - 1) ? buckets - 1
+                                     : static_cast<std::size_t>(slot);
+            bucket_of[i] = static_cast<std::uint8_t>(bucket);
+            ++starts[bucket + 1];
+        }
+        for (std::size_t b = 0; b < buckets; ++b) {
+            starts[b + 1] += starts[b];
+        }
+
+        std::vector<T> grouped(keys.size());
+        std::vector<std::uint32_t> origin(keys.size());
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            const std::size_t slot = starts[bucket_of[i]]++;
+            grouped[slot] = keys[i];
+            origin[slot] = static_cast<std::uint32_t>(i);
+        }
+
+        std::vector<const T*> found(keys.size());
+        index.find_batch(grouped, found);
+        for (std::size_t j = 0; j < keys.size(); ++j) {
+            out[origin[j]] = found[j];
+        }
+    }
+};
+
+// out[i] receives index.find(keys[i]), for a probe set split into chunks of options.chunk_size
+// keys searched concurrently on executor. Sorted chunks are answered as a merge join (carrying
+// the segment from key to key), unsorted ones by the staged batch kernel. Chunk positions are
+// stored as 32-bit offsets, so chunk_size is capped at 2^32 keys
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options,
+          Executor Exec>
+void find_many(const JazzyIndex<T, Segments, Compare, KeyExtractor, Options>& index,
+               std::type_identity_t<std::span<const T>> keys,
+               std::type_identity_t<std::span<const T*>> out,
+               Exec& executor,
+               FindManyOptions options = {}) {
+    using Prober = ParallelProber<T, Segments, Compare, KeyExtractor, Options>;
+    if (out.size() < keys.size()) {
+        throw std::invalid_argument("find_many output span is smaller than the key span");
+    }
+
+    const std::size_t chunk_size =
+        std::clamp<std::size_t>(options.chunk_size, 1, std::numeric_limits<std::uint32_t>::max());
+    const std::size_t chunks = (keys.size() + chunk_size - 1) / chunk_size;
+    if (chunks <= 1) {
+        Prober::find_chunk(index, keys, out, options.partition);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(chunks);
+    executor.bulk_execute(chunks, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * chunk_size;
+        const std::size_t count = std::min(chunk_size, keys.size() - begin);
+        try {
+            Prober::find_chunk(index, keys.subspan(begin, count), out.subspan(begin, count), options.partition);
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    });
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// find_many on the default thread pool
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+void find_many(const JazzyIndex<T, Segments, Compare, KeyExtractor, Options>& index,
+               std::type_identity_t<std::span<const T>> keys,
+               std::type_identity_t<std::span<const T*>> out,
+               FindManyOptions options = {}) {
+    find_many(index, keys, out, default_thread_pool(), options);
+}
+
 }  // namespace parallel
 
 // Implement JazzyIndex parallel build methods
-template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor>
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
 inline std::vector<parallel::BuildTask<T, Compare, KeyExtractor>>
-JazzyIndex<T, Segments, Compare, KeyExtractor>::prepare_build_tasks(
+JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::prepare_build_tasks(
     const T* first, const T* last,
     Compare comp, KeyExtractor key_extract) {
-    return parallel::ParallelBuilder<T, Segments, Compare, KeyExtractor>::prepare_build_tasks(
+    return parallel::ParallelBuilder<T, Segments, Compare, KeyExtractor, Options>::prepare_build_tasks(
         *this, first, last, comp, key_extract);
 }
 
-template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor>
-inline void JazzyIndex<T, Segments, Compare, KeyExtractor>::finalize_build(
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+inline void JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::finalize_build(
     const std::vector<detail::SegmentAnalysis<T>>& results) {
-    parallel::ParallelBuilder<T, Segments, Compare, KeyExtractor>::finalize_build(*this, results);
+    parallel::ParallelBuilder<T, Segments, Compare, KeyExtractor, Options>::finalize_build(*this, results);
 }
 
-template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor>
-inline void JazzyIndex<T, Segments, Compare, KeyExtractor>::build_parallel(
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+inline void JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::build_parallel(
     const T* first, const T* last,
     Compare comp, KeyExtractor key_extract) {
-    parallel::ParallelBuilder<T, Segments, Compare, KeyExtractor>::build_parallel(
+    parallel::ParallelBuilder<T, Segments, Compare, KeyExtractor, Options>::build_parallel(
         *this, first, last, comp, key_extract);
 }
 
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+template <parallel::Executor Exec>
+inline void JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::build_parallel(
+    const T* first, const T* last, Exec& executor,
+    Compare comp, KeyExtractor key_extract) {
+    parallel::ParallelBuilder<T, Segments, Compare, KeyExtractor, Options>::build_parallel(
+        *this, first, last, executor, comp, key_extract);
+}
+
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+inline std::vector<parallel::BuildTask<T, Compare, KeyExtractor>>
+JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::prepare_error_bounded_tasks(
+    const T* first, const T* last, std::size_t epsilon,
+    Compare comp, KeyExtractor key_extract) {
+    return parallel::ParallelBuilder<T, Segments, Compare, KeyExtractor, Options>::prepare_error_bounded_tasks(
+        *this, first, last, epsilon, comp, key_extract);
+}
+
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+inline void JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::build_parallel_error_bounded(
+    const T* first, const T* last, std::size_t epsilon,
+    Compare comp, KeyExtractor key_extract) {
+    parallel::ParallelBuilder<T, Segments, Compare, KeyExtractor, Options>::build_parallel_error_bounded(
+        *this, first, last, epsilon, comp, key_extract);
+}
+
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+template <parallel::Executor Exec>
+inline void JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::build_parallel_error_bounded(
+    const T* first, const T* last, std::size_t epsilon, Exec& executor,
+    Compare comp, KeyExtractor key_extract) {
+    parallel::ParallelBuilder<T, Segments, Compare, KeyExtractor, Options>::build_parallel_error_bounded(
+        *this, first, last, epsilon, executor, comp, key_extract);
+}
+
 }  // namespace jazzy
@@ -0,0 +1,406 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "jazzy_index.hpp"
+
+namespace jazzy {
+namespace detail {
+
+inline constexpr std::size_t KEY_PREFIX_BYTES = 8;
+// Key bytes in one prefix (one uint64_t)
+
+inline constexpr std::size_t MIN_PREFIX_TIE = 512;
+// Fewest keys sharing a prefix that get a nested level over the following key bytes; shorter
+// ties are binary searched with the full comparator, which is faster below about this size
+
+inline constexpr std::size_t MAX_PREFIX_BYTES = 64;
+// Key bytes the nested levels reach; keys still tied past them are binary searched
+
+// Collects bytes [skip, skip + 8) of a key's encoding, most significant first: a key shorter
+// than that is padded with zero bytes
+class PrefixWriter {
+public:
+    explicit constexpr PrefixWriter(std::size_t skip) noexcept : skip_(skip) {}
+
+    constexpr void put(std::uint8_t byte) noexcept {
+        if (skip_ > 0) {
+            --skip_;
+        } else if (filled_ < KEY_PREFIX_BYTES) {
+            bits_ |= std::uint64_t{byte} << (8 * (KEY_PREFIX_BYTES - 1 - filled_));
+            ++filled_;
+        }
+    }
+
+    [[nodiscard]] constexpr bool full() const noexcept { return filled_ == KEY_PREFIX_BYTES; }
+    [[nodiscard]] constexpr std::uint64_t bits() const noexcept { return bits_; }
+
+private:
+    std::size_t skip_;
+    std::size_t filled_{0};
+    std::uint64_t bits_{0};
+};
+
+template <typename K>
+[[nodiscard]] consteval bool is_prefix_key();
+
+template <typename K, std::size_t... I>
+[[nodiscard]] consteval bool are_prefix_keys(std::index_sequence<I...> /*elements*/) {
+    return (is_prefix_key<std::remove_cvref_t<std::tuple_element_t<I, K>>>() && ...);
+}
+
+// Arithmetic values up to 64 bits, strings and tuple-likes (std::tuple, std::pair, std::array)
+// of those
+template <typename K>
+[[nodiscard]] consteval bool is_prefix_key() {
+    if constexpr (std::is_arithmetic_v<K>) {
+        return sizeof(K) <= sizeof(std::uint64_t);
+    } else if constexpr (std::is_convertible_v<const K&, std::string_view>) {
+        return true;
+    } else if constexpr (requires { std::tuple_size<K>::value; }) {
+        return are_prefix_keys<K>(std::make_index_sequence<std::tuple_size_v<K>>{});
+    } else {
+        return false;
+    }
+}
+
+template <typename K>
+concept PrefixKey = is_prefix_key<std::remove_cvref_t<K>>();
+
+// Unsigned image of an arithmetic value that orders as the value does (sign bit flipped for
+// signed integers; IEEE bits mirrored below zero for floating point, with -0.0 taken as 0.0)
+template <typename K>
+[[nodiscard]] constexpr auto ordered_bits(K value) noexcept {
+    if constexpr (std::is_same_v<K, bool>) {
+        return static_cast<std::uint8_t>(value);
+    } else if constexpr (std::is_integral_v<K>) {
+        using Unsigned = std::make_unsigned_t<K>;
+        auto bits = static_cast<Unsigned>(value);
+        if constexpr (std::is_signed_v<K>) {
+            bits = static_cast<Unsigned>(bits ^ (Unsigned{1} << (8 * sizeof(K) - 1)));
+        }
+        return bits;
+    } else {
+        using Unsigned = std::conditional_t<sizeof(K) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+        const auto bits = std::bit_cast<Unsigned>(value == K{0} ? K{0} : value);
+        constexpr Unsigned SIGN = Unsigned{1} << (8 * sizeof(K) - 1);
+        return static_cast<Unsigned>((bits & SIGN) != 0 ? ~bits : bits | SIGN);
+    }
+}
+
+// Write key's encoding: numbers as their ordered bits, big-endian; a string as its bytes (a
+// string followed by other elements escapes 0 as 0x00 0xFF and ends with 0x00 0x00, so a shorter
+// string orders first); tuple elements one after another. Byte strings compare as keys do
+template <typename K>
+constexpr void encode_prefix(const K& key, PrefixWriter& out, bool last) noexcept {
+    if constexpr (std::is_arithmetic_v<K>) {
+        const auto bits = ordered_bits(key);
+        for (std::size_t i = sizeof(bits); i > 0 && !out.full(); --i) {
+            out.put(static_cast<std::uint8_t>(bits >> (8 * (i - 1))));
+        }
+    } else if constexpr (std::is_convertible_v<const K&, std::string_view>) {
+        const std::string_view text(key);
+        for (std::size_t i = 0; i < text.size() && !out.full(); ++i) {
+            const auto byte = static_cast<std::uint8_t>(text[i]);
+            out.put(byte);
+            if (byte == 0 && !last) {
+                out.put(0xFF);
+            }
+        }
+        if (!last) {
+            out.put(0);
+            out.put(0);
+        }
+    } else {
+        [&]<std::size_t... I>(std::index_sequence<I...> /*elements*/) {
+            ((out.full() ? void() : encode_prefix(std::get<I>(key), out, last && I + 1 == sizeof...(I))), ...);
+        }(std::make_index_sequence<std::tuple_size_v<K>>{});
+    }
+}
+
+// One distinct prefix of a PrefixJazzyIndex level and the position of the first key with it;
+// kept together so the search that finds the prefix also brings in where its keys start
+struct PrefixEntry {
+    std::uint64_t prefix;
+    std::size_t start;
+};
+
+struct PrefixEntryKey {
+    [[nodiscard]] constexpr std::uint64_t operator()(const PrefixEntry& entry) const noexcept { return entry.prefix; }
+};
+
+// Orders entries by prefix, and the bare prefixes a JazzyIndex keeps as segment bounds
+struct PrefixEntryOrder {
+    [[nodiscard]] constexpr bool operator()(const PrefixEntry& a, const PrefixEntry& b) const noexcept {
+        return a.prefix < b.prefix;
+    }
+    [[nodiscard]] constexpr bool operator()(std::uint64_t a, std::uint64_t b) const noexcept { return a < b; }
+};
+
+}  // namespace detail
+
+// Order-preserving 64-bit prefix of a key: bytes [skip, skip + 8) of its encoding (see
+// detail::encode_prefix) as one big-endian integer. If a orders before b, a's prefix is not
+// greater than b's; keys that differ only past the prefix share it
+struct key_prefix {
+    template <detail::PrefixKey K>
+    [[nodiscard]] constexpr std::uint64_t operator()(const K& key, std::size_t skip = 0) const noexcept {
+        detail::PrefixWriter out(skip);
+        detail::encode_prefix(key, out, true);
+        return out.bits();
+    }
+};
+
+// Index over sorted keys that are not numbers: strings, or composites such as (symbol, timestamp)
+// given as tuples. KeyOf maps a stored T to its key (identity when T is the key) and Compare
+// orders T as those keys order: ascending, element by element, strings byte by byte.
+//
+// Routing and prediction run on 64-bit key prefixes (key_prefix): a JazzyIndex over the distinct
+// prefixes finds the query's prefix and where the keys sharing it start, and full keys are
+// compared only within that tie. A tie of at least MIN_PREFIX_TIE keys gets a nested level over
+// the next eight key bytes that differ within it, found in the level's tie table, so long shared
+// prefixes (URLs, one symbol's rows) stay learned instead of binary searched. The keys are
+// borrowed, not copied; each level takes 16 bytes per distinct prefix.
+template <typename T, SegmentCount Segments = SegmentCount::LARGE, typename Compare = std::less<>,
+          typename KeyOf = jazzy::identity, typename Options = IndexOptions<layout::Precise>>
+class PrefixJazzyIndex {
+    static_assert(std::is_invocable_v<const KeyOf&, const T&>, "KeyOf must be callable with const T&");
+    static_assert(detail::PrefixKey<std::invoke_result_t<const KeyOf&, const T&>>,
+                  "KeyOf must return a string, a number of up to 64 bits, or a tuple of those");
+    static_assert(std::is_invocable_r_v<bool, const Compare&, const T&, const T&>,
+                  "Compare must be callable with (const T&, const T&) and return bool");
+
+    using Entry = detail::PrefixEntry;
+    using PrefixIndex = JazzyIndex<Entry, Segments, detail::PrefixEntryOrder, detail::PrefixEntryKey, Options>;
+    using TieIndex =
+        JazzyIndex<Entry, SegmentCount::DYNAMIC, detail::PrefixEntryOrder, detail::PrefixEntryKey, Options>;
+
+    // Distinct prefixes of some keys at one key byte offset
+    template <typename Index>
+    struct Level;
+
+    struct Tie {
+        std::size_t rank;                  // Of the tied prefix in the enclosing level
+        std::vector<std::uint64_t> shared; // Prefixes every tied key has between the two levels' bytes
+        std::unique_ptr<Level<TieIndex>> level;
+    };
+
+    template <typename Index>
+    struct Level {
+        std::size_t offset{0};             // Key bytes before this level's prefixes
+        std::vector<Entry> entries;        // By prefix, then an end entry whose start is the level's end
+        Index index{};
+        std::vector<Tie> ties;             // Nested levels of the long ties, sorted by rank
+
+        Level() = default;
+        explicit Level(std::size_t key_offset) : offset(key_offset), index(SegmentSizing{}) {}
+
+        [[nodiscard]] std::size_t count() const noexcept { return entries.size() - 1; }
+    };
+
+public:
+    using iterator = const T*;
+    using const_iterator = const T*;
+    using value_type = T;
+    using size_type = std::size_t;
+
+    PrefixJazzyIndex() = default;
+
+    PrefixJazzyIndex(const T* first, const T* last, Compare comp = Compare{}, KeyOf key_of = KeyOf{}) {
+        build(first, last, comp, key_of);
+    }
+
+    // Index [first, last) (sorted by comp). The keys must stay alive and in place while the
+    // index is used. Throws std::runtime_error for unsorted keys and std::invalid_argument when
+    // comp does not order keys as their prefixes
+    void build(const T* first, const T* last, Compare comp = Compare{}, KeyOf key_of = KeyOf{}) {
+        if (first > last) {
+            throw std::invalid_argument("Invalid range: first > last");
+        }
+        const auto size = static_cast<std::size_t>(last - first);
+        for (std::size_t i = 1; i < size; ++i) {
+            if (comp(first[i], first[i - 1])) {
+                throw std::runtime_error(
+                    "Input data is not sorted. JazzyIndex requires sorted data. "
+                    "Please sort your data before building the index."
+                );
+            }
+        }
+        Level<PrefixIndex> root;
+        std::size_t tie_levels = 0;
+        build_level(root, first, 0, size, key_of, tie_levels);
+        root_ = std::move(root);
+        base_ = first;
+        size_ = size;
+        comp_ = comp;
+        key_of_ = key_of;
+        tie_levels_ = tie_levels;
+        DEBUG_LOG("PrefixJazzyIndex::build: %zu keys, %zu distinct prefixes, %zu tie levels",
+                  size_, root_.count(), tie_levels_);
+    }
+
+    // A stored key equivalent to key, or end()
+    [[nodiscard]] const_iterator find(const T& key) const {
+        const T* found = find_lower_bound(key);
+        return found != end() && !comp_(key, *found) ? found : end();
+    }
+
+    [[nodiscard]] bool contains(const T& key) const { return find(key) != end(); }
+
+    // First stored key not less than value, or end()
+    [[nodiscard]] const_iterator find_lower_bound(const T& value) const {
+        return size_ == 0 ? end() : bound<false>(root_, value);
+    }
+
+    // First stored key greater than value, or end()
+    [[nodiscard]] const_iterator find_upper_bound(const T& value) const {
+        return size_ == 0 ? end() : bound<true>(root_, value);
+    }
+
+    [[nodiscard]] std::pair<const_iterator, const_iterator> equal_range(const T& value) const {
+        return {find_lower_bound(value), find_upper_bound(value)};
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept { return base_; }
+    [[nodiscard]] const_iterator end() const noexcept { return base_ + size_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+
+    // Distinct prefixes of the first key bytes
+    [[nodiscard]] std::size_t num_prefixes() const noexcept { return root_.entries.empty() ? 0 : root_.count(); }
+
+    // Nested levels built for long ties, at every depth
+    [[nodiscard]] std::size_t num_tie_levels() const noexcept { return tie_levels_; }
+
+    // Bytes held by the index: the prefix tables, tie tables and JazzyIndex of every level (not
+    // the keys)
+    [[nodiscard]] std::size_t memory_usage() const noexcept {
+        return sizeof(*this) - sizeof(root_) + level_bytes(root_);
+    }
+
+private:
+    // Distinct prefixes of the keys [first, last) at level.offset, their JazzyIndex and nested
+    // levels for the long ties
+    template <typename Index>
+    void build_level(Level<Index>& level, const T* base, std::size_t first, std::size_t last, const KeyOf& key_of,
+                     std::size_t& tie_levels) const {
+        for (std::size_t i = first; i < last; ++i) {
+            const std::uint64_t prefix = prefix_of(base[i], level.offset, key_of);
+            if (!level.entries.empty() && prefix <= level.entries.back().prefix) {
+                if (prefix < level.entries.back().prefix) {
+                    throw std::invalid_argument(
+                        "PrefixJazzyIndex needs a Compare that orders keys as their prefixes "
+                        "(ascending, element by element)");
+                }
+                continue;
+            }
+            level.entries.push_back(Entry{prefix, i});
+        }
+        const std::size_t count = level.entries.size();
+        level.entries.push_back(Entry{0, last});
+        level.entries.shrink_to_fit();
+        if (count > 0) {
+            level.index.build(level.entries.data(), level.entries.data() + count);
+        }
+
+        for (std::size_t rank = 0; rank < count; ++rank) {
+            const std::size_t tie_first = level.entries[rank].start;
+            const std::size_t tie_last = level.entries[rank + 1].start;
+            if (tie_last - tie_first < detail::MIN_PREFIX_TIE) {
+                continue;
+            }
+            // The keys are sorted, so bytes the first and last keys share are shared by the whole tie
+            std::vector<std::uint64_t> shared;
+            std::size_t offset = level.offset + detail::KEY_PREFIX_BYTES;
+            while (offset < detail::MAX_PREFIX_BYTES) {
+                const std::uint64_t prefix = prefix_of(base[tie_first], offset, key_of);
+                if (prefix != prefix_of(base[tie_last - 1], offset, key_of)) {
+                    break;
+                }
+                shared.push_back(prefix);
+                offset += detail::KEY_PREFIX_BYTES;
+            }
+            if (offset >= detail::MAX_PREFIX_BYTES) {
+                continue;
+            }
+            auto nested = std::make_unique<Level<TieIndex>>(offset);
+            build_level(*nested, base, tie_first, tie_last, key_of, tie_levels);
+            DEBUG_LOG("PrefixJazzyIndex::build_level: Keys [%zu-%zu) tied at byte %zu, indexed from byte %zu",
+                      tie_first, tie_last, level.offset, offset);
+            shared.shrink_to_fit();
+            level.ties.push_back(Tie{rank, std::move(shared), std::move(nested)});
+            ++tie_levels;
+        }
+    }
+
+    // The bound of value among level's keys: its prefix's entry, then a nested level or the full
+    // comparator within the keys sharing that prefix
+    template <bool Upper, typename Index>
+    [[nodiscard]] const T* bound(const Level<Index>& level, const T& value) const {
+        const std::uint64_t prefix = prefix_of(value, level.offset, key_of_);
+        const Entry* entry = level.index.find_lower_bound(Entry{prefix, 0});
+        const T* first = base_ + entry->start;
+        if (entry == level.entries.data() + level.count() || entry->prefix != prefix) {
+            return first;  // Every key before has a smaller prefix, every key after a larger one
+        }
+        const T* last = base_ + entry[1].start;
+        if (last - first >= static_cast<std::ptrdiff_t>(detail::MIN_PREFIX_TIE)) {
+            const auto rank = static_cast<std::size_t>(entry - level.entries.data());
+            const auto tie = std::lower_bound(level.ties.begin(), level.ties.end(), rank,
+                                              [](const Tie& t, std::size_t r) { return t.rank < r; });
+            if (tie != level.ties.end() && tie->rank == rank) {
+                // The nested level only orders keys with the tie's shared bytes: a value differing
+                // in them bounds the whole tie
+                for (std::size_t i = 0; i < tie->shared.size(); ++i) {
+                    const std::uint64_t skipped =
+                        prefix_of(value, level.offset + (i + 1) * detail::KEY_PREFIX_BYTES, key_of_);
+                    if (skipped != tie->shared[i]) {
+                        return skipped < tie->shared[i] ? first : last;
+                    }
+                }
+                return bound<Upper>(*tie->level, value);
+            }
+        }
+        DEBUG_LOG("PrefixJazzyIndex: Tie [%zu-%zu) at byte %zu searched with the comparator",
+                  static_cast<std::size_t>(first - base_), static_cast<std::size_t>(last - base_), level.offset);
+        if constexpr (Upper) {
+            return std::upper_bound(first, last, value, comp_);
+        } else {
+            return std::lower_bound(first, last, value, comp_);
+        }
+    }
+
+    [[nodiscard]] static std::uint64_t prefix_of(const T& value, std::size_t offset, const KeyOf& key_of) {
+        return key_prefix{}(std::invoke(key_of, value), offset);
+    }
+
+    template <typename Index>
+    [[nodiscard]] static std::size_t level_bytes(const Level<Index>& level) noexcept {
+        std::size_t bytes = sizeof(level) - sizeof(level.index) + level.index.memory_usage() +
+                            level.entries.capacity() * sizeof(Entry) + level.ties.capacity() * sizeof(Tie);
+        for (const Tie& tie : level.ties) {
+            bytes += tie.shared.capacity() * sizeof(std::uint64_t) + level_bytes(*tie.level);
+        }
+        return bytes;
+    }
+
+    const T* base_{nullptr};
+    std::size_t size_{0};
+    Compare comp_{};
+    KeyOf key_of_{};
+    std::size_t tie_levels_{0};
+    Level<PrefixIndex> root_{};
+};
+
+}  // namespace jazzy
@@ -0,0 +1,699 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <istream>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define JAZZY_HAS_MAPPED_FILE 1
+#endif
+
+#include "jazzy_index.hpp"
+
+namespace jazzy {
+namespace detail {
+
+// Index file format. A file is a fixed header followed by sections at 64-byte aligned offsets:
+//   segment table   FileSegment[segment_count]
+//   route keys      T[segment_count]                 (segment max keys, for the view's routing)
+//   routing layer   T[routing_nodes], uint32[routing_nodes]  (Eytzinger keys and ranks, if any)
+//   keys            T[key_count]                     (only with KeyData::EMBEDDED)
+// Everything is stored in the saving machine's byte order, which the header records, so a view
+// can use the sections in place. Readers reject other versions and other byte orders.
+inline constexpr std::array<char, 8> FILE_MAGIC = {'J', 'A', 'Z', 'Z', 'Y', 'I', 'D', 'X'};
+
+inline constexpr std::uint32_t FILE_FORMAT_VERSION = 1;
+// Bump on any change to the header, the record layout or the section order
+
+inline constexpr std::uint32_t FILE_BYTE_ORDER_MARK = 0x01020304;
+// Written natively; reads back as 0x04030201 on a machine with the other byte order
+
+inline constexpr std::size_t FILE_SECTION_ALIGNMENT = 64;
+
+// Header flags
+inline constexpr std::uint32_t FILE_FLAG_UNIFORM = 1u << 0;        // O(1) arithmetic routing is valid
+inline constexpr std::uint32_t FILE_FLAG_ERROR_BOUNDED = 1u << 1;  // error_bound holds the build's bound
+inline constexpr std::uint32_t FILE_FLAG_KEYS_EMBEDDED = 1u << 2;  // keys section is present
+
+// Coarse key type tag, so an index saved for one key type is not read as another of the same size
+enum class FileKeyKind : std::uint32_t {
+    UNSIGNED_INTEGER,
+    SIGNED_INTEGER,
+    FLOATING_POINT,
+    RECORD  // Trivially copyable struct read through a KeyExtractor
+};
+
+template <typename T>
+[[nodiscard]] constexpr FileKeyKind file_key_kind() noexcept {
+    if constexpr (std::is_floating_point_v<T>) {
+        return FileKeyKind::FLOATING_POINT;
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return FileKeyKind::SIGNED_INTEGER;
+    } else if constexpr (std::is_integral_v<T>) {
+        return FileKeyKind::UNSIGNED_INTEGER;
+    } else {
+        return FileKeyKind::RECORD;
+    }
+}
+
+struct FileHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t key_size;
+    std::uint32_t key_kind;
+    std::uint32_t flags;
+    std::uint32_t reserved0;
+    std::uint64_t key_count;
+    std::uint64_t segment_count;
+    std::uint64_t routing_nodes;  // Entries in each routing layer array (slot 0 unused), 0 if none
+    std::uint64_t error_bound;
+    double segment_scale;
+    std::uint64_t segments_offset;
+    std::uint64_t route_keys_offset;
+    std::uint64_t routing_keys_offset;
+    std::uint64_t routing_ranks_offset;
+    std::uint64_t keys_offset;  // 0 when the keys are not embedded
+    std::uint64_t file_size;
+    std::uint64_t reserved1;
+};
+static_assert(sizeof(FileHeader) == 128 && std::is_trivially_copyable_v<FileHeader>,
+              "FileHeader must be a fixed 128-byte record");
+
+// One segment in cubic form, independent of the index's layout policy
+struct FileSegment {
+    PackedModel model;  // LINEAR (0,0,slope,intercept), QUADRATIC (0,a,b,c), CUBIC (a,b,c,d)
+    std::uint64_t start_idx;
+    std::uint64_t end_idx;
+    std::uint32_t max_error;
+    std::uint8_t model_type;
+    std::array<std::uint8_t, 11> reserved;
+};
+static_assert(sizeof(FileSegment) == 48 && std::is_trivially_copyable_v<FileSegment>,
+              "FileSegment must be a fixed 48-byte record");
+
+[[nodiscard]] constexpr std::uint64_t align_file_offset(std::uint64_t offset) noexcept {
+    return (offset + FILE_SECTION_ALIGNMENT - 1) / FILE_SECTION_ALIGNMENT * FILE_SECTION_ALIGNMENT;
+}
+
+// Header with the identity fields and section offsets filled in for the given section sizes
+template <typename T>
+[[nodiscard]] FileHeader make_file_header(std::uint64_t key_count, std::uint64_t segment_count,
+                                          std::uint64_t routing_nodes, bool embed_keys) noexcept {
+    FileHeader header{};
+    header.magic = FILE_MAGIC;
+    header.version = FILE_FORMAT_VERSION;
+    header.byte_order = FILE_BYTE_ORDER_MARK;
+    header.key_size = static_cast<std::uint32_t>(sizeof(T));
+    header.key_kind = static_cast<std::uint32_t>(file_key_kind<T>());
+    header.flags = embed_keys ? FILE_FLAG_KEYS_EMBEDDED : 0;
+    header.key_count = key_count;
+    header.segment_count = segment_count;
+    header.routing_nodes = routing_nodes;
+
+    std::uint64_t offset = align_file_offset(sizeof(FileHeader));
+    header.segments_offset = offset;
+    offset = align_file_offset(offset + segment_count * sizeof(FileSegment));
+    header.route_keys_offset = offset;
+    offset = align_file_offset(offset + segment_count * sizeof(T));
+    header.routing_keys_offset = offset;
+    offset = align_file_offset(offset + routing_nodes * sizeof(T));
+    header.routing_ranks_offset = offset;
+    offset += routing_nodes * sizeof(std::uint32_t);
+    if (embed_keys) {
+        offset = align_file_offset(offset);
+        header.keys_offset = offset;
+        offset += key_count * sizeof(T);
+    }
+    header.file_size = offset;
+    return header;
+}
+
+// Reject files that were not saved by this format version for key type T, or whose section
+// table does not match their counts; available is the number of bytes the caller can read
+template <typename T>
+void check_file_header(const FileHeader& header, std::uint64_t available) {
+    if (header.magic != FILE_MAGIC) {
+        throw std::runtime_error("Not a JazzyIndex file (bad magic)");
+    }
+    if (header.byte_order != FILE_BYTE_ORDER_MARK) {
+        throw std::runtime_error(
+            "JazzyIndex file was saved on a machine with a different byte order; rebuild or re-save it here");
+    }
+    if (header.version != FILE_FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported JazzyIndex file version " + std::to_string(header.version) +
+                                 " (expected " + std::to_string(FILE_FORMAT_VERSION) + ")");
+    }
+    if (header.key_size != sizeof(T) || header.key_kind != static_cast<std::uint32_t>(file_key_kind<T>())) {
+        throw std::runtime_error("JazzyIndex file was saved for a different key type");
+    }
+    if (header.segment_count > MAX_SEGMENTS || (header.segment_count == 0) != (header.key_count == 0) ||
+        header.segment_count > header.key_count) {
+        throw std::runtime_error("JazzyIndex file has an invalid segment count");
+    }
+    if (header.routing_nodes != 0 && header.routing_nodes != header.segment_count) {
+        throw std::runtime_error("JazzyIndex file has an invalid routing layer");
+    }
+
+    const bool embedded = (header.flags & FILE_FLAG_KEYS_EMBEDDED) != 0;
+    if (header.key_count > (std::numeric_limits<std::uint64_t>::max() - FILE_SECTION_ALIGNMENT * 8) / sizeof(T)) {
+        throw std::runtime_error("JazzyIndex file has an invalid key count");
+    }
+    const FileHeader expected =
+        make_file_header<T>(header.key_count, header.segment_count, header.routing_nodes, embedded);
+    if (header.segments_offset != expected.segments_offset ||
+        header.route_keys_offset != expected.route_keys_offset ||
+        header.routing_keys_offset != expected.routing_keys_offset ||
+        header.routing_ranks_offset != expected.routing_ranks_offset ||
+        header.keys_offset != expected.keys_offset || header.file_size != expected.file_size) {
+        throw std::runtime_error("JazzyIndex file has a corrupt section table");
+    }
+    if (header.file_size > available) {
+        throw std::runtime_error("JazzyIndex file is truncated");
+    }
+}
+
+// Segments must tile [0, key_count) in order with known model types
+inline void check_file_segments(const FileSegment* segments, std::size_t count, std::uint64_t key_count) {
+    std::uint64_t start = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& seg = segments[i];
+        if (seg.start_idx != start || seg.end_idx <= seg.start_idx ||
+            seg.model_type > static_cast<std::uint8_t>(ModelType::CONSTANT)) {
+            throw std::runtime_error("JazzyIndex file has a corrupt segment table");
+        }
+        start = seg.end_idx;
+    }
+    if (start != key_count) {
+        throw std::runtime_error("JazzyIndex file segments do not cover its keys");
+    }
+}
+
+// Inverse of pack_model: the analysis that stores exactly this packed model
+template <typename T>
+[[nodiscard]] SegmentAnalysis<T> unpack_model(ModelType type, const PackedModel& model) noexcept {
+    SegmentAnalysis<T> analysis{};
+    analysis.best_model = type;
+    switch (type) {
+        case ModelType::LINEAR:
+            analysis.linear_a = model.c;
+            analysis.linear_b = model.d;
+            break;
+        case ModelType::QUADRATIC:
+            analysis.quad_a = model.b;
+            analysis.quad_b = model.c;
+            analysis.quad_c = model.d;
+            break;
+        case ModelType::CUBIC:
+            analysis.cubic_a = model.a;
+            analysis.cubic_b = model.b;
+            analysis.cubic_c = model.c;
+            analysis.cubic_d = model.d;
+            break;
+        case ModelType::CONSTANT:
+            break;
+    }
+    return analysis;
+}
+
+// analysis re-expressed over key offsets from origin, for segment stores with OFFSET_MODELS
+template <typename T>
+[[nodiscard]] SegmentAnalysis<T> shift_model(SegmentAnalysis<T> analysis, double origin) noexcept {
+    const double o = origin;
+    switch (analysis.best_model) {
+        case ModelType::LINEAR:
+            analysis.linear_b += analysis.linear_a * o;
+            break;
+        case ModelType::QUADRATIC:
+            analysis.quad_c += (analysis.quad_a * o + analysis.quad_b) * o;
+            analysis.quad_b += 2.0 * analysis.quad_a * o;
+            break;
+        case ModelType::CUBIC:
+            analysis.cubic_d += ((analysis.cubic_a * o + analysis.cubic_b) * o + analysis.cubic_c) * o;
+            analysis.cubic_c += (3.0 * analysis.cubic_a * o + 2.0 * analysis.cubic_b) * o;
+            analysis.cubic_b += 3.0 * analysis.cubic_a * o;
+            break;
+        case ModelType::CONSTANT:
+            break;
+    }
+    return analysis;
+}
+
+// Write bytes at offset of a stream positioned at written, zero-filling the gap
+inline void write_file_section(std::ostream& out, std::uint64_t& written, std::uint64_t offset,
+                               const void* data, std::size_t bytes) {
+    static constexpr std::array<char, FILE_SECTION_ALIGNMENT> zeros{};
+    while (written < offset) {
+        const std::size_t pad = static_cast<std::size_t>(std::min<std::uint64_t>(offset - written, zeros.size()));
+        out.write(zeros.data(), static_cast<std::streamsize>(pad));
+        written += pad;
+    }
+    if (bytes > 0) {
+        out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        written += bytes;
+    }
+}
+
+inline void read_file_bytes(std::istream& in, void* data, std::size_t bytes) {
+    if (!in.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes))) {
+        throw std::runtime_error("JazzyIndex file is truncated");
+    }
+}
+
+// Move past bytes of input: seek when the stream supports it, read through otherwise
+inline void skip_file_bytes(std::istream& in, std::uint64_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    if (!in.seekg(static_cast<std::streamoff>(bytes), std::ios::cur)) {
+        in.clear();
+        if (!in.ignore(static_cast<std::streamsize>(bytes)) ||
+            static_cast<std::uint64_t>(in.gcount()) != bytes) {
+            throw std::runtime_error("JazzyIndex file is truncated");
+        }
+    }
+}
+
+}  // namespace detail
+
+namespace serialize {
+
+// Reads and writes the private state of a JazzyIndex for save() and load()
+template <typename T, SegmentCount Segments, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity,
+          typename Options = IndexOptions<>>
+class IndexSerializer {
+    using IndexType = JazzyIndex<T, Segments, Compare, KeyExtractor, Options>;
+
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Index files store keys as raw bytes; T must be trivially copyable");
+
+public:
+    static void save(const IndexType& index, std::ostream& out, KeyData keys) {
+        const std::size_t count = index.num_segments_;
+        std::size_t routing_nodes = 0;
+        if constexpr (std::is_same_v<typename IndexType::Routing, routing::Eytzinger>) {
+            routing_nodes = count > 0 ? index.router_.count() + 1 : 0;
+        }
+
+        detail::FileHeader header =
+            detail::make_file_header<T>(index.size_, count, routing_nodes, keys == KeyData::EMBEDDED);
+        if (index.is_uniform_) {
+            header.flags |= detail::FILE_FLAG_UNIFORM;
+        }
+        if (index.error_bound_) {
+            header.flags |= detail::FILE_FLAG_ERROR_BOUNDED;
+            header.error_bound = *index.error_bound_;
+        }
+        header.segment_scale = index.segment_scale_;
+
+        std::vector<detail::FileSegment> records(count);
+        std::vector<T> route_keys(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& seg = index.segments_[i];
+            auto& rec = records[i];
+            rec.model = index.segments_.packed_model(i);
+            rec.start_idx = seg.start_idx;
+            rec.end_idx = seg.end_idx;
+            rec.max_error = seg.max_error;
+            rec.model_type = static_cast<std::uint8_t>(seg.model_type);
+            route_keys[i] = index.base_[seg.end_idx - 1];  // Full keys even when the index keeps only bounds
+        }
+        // The routing layer in the file holds T as well; lay it out again when the index's does not
+        std::vector<T> routing_keys;
+        if constexpr (std::is_same_v<typename IndexType::Routing, routing::Eytzinger> &&
+                      !std::is_same_v<typename IndexType::Bound, T>) {
+            routing_keys.resize(routing_nodes);
+            for (std::size_t k = 1; k < routing_nodes; ++k) {
+                routing_keys[k] = route_keys[index.router_.ranks()[k]];
+            }
+        }
+        if constexpr (IndexType::SegmentStore::RELATIVE_MODELS) {
+            // Files store float cubics over absolute keys; record the error of that form of the model
+            for (std::size_t i = 0; i < count; ++i) {
+                auto& rec = records[i];
+                const detail::CompactSegment seg{rec.model, static_cast<std::size_t>(rec.start_idx),
+                                                 static_cast<std::size_t>(rec.end_idx), 0,
+                                                 static_cast<detail::ModelType>(rec.model_type)};
+                std::size_t measured = 0;
+                for (std::size_t j = seg.start_idx; j < seg.end_idx; ++j) {
+                    const std::size_t predicted = detail::clamp_value<std::size_t>(
+                        seg.predict(index.base_[j], index.key_extract_), seg.start_idx, seg.end_idx - 1);
+                    measured = std::max(measured, predicted > j ? predicted - j : j - predicted);
+                }
+                rec.max_error = static_cast<std::uint32_t>(
+                    std::min<std::size_t>(measured, std::numeric_limits<std::uint32_t>::max()));
+            }
+        }
+
+        std::uint64_t written = 0;
+        detail::write_file_section(out, written, 0, &header, sizeof(header));
+        detail::write_file_section(out, written, header.segments_offset, records.data(),
+                                   count * sizeof(detail::FileSegment));
+        detail::write_file_section(out, written, header.route_keys_offset, route_keys.data(), count * sizeof(T));
+        if constexpr (std::is_same_v<typename IndexType::Routing, routing::Eytzinger>) {
+            if (routing_nodes > 0) {
+                const T* nodes = nullptr;
+                if constexpr (std::is_same_v<typename IndexType::Bound, T>) {
+                    nodes = index.router_.keys();
+                } else {
+                    nodes = routing_keys.data();
+                }
+                detail::write_file_section(out, written, header.routing_keys_offset, nodes,
+                                           routing_nodes * sizeof(T));
+                detail::write_file_section(out, written, header.routing_ranks_offset, index.router_.ranks(),
+                                           routing_nodes * sizeof(std::uint32_t));
+            }
+        }
+        if (keys == KeyData::EMBEDDED) {
+            detail::write_file_section(out, written, header.keys_offset, index.base_, index.size_ * sizeof(T));
+        }
+        detail::write_file_section(out, written, header.file_size, nullptr, 0);
+
+        if (!out) {
+            throw std::runtime_error("Failed to write JazzyIndex file");
+        }
+        DEBUG_LOG("IndexSerializer::save: Wrote %zu segments over %zu keys (%llu bytes)",
+                  count, index.size_, static_cast<unsigned long long>(header.file_size));
+    }
+
+    static void load(IndexType& index, std::istream& in, const T* first, const T* last,
+                     Compare comp, KeyExtractor key_extract) {
+        detail::FileHeader header{};
+        detail::read_file_bytes(in, &header, sizeof(header));
+        detail::check_file_header<T>(header, header.file_size);
+
+        const auto size = static_cast<std::size_t>(last - first);
+        if (header.key_count != size) {
+            throw std::runtime_error("JazzyIndex file was saved over " + std::to_string(header.key_count) +
+                                     " keys, but " + std::to_string(size) + " were given");
+        }
+        const auto count = static_cast<std::size_t>(header.segment_count);
+        if (count > index.segment_budget()) {
+            throw std::runtime_error("JazzyIndex file has " + std::to_string(count) +
+                                     " segments, more than this index can hold (" +
+                                     std::to_string(index.segment_budget()) + ")");
+        }
+
+        std::vector<detail::FileSegment> records(count);
+        detail::skip_file_bytes(in, header.segments_offset - sizeof(header));
+        detail::read_file_bytes(in, records.data(), count * sizeof(detail::FileSegment));
+        detail::check_file_segments(records.data(), count, header.key_count);
+        // Route keys and the routing layer are rebuilt from the data (O(segments)); skip the rest
+        detail::skip_file_bytes(in, header.file_size - header.segments_offset - count * sizeof(detail::FileSegment));
+
+        index.base_ = first;
+        index.size_ = size;
+        index.query_path_ = QueryPath::GENERAL;
+        index.key_extract_ = key_extract;
+        index.comp_ = comp;
+        index.error_bound_.reset();
+        index.timings_ = {};
+        if (header.flags & detail::FILE_FLAG_ERROR_BOUNDED) {
+            index.error_bound_ = static_cast<std::size_t>(header.error_bound);
+        }
+        index.is_uniform_ = (header.flags & detail::FILE_FLAG_UNIFORM) != 0;
+        index.segment_scale_ = header.segment_scale;
+        index.num_segments_ = count;
+        if (size == 0) {
+            return;
+        }
+
+        index.min_ = first[0];
+        index.max_ = first[size - 1];
+        index.allocate_segments(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& rec = records[i];
+            const auto start = static_cast<std::size_t>(rec.start_idx);
+            const auto end = static_cast<std::size_t>(rec.end_idx);
+            const auto type = static_cast<detail::ModelType>(rec.model_type);
+            index.segments_.set_extent(i, index.bound_of(first[start]), index.bound_of(first[end - 1]), start, end);
+            auto analysis = detail::unpack_model<T>(type, rec.model);
+            if constexpr (IndexType::SegmentStore::OFFSET_MODELS) {
+                analysis = detail::shift_model(analysis, static_cast<double>(std::invoke(index.key_extract_, first[start])));
+            }
+            index.store_segment_model(i, analysis, rec.max_error);
+        }
+        index.build_routing_tables();
+        DEBUG_LOG("IndexSerializer::load: Restored %zu segments over %zu keys", count, size);
+    }
+};
+
+}  // namespace serialize
+
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+inline void JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::save(std::ostream& out, KeyData keys) const {
+    serialize::IndexSerializer<T, Segments, Compare, KeyExtractor, Options>::save(*this, out, keys);
+}
+
+template <typename T, SegmentCount Segments, typename Compare, typename KeyExtractor, typename Options>
+inline void JazzyIndex<T, Segments, Compare, KeyExtractor, Options>::load(
+    std::istream& in, const T* first, const T* last, Compare comp, KeyExtractor key_extract) {
+    serialize::IndexSerializer<T, Segments, Compare, KeyExtractor, Options>::load(*this, in, first, last,
+                                                                                comp, key_extract);
+}
+
+// Read-only index over a saved index file held in memory (typically a MappedFile): lookups read
+// the segment table, routing layer and keys in place, so opening it costs nothing per key.
+// The view does not own the bytes, which must outlive it and be aligned for T (mmap pages are).
+template <typename T, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity>
+class JazzyIndexView {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Index files store keys as raw bytes; T must be trivially copyable");
+
+public:
+    using const_iterator = const T*;
+    using value_type = T;
+    using size_type = std::size_t;
+
+    JazzyIndexView() = default;
+
+    // View of a file saved with KeyData::EMBEDDED
+    explicit JazzyIndexView(std::span<const std::byte> file, Compare comp = Compare{},
+                            KeyExtractor key_extract = KeyExtractor{})
+        : comp_(comp), key_extract_(key_extract) {
+        const auto& header = attach(file);
+        if (!(header.flags & detail::FILE_FLAG_KEYS_EMBEDDED)) {
+            throw std::invalid_argument("JazzyIndex file has no embedded keys; pass the keys it was saved over");
+        }
+        bind_keys(section<T>(file, header.keys_offset));
+    }
+
+    // View of a file saved with KeyData::EXTERNAL over the sorted keys [first, last)
+    JazzyIndexView(std::span<const std::byte> file, const T* first, const T* last,
+                   Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{})
+        : comp_(comp), key_extract_(key_extract) {
+        const auto& header = attach(file);
+        if (header.key_count != static_cast<std::uint64_t>(last - first)) {
+            throw std::invalid_argument("JazzyIndex file was saved over a different number of keys");
+        }
+        bind_keys(first);
+    }
+
+    [[nodiscard]] const_iterator find(const T& key) const {
+        const const_iterator result = find_lower_bound(key);
+        return result != end() && !comp_(key, *result) ? result : end();
+    }
+
+    [[nodiscard]] std::pair<const_iterator, const_iterator> equal_range(const T& value) const {
+        const const_iterator lower = find_lower_bound(value);
+        if (lower == end() || comp_(value, *lower)) {
+            return {lower, lower};
+        }
+        return {lower, find_upper_bound(value)};
+    }
+
+    // First key not less than value: last-mile search in the segment's error window around the
+    // prediction, widened to the rest of the keys when the answer lies outside it
+    [[nodiscard]] const_iterator find_lower_bound(const T& value) const {
+        if (num_segments_ == 0) {
+            return end();
+        }
+        const auto [lo, hi] = search_window(find_segment(value), value);
+        return detail::windowed_search<false>(keys_, end(), lo, hi, value, comp_);
+    }
+
+    // First key greater than value
+    [[nodiscard]] const_iterator find_upper_bound(const T& value) const {
+        if (num_segments_ == 0) {
+            return end();
+        }
+        const auto [lo, hi] = search_window(find_segment(value), value);
+        return detail::windowed_search<true>(keys_, end(), lo, hi, value, comp_);
+    }
+
+    [[nodiscard]] const_iterator begin() const noexcept { return keys_; }
+    [[nodiscard]] const_iterator end() const noexcept { return keys_ + size_; }
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] std::size_t num_segments() const noexcept { return num_segments_; }
+    [[nodiscard]] bool is_uniform() const noexcept { return is_uniform_; }
+    [[nodiscard]] std::optional<std::size_t> error_bound() const noexcept { return error_bound_; }
+
+private:
+    // Validate the header and segment table and point at the sections (O(segments))
+    const detail::FileHeader& attach(std::span<const std::byte> file) {
+        constexpr std::size_t required_alignment =
+            std::max({alignof(T), alignof(detail::FileSegment), alignof(detail::FileHeader)});
+        if (reinterpret_cast<std::uintptr_t>(file.data()) % required_alignment != 0) {
+            throw std::invalid_argument("JazzyIndex file bytes are not aligned for in-place use");
+        }
+        if (file.size() < sizeof(detail::FileHeader)) {
+            throw std::runtime_error("JazzyIndex file is truncated");
+        }
+        const auto& header = *reinterpret_cast<const detail::FileHeader*>(file.data());
+        detail::check_file_header<T>(header, file.size());
+
+        num_segments_ = static_cast<std::size_t>(header.segment_count);
+        segments_ = section<detail::FileSegment>(file, header.segments_offset);
+        detail::check_file_segments(segments_, num_segments_, header.key_count);
+        route_keys_ = section<T>(file, header.route_keys_offset);
+        if (header.routing_nodes > 0) {
+            routing_count_ = static_cast<std::size_t>(header.routing_nodes) - 1;
+            routing_keys_ = section<T>(file, header.routing_keys_offset);
+            routing_ranks_ = section<std::uint32_t>(file, header.routing_ranks_offset);
+        }
+        size_ = static_cast<std::size_t>(header.key_count);
+        is_uniform_ = (header.flags & detail::FILE_FLAG_UNIFORM) != 0;
+        segment_scale_ = header.segment_scale;
+        if (header.flags & detail::FILE_FLAG_ERROR_BOUNDED) {
+            error_bound_ = static_cast<std::size_t>(header.error_bound);
+        }
+        return header;
+    }
+
+    void bind_keys(const T* keys) {
+        keys_ = keys;
+        if (size_ > 0) {
+            min_key_ = static_cast<double>(std::invoke(key_extract_, keys_[0]));
+        }
+    }
+
+    template <typename U>
+    [[nodiscard]] static const U* section(std::span<const std::byte> file, std::uint64_t offset) noexcept {
+        return reinterpret_cast<const U*>(file.data() + offset);
+    }
+
+    // Segment whose max key is the first not less than value (the last segment catches the rest),
+    // as JazzyIndex::find_segment routes
+    [[nodiscard]] std::size_t find_segment(const T& value) const {
+        if (is_uniform_) {
+            const double offset = static_cast<double>(std::invoke(key_extract_, value)) - min_key_;
+            const auto guess = static_cast<std::size_t>(detail::clamp_value<double>(
+                offset * segment_scale_, 0.0, static_cast<double>(num_segments_ - 1)));
+            if (!comp_(route_keys_[guess], value) && (guess == 0 || comp_(route_keys_[guess - 1], value))) {
+                return guess;
+            }
+        }
+        if (routing_keys_ != nullptr) {
+            return detail::eytzinger_lower_bound(routing_keys_, routing_ranks_, routing_count_, value, comp_);
+        }
+        return static_cast<std::size_t>(
+            std::lower_bound(route_keys_, route_keys_ + num_segments_ - 1, value, comp_) - route_keys_);
+    }
+
+    // Keys within the segment's error window (plus margin) of its model's prediction for value
+    [[nodiscard]] std::pair<const T*, const T*> search_window(std::size_t seg_idx, const T& value) const {
+        const auto& rec = segments_[seg_idx];
+        const detail::CompactSegment seg{rec.model, static_cast<std::size_t>(rec.start_idx),
+                                 static_cast<std::size_t>(rec.end_idx), rec.max_error,
+                                 static_cast<detail::ModelType>(rec.model_type)};
+        const std::size_t predicted =
+            detail::clamp_value<std::size_t>(seg.predict(value, key_extract_), seg.start_idx, seg.end_idx - 1);
+        const std::size_t radius = seg.max_error + detail::SEARCH_RADIUS_MARGIN;
+        const T* lo = keys_ + (predicted > radius ? predicted - radius : 0);
+        const T* hi = keys_ + std::min(size_, predicted + radius + 1);
+        return {lo, hi};
+    }
+
+    const T* keys_{nullptr};
+    std::size_t size_{0};
+    const detail::FileSegment* segments_{nullptr};
+    std::size_t num_segments_{0};
+    const T* route_keys_{nullptr};
+    const T* routing_keys_{nullptr};
+    const std::uint32_t* routing_ranks_{nullptr};
+    std::size_t routing_count_{0};
+    bool is_uniform_{false};
+    double segment_scale_{0.0};
+    double min_key_{0.0};
+    std::optional<std::size_t> error_bound_{};
+    Compare comp_{};
+    KeyExtractor key_extract_{};
+};
+
+#ifdef JAZZY_HAS_MAPPED_FILE
+// Read-only memory mapping of a whole file (POSIX), e.g. an index saved for a JazzyIndexView
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot stat " + path);
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+        if (size_ > 0) {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Cannot map " + path);
+            }
+            data_ = addr;
+        }
+        ::close(fd);  // The mapping keeps the file open
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() { unmap(); }
+
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept {
+        return {static_cast<const std::byte*>(data_), size_};
+    }
+
+private:
+    void unmap() noexcept {
+        if (data_ != nullptr) {
+            ::munmap(data_, size_);
+        }
+    }
+
+    void* data_{nullptr};
+    std::size_t size_{0};
+};
+#endif
+
+}  // namespace jazzy
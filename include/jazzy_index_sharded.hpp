@@ -0,0 +1,576 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_executor.hpp"
+
+namespace jazzy {
+
+// Range-partitioned index for more keys than one JazzyIndex models well. The sorted input is cut
+// into shards of about equal size (never splitting a run of equivalent keys), and each shard gets
+// its own copy of its keys and its own JazzyIndex: a two-level learned index. The root is a
+// linear model from key to shard, corrected by a search over the shard first keys no wider than
+// its measured error.
+//
+// Shards are spread over placement domains, one executor per domain, in contiguous blocks. A
+// shard's keys and index are allocated and built by a task on its domain's executor, and batched
+// queries run each shard's keys on that executor too. Bind each domain's threads to one NUMA node
+// (for example a SchedulerExecutor over workers pinned with pthread_setaffinity_np), and
+// first-touch allocation keeps every shard local to the threads that serve it. A ThreadPool also
+// runs tasks on the thread that submits them, which here is a thread started per domain and not
+// pinned, so use it where placement does not matter.
+//
+// build_pages indexes a sequence that is logically contiguous but stored in pages (a chunked
+// column store, a deque-like buffer) without gathering it into one array: each page becomes a
+// shard that borrows its keys, so every last-mile search stays within one page. Pages may split
+// runs of equivalent keys. Batched lookups can take a prefetch hook, called for every page a
+// batch routes to before any page is searched.
+template <typename T, SegmentCount Segments = SegmentCount::LARGE, typename Compare = std::less<>,
+          typename KeyExtractor = jazzy::identity, typename Options = IndexOptions<>>
+class ShardedJazzyIndex {
+public:
+    using shard_type = JazzyIndex<T, Segments, Compare, KeyExtractor, Options>;
+
+    ShardedJazzyIndex() = default;
+
+    // Build up to shard_count shards over [first, last) (sorted) on the calling thread. Shards
+    // copy their keys, so the input may be released afterwards
+    void build(const T* first, const T* last, std::size_t shard_count, Compare comp = Compare{},
+               KeyExtractor key_extract = KeyExtractor{}) {
+        std::vector<std::unique_ptr<Shard>> shards = make_shards(first, last, shard_count, 1, comp);
+        std::vector<std::exception_ptr> errors(shards.size());
+        for (std::size_t s = 0; s < shards.size(); ++s) {
+            build_shard(*shards[s], first, errors[s], comp, key_extract);
+        }
+        publish(std::move(shards), errors, 1, comp, key_extract);
+    }
+
+    // As build, with shards spread over domains (one executor per placement domain). Every domain
+    // builds its shards concurrently with the others
+    template <parallel::Executor Exec>
+    void build(const T* first, const T* last, std::size_t shard_count, const std::vector<Exec*>& domains,
+               Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
+        if (domains.empty()) {
+            throw std::invalid_argument("ShardedJazzyIndex needs at least one placement domain");
+        }
+        std::vector<std::unique_ptr<Shard>> shards = make_shards(first, last, shard_count, domains.size(), comp);
+        std::vector<std::exception_ptr> errors(shards.size());
+        for_each_domain(domains.size(), [&](std::size_t d) {
+            const auto [begin, end] = domain_shards(shards, d);
+            domains[d]->bulk_execute(end - begin, [&, begin](std::size_t j) {
+                build_shard(*shards[begin + j], first, errors[begin + j], comp, key_extract);
+            });
+        });
+        publish(std::move(shards), errors, domains.size(), comp, key_extract);
+    }
+
+    // Build one shard per non-empty page of pages (a range of contiguous ranges, each sorted and
+    // ordered after the one before) on the calling thread. Shards borrow the pages instead of
+    // copying them, so the pages must stay alive and in place while the index is used
+    template <std::ranges::input_range Pages>
+    void build_pages(const Pages& pages, Compare comp = Compare{}, KeyExtractor key_extract = KeyExtractor{}) {
+        std::vector<std::unique_ptr<Shard>> shards = make_page_shards(pages, 1, comp);
+        std::vector<std::exception_ptr> errors(shards.size());
+        for (std::size_t s = 0; s < shards.size(); ++s) {
+            build_page_shard(*shards[s], errors[s], comp, key_extract);
+        }
+        publish(std::move(shards), errors, 1, comp, key_extract);
+    }
+
+    // As build_pages, with the pages' shards spread over domains like build's
+    template <std::ranges::input_range Pages, parallel::Executor Exec>
+    void build_pages(const Pages& pages, const std::vector<Exec*>& domains, Compare comp = Compare{},
+                     KeyExtractor key_extract = KeyExtractor{}) {
+        if (domains.empty()) {
+            throw std::invalid_argument("ShardedJazzyIndex needs at least one placement domain");
+        }
+        std::vector<std::unique_ptr<Shard>> shards = make_page_shards(pages, domains.size(), comp);
+        std::vector<std::exception_ptr> errors(shards.size());
+        for_each_domain(domains.size(), [&](std::size_t d) {
+            const auto [begin, end] = domain_shards(shards, d);
+            domains[d]->bulk_execute(end - begin, [&, begin](std::size_t j) {
+                build_page_shard(*shards[begin + j], errors[begin + j], comp, key_extract);
+            });
+        });
+        publish(std::move(shards), errors, domains.size(), comp, key_extract);
+    }
+
+    // A stored key equivalent to key, or nullptr
+    [[nodiscard]] const T* find(const T& key) const {
+        if (shards_.empty()) {
+            return nullptr;
+        }
+        const Shard& shard = *shards_[route(key)];
+        const T* found = shard.index.find(key);
+        return found == shard.end_ptr() ? nullptr : found;
+    }
+
+    [[nodiscard]] bool contains(const T& key) const { return find(key) != nullptr; }
+
+    // First stored key not less than value, or nullptr
+    [[nodiscard]] const T* find_lower_bound(const T& value) const {
+        if (shards_.empty()) {
+            return nullptr;
+        }
+        const std::size_t s = route_before(value);
+        return past_shard_end(s, shards_[s]->index.find_lower_bound(value));
+    }
+
+    // First stored key greater than value, or nullptr
+    [[nodiscard]] const T* find_upper_bound(const T& value) const {
+        if (shards_.empty()) {
+            return nullptr;
+        }
+        const std::size_t s = route(value);
+        return past_shard_end(s, shards_[s]->index.find_upper_bound(value));
+    }
+
+    // Batched lookups on the calling thread: out[i] receives find(keys[i]). Keys are grouped by
+    // shard and each group runs through the shard's JazzyIndex::find_batch
+    void find_batch(std::span<const T> keys, std::span<const T*> out) const {
+        run_batch<Query::FIND>(keys, out);
+    }
+
+    void find_lower_bound_batch(std::span<const T> keys, std::span<const T*> out) const {
+        run_batch<Query::LOWER_BOUND>(keys, out);
+    }
+
+    void find_upper_bound_batch(std::span<const T> keys, std::span<const T*> out) const {
+        run_batch<Query::UPPER_BOUND>(keys, out);
+    }
+
+    // Batched lookups on the calling thread that first call prefetch(s, shard_keys(s)) for every
+    // shard the keys route to, in shard order, before searching any of them: a hook to start
+    // fetching pages from slow storage (madvise(MADV_WILLNEED), an async read) ahead of their
+    // searches
+    template <typename Prefetch>
+        requires std::invocable<Prefetch&, std::size_t, std::span<const T>>
+    void find_batch(std::span<const T> keys, std::span<const T*> out, Prefetch&& prefetch) const {
+        run_batch<Query::FIND>(keys, out, prefetch);
+    }
+
+    template <typename Prefetch>
+        requires std::invocable<Prefetch&, std::size_t, std::span<const T>>
+    void find_lower_bound_batch(std::span<const T> keys, std::span<const T*> out, Prefetch&& prefetch) const {
+        run_batch<Query::LOWER_BOUND>(keys, out, prefetch);
+    }
+
+    template <typename Prefetch>
+        requires std::invocable<Prefetch&, std::size_t, std::span<const T>>
+    void find_upper_bound_batch(std::span<const T> keys, std::span<const T*> out, Prefetch&& prefetch) const {
+        run_batch<Query::UPPER_BOUND>(keys, out, prefetch);
+    }
+
+    // Batched lookups sent to the owning shards' domains: domains must be the executors of the
+    // build, in the same order. Routing runs on the calling thread; each domain then answers the
+    // keys of its shards, concurrently with the other domains
+    template <parallel::Executor Exec>
+    void find_batch(std::span<const T> keys, std::span<const T*> out, const std::vector<Exec*>& domains) const {
+        run_batch<Query::FIND>(keys, out, domains);
+    }
+
+    template <parallel::Executor Exec>
+    void find_lower_bound_batch(std::span<const T> keys, std::span<const T*> out,
+                                const std::vector<Exec*>& domains) const {
+        run_batch<Query::LOWER_BOUND>(keys, out, domains);
+    }
+
+    template <parallel::Executor Exec>
+    void find_upper_bound_batch(std::span<const T> keys, std::span<const T*> out,
+                                const std::vector<Exec*>& domains) const {
+        run_batch<Query::UPPER_BOUND>(keys, out, domains);
+    }
+
+    // Shard holding value, or the shard its bounds start in (requires a built, non-empty index)
+    [[nodiscard]] std::size_t route(const T& value) const { return route_window<true>(value); }
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+    [[nodiscard]] bool empty() const noexcept { return size_ == 0; }
+    [[nodiscard]] std::size_t num_shards() const noexcept { return shards_.size(); }
+    [[nodiscard]] std::size_t num_domains() const noexcept { return num_domains_; }
+
+    [[nodiscard]] const shard_type& shard(std::size_t s) const { return shards_[s]->index; }
+    [[nodiscard]] std::span<const T> shard_keys(std::size_t s) const { return shards_[s]->keys; }
+    [[nodiscard]] std::size_t shard_domain(std::size_t s) const { return shards_[s]->domain; }
+
+    // Most shards the root model can be off by, before the search over shard first keys
+    [[nodiscard]] std::size_t root_error() const noexcept { return root_error_; }
+
+    // Bytes held by the shard indexes and the root (not the keys, copied or borrowed)
+    [[nodiscard]] std::size_t memory_usage() const noexcept {
+        std::size_t bytes = sizeof(*this) + shards_.capacity() * sizeof(std::unique_ptr<Shard>) +
+                            first_keys_.capacity() * sizeof(T);
+        for (const auto& shard : shards_) {
+            bytes += sizeof(Shard) - sizeof(shard_type) + shard->index.memory_usage();
+        }
+        return bytes;
+    }
+
+private:
+    enum class Query : uint8_t { FIND, LOWER_BOUND, UPPER_BOUND };
+
+    struct Shard {
+        std::vector<T> storage;   // The shard's copy of its keys (empty when it borrows a page)
+        std::span<const T> keys;  // storage, or the borrowed page
+        shard_type index;
+        std::size_t begin = 0;    // Position of keys[0] in the build input (across all pages)
+        std::size_t end = 0;
+        std::size_t domain = 0;
+
+        [[nodiscard]] const T* end_ptr() const noexcept { return keys.data() + keys.size(); }
+    };
+
+    // Cut [first, last) into at most shard_count ranges of about equal size, moving each cut past
+    // any run of keys equivalent to the one before it, and assign them to domains in blocks
+    static std::vector<std::unique_ptr<Shard>> make_shards(const T* first, const T* last, std::size_t shard_count,
+                                                           std::size_t domain_count, Compare comp) {
+        if (shard_count == 0) {
+            throw std::invalid_argument("ShardedJazzyIndex needs at least one shard");
+        }
+        const std::size_t n = static_cast<std::size_t>(last - first);
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::size_t begin = 0;
+        for (std::size_t s = 1; s <= shard_count && begin < n; ++s) {
+            std::size_t end = s == shard_count ? n : std::max(begin + 1, s * n / shard_count);
+            if (end < n && !comp(first[end - 1], first[end]) && !comp(first[end], first[end - 1])) {
+                end = static_cast<std::size_t>(std::upper_bound(first + end, last, first[end - 1], comp) - first);
+            }
+            if (end < n && comp(first[end], first[end - 1])) {
+                throw std::runtime_error(
+                    "Input data is not sorted. JazzyIndex requires sorted data. "
+                    "Please sort your data before building the index."
+                );
+            }
+            auto shard = std::make_unique<Shard>();
+            shard->begin = begin;
+            shard->end = end;
+            shards.push_back(std::move(shard));
+            begin = end;
+        }
+        assign_domains(shards, domain_count);
+        return shards;
+    }
+
+    // One shard per non-empty page, borrowing it; pages must continue the order of the one before
+    template <typename Pages>
+    static std::vector<std::unique_ptr<Shard>> make_page_shards(const Pages& pages, std::size_t domain_count,
+                                                                Compare comp) {
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::size_t begin = 0;
+        for (const auto& page : pages) {
+            const std::span<const T> keys(std::ranges::data(page), std::ranges::size(page));
+            if (keys.empty()) {
+                continue;
+            }
+            if (!shards.empty() && comp(keys.front(), shards.back()->keys.back())) {
+                throw std::runtime_error(
+                    "Input data is not sorted. JazzyIndex requires sorted data. "
+                    "Please sort your data before building the index."
+                );
+            }
+            auto shard = std::make_unique<Shard>();
+            shard->keys = keys;
+            shard->begin = begin;
+            shard->end = begin + keys.size();
+            begin = shard->end;
+            shards.push_back(std::move(shard));
+        }
+        assign_domains(shards, domain_count);
+        return shards;
+    }
+
+    static void assign_domains(std::vector<std::unique_ptr<Shard>>& shards, std::size_t domain_count) {
+        for (std::size_t s = 0; s < shards.size(); ++s) {
+            shards[s]->domain = s * domain_count / shards.size();
+        }
+    }
+
+    // Runs on the shard's domain: the key copy and the index tables are first touched here
+    static void build_shard(Shard& shard, const T* input, std::exception_ptr& error, Compare comp,
+                            KeyExtractor key_extract) {
+        try {
+            shard.storage.assign(input + shard.begin, input + shard.end);
+            shard.keys = shard.storage;
+            shard.index.build(shard.keys.data(), shard.keys.data() + shard.keys.size(), comp, key_extract);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    // Runs on the shard's domain: only the index tables are first touched here
+    static void build_page_shard(Shard& shard, std::exception_ptr& error, Compare comp, KeyExtractor key_extract) {
+        try {
+            shard.index.build(shard.keys.data(), shard.keys.data() + shard.keys.size(), comp, key_extract);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    // [begin, end) of the shards assigned to domain d (shards are dealt out in contiguous blocks)
+    static std::pair<std::size_t, std::size_t> domain_shards(const std::vector<std::unique_ptr<Shard>>& shards,
+                                                             std::size_t d) {
+        const auto in_domain = [d](const std::unique_ptr<Shard>& shard) { return shard->domain < d; };
+        const auto begin = std::partition_point(shards.begin(), shards.end(), in_domain);
+        const auto end = std::partition_point(begin, shards.end(),
+                                              [d](const std::unique_ptr<Shard>& shard) { return shard->domain <= d; });
+        return {static_cast<std::size_t>(begin - shards.begin()), static_cast<std::size_t>(end - shards.begin())};
+    }
+
+    // Run fn(d) for every domain at once: domain 0 on the calling thread, the rest on threads
+    // started for the call (each of which only submits to and waits on its domain's executor)
+    template <typename Fn>
+    static void for_each_domain(std::size_t count, Fn&& fn) {
+        std::vector<std::jthread> submitters;
+        submitters.reserve(count - 1);
+        for (std::size_t d = 1; d < count; ++d) {
+            submitters.emplace_back([&fn, d] { fn(d); });
+        }
+        fn(0);
+    }
+
+    // Re-throw the first shard error (in key order), or swap the shards in and fit the root
+    void publish(std::vector<std::unique_ptr<Shard>> shards, const std::vector<std::exception_ptr>& errors,
+                 std::size_t domain_count, Compare comp, KeyExtractor key_extract) {
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        shards_ = std::move(shards);
+        comp_ = comp;
+        key_extract_ = key_extract;
+        num_domains_ = domain_count;
+        size_ = shards_.empty() ? 0 : shards_.back()->end;
+        first_keys_.clear();
+        for (const auto& shard : shards_) {
+            first_keys_.push_back(shard->keys.front());
+        }
+        fit_root();
+        DEBUG_LOG("ShardedJazzyIndex::build: %zu keys in %zu shards over %zu domains, root error %zu",
+                  size_, shards_.size(), num_domains_, root_error_);
+    }
+
+    // Least-squares line from key to shard number through the shard first keys. The line is
+    // monotone, so a key between two first keys is predicted between their predictions, and one
+    // more than the worst error at a first key bounds the error for every key
+    void fit_root() {
+        const std::size_t count = first_keys_.size();
+        root_slope_ = 0.0;
+        root_intercept_ = 0.0;
+        root_error_ = 0;
+        if (count < 2) {
+            return;
+        }
+        double mean_x = 0.0;
+        double mean_y = 0.0;
+        for (std::size_t s = 0; s < count; ++s) {
+            mean_x += key_of(first_keys_[s]);
+            mean_y += static_cast<double>(s);
+        }
+        mean_x /= static_cast<double>(count);
+        mean_y /= static_cast<double>(count);
+        double sxx = 0.0;
+        double sxy = 0.0;
+        for (std::size_t s = 0; s < count; ++s) {
+            const double dx = key_of(first_keys_[s]) - mean_x;
+            sxx += dx * dx;
+            sxy += dx * (static_cast<double>(s) - mean_y);
+        }
+        if (sxx > 0.0 && std::isfinite(sxx) && std::isfinite(sxy)) {
+            root_slope_ = sxy / sxx;
+            root_intercept_ = mean_y - root_slope_ * mean_x;
+        } else {
+            root_intercept_ = mean_y;
+        }
+        std::size_t worst = 0;
+        for (std::size_t s = 0; s < count; ++s) {
+            const std::size_t predicted = predict_shard(first_keys_[s]);
+            worst = std::max(worst, predicted > s ? predicted - s : s - predicted);
+        }
+        root_error_ = worst + 1;
+    }
+
+    // With Inclusive, the last shard starting at or before value (route); otherwise the last
+    // shard starting before it, where a lower bound of value starts when a run of keys
+    // equivalent to value crosses into later shards (build_pages can split runs). The root's
+    // error covers every shard starting with the same key, so both lie in its window
+    template <bool Inclusive>
+    [[nodiscard]] std::size_t route_window(const T& value) const {
+        const std::size_t count = shards_.size();
+        const std::size_t predicted = predict_shard(value);
+        const std::size_t lo = std::max<std::size_t>(predicted > root_error_ ? predicted - root_error_ : 0, 1);
+        const std::size_t hi = std::min(count, predicted + root_error_ + 1);
+        if (lo >= hi) {
+            return lo - 1;
+        }
+        // Shard s starts at first_keys_[s]
+        const auto first = first_keys_.begin() + static_cast<std::ptrdiff_t>(lo);
+        const auto last = first_keys_.begin() + static_cast<std::ptrdiff_t>(hi);
+        const auto it = Inclusive ? std::upper_bound(first, last, value, comp_)
+                                  : std::lower_bound(first, last, value, comp_);
+        return static_cast<std::size_t>(it - first_keys_.begin()) - 1;
+    }
+
+    [[nodiscard]] std::size_t route_before(const T& value) const { return route_window<false>(value); }
+
+    [[nodiscard]] double key_of(const T& value) const {
+        return static_cast<double>(std::invoke(key_extract_, value));
+    }
+
+    [[nodiscard]] std::size_t predict_shard(const T& value) const {
+        const double predicted = std::round(root_slope_ * key_of(value) + root_intercept_);
+        const double top = static_cast<double>(shards_.size() - 1);
+        if (!(predicted > 0.0)) {  // Also catches NaN
+            return 0;
+        }
+        return predicted >= top ? shards_.size() - 1 : static_cast<std::size_t>(predicted);
+    }
+
+    // A shard's answer, or the next shard's first key when the bound lies past this shard's end
+    [[nodiscard]] const T* past_shard_end(std::size_t s, const T* found) const {
+        if (found != shards_[s]->end_ptr()) {
+            return found;
+        }
+        return s + 1 < shards_.size() ? shards_[s + 1]->keys.data() : nullptr;
+    }
+
+    // Group keys by shard: order lists key positions shard by shard, offsets[s] where shard s starts
+    template <Query Q>
+    void group_by_shard(std::span<const T> keys, std::vector<std::size_t>& order,
+                        std::vector<std::size_t>& offsets) const {
+        std::vector<std::size_t> owner(keys.size());
+        offsets.assign(shards_.size() + 1, 0);
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            owner[i] = Q == Query::LOWER_BOUND ? route_before(keys[i]) : route(keys[i]);
+            ++offsets[owner[i] + 1];
+        }
+        for (std::size_t s = 0; s < shards_.size(); ++s) {
+            offsets[s + 1] += offsets[s];
+        }
+        order.resize(keys.size());
+        std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            order[next[owner[i]]++] = i;
+        }
+    }
+
+    // Answer shard s's group of keys with its batched lookups and scatter the results into out
+    template <Query Q>
+    void query_shard(std::size_t s, std::span<const T> keys, std::span<const std::size_t> positions,
+                     std::span<const T*> out) const {
+        if (positions.empty()) {
+            return;
+        }
+        std::vector<T> gathered;
+        gathered.reserve(positions.size());
+        for (const std::size_t i : positions) {
+            gathered.push_back(keys[i]);
+        }
+        std::vector<const T*> results(positions.size());
+        const shard_type& index = shards_[s]->index;
+        if constexpr (Q == Query::FIND) {
+            index.find_batch(gathered, results);
+        } else if constexpr (Q == Query::LOWER_BOUND) {
+            index.find_lower_bound_batch(gathered, results);
+        } else {
+            index.find_upper_bound_batch(gathered, results);
+        }
+        for (std::size_t j = 0; j < positions.size(); ++j) {
+            if constexpr (Q == Query::FIND) {
+                out[positions[j]] = results[j] == shards_[s]->end_ptr() ? nullptr : results[j];
+            } else {
+                out[positions[j]] = past_shard_end(s, results[j]);
+            }
+        }
+    }
+
+    template <Query Q>
+    void run_batch(std::span<const T> keys, std::span<const T*> out) const {
+        auto no_prefetch = [](std::size_t, std::span<const T>) {};
+        run_batch<Q>(keys, out, no_prefetch);
+    }
+
+    template <Query Q, typename Prefetch>
+        requires std::invocable<Prefetch&, std::size_t, std::span<const T>>
+    void run_batch(std::span<const T> keys, std::span<const T*> out, Prefetch& prefetch) const {
+        if (out.size() < keys.size()) {
+            throw std::invalid_argument("Batch output span is smaller than the key span");
+        }
+        if (shards_.empty()) {
+            std::fill_n(out.begin(), keys.size(), nullptr);
+            return;
+        }
+        std::vector<std::size_t> order;
+        std::vector<std::size_t> offsets;
+        group_by_shard<Q>(keys, order, offsets);
+        for (std::size_t s = 0; s < shards_.size(); ++s) {
+            if (offsets[s + 1] > offsets[s]) {
+                prefetch(s, shard_keys(s));
+            }
+        }
+        for (std::size_t s = 0; s < shards_.size(); ++s) {
+            query_shard<Q>(s, keys, std::span(order).subspan(offsets[s], offsets[s + 1] - offsets[s]), out);
+        }
+    }
+
+    template <Query Q, typename Exec>
+    void run_batch(std::span<const T> keys, std::span<const T*> out, const std::vector<Exec*>& domains) const {
+        if (domains.size() != num_domains_) {
+            throw std::invalid_argument("Batched queries need the placement domains the index was built with");
+        }
+        if (out.size() < keys.size()) {
+            throw std::invalid_argument("Batch output span is smaller than the key span");
+        }
+        if (shards_.empty()) {
+            std::fill_n(out.begin(), keys.size(), nullptr);
+            return;
+        }
+        std::vector<std::size_t> order;
+        std::vector<std::size_t> offsets;
+        group_by_shard<Q>(keys, order, offsets);
+        // Shards write disjoint positions of out, so domains and their tasks never share a slot
+        std::vector<std::exception_ptr> errors(shards_.size());
+        for_each_domain(num_domains_, [&](std::size_t d) {
+            const auto [begin, end] = domain_shards(shards_, d);
+            domains[d]->bulk_execute(end - begin, [&, begin](std::size_t j) {
+                const std::size_t s = begin + j;
+                try {
+                    query_shard<Q>(s, keys, std::span(order).subspan(offsets[s], offsets[s + 1] - offsets[s]), out);
+                } catch (...) {
+                    errors[s] = std::current_exception();
+                }
+            });
+        });
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Shard>> shards_{};  // In key order; shards of a domain are contiguous
+    std::vector<T> first_keys_{};                   // first_keys_[s] = shards_[s]->keys.front()
+    double root_slope_{0.0};
+    double root_intercept_{0.0};
+    std::size_t root_error_{0};
+    std::size_t size_{0};
+    std::size_t num_domains_{0};
+    Compare comp_{};
+    KeyExtractor key_extract_{};
+};
+
+}  // namespace jazzy
@@ -0,0 +1,349 @@
+#pragma once
+
+// Vector kernels for batched lookups (segment routing and model evaluation) and for the
+// last-mile scan of a short key window. Each kernel has a scalar fallback with identical results,
+// so callers never need to know which instruction set was used.
+// Define JAZZY_DISABLE_SIMD to force the scalar kernels.
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if !defined(JAZZY_DISABLE_SIMD)
+#if defined(__AVX512F__)
+#define JAZZY_SIMD_AVX512 1
+#include <immintrin.h>
+#elif defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))  // MSVC /arch:AVX2 implies FMA
+#define JAZZY_SIMD_AVX2 1
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define JAZZY_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace jazzy::detail {
+
+// Segment model in cubic form: ((a*x + b)*x + c)*x + d
+// LINEAR is (0, 0, slope, intercept), QUADRATIC is (0, a, b, c) and CONSTANT is all zeros,
+// which evaluate bit-for-bit like Segment::predict (fma(x, 0, k) == k for finite x)
+struct alignas(16) PackedModel {
+    float a;
+    float b;
+    float c;
+    float d;
+};
+
+namespace simd {
+
+// Name of the compiled-in kernel set (reported by benchmarks)
+[[nodiscard]] constexpr const char* kernel_name() noexcept {
+#if defined(JAZZY_SIMD_AVX512)
+    return "avx512";
+#elif defined(JAZZY_SIMD_AVX2)
+    return "avx2";
+#elif defined(JAZZY_SIMD_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+// Scalar reference kernels (also used for the tail of each group)
+inline std::uint32_t route_uniform_one(double key, double min_key, double scale, double last) noexcept {
+    double pos = (key - min_key) * scale;
+    pos = pos < last ? pos : last;   // NaN clamps to the last segment
+    pos = pos > 0.0 ? pos : 0.0;
+    return static_cast<std::uint32_t>(pos);
+}
+
+inline std::uint32_t route_sorted_one(const double* bounds, std::size_t n, double key) noexcept {
+    // Branchless lower_bound: every key takes the same log2(n) steps
+    const double* base = bounds;
+    std::size_t len = n;
+    while (len > 1) {
+        const std::size_t half = len / 2;
+        base = (base[half] < key) ? base + half : base;
+        len -= half;
+    }
+    const std::size_t idx = static_cast<std::size_t>(base - bounds) + (*base < key ? 1 : 0);
+    return static_cast<std::uint32_t>(std::min(idx, n - 1));
+}
+
+inline double predict_one(const PackedModel& m, double key) noexcept {
+    double pred = std::fma(key, static_cast<double>(m.a), static_cast<double>(m.b));
+    pred = std::fma(key, pred, static_cast<double>(m.c));
+    pred = std::fma(key, pred, static_cast<double>(m.d));
+    return std::max(0.0, pred);  // NaN maps to 0, as in Segment::predict
+}
+
+// out[i] = segment guess for uniform data: clamp((keys[i] - min_key) * scale, 0, n - 1)
+inline void route_uniform(const double* keys, std::size_t count, double min_key, double scale,
+                          std::size_t num_segments, std::uint32_t* out) noexcept {
+    const double last = static_cast<double>(num_segments - 1);
+    std::size_t i = 0;
+#if defined(JAZZY_SIMD_AVX512)
+    const __m512d vmin = _mm512_set1_pd(min_key);
+    const __m512d vscale = _mm512_set1_pd(scale);
+    const __m512d vlast = _mm512_set1_pd(last);
+    const __m512d vzero = _mm512_setzero_pd();
+    for (; i + 8 <= count; i += 8) {
+        __m512d pos = _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(keys + i), vmin), vscale);
+        pos = _mm512_max_pd(_mm512_min_pd(pos, vlast), vzero);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvttpd_epi32(pos));
+    }
+#elif defined(JAZZY_SIMD_AVX2)
+    const __m256d vmin = _mm256_set1_pd(min_key);
+    const __m256d vscale = _mm256_set1_pd(scale);
+    const __m256d vlast = _mm256_set1_pd(last);
+    const __m256d vzero = _mm256_setzero_pd();
+    for (; i + 4 <= count; i += 4) {
+        __m256d pos = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(keys + i), vmin), vscale);
+        pos = _mm256_max_pd(_mm256_min_pd(pos, vlast), vzero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvttpd_epi32(pos));
+    }
+#elif defined(JAZZY_SIMD_NEON)
+    const float64x2_t vmin = vdupq_n_f64(min_key);
+    const float64x2_t vscale = vdupq_n_f64(scale);
+    const float64x2_t vlast = vdupq_n_f64(last);
+    const float64x2_t vzero = vdupq_n_f64(0.0);
+    for (; i + 2 <= count; i += 2) {
+        float64x2_t pos = vmulq_f64(vsubq_f64(vld1q_f64(keys + i), vmin), vscale);
+        pos = vmaxnmq_f64(vminnmq_f64(pos, vlast), vzero);
+        // minnm(NaN, last) returns last, matching the scalar clamp
+        vst1_u32(out + i, vmovn_u64(vcvtq_u64_f64(pos)));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = route_uniform_one(keys[i], min_key, scale, last);
+    }
+}
+
+// out[i] = first j with bounds[j] >= keys[i], clamped to n - 1 (bounds ascending, n >= 1)
+// Lanes walk the bounds in lockstep, so each step is one gather and one compare
+inline void route_sorted(const double* bounds, std::size_t n, const double* keys, std::size_t count,
+                         std::uint32_t* out) noexcept {
+    std::size_t i = 0;
+#if defined(JAZZY_SIMD_AVX512)
+    const __m512i vlast = _mm512_set1_epi64(static_cast<long long>(n - 1));
+    for (; i + 8 <= count; i += 8) {
+        const __m512d vkey = _mm512_loadu_pd(keys + i);
+        __m512i idx = _mm512_setzero_si512();
+        std::size_t len = n;
+        while (len > 1) {
+            const std::size_t half = len / 2;
+            const __m512d probe = _mm512_i64gather_pd(idx, bounds + half, 8);
+            const __mmask8 less = _mm512_cmp_pd_mask(probe, vkey, _CMP_LT_OQ);
+            idx = _mm512_mask_add_epi64(idx, less, idx, _mm512_set1_epi64(static_cast<long long>(half)));
+            len -= half;
+        }
+        const __m512d probe = _mm512_i64gather_pd(idx, bounds, 8);
+        const __mmask8 less = _mm512_cmp_pd_mask(probe, vkey, _CMP_LT_OQ);
+        idx = _mm512_mask_add_epi64(idx, less, idx, _mm512_set1_epi64(1));
+        idx = _mm512_min_epu64(idx, vlast);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtepi64_epi32(idx));
+    }
+#elif defined(JAZZY_SIMD_AVX2)
+    for (; i + 4 <= count; i += 4) {
+        const __m256d vkey = _mm256_loadu_pd(keys + i);
+        __m256i idx = _mm256_setzero_si256();
+        std::size_t len = n;
+        while (len > 1) {
+            const std::size_t half = len / 2;
+            const __m256d probe = _mm256_i64gather_pd(bounds + half, idx, 8);
+            const __m256i less = _mm256_castpd_si256(_mm256_cmp_pd(probe, vkey, _CMP_LT_OQ));
+            idx = _mm256_add_epi64(idx, _mm256_and_si256(less, _mm256_set1_epi64x(static_cast<long long>(half))));
+            len -= half;
+        }
+        const __m256d probe = _mm256_i64gather_pd(bounds, idx, 8);
+        const __m256i less = _mm256_castpd_si256(_mm256_cmp_pd(probe, vkey, _CMP_LT_OQ));
+        idx = _mm256_sub_epi64(idx, less);  // mask lanes are -1
+        alignas(32) std::uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), idx);
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            out[i + lane] = static_cast<std::uint32_t>(std::min<std::uint64_t>(lanes[lane], n - 1));
+        }
+    }
+#elif defined(JAZZY_SIMD_NEON)
+    for (; i + 2 <= count; i += 2) {
+        const float64x2_t vkey = vld1q_f64(keys + i);
+        std::uint64_t lo = 0;
+        std::uint64_t hi = 0;
+        std::size_t len = n;
+        while (len > 1) {
+            const std::size_t half = len / 2;
+            float64x2_t probe = vdupq_n_f64(bounds[lo + half]);
+            probe = vsetq_lane_f64(bounds[hi + half], probe, 1);
+            const uint64x2_t step = vandq_u64(vcltq_f64(probe, vkey), vdupq_n_u64(half));
+            lo += vgetq_lane_u64(step, 0);
+            hi += vgetq_lane_u64(step, 1);
+            len -= half;
+        }
+        lo += bounds[lo] < keys[i] ? 1 : 0;
+        hi += bounds[hi] < keys[i + 1] ? 1 : 0;
+        out[i] = static_cast<std::uint32_t>(std::min<std::uint64_t>(lo, n - 1));
+        out[i + 1] = static_cast<std::uint32_t>(std::min<std::uint64_t>(hi, n - 1));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = route_sorted_one(bounds, n, keys[i]);
+    }
+}
+
+// out[i] = max(0, model(keys[i])) using the packed model of segment seg[i]
+inline void predict(const PackedModel* models, const std::uint32_t* seg, const double* keys,
+                    std::size_t count, double* out) noexcept {
+    std::size_t i = 0;
+#if defined(JAZZY_SIMD_AVX512) || defined(JAZZY_SIMD_AVX2)
+    const float* coeffs = &models[0].a;
+#endif
+#if defined(JAZZY_SIMD_AVX512)
+    const __m512d vzero = _mm512_setzero_pd();
+    for (; i + 8 <= count; i += 8) {
+        // Coefficient k of segment s lives at float offset 4*s + k
+        const __m256i offs = _mm256_slli_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(seg + i)), 2);
+        const __m512d a = _mm512_cvtps_pd(_mm256_i32gather_ps(coeffs + 0, offs, 4));
+        const __m512d b = _mm512_cvtps_pd(_mm256_i32gather_ps(coeffs + 1, offs, 4));
+        const __m512d c = _mm512_cvtps_pd(_mm256_i32gather_ps(coeffs + 2, offs, 4));
+        const __m512d d = _mm512_cvtps_pd(_mm256_i32gather_ps(coeffs + 3, offs, 4));
+        const __m512d x = _mm512_loadu_pd(keys + i);
+        __m512d pred = _mm512_fmadd_pd(x, a, b);
+        pred = _mm512_fmadd_pd(x, pred, c);
+        pred = _mm512_fmadd_pd(x, pred, d);
+        _mm512_storeu_pd(out + i, _mm512_max_pd(pred, vzero));  // NaN lanes take the second operand
+    }
+#elif defined(JAZZY_SIMD_AVX2)
+    const __m256d vzero = _mm256_setzero_pd();
+    for (; i + 4 <= count; i += 4) {
+        const __m128i offs = _mm_slli_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(seg + i)), 2);
+        const __m256d a = _mm256_cvtps_pd(_mm_i32gather_ps(coeffs + 0, offs, 4));
+        const __m256d b = _mm256_cvtps_pd(_mm_i32gather_ps(coeffs + 1, offs, 4));
+        const __m256d c = _mm256_cvtps_pd(_mm_i32gather_ps(coeffs + 2, offs, 4));
+        const __m256d d = _mm256_cvtps_pd(_mm_i32gather_ps(coeffs + 3, offs, 4));
+        const __m256d x = _mm256_loadu_pd(keys + i);
+        __m256d pred = _mm256_fmadd_pd(x, a, b);
+        pred = _mm256_fmadd_pd(x, pred, c);
+        pred = _mm256_fmadd_pd(x, pred, d);
+        _mm256_storeu_pd(out + i, _mm256_max_pd(pred, vzero));
+    }
+#elif defined(JAZZY_SIMD_NEON)
+    const float64x2_t vzero = vdupq_n_f64(0.0);
+    for (; i + 2 <= count; i += 2) {
+        // One 16-byte load per segment, then widen and transpose into coefficient vectors
+        const float32x4_t m0 = vld1q_f32(&models[seg[i]].a);
+        const float32x4_t m1 = vld1q_f32(&models[seg[i + 1]].a);
+        const float32x4_t ab = vzip1q_f32(m0, m1);  // a0 a1 b0 b1
+        const float32x4_t cd = vzip2q_f32(m0, m1);  // c0 c1 d0 d1
+        const float64x2_t a = vcvt_f64_f32(vget_low_f32(ab));
+        const float64x2_t b = vcvt_high_f64_f32(ab);
+        const float64x2_t c = vcvt_f64_f32(vget_low_f32(cd));
+        const float64x2_t d = vcvt_high_f64_f32(cd);
+        const float64x2_t x = vld1q_f64(keys + i);
+        float64x2_t pred = vfmaq_f64(b, x, a);
+        pred = vfmaq_f64(c, x, pred);
+        pred = vfmaq_f64(d, x, pred);
+        vst1q_f64(out + i, vmaxnmq_f64(pred, vzero));  // maxnm returns 0 for NaN lanes
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = predict_one(models[seg[i]], keys[i]);
+    }
+}
+
+// Number of keys[0..n) ordered before value: keys[i] < value, or !(value < keys[i]) with Upper.
+// Over a sorted window that is the offset of its lower (upper) bound. double and 64-bit integer
+// keys are compared a vector at a time, the last partial vector through a masked load so short
+// windows take no scalar tail; other key types use the scalar loop.
+template <bool Upper, typename K>
+[[nodiscard]] inline std::size_t count_before(const K* keys, std::size_t n, K value) noexcept {
+    std::size_t i = 0;
+    std::size_t count = 0;
+    [[maybe_unused]] constexpr bool is_double = std::is_same_v<K, double>;
+    [[maybe_unused]] constexpr bool is_int64 = std::is_integral_v<K> && sizeof(K) == 8;
+#if defined(JAZZY_SIMD_AVX512)
+    if constexpr (is_double || is_int64) {
+        for (; i < n; i += 8) {
+            const auto valid = static_cast<__mmask8>(n - i >= 8 ? 0xFF : (1u << (n - i)) - 1);
+            __mmask8 m;
+            if constexpr (is_double) {
+                const __m512d v = _mm512_set1_pd(value);
+                const __m512d x = _mm512_maskz_loadu_pd(valid, keys + i);
+                // NLT_UQ is true for NaN, like the scalar !(value < key)
+                m = Upper ? _mm512_mask_cmp_pd_mask(valid, v, x, _CMP_NLT_UQ)
+                          : _mm512_mask_cmp_pd_mask(valid, x, v, _CMP_LT_OQ);
+            } else {
+                const __m512i v = _mm512_set1_epi64(static_cast<long long>(value));
+                const __m512i x = _mm512_maskz_loadu_epi64(valid, keys + i);
+                if constexpr (std::is_signed_v<K>) {
+                    m = Upper ? _mm512_mask_cmpge_epi64_mask(valid, v, x) : _mm512_mask_cmplt_epi64_mask(valid, x, v);
+                } else {
+                    m = Upper ? _mm512_mask_cmpge_epu64_mask(valid, v, x) : _mm512_mask_cmplt_epu64_mask(valid, x, v);
+                }
+            }
+            count += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(m)));
+        }
+    }
+#elif defined(JAZZY_SIMD_AVX2)
+    if constexpr (is_double || is_int64) {
+        const __m256i lane = _mm256_setr_epi64x(0, 1, 2, 3);
+        for (; i < n; i += 4) {
+            const std::size_t rem = n - i >= 4 ? 4 : n - i;
+            const unsigned valid = (1u << rem) - 1;
+            const __m256i load_mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(static_cast<long long>(rem)), lane);
+            unsigned bits;
+            if constexpr (is_double) {
+                const __m256d v = _mm256_set1_pd(value);
+                const __m256d x = _mm256_maskload_pd(keys + i, load_mask);
+                const __m256d m = Upper ? _mm256_cmp_pd(v, x, _CMP_NLT_UQ) : _mm256_cmp_pd(x, v, _CMP_LT_OQ);
+                bits = static_cast<unsigned>(_mm256_movemask_pd(m));
+            } else {
+                // AVX2 only has a signed 64-bit compare: flipping the sign bit orders unsigned keys the same way
+                const __m256i flip = _mm256_set1_epi64x(std::is_signed_v<K> ? 0 : std::numeric_limits<long long>::min());
+                const __m256i v = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(value)), flip);
+                const __m256i x = _mm256_xor_si256(
+                    _mm256_maskload_epi64(reinterpret_cast<const long long*>(keys + i), load_mask), flip);
+                // Upper counts the lanes where key > value is false
+                const __m256i gt = Upper ? _mm256_cmpgt_epi64(x, v) : _mm256_cmpgt_epi64(v, x);
+                bits = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(gt)));
+                bits = Upper ? ~bits : bits;
+            }
+            count += static_cast<std::size_t>(std::popcount(bits & valid));
+        }
+    }
+#elif defined(JAZZY_SIMD_NEON)
+    if constexpr (is_double || is_int64) {
+        // Compare masks are all ones (-1) per lane, so subtracting them counts the hits
+        uint64x2_t hits = vdupq_n_u64(0);
+        for (; i + 2 <= n; i += 2) {
+            uint64x2_t gt;  // Upper: value < key; otherwise key < value
+            if constexpr (is_double) {
+                const float64x2_t x = vld1q_f64(keys + i);
+                const float64x2_t v = vdupq_n_f64(value);
+                gt = Upper ? vcltq_f64(v, x) : vcltq_f64(x, v);
+            } else if constexpr (std::is_signed_v<K>) {
+                const int64x2_t x = vld1q_s64(reinterpret_cast<const std::int64_t*>(keys + i));
+                const int64x2_t v = vdupq_n_s64(static_cast<std::int64_t>(value));
+                gt = Upper ? vcltq_s64(v, x) : vcltq_s64(x, v);
+            } else {
+                const uint64x2_t x = vld1q_u64(reinterpret_cast<const std::uint64_t*>(keys + i));
+                const uint64x2_t v = vdupq_n_u64(static_cast<std::uint64_t>(value));
+                gt = Upper ? vcltq_u64(v, x) : vcltq_u64(x, v);
+            }
+            hits = vsubq_u64(hits, gt);
+        }
+        const auto lanes = static_cast<std::size_t>(vaddvq_u64(hits));
+        count = Upper ? i - lanes : lanes;
+    }
+#endif
+    for (; i < n; ++i) {
+        count += Upper ? !(value < keys[i]) : keys[i] < value;
+    }
+    return count;
+}
+
+}  // namespace simd
+}  // namespace jazzy::detail
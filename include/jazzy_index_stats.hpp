@@ -0,0 +1,261 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace jazzy {
+
+// Query counters collected by an index built with IndexOptions<..., stats::PerThread> and read
+// with query_stats(). Histogram bucket b counts values v with std::bit_width(v) == b (bucket 0 is
+// v == 0, bucket 1 is v == 1, bucket 2 is 2-3, bucket 3 is 4-7, ...); the last bucket takes the rest
+struct QueryStats {
+    static constexpr std::size_t HISTOGRAM_BUCKETS = 16;
+    using Histogram = std::array<std::uint64_t, HISTOGRAM_BUCKETS>;
+
+    std::uint64_t searches = 0;        // Last-mile searches (one per find or bound, two per range)
+    std::uint64_t run_table_hits = 0;  // Searches answered by the run table
+    std::uint64_t window_misses = 0;   // Searches whose answer lay outside the error window (galloped)
+    std::uint64_t uniform_routes = 0;  // O(1) uniform segment guesses, scalar and batched
+    std::uint64_t uniform_misses = 0;  // Guesses that failed verification and fell back to search
+
+    Histogram error_histogram{};       // |predicted - actual| per search (run table hits excluded)
+    Histogram gallop_histogram{};      // Keys galloped past the window edge, per window miss
+    std::vector<std::uint64_t> segment_hits;  // Searches per segment
+
+    [[nodiscard]] double window_miss_rate() const noexcept {
+        return searches == 0 ? 0.0 : static_cast<double>(window_misses) / static_cast<double>(searches);
+    }
+
+    [[nodiscard]] double uniform_miss_rate() const noexcept {
+        return uniform_routes == 0 ? 0.0
+                                   : static_cast<double>(uniform_misses) / static_cast<double>(uniform_routes);
+    }
+
+    // Histogram bucket for a value (see above)
+    [[nodiscard]] static constexpr std::size_t bucket_of(std::size_t value) noexcept {
+        const auto bucket = static_cast<std::size_t>(std::bit_width(value));
+        return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+    }
+};
+
+namespace detail {
+
+inline constexpr std::size_t STATS_THREAD_CACHE_SLOTS = 8;
+// Indexes a thread can record into without taking the registry lock (direct-mapped by index id)
+
+// One thread's counters for one index. Only the owning thread writes them, so an increment is a
+// relaxed load and store (no locked instruction); query_stats() reads them with relaxed loads
+struct StatsBlock {
+    using Counter = std::atomic<std::uint64_t>;
+
+    StatsBlock(std::thread::id owner, std::size_t num_segments)
+        : segment_hits(std::make_unique<Counter[]>(num_segments)), num_segments(num_segments), owner(owner) {}
+
+    static void bump(Counter& counter) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void clear() noexcept {
+        for (Counter* counter : {&run_table_hits, &uniform_routes, &uniform_misses}) {
+            counter->store(0, std::memory_order_relaxed);
+        }
+        for (std::size_t b = 0; b < QueryStats::HISTOGRAM_BUCKETS; ++b) {
+            error_histogram[b].store(0, std::memory_order_relaxed);
+            gallop_histogram[b].store(0, std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < num_segments; ++i) {
+            segment_hits[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Searches and window misses are not counted separately: every search lands in the error
+    // histogram or the run table, and every window miss in the gallop histogram
+    void add_to(QueryStats& stats) const noexcept {
+        const std::uint64_t tabled = run_table_hits.load(std::memory_order_relaxed);
+        stats.searches += tabled;
+        stats.run_table_hits += tabled;
+        stats.uniform_routes += uniform_routes.load(std::memory_order_relaxed);
+        stats.uniform_misses += uniform_misses.load(std::memory_order_relaxed);
+        for (std::size_t b = 0; b < QueryStats::HISTOGRAM_BUCKETS; ++b) {
+            const std::uint64_t errors = error_histogram[b].load(std::memory_order_relaxed);
+            const std::uint64_t gallops = gallop_histogram[b].load(std::memory_order_relaxed);
+            stats.error_histogram[b] += errors;
+            stats.gallop_histogram[b] += gallops;
+            stats.searches += errors;
+            stats.window_misses += gallops;
+        }
+        for (std::size_t i = 0; i < num_segments; ++i) {
+            stats.segment_hits[i] += segment_hits[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    Counter run_table_hits{0};
+    Counter uniform_routes{0};
+    Counter uniform_misses{0};
+    std::array<Counter, QueryStats::HISTOGRAM_BUCKETS> error_histogram{};
+    std::array<Counter, QueryStats::HISTOGRAM_BUCKETS> gallop_histogram{};
+    std::unique_ptr<Counter[]> segment_hits;
+    std::size_t num_segments;
+    std::thread::id owner;
+};
+
+// The calling thread's recently used blocks, keyed by collector id. Ids are never reused, so an
+// entry left behind by a destroyed or rebuilt collector can never match again
+struct StatsThreadSlot {
+    std::uint64_t owner = 0;
+    StatsBlock* block = nullptr;
+};
+
+inline thread_local std::array<StatsThreadSlot, STATS_THREAD_CACHE_SLOTS> stats_thread_slots{};
+
+inline std::uint64_t next_stats_id() noexcept {
+    static std::atomic<std::uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Per-thread query counters for one index (IndexOptions<..., stats::PerThread>). Each thread
+// records into its own StatsBlock, found through a thread-local cache and registered under a
+// mutex the first time a thread queries the index; snapshot() sums the blocks on demand.
+// reset() runs at the end of every build (not concurrently with queries) and drops all blocks;
+// clear() zeroes them in place and may race with queries (a racing count may survive it).
+// Copies start empty; moves take the counters along.
+class StatsCollector {
+public:
+    StatsCollector() = default;
+
+    StatsCollector(const StatsCollector& other) : num_segments_(other.num_segments_) {}
+
+    StatsCollector(StatsCollector&& other) noexcept
+        : id_(other.id_), num_segments_(other.num_segments_), blocks_(std::move(other.blocks_)) {
+        other.id_ = next_stats_id();
+        other.blocks_.clear();
+    }
+
+    StatsCollector& operator=(const StatsCollector& other) {
+        if (this != &other) {
+            reset(other.num_segments_);
+        }
+        return *this;
+    }
+
+    StatsCollector& operator=(StatsCollector&& other) noexcept {
+        if (this != &other) {
+            const std::lock_guard lock(mutex_);
+            id_ = other.id_;
+            num_segments_ = other.num_segments_;
+            blocks_ = std::move(other.blocks_);
+            other.id_ = next_stats_id();
+            other.blocks_.clear();
+        }
+        return *this;
+    }
+
+    ~StatsCollector() = default;
+
+    // Start over for a freshly built index of num_segments segments
+    void reset(std::size_t num_segments) {
+        const std::lock_guard lock(mutex_);
+        id_ = next_stats_id();
+        num_segments_ = num_segments;
+        blocks_.clear();
+    }
+
+    void clear() noexcept {
+        const std::lock_guard lock(mutex_);
+        for (const auto& block : blocks_) {
+            block->clear();
+        }
+    }
+
+    void record_route(bool verified) noexcept {
+        if (StatsBlock* block = local_block()) {
+            StatsBlock::bump(block->uniform_routes);
+            if (!verified) {
+                StatsBlock::bump(block->uniform_misses);
+            }
+        }
+    }
+
+    void record_run_table(std::size_t segment) noexcept {
+        if (StatsBlock* block = local_block()) {
+            StatsBlock::bump(block->run_table_hits);
+            StatsBlock::bump(block->segment_hits[segment]);
+        }
+    }
+
+    // A last-mile search in segment that found its answer error keys from the prediction,
+    // galloping gallop keys past the window edge (0: the answer was inside the window)
+    void record_search(std::size_t segment, std::size_t error, std::size_t gallop) noexcept {
+        if (StatsBlock* block = local_block()) {
+            StatsBlock::bump(block->segment_hits[segment]);
+            StatsBlock::bump(block->error_histogram[QueryStats::bucket_of(error)]);
+            if (gallop > 0) {
+                StatsBlock::bump(block->gallop_histogram[QueryStats::bucket_of(gallop)]);
+            }
+        }
+    }
+
+    [[nodiscard]] QueryStats snapshot() const {
+        QueryStats stats;
+        const std::lock_guard lock(mutex_);
+        stats.segment_hits.assign(num_segments_, 0);
+        for (const auto& block : blocks_) {
+            block->add_to(stats);
+        }
+        return stats;
+    }
+
+private:
+    [[nodiscard]] StatsBlock* local_block() noexcept {
+        StatsThreadSlot& slot = stats_thread_slots[id_ % STATS_THREAD_CACHE_SLOTS];
+        if (slot.owner == id_) {
+            return slot.block;
+        }
+        return register_thread(slot);
+    }
+
+    // First query from this thread, or its slot was taken by another index since
+    [[nodiscard]] StatsBlock* register_thread(StatsThreadSlot& slot) noexcept {
+        const std::thread::id self = std::this_thread::get_id();
+        const std::lock_guard lock(mutex_);
+        StatsBlock* block = nullptr;
+        for (const auto& candidate : blocks_) {
+            if (candidate->owner == self) {
+                block = candidate.get();
+                break;
+            }
+        }
+        if (block == nullptr) {
+            try {
+                blocks_.push_back(std::make_unique<StatsBlock>(self, num_segments_));
+            } catch (const std::bad_alloc&) {
+                return nullptr;  // Drop the count rather than fail the query
+            }
+            block = blocks_.back().get();
+        }
+        slot = StatsThreadSlot{id_, block};
+        return block;
+    }
+
+    std::uint64_t id_ = next_stats_id();
+    std::size_t num_segments_ = 0;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<StatsBlock>> blocks_;
+};
+
+// Stand-in for StatsCollector when statistics are disabled: takes no space and records nothing
+struct NoStats {
+    void reset(std::size_t /*num_segments*/) noexcept {}
+};
+
+}  // namespace detail
+
+}  // namespace jazzy
@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_serialize.hpp"
+
+namespace jazzy {
+namespace detail {
+
+// analysis predicting positions from start instead of from 0 (the fits are linear in the index)
+template <typename T>
+[[nodiscard]] SegmentAnalysis<T> offset_positions(SegmentAnalysis<T> analysis, std::size_t start) noexcept {
+    const auto by = static_cast<double>(start);
+    switch (analysis.best_model) {
+        case ModelType::LINEAR:
+        case ModelType::CONSTANT:
+            analysis.linear_b += by;
+            break;
+        case ModelType::QUADRATIC:
+            analysis.quad_c += by;
+            break;
+        case ModelType::CUBIC:
+            analysis.cubic_d += by;
+            break;
+    }
+    return analysis;
+}
+
+}  // namespace detail
+
+// Writes an index file (KeyData::EXTERNAL) for sorted keys that arrive one at a time, e.g. from a
+// file being read or written, or a socket, without holding them: only the keys of the segment
+// being filled are buffered, and each segment's model is fitted as soon as its last key arrives.
+// The file loads like any saved index over the same keys once they are stored contiguously
+// (JazzyIndex::load, or a JazzyIndexView over the mapped index and key files).
+//
+// With a known key count, segments are cut as JazzyIndex::build cuts them; with SegmentSizing,
+// every segment but the last holds keys_per_segment keys. The segment table (at most
+// MAX_SEGMENTS records) is kept until finish() writes the file, whose header needs its size.
+template <typename T, typename Compare = std::less<>, typename KeyExtractor = jazzy::identity>
+class StreamingIndexWriter {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Index files store keys as raw bytes; T must be trivially copyable");
+
+public:
+    // key_count keys in min(segments, key_count) equal-count segments, as a JazzyIndex with
+    // that segment count builds them (segments in range [1, MAX_SEGMENTS])
+    StreamingIndexWriter(std::size_t key_count, std::size_t segments, Compare comp = Compare{},
+                         KeyExtractor key_extract = KeyExtractor{})
+        : key_count_(key_count), comp_(comp), key_extract_(key_extract) {
+        if (segments == 0 || segments > detail::MAX_SEGMENTS) {
+            throw std::invalid_argument("StreamingIndexWriter needs a segment count in range [1, 4096]");
+        }
+        segment_count_ = std::min(segments, key_count);
+        if (segment_count_ > 0) {
+            buffer_.reserve((key_count + segment_count_ - 1) / segment_count_);
+        }
+    }
+
+    // Any number of keys, in segments of sizing.keys_per_segment keys; appending past
+    // sizing.max_segments segments throws
+    explicit StreamingIndexWriter(SegmentSizing sizing, Compare comp = Compare{},
+                                  KeyExtractor key_extract = KeyExtractor{})
+        : sizing_(sizing), comp_(comp), key_extract_(key_extract) {
+        if (sizing.keys_per_segment == 0 || sizing.max_segments == 0 || sizing.max_segments > detail::MAX_SEGMENTS) {
+            throw std::invalid_argument(
+                "SegmentSizing needs keys_per_segment >= 1 and max_segments in range [1, 4096]");
+        }
+        segment_count_ = sizing.max_segments;
+        buffer_.reserve(sizing.keys_per_segment);
+    }
+
+    // Add the next key, not less than the one before it
+    void append(const T& key) {
+        if (finished_) {
+            throw std::runtime_error("StreamingIndexWriter already finished its file");
+        }
+        if (key_count_ && size_ == *key_count_) {
+            throw std::runtime_error("StreamingIndexWriter was given " + std::to_string(*key_count_) +
+                                     " keys to expect, but more arrived");
+        }
+        if (buffer_.empty() && records_.size() == segment_count_) {
+            throw std::runtime_error("StreamingIndexWriter needs more than " + std::to_string(segment_count_) +
+                                     " segments; raise SegmentSizing::keys_per_segment");
+        }
+        if (size_ > 0 && comp_(key, last_)) {
+            throw std::runtime_error(
+                "Input data is not sorted. JazzyIndex requires sorted data. "
+                "Please sort your data before building the index."
+            );
+        }
+        if (size_ == 0) {
+            first_ = key;
+        }
+        last_ = key;
+        buffer_.push_back(key);
+        ++size_;
+        if (size_ == segment_end(records_.size())) {
+            close_segment();
+        }
+    }
+
+    // Add every key of a single-pass range
+    template <std::input_iterator Iterator, std::sentinel_for<Iterator> Sentinel>
+    void append(Iterator first, Sentinel last) {
+        for (; first != last; ++first) {
+            append(*first);
+        }
+    }
+
+    // Fit the last (partial) segment and write the file. Throws if fewer keys arrived than the
+    // key count given; the writer takes no keys afterwards
+    void finish(std::ostream& out) {
+        if (finished_) {
+            throw std::runtime_error("StreamingIndexWriter already finished its file");
+        }
+        if (key_count_ && size_ != *key_count_) {
+            throw std::runtime_error("StreamingIndexWriter was given " + std::to_string(*key_count_) +
+                                     " keys to expect, but " + std::to_string(size_) + " arrived");
+        }
+        if (!buffer_.empty()) {
+            close_segment();
+        }
+        finished_ = true;
+        write_file(out);
+    }
+
+    // Model selection for every segment, and the uniformity tolerance finish() tests the file's
+    // segments with. Throws std::invalid_argument for an invalid config and std::runtime_error
+    // once keys have been appended
+    void set_build_config(const BuildConfig& config) {
+        config.validate();
+        if (size_ > 0) {
+            throw std::runtime_error("StreamingIndexWriter needs its BuildConfig before the first key");
+        }
+        config_ = config;
+    }
+
+    [[nodiscard]] const BuildConfig& build_config() const noexcept { return config_; }
+
+    // Keys appended so far
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    // Segments fitted so far (the one being filled is not counted)
+    [[nodiscard]] std::size_t num_segments() const noexcept { return records_.size(); }
+
+private:
+    // Position one past segment i's last key
+    [[nodiscard]] std::size_t segment_end(std::size_t i) const noexcept {
+        if (key_count_) {
+            return ((i + 1) * *key_count_) / segment_count_;
+        }
+        return (i + 1) * sizing_.keys_per_segment;
+    }
+
+    // Fit the buffered keys over positions from 0, move the model to their place in the file
+    // and record the error of its stored float form, as IndexSerializer::save does
+    void close_segment() {
+        const std::size_t start = size_ - buffer_.size();
+        const auto analysis = detail::offset_positions(
+            detail::fit_segment<false>(buffer_.data(), 0, buffer_.size(), detail::UNBOUNDED_ERROR, comp_, key_extract_,
+                                       config_),
+            start);
+
+        detail::FileSegment rec{};
+        rec.model = detail::pack_model(analysis);
+        rec.start_idx = start;
+        rec.end_idx = size_;
+        rec.model_type = static_cast<std::uint8_t>(analysis.best_model);
+        const detail::CompactSegment seg{rec.model, start, size_, 0, analysis.best_model};
+        std::size_t measured = 0;
+        for (std::size_t j = 0; j < buffer_.size(); ++j) {
+            const std::size_t predicted =
+                detail::clamp_value<std::size_t>(seg.predict(buffer_[j], key_extract_), start, size_ - 1);
+            measured = std::max(measured, predicted > start + j ? predicted - start - j : start + j - predicted);
+        }
+        if (measured > std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error(
+                "Segment prediction error exceeds uint32_t limit. "
+                "Data distribution is too extreme for indexing. "
+                "Consider using fewer segments or preprocessing the data."
+            );
+        }
+        rec.max_error = static_cast<std::uint32_t>(measured);
+        records_.push_back(rec);
+        route_keys_.push_back(buffer_.back());
+        segment_ranges_.push_back(key_of(buffer_.back()) - key_of(buffer_.front()));
+        DEBUG_LOG("StreamingIndexWriter: Segment %zu [%zu-%zu) model %d, max_error=%zu",
+                  records_.size() - 1, start, size_, static_cast<int>(analysis.best_model), measured);
+        buffer_.clear();
+    }
+
+    // Header, segment table, route keys and Eytzinger routing layer, with the uniformity test
+    // of JazzyIndex::build over the recorded segment ranges
+    void write_file(std::ostream& out) const {
+        const std::size_t count = records_.size();
+        detail::SegmentRouter<T, 0, routing::Eytzinger> router;
+        if (count > 0) {
+            router.build(count - 1, [this](std::size_t i) -> const T& { return route_keys_[i]; });
+        }
+        const std::size_t routing_nodes = count > 0 ? router.count() + 1 : 0;
+        detail::FileHeader header = detail::make_file_header<T>(size_, count, routing_nodes, false);
+
+        if (size_ > 1) {
+            const double total_range = key_of(last_) - key_of(first_);
+            const double expected_spacing = (count > 1 && total_range >= detail::ZERO_RANGE_THRESHOLD)
+                ? total_range / static_cast<double>(count)
+                : 0.0;
+            const double tolerance = expected_spacing * config_.uniformity_tolerance;
+            bool uniform = true;
+            for (std::size_t i = 0; uniform && count > 1 && total_range >= detail::ZERO_RANGE_THRESHOLD && i < count;
+                 ++i) {
+                uniform = std::abs(segment_ranges_[i] - expected_spacing) <= tolerance;
+            }
+            if (uniform) {
+                header.flags |= detail::FILE_FLAG_UNIFORM;
+                if (total_range >= detail::ZERO_RANGE_THRESHOLD) {
+                    header.segment_scale = static_cast<double>(count) / total_range;
+                }
+            }
+        }
+
+        std::uint64_t written = 0;
+        detail::write_file_section(out, written, 0, &header, sizeof(header));
+        detail::write_file_section(out, written, header.segments_offset, records_.data(),
+                                   count * sizeof(detail::FileSegment));
+        detail::write_file_section(out, written, header.route_keys_offset, route_keys_.data(), count * sizeof(T));
+        if (routing_nodes > 0) {
+            detail::write_file_section(out, written, header.routing_keys_offset, router.keys(),
+                                       routing_nodes * sizeof(T));
+            detail::write_file_section(out, written, header.routing_ranks_offset, router.ranks(),
+                                       routing_nodes * sizeof(std::uint32_t));
+        }
+        detail::write_file_section(out, written, header.file_size, nullptr, 0);
+
+        if (!out) {
+            throw std::runtime_error("Failed to write JazzyIndex file");
+        }
+        DEBUG_LOG("StreamingIndexWriter::finish: Wrote %zu segments over %zu keys (%llu bytes)",
+                  count, size_, static_cast<unsigned long long>(header.file_size));
+    }
+
+    [[nodiscard]] double key_of(const T& value) const {
+        return static_cast<double>(std::invoke(key_extract_, value));
+    }
+
+    std::optional<std::size_t> key_count_{};  // Set for equal-count segments
+    SegmentSizing sizing_{};                   // Used without a key count
+    std::size_t segment_count_{0};             // Segments for key_count_, or the most allowed
+    std::size_t size_{0};
+    T first_{};
+    T last_{};
+    std::vector<T> buffer_;                    // Keys of the segment being filled
+    std::vector<detail::FileSegment> records_;
+    std::vector<T> route_keys_;                // Segment max keys
+    std::vector<double> segment_ranges_;       // Segment max minus min key, for the uniformity test
+    bool finished_{false};
+    Compare comp_{};
+    KeyExtractor key_extract_{};
+    BuildConfig config_{};
+};
+
+}  // namespace jazzy
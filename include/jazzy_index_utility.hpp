@@ -1,14 +1,27 @@
 #pragma once
 
 #include <cmath>
+#include <functional>
 #include <type_traits>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>  // _mm_prefetch
+#endif
+
 namespace jazzy::detail {
 
 template <typename T>
 constexpr bool IS_STRICTLY_ARITHMETIC_V =
     std::is_integral_v<T> || std::is_floating_point_v<T>;
 
+// Comparators known to order keys ascending by operator< (lets batch routing compare
+// keys as doubles; other comparators fall back to comp_-based routing)
+template <typename Compare>
+inline constexpr bool IS_ASCENDING_COMPARE_V = false;
+
+template <typename U>
+inline constexpr bool IS_ASCENDING_COMPARE_V<std::less<U>> = true;
+
 template <typename T>
 [[nodiscard]] constexpr T clamp_value(T value, T lo, T hi) {
     // For floating-point types, handle NaN by clamping to lower bound
@@ -20,4 +33,15 @@ template <typename T>
     return value;
 }
 
+// Hint the CPU to pull the cache line holding addr into L1 (read access, high locality)
+inline void prefetch_read(const void* addr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr, 0, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(addr), _MM_HINT_T0);
+#else
+    (void)addr;
+#endif
+}
+
 }  // namespace jazzy::detail
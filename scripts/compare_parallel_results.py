@@ -2,8 +2,14 @@
 """
 Compare benchmark results from sequential vs parallel execution to determine
 if running multiple benchmark processes simultaneously affects timing accuracy.
+
+With --diff BASE NEW, compare two benchmark JSON files instead (for example
+jazzy_trace_benchmark runs on two commits): mean time and, where present, the
+p50/p99/p999 latencies. Exits with status 1 if any of them regressed by more
+than --threshold percent.
 """
 
+import argparse
 import json
 import sys
 from pathlib import Path
@@ -71,7 +77,68 @@ def compare_timings(baseline: Dict[str, float],
 
     return max_degradation, [(d[0], d[1]) for d in differences]
 
+LATENCY_FIELDS = ('p50_ns', 'p99_ns', 'p999_ns')
+
+def extract_metrics(results: Dict) -> Dict[str, Dict[str, float]]:
+    """Extract benchmark name -> {cpu_time, p50_ns, p99_ns, p999_ns} mapping."""
+    timings = extract_timings(results)
+    metrics = {name: {'cpu_time': time} for name, time in timings.items()}
+    for bench in results.get('benchmarks', []):
+        if bench['name'] in metrics:
+            for field in LATENCY_FIELDS:
+                if bench.get(field) is not None:
+                    metrics[bench['name']][field] = bench[field]
+    return metrics
+
+def diff_results(base_path: Path, new_path: Path, threshold: float) -> int:
+    """Print per-benchmark changes between two runs; return 1 on a regression."""
+    base = extract_metrics(load_benchmark_results(base_path))
+    new = extract_metrics(load_benchmark_results(new_path))
+    common = [name for name in base if name in new]
+    if not common:
+        print(f"Error: no benchmarks in common between {base_path} and {new_path}")
+        return 1
+
+    fields = ('cpu_time',) + LATENCY_FIELDS
+    print(f"{'Benchmark':<64} " + " ".join(f"{f:>10}" for f in fields))
+    print("-" * (65 + 11 * len(fields)))
+    regressions = []
+    for name in common:
+        changes = []
+        for field in fields:
+            before, after = base[name].get(field), new[name].get(field)
+            if before is None or after is None or before <= 0:
+                changes.append("")
+                continue
+            change_pct = (after - before) / before * 100
+            changes.append(f"{change_pct:+.1f}%")
+            if change_pct > threshold:
+                regressions.append((name, field, before, after, change_pct))
+        print(f"{name:<64} " + " ".join(f"{c:>10}" for c in changes))
+
+    missing = sorted(set(base) ^ set(new))
+    if missing:
+        print(f"\n{len(missing)} benchmark(s) only in one file, not compared")
+
+    if regressions:
+        print(f"\n❌ {len(regressions)} regression(s) above {threshold:.1f}%:")
+        for name, field, before, after, change_pct in regressions:
+            print(f"  {name} {field}: {before:.1f} -> {after:.1f} ns ({change_pct:+.1f}%)")
+        return 1
+    print(f"\n✓ No regressions above {threshold:.1f}% across {len(common)} benchmarks")
+    return 0
+
 def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--diff', nargs=2, metavar=('BASE', 'NEW'), type=Path,
+                        help='compare two benchmark JSON files instead of the parallelism test')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='regression threshold in percent for --diff (default: 10)')
+    args = parser.parse_args()
+    if args.diff:
+        sys.exit(diff_results(args.diff[0], args.diff[1], args.threshold))
+
     test_dir = Path("benchmark_parallelism_test")
 
     if not test_dir.exists():
@@ -38,6 +38,7 @@ mkdir -p "$DOCS_IMAGES/index_data"
 
 echo "Step 1/3: Running performance benchmarks..."
 "$BUILD_DIR/jazzy_index_benchmarks" \
+    --index-stats \
     --benchmark_format=json \
     --benchmark_out="$BUILD_DIR/jazzy_benchmarks.json"
 
@@ -45,7 +46,8 @@ echo
 echo "Step 2/3: Generating performance plots..."
 python3 "$SCRIPT_DIR/plot_benchmarks.py" \
     --input "$BUILD_DIR/jazzy_benchmarks.json" \
-    --output "$DOCS_IMAGES/benchmarks/jazzy_benchmarks.png"
+    --output "$DOCS_IMAGES/benchmarks/jazzy_benchmarks.png" \
+    --pareto
 
 echo
 echo "Step 3/3: Generating index structure visualizations..."
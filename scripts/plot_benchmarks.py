@@ -5,7 +5,8 @@ Plot JazzyIndex benchmark results.
 The script expects a JSON file produced by Google Benchmark
 (`--benchmark_format=json --benchmark_out=<file>`). It generates a PNG
 containing per-distribution lookup cost over dataset sizes for each
-segment configuration.
+segment configuration. With --pareto and a run recorded with
+--index-stats, it also plots index memory against lookup time.
 """
 
 from __future__ import annotations
@@ -478,6 +479,88 @@ def plot(grouped, output: Path) -> None:
         plot_segment_group(grouped, group_output, segment_list, group_name)
 
 
+def load_pareto_data(path: Path):
+    """
+    Load JazzyIndex/* runs recorded with --index-stats as:
+      data[distribution][size] -> list[(segments, index_bytes, mean_time_ns)]
+    averaging the lookup time over scenarios
+    """
+    with path.open("r", encoding="utf-8") as handle:
+        payload = json.load(handle)
+
+    samples = defaultdict(list)
+    for run in payload.get("benchmarks", []):
+        name = run.get("name")
+        if not name or "index_bytes" not in run:
+            continue
+        try:
+            impl, distribution, _scenario, segments, size = parse_benchmark_name(name)
+        except ValueError:
+            continue
+        if impl != "JazzyIndex":
+            continue
+        samples[(distribution, size, segments)].append((float(run["index_bytes"]), float(run.get("real_time", 0.0))))
+
+    data = defaultdict(lambda: defaultdict(list))
+    for (distribution, size, segments), values in samples.items():
+        index_bytes = max(value[0] for value in values)
+        mean_time = sum(value[1] for value in values) / len(values)
+        data[distribution][size].append((segments, index_bytes, mean_time))
+    return data
+
+
+def pareto_front(points: List[Tuple[int, float, float]]) -> List[Tuple[int, float, float]]:
+    """Points no other point beats on both memory and latency, by increasing memory."""
+    front = []
+    best_time = float("inf")
+    for point in sorted(points, key=lambda p: (p[1], p[2])):
+        if point[2] < best_time:
+            front.append(point)
+            best_time = point[2]
+    return front
+
+
+def plot_pareto(data, output: Path) -> None:
+    """Memory vs latency per distribution at its largest dataset size, with the Pareto front."""
+    distributions = sorted(data)
+    if not distributions:
+        raise ValueError("No JazzyIndex runs with index_bytes counters (run the benchmarks with --index-stats).")
+
+    cols = 2
+    rows = ceil(len(distributions) / cols)
+    fig, axes = plt.subplots(rows, cols, figsize=(14, 4.5 * rows), squeeze=False)
+    for ax, distribution in zip(axes.flat, distributions):
+        size = max(data[distribution])
+        points = data[distribution][size]
+        for segments, index_bytes, time_ns in points:
+            ax.scatter(
+                index_bytes,
+                time_ns,
+                color=SEGMENT_COLORS.get(segments, "#333333"),
+                marker=SEGMENT_MARKERS.get(segments, "o"),
+                s=50,
+                zorder=3,
+            )
+            ax.annotate(f"S{segments}", (index_bytes, time_ns), textcoords="offset points", xytext=(4, 4), fontsize=7)
+        front = pareto_front(points)
+        ax.plot([p[1] for p in front], [p[2] for p in front], color="#000000", linewidth=1.5, linestyle="--",
+                label="Pareto front", zorder=2)
+        ax.set_xscale("log")
+        ax.set_title(f"{distribution} (N={size:,})")
+        ax.set_xlabel("Index memory (bytes, log scale)")
+        ax.set_ylabel("Mean lookup time (ns)")
+        ax.grid(True, which="both", alpha=0.3)
+        ax.legend(loc="upper right", fontsize=8)
+    for ax in list(axes.flat)[len(distributions):]:
+        ax.set_visible(False)
+
+    fig.suptitle(f"JazzyIndex memory vs latency\n{get_cpu_name()}", fontsize=14)
+    fig.tight_layout(rect=(0.02, 0.02, 0.98, 0.95))
+    output.parent.mkdir(parents=True, exist_ok=True)
+    fig.savefig(output, dpi=150)
+    plt.close(fig)
+
+
 def main() -> None:
     parser = argparse.ArgumentParser(description="Plot JazzyIndex benchmark results.")
     parser.add_argument(
@@ -492,10 +575,21 @@ def main() -> None:
         default=Path("benchmarks/jazzy_benchmarks.png"),
         help="Destination PNG (will be overwritten). Default: benchmarks/jazzy_benchmarks.png",
     )
+    parser.add_argument(
+        "--pareto",
+        action="store_true",
+        help="Also draw memory-vs-latency Pareto curves to <output>_pareto.png "
+        "(needs benchmarks run with --index-stats).",
+    )
     args = parser.parse_args()
 
     grouped = load_benchmark_data(args.input)
     plot(grouped, args.output)
+    if args.pareto:
+        plot_pareto(
+            load_pareto_data(args.input),
+            args.output.parent / f"{args.output.stem}_pareto{args.output.suffix}",
+        )
 
 
 if __name__ == "__main__":
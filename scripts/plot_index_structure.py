@@ -1,6 +1,7 @@
 #!/usr/bin/env python3
 """
-Visualize JazzyIndex structure: data distribution, segment boundaries, and model predictions.
+Visualize JazzyIndex structure: data distribution, segment boundaries, and model predictions,
+plus query statistics (segment hits, prediction error, galloping) when the export carries them.
 """
 
 import argparse
@@ -230,6 +231,72 @@ L: {model_counts['LINEAR']} | Q: {model_counts['QUADRATIC']} | Cu: {model_counts
     print(f"  Created: {output_file}")
 
 
+def histogram_labels(buckets: int) -> List[str]:
+    """Labels for log2 histogram buckets: bucket b holds values with bit width b."""
+    labels = ['0', '1']
+    for b in range(2, buckets):
+        labels.append(f'{1 << (b - 1)}-{(1 << b) - 1}')
+    labels[-1] = f'{1 << (buckets - 2)}+'
+    return labels
+
+
+def plot_query_stats(data: Dict[str, Any], output_file: Path):
+    """Plot query counters: per-segment hits, prediction error and gallop histograms."""
+    stats = data['query_stats']
+    segment_hits = np.array(stats['segment_hits'])
+    error_hist = np.array(stats['error_histogram'])
+    gallop_hist = np.array(stats['gallop_histogram'])
+    searches = stats['searches']
+
+    fig, (ax_hits, ax_error, ax_gallop) = plt.subplots(3, 1, figsize=(14, 12))
+
+    # Per-segment hits, colored by the segment's stored max_error when segments are present
+    segments = data.get('segments', [])
+    colors = 'steelblue'
+    if len(segments) == len(segment_hits) and segments:
+        errors = np.array([segment['max_error'] for segment in segments], dtype=float)
+        colors = plt.cm.viridis(errors / errors.max()) if errors.max() > 0 else 'steelblue'
+    ax_hits.bar(np.arange(len(segment_hits)), segment_hits, color=colors, width=1.0)
+    ax_hits.set_xlabel('Segment', fontsize=11, fontweight='bold')
+    ax_hits.set_ylabel('Searches', fontsize=11, fontweight='bold')
+    ax_hits.set_title('Searches per segment (color: max_error)', fontsize=12, fontweight='bold')
+
+    labels = histogram_labels(len(error_hist))
+    ax_error.bar(labels, error_hist, color='indianred')
+    ax_error.set_xlabel('|predicted - actual| (positions)', fontsize=11, fontweight='bold')
+    ax_error.set_ylabel('Searches', fontsize=11, fontweight='bold')
+    ax_error.set_title('Prediction error', fontsize=12, fontweight='bold')
+
+    ax_gallop.bar(labels, gallop_hist, color='darkorange')
+    ax_gallop.set_xlabel('Keys galloped past the error window', fontsize=11, fontweight='bold')
+    ax_gallop.set_ylabel('Searches', fontsize=11, fontweight='bold')
+    ax_gallop.set_title('Window misses', fontsize=12, fontweight='bold')
+
+    for ax in (ax_hits, ax_error, ax_gallop):
+        ax.grid(True, axis='y', alpha=0.3, linestyle=':', linewidth=0.5)
+
+    def rate(part: int, whole: int) -> str:
+        return f'{100.0 * part / whole:.2f}%' if whole > 0 else 'n/a'
+
+    stats_text = f"""Searches: {searches:,}
+Run table hits: {stats['run_table_hits']:,}
+Window misses: {stats['window_misses']:,} ({rate(stats['window_misses'], searches)})
+Uniform routes: {stats['uniform_routes']:,}
+Uniform misses: {stats['uniform_misses']:,} ({rate(stats['uniform_misses'], stats['uniform_routes'])})"""
+    ax_hits.text(0.98, 0.95, stats_text, transform=ax_hits.transAxes,
+                 fontsize=9, verticalalignment='top', horizontalalignment='right',
+                 bbox=dict(boxstyle='round', facecolor='wheat', alpha=0.5))
+
+    title_parts = output_file.stem.replace('index_', '').replace('query_stats_', '').split('_')
+    fig.suptitle(f"JazzyIndex Query Statistics: {' '.join(title_parts)}", fontsize=14, fontweight='bold')
+
+    plt.tight_layout()
+    plt.savefig(output_file, dpi=150, bbox_inches='tight')
+    plt.close()
+
+    print(f"  Created: {output_file}")
+
+
 def main():
     parser = argparse.ArgumentParser(
         description='Visualize JazzyIndex structure from exported JSON data'
@@ -260,8 +327,8 @@ def main():
     # Create output directory if it doesn't exist
     output_dir.mkdir(parents=True, exist_ok=True)
 
-    # Find all JSON files
-    json_files = list(input_dir.glob('index_*.json'))
+    # Find all JSON files (index metadata, and query counters from export_query_stats)
+    json_files = list(input_dir.glob('index_*.json')) + list(input_dir.glob('query_stats_*.json'))
 
     if not json_files:
         print(f"Error: No index JSON files found in '{input_dir}'", file=sys.stderr)
@@ -279,7 +346,12 @@ def main():
         try:
             data = load_index_data(json_file)
             output_file = output_dir / json_file.name.replace('.json', '.png')
-            plot_index_structure(data, output_file)
+            if 'segments' in data:
+                plot_index_structure(data, output_file)
+                if 'query_stats' in data:
+                    plot_query_stats(data, output_dir / json_file.name.replace('.json', '_stats.png'))
+            else:
+                plot_query_stats({'query_stats': data}, output_file)
             success_count += 1
         except Exception as e:
             print(f"  Error processing {json_file}: {e}", file=sys.stderr)
@@ -0,0 +1,265 @@
+// Tests for batched lookup API (find_batch, find_lower_bound_batch, find_upper_bound_batch)
+// Verifies that every batched result matches the corresponding single-key query
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_parallel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+struct Record {
+    std::uint64_t key;
+    int payload;
+
+    bool operator<(const Record& other) const { return key < other.key; }
+};
+
+// Queries mixing hits, misses inside the range and misses outside it
+std::vector<std::uint64_t> make_mixed_queries(const std::vector<std::uint64_t>& data, std::size_t count) {
+    std::mt19937_64 rng(1234);
+    std::uniform_int_distribution<std::size_t> index_dist(0, data.size() - 1);
+    std::vector<std::uint64_t> queries;
+    queries.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint64_t hit = data[index_dist(rng)];
+        switch (i % 4) {
+            case 0:
+            case 1:
+                queries.push_back(hit);
+                break;
+            case 2:
+                queries.push_back(hit + 1);
+                break;
+            default:
+                queries.push_back(data.back() + 1 + i);
+                break;
+        }
+    }
+    return queries;
+}
+
+template <typename Index>
+void expect_batch_matches_single(const Index& index, const std::vector<std::uint64_t>& queries) {
+    std::vector<const std::uint64_t*> found(queries.size());
+    std::vector<const std::uint64_t*> lower(queries.size());
+    std::vector<const std::uint64_t*> upper(queries.size());
+
+    index.find_batch(queries, found);
+    index.find_lower_bound_batch(queries, lower);
+    index.find_upper_bound_batch(queries, upper);
+
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(found[i], index.find(queries[i])) << "find mismatch for key " << queries[i];
+        EXPECT_EQ(lower[i], index.find_lower_bound(queries[i])) << "lower bound mismatch for key " << queries[i];
+        EXPECT_EQ(upper[i], index.find_upper_bound(queries[i])) << "upper bound mismatch for key " << queries[i];
+    }
+}
+
+}  // namespace
+
+// Test: Uniform data exercises the arithmetic routing stage
+TEST(BatchLookupTest, UniformMatchesSingleLookups) {
+    std::vector<std::uint64_t> data(10'000);
+    std::iota(data.begin(), data.end(), 0);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index(data.data(), data.data() + data.size());
+    expect_batch_matches_single(index, make_mixed_queries(data, 1'000));
+}
+
+// Test: Skewed data exercises the binary search routing path
+TEST(BatchLookupTest, SkewedMatchesSingleLookups) {
+    std::vector<std::uint64_t> data(20'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<std::uint64_t>(i) * static_cast<std::uint64_t>(i) / 7;
+    }
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::XLARGE> index(data.data(), data.data() + data.size());
+    expect_batch_matches_single(index, make_mixed_queries(data, 3'001));
+}
+
+// Test: Duplicates must resolve to the same run boundaries as the single-key API
+TEST(BatchLookupTest, DuplicatesMatchSingleLookups) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t v = 0; v < 500; ++v) {
+        data.insert(data.end(), 1 + (v % 7), v * 3);
+    }
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> index(data.data(), data.data() + data.size());
+    expect_batch_matches_single(index, make_mixed_queries(data, 777));
+}
+
+// Test: Batch sizes that are not a multiple of the pipeline group size
+TEST(BatchLookupTest, PartialGroups) {
+    std::vector<std::uint64_t> data(1'000);
+    std::iota(data.begin(), data.end(), 100);
+    jazzy::JazzyIndex<std::uint64_t> index(data.data(), data.data() + data.size());
+
+    for (std::size_t count : {std::size_t{1}, std::size_t{31}, std::size_t{33}, std::size_t{65}}) {
+        std::vector<std::uint64_t> queries(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(count));
+        std::vector<const std::uint64_t*> out(count, nullptr);
+        index.find_batch(queries, out);
+        for (std::size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(out[i], data.data() + i);
+        }
+    }
+}
+
+// Test: Empty index and empty batch
+TEST(BatchLookupTest, EmptyInputs) {
+    std::vector<std::uint64_t> data;
+    jazzy::JazzyIndex<std::uint64_t> index(data.data(), data.data());
+
+    std::vector<std::uint64_t> queries{1, 2, 3};
+    std::vector<const std::uint64_t*> out(queries.size(), nullptr);
+    index.find_batch(queries, out);
+    for (const auto* result : out) {
+        EXPECT_EQ(result, data.data());
+    }
+
+    std::vector<std::uint64_t> no_queries;
+    std::vector<const std::uint64_t*> no_out;
+    EXPECT_NO_THROW(index.find_lower_bound_batch(no_queries, no_out));
+}
+
+// Test: Output span must hold one result per key
+TEST(BatchLookupTest, OutputTooSmallThrows) {
+    std::vector<std::uint64_t> data(100);
+    std::iota(data.begin(), data.end(), 0);
+    jazzy::JazzyIndex<std::uint64_t> index(data.data(), data.data() + data.size());
+
+    std::vector<std::uint64_t> queries{1, 2, 3};
+    std::vector<const std::uint64_t*> out(2);
+    EXPECT_THROW(index.find_batch(queries, out), std::invalid_argument);
+}
+
+// Test: Key extractor and custom comparator
+TEST(BatchLookupTest, KeyExtractorAndReverseComparator) {
+    std::vector<Record> records;
+    for (int i = 0; i < 2'000; ++i) {
+        records.push_back({static_cast<std::uint64_t>(i) * 5, i});
+    }
+    jazzy::JazzyIndex<Record, jazzy::SegmentCount::MEDIUM, std::less<>, decltype(&Record::key)> kv_index;
+    kv_index.build(records.data(), records.data() + records.size(), std::less<>{}, &Record::key);
+
+    std::vector<Record> kv_queries{{0, 0}, {5, 0}, {7, 0}, {9'995, 0}, {10'000, 0}};
+    std::vector<const Record*> kv_out(kv_queries.size());
+    kv_index.find_batch(kv_queries, kv_out);
+    for (std::size_t i = 0; i < kv_queries.size(); ++i) {
+        EXPECT_EQ(kv_out[i], kv_index.find(kv_queries[i]));
+    }
+
+    std::vector<int> desc(1'000);
+    std::iota(desc.begin(), desc.end(), 0);
+    std::reverse(desc.begin(), desc.end());
+    jazzy::JazzyIndex<int, jazzy::SegmentCount::SMALL, std::greater<int>> desc_index;
+    desc_index.build(desc.data(), desc.data() + desc.size(), std::greater<int>{});
+
+    std::vector<int> desc_queries{999, 500, 0, -1, 1'000};
+    std::vector<const int*> desc_out(desc_queries.size());
+    desc_index.find_batch(desc_queries, desc_out);
+    for (std::size_t i = 0; i < desc_queries.size(); ++i) {
+        EXPECT_EQ(desc_out[i], desc_index.find(desc_queries[i]));
+    }
+}
+
+// Test: Vector routing kernel agrees with std::lower_bound over the segment bounds
+TEST(BatchLookupTest, SortedRoutingKernelMatchesLowerBound) {
+    for (std::size_t n : {std::size_t{1}, std::size_t{2}, std::size_t{7}, std::size_t{64}, std::size_t{513}}) {
+        std::vector<double> bounds(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            bounds[i] = static_cast<double>(i * i);
+        }
+        std::vector<double> keys;
+        for (double k = -3.0; k < static_cast<double>(n * n) + 5.0; k += 0.5 + static_cast<double>(n) / 16.0) {
+            keys.push_back(k);
+        }
+        std::vector<std::uint32_t> out(keys.size());
+        jazzy::detail::simd::route_sorted(bounds.data(), n, keys.data(), keys.size(), out.data());
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            const auto expected = static_cast<std::size_t>(
+                std::lower_bound(bounds.begin(), bounds.end(), keys[i]) - bounds.begin());
+            ASSERT_EQ(out[i], std::min(expected, n - 1)) << "n=" << n << " key=" << keys[i];
+        }
+    }
+}
+
+// Test: Vector Horner evaluation matches the scalar segment models for every model type
+TEST(BatchLookupTest, PredictKernelMatchesSegmentModels) {
+    std::vector<std::uint64_t> data(50'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        const double x = static_cast<double>(i);
+        data[i] = static_cast<std::uint64_t>(x * x * x / 1e6 + x);
+    }
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> index(data.data(), data.data() + data.size());
+    expect_batch_matches_single(index, make_mixed_queries(data, 5'000));
+}
+
+// Test: Floating-point keys, including infinities and keys outside the data range
+TEST(BatchLookupTest, FloatingPointKeys) {
+    std::vector<double> data(5'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = std::exp(static_cast<double>(i) / 500.0) - 3.0;
+    }
+    jazzy::JazzyIndex<double, jazzy::SegmentCount::LARGE> index(data.data(), data.data() + data.size());
+
+    std::vector<double> queries{-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity(),
+                                -10.0, data.front(), data.back(), data.back() + 1.0};
+    for (std::size_t i = 0; i < data.size(); i += 37) {
+        queries.push_back(data[i]);
+        queries.push_back(data[i] + 1e-9);
+    }
+
+    std::vector<const double*> found(queries.size());
+    std::vector<const double*> lower(queries.size());
+    std::vector<const double*> upper(queries.size());
+    index.find_batch(queries, found);
+    index.find_lower_bound_batch(queries, lower);
+    index.find_upper_bound_batch(queries, upper);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(found[i], index.find(queries[i])) << "key " << queries[i];
+        EXPECT_EQ(lower[i], index.find_lower_bound(queries[i])) << "key " << queries[i];
+        EXPECT_EQ(upper[i], index.find_upper_bound(queries[i])) << "key " << queries[i];
+    }
+}
+
+// Test: Keys above 2^53 round when converted to double; routing must still be exact
+TEST(BatchLookupTest, LargeKeysBeyondDoublePrecision) {
+    const std::uint64_t base = std::uint64_t{1} << 60;
+    std::vector<std::uint64_t> data(4'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = base + static_cast<std::uint64_t>(i) * (i % 3 == 0 ? 1 : 1'000);
+    }
+    std::sort(data.begin(), data.end());
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index(data.data(), data.data() + data.size());
+    expect_batch_matches_single(index, make_mixed_queries(data, 2'000));
+}
+
+// Test: Index built in parallel carries the same batch tables
+TEST(BatchLookupTest, ParallelBuildMatchesSingleLookups) {
+    std::vector<std::uint64_t> data(30'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<std::uint64_t>(i) * static_cast<std::uint64_t>(i % 100 + 1);
+    }
+    std::sort(data.begin(), data.end());
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::XLARGE> index;
+    index.build_parallel(data.data(), data.data() + data.size());
+    expect_batch_matches_single(index, make_mixed_queries(data, 3'000));
+
+    std::vector<std::uint64_t> single{42};
+    jazzy::JazzyIndex<std::uint64_t> single_index;
+    single_index.build_parallel(single.data(), single.data() + single.size());
+    expect_batch_matches_single(single_index, {41, 42, 43});
+}
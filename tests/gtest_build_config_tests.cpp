@@ -0,0 +1,265 @@
+// Tests for BuildConfig (model limits and thresholds for analyze_segment and every build path)
+// and for autotune (jazzy_index_autotune.hpp)
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_autotune.hpp"
+#include "jazzy_index_export.hpp"
+#include "jazzy_index_mutable.hpp"
+#include "jazzy_index_parallel.hpp"
+#include "jazzy_index_streaming.hpp"
+#include "test_data.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using jazzy::test::count_models;
+using jazzy::test::make_cubic_keys;
+
+template <typename Index>
+void expect_finds_all(const Index& index, const std::vector<std::uint64_t>& keys) {
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        const auto* found = index.find(keys[i]);
+        ASSERT_NE(found, keys.data() + keys.size()) << "key " << keys[i];
+        ASSERT_EQ(*found, keys[i]);
+        ASSERT_EQ(index.find_lower_bound(keys[i] + 1), keys.data() + i + 1);
+    }
+}
+
+}  // namespace
+
+TEST(BuildConfigTest, DefaultsMatchConstantsAndValidate) {
+    const jazzy::BuildConfig config;
+    EXPECT_EQ(config.model_limit, jazzy::ModelLimit::CUBIC);
+    EXPECT_EQ(config.max_acceptable_linear_error, jazzy::detail::MAX_ACCEPTABLE_LINEAR_ERROR);
+    EXPECT_EQ(config.quadratic_improvement_threshold, jazzy::detail::QUADRATIC_IMPROVEMENT_THRESHOLD);
+    EXPECT_EQ(config.cubic_improvement_threshold, jazzy::detail::CUBIC_IMPROVEMENT_THRESHOLD);
+    EXPECT_EQ(config.max_acceptable_quadratic_error, jazzy::detail::MAX_ACCEPTABLE_QUADRATIC_ERROR);
+    EXPECT_EQ(config.max_cubic_worthwhile_error, jazzy::detail::MAX_CUBIC_WORTHWHILE_ERROR);
+    EXPECT_EQ(config.uniformity_tolerance, jazzy::detail::UNIFORMITY_TOLERANCE);
+    EXPECT_NO_THROW(config.validate());
+    EXPECT_NO_THROW(jazzy::BuildConfig::linear_only().validate());
+    EXPECT_NO_THROW(jazzy::BuildConfig::prefer_cubic().validate());
+
+    jazzy::JazzyIndex<std::uint64_t> index;
+    EXPECT_EQ(index.build_config(), config);
+
+    jazzy::BuildConfig bad;
+    bad.quadratic_improvement_threshold = 0.0;
+    EXPECT_THROW(index.set_build_config(bad), std::invalid_argument);
+    bad = {};
+    bad.cubic_improvement_threshold = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_THROW(index.set_build_config(bad), std::invalid_argument);
+    bad = {};
+    bad.uniformity_tolerance = -0.1;
+    EXPECT_THROW(index.set_build_config(bad), std::invalid_argument);
+    bad = {};
+    bad.model_limit = static_cast<jazzy::ModelLimit>(7);
+    EXPECT_THROW(index.set_build_config(bad), std::invalid_argument);
+    EXPECT_EQ(index.build_config(), config);  // Unchanged by the rejected configs
+}
+
+TEST(BuildConfigTest, AnalyzeSegmentHonoursModelLimit) {
+    const auto keys = make_cubic_keys(2000);
+    const auto* data = keys.data();
+    const auto analyze = [data](std::size_t start, std::size_t end, const jazzy::BuildConfig& config) {
+        return jazzy::detail::analyze_segment(data, start, end, std::less<>{}, jazzy::identity{}, config);
+    };
+    using jazzy::detail::ModelType;
+
+    // [1000, 2000) is curved enough for a cubic under the default thresholds
+    const auto defaults = analyze(1000, 2000, jazzy::BuildConfig{});
+    EXPECT_EQ(defaults.best_model, ModelType::CUBIC);
+
+    const auto linear = analyze(1000, 2000, jazzy::BuildConfig::linear_only());
+    EXPECT_EQ(linear.best_model, ModelType::LINEAR);
+    EXPECT_GT(linear.max_error, defaults.max_error);
+
+    jazzy::BuildConfig up_to_quadratic;
+    up_to_quadratic.model_limit = jazzy::ModelLimit::QUADRATIC;
+    const auto quadratic = analyze(1000, 2000, up_to_quadratic);
+    EXPECT_EQ(quadratic.best_model, ModelType::QUADRATIC);
+    EXPECT_GT(quadratic.max_error, defaults.max_error);
+    EXPECT_LT(quadratic.max_error, linear.max_error);
+
+    // [500, 800) stops at a quadratic by default (error within MAX_ACCEPTABLE_QUADRATIC_ERROR);
+    // prefer_cubic keeps going while the error drops
+    const auto good_enough = analyze(500, 800, jazzy::BuildConfig{});
+    EXPECT_EQ(good_enough.best_model, ModelType::QUADRATIC);
+    const auto cubic = analyze(500, 800, jazzy::BuildConfig::prefer_cubic());
+    EXPECT_EQ(cubic.best_model, ModelType::CUBIC);
+    EXPECT_LT(cubic.max_error, good_enough.max_error);
+
+    // A looser linear threshold accepts the line outright
+    jazzy::BuildConfig loose_linear;
+    loose_linear.max_acceptable_linear_error = linear.max_error;
+    EXPECT_EQ(analyze(1000, 2000, loose_linear).best_model, ModelType::LINEAR);
+}
+
+TEST(BuildConfigTest, LinearOnlyIndexUsesOnlyLinearModels) {
+    const auto keys = make_cubic_keys(20000);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> defaults(keys.data(), keys.data() + keys.size());
+    EXPECT_GT(count_models(jazzy::export_index_metadata(defaults), "QUADRATIC") +
+                  count_models(jazzy::export_index_metadata(defaults), "CUBIC"),
+              0);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> index;
+    index.set_build_config(jazzy::BuildConfig::linear_only());
+    index.build(keys.data(), keys.data() + keys.size());
+    const std::string json = jazzy::export_index_metadata(index);
+    EXPECT_EQ(count_models(json, "QUADRATIC"), 0);
+    EXPECT_EQ(count_models(json, "CUBIC"), 0);
+    EXPECT_EQ(count_models(json, "LINEAR"), static_cast<int>(index.num_segments()));
+    EXPECT_GE(index.max_segment_error(), defaults.max_segment_error());
+    expect_finds_all(index, keys);
+
+    // The config stays with the index: error-bounded and parallel builds use it too
+    index.build_error_bounded(keys.data(), keys.data() + keys.size(), 16);
+    EXPECT_EQ(count_models(jazzy::export_index_metadata(index), "LINEAR"), static_cast<int>(index.num_segments()));
+    expect_finds_all(index, keys);
+
+    index.build_parallel(keys.data(), keys.data() + keys.size());
+    EXPECT_EQ(count_models(jazzy::export_index_metadata(index), "LINEAR"), static_cast<int>(index.num_segments()));
+    expect_finds_all(index, keys);
+}
+
+TEST(BuildConfigTest, MutableIndexAndStreamingWriterUseConfig) {
+    using jazzy::detail::ModelType;
+    const auto keys = make_cubic_keys(20000);
+
+    // Refits after inserts and splits keep to the config, like the first build
+    jazzy::MutableJazzyIndex<std::uint64_t> mutable_index(jazzy::UpdatePolicy{.keys_per_segment = 1000});
+    mutable_index.build(keys.data(), keys.data() + keys.size());
+    bool curved = false;
+    for (std::size_t i = 0; i < mutable_index.num_segments(); ++i) {
+        curved = curved || mutable_index.segment_model(i) == ModelType::QUADRATIC ||
+                 mutable_index.segment_model(i) == ModelType::CUBIC;
+    }
+    EXPECT_TRUE(curved);
+    mutable_index.set_build_config(jazzy::BuildConfig::linear_only());
+    EXPECT_EQ(mutable_index.build_config(), jazzy::BuildConfig::linear_only());
+    mutable_index.build(keys.data(), keys.data() + keys.size());
+    for (std::size_t i = 1; i < keys.size(); i += 3) {
+        mutable_index.insert(keys[i] - 1);
+    }
+    for (std::size_t i = 0; i < mutable_index.num_segments(); ++i) {
+        const ModelType model = mutable_index.segment_model(i);
+        EXPECT_TRUE(model == ModelType::LINEAR || model == ModelType::CONSTANT) << "segment " << i;
+    }
+    for (const auto k : keys) {
+        ASSERT_NE(mutable_index.find(k), nullptr) << "key " << k;
+    }
+    jazzy::BuildConfig invalid;
+    invalid.cubic_improvement_threshold = 0.0;
+    EXPECT_THROW(mutable_index.set_build_config(invalid), std::invalid_argument);
+
+    // A streamed file has the models a JazzyIndex build with the same config fits
+    jazzy::StreamingIndexWriter<std::uint64_t> writer(keys.size(), 64);
+    writer.set_build_config(jazzy::BuildConfig::linear_only());
+    writer.append(keys.begin(), keys.end());
+    std::ostringstream out(std::ios::binary);
+    writer.finish(out);
+    std::istringstream in(out.str(), std::ios::binary);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> loaded;
+    loaded.load(in, keys.data(), keys.data() + keys.size());
+    const std::string json = jazzy::export_index_metadata(loaded);
+    EXPECT_EQ(count_models(json, "QUADRATIC") + count_models(json, "CUBIC"), 0);
+    expect_finds_all(loaded, keys);
+
+    jazzy::StreamingIndexWriter<std::uint64_t> started(keys.size(), 64);
+    started.append(keys.front());
+    EXPECT_THROW(started.set_build_config(jazzy::BuildConfig::linear_only()), std::runtime_error);
+    EXPECT_THROW(started.set_build_config(invalid), std::invalid_argument);
+}
+
+TEST(BuildConfigTest, PreferCubicAndUniformityTolerance) {
+    const auto keys = make_cubic_keys(20000);
+
+    jazzy::DynamicJazzyIndex<std::uint64_t> defaults(jazzy::SegmentSizing{1000, 64});
+    defaults.build(keys.data(), keys.data() + keys.size());
+    jazzy::DynamicJazzyIndex<std::uint64_t> cubic(jazzy::SegmentSizing{1000, 64});
+    cubic.set_build_config(jazzy::BuildConfig::prefer_cubic());
+    cubic.build(keys.data(), keys.data() + keys.size());
+    EXPECT_GE(count_models(jazzy::export_index_metadata(cubic), "CUBIC"),
+              count_models(jazzy::export_index_metadata(defaults), "CUBIC"));
+    EXPECT_LE(cubic.max_segment_error(), defaults.max_segment_error());
+    expect_finds_all(cubic, keys);
+
+    // Keys whose segments span very different ranges are only uniformly routed with a tolerance
+    // wide enough to cover them
+    std::vector<std::uint64_t> skewed(4096);
+    for (std::size_t i = 0; i < skewed.size(); ++i) {
+        skewed[i] = i * 100 + (i % 64 < 32 ? 0 : 40);
+    }
+    std::sort(skewed.begin(), skewed.end());
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL> index;
+    jazzy::BuildConfig strict;
+    strict.uniformity_tolerance = 0.0;
+    index.set_build_config(strict);
+    index.build(skewed.data(), skewed.data() + skewed.size());
+    const bool strict_uniform = index.query_path() == jazzy::QueryPath::LINEAR_UNIFORM;
+    jazzy::BuildConfig loose;
+    loose.uniformity_tolerance = 0.5;
+    index.set_build_config(loose);
+    index.build(skewed.data(), skewed.data() + skewed.size());
+    EXPECT_FALSE(strict_uniform);
+    EXPECT_EQ(index.query_path(), jazzy::QueryPath::LINEAR_UNIFORM);
+    expect_finds_all(index, skewed);
+}
+
+TEST(AutotuneTest, PicksFastestWithinMemoryBudget) {
+    const auto keys = make_cubic_keys(20000);
+    std::vector<std::uint64_t> queries;
+    for (std::size_t i = 0; i < keys.size(); i += 7) {
+        queries.push_back(keys[(i * 7919) % keys.size()]);
+    }
+
+    jazzy::TuningOptions options;
+    options.segment_counts = {16, 256};
+    options.rounds = 1;
+    const jazzy::TuningResult result = jazzy::autotune<std::uint64_t>(keys, queries, options);
+    ASSERT_EQ(result.trials.size(), 6u);  // Two segment counts times the three default configs
+    for (const auto& trial : result.trials) {
+        EXPECT_GT(trial.ns_per_query, 0.0);
+        EXPECT_GT(trial.memory_bytes, 0u);
+        EXPECT_LE(trial.num_segments, trial.sizing.max_segments);
+        EXPECT_GE(trial.ns_per_query, result.best.ns_per_query);
+    }
+    EXPECT_EQ(result.trials[0].config, jazzy::BuildConfig::linear_only());
+
+    // The result builds an index that finds every key
+    jazzy::DynamicJazzyIndex<std::uint64_t> index(result.best.sizing);
+    index.set_build_config(result.best.config);
+    index.build(keys.data(), keys.data() + keys.size());
+    EXPECT_EQ(index.num_segments(), result.best.num_segments);
+    expect_finds_all(index, keys);
+
+    // A memory budget only the 16-segment builds meet
+    const auto smallest = std::min_element(result.trials.begin(), result.trials.end(),
+                                           [](const auto& a, const auto& b) { return a.memory_bytes < b.memory_bytes; });
+    options.max_memory_bytes = smallest->memory_bytes;
+    const jazzy::TuningResult small = jazzy::autotune<std::uint64_t>(keys, queries, options);
+    EXPECT_EQ(small.best.sizing.max_segments, 16u);
+
+    // No candidate fits: the smallest one is returned
+    options.max_memory_bytes = 1;
+    EXPECT_EQ(jazzy::autotune<std::uint64_t>(keys, queries, options).best.sizing.max_segments, 16u);
+
+    options.rounds = 0;
+    EXPECT_THROW((void)jazzy::autotune<std::uint64_t>(keys, queries, options), std::invalid_argument);
+    options.rounds = 1;
+    options.segment_counts = {0};
+    EXPECT_THROW((void)jazzy::autotune<std::uint64_t>(keys, queries, options), std::invalid_argument);
+    EXPECT_THROW((void)jazzy::autotune<std::uint64_t>(keys, std::span<const std::uint64_t>{}),
+                 std::invalid_argument);
+}
@@ -0,0 +1,250 @@
+// Tests for compact segment tables: key-only segment bounds for records read through a
+// KeyExtractor, the quantized layout::Compressed models, and memory_usage()
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_parallel.hpp"
+#include "jazzy_index_serialize.hpp"
+#include "test_data.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+using jazzy::test::make_skewed;
+
+struct Record {
+    std::uint64_t key;
+    std::string payload;
+
+    bool operator<(const Record& other) const { return key < other.key; }
+    bool operator>(const Record& other) const { return key > other.key; }
+};
+
+struct ByKey {
+    bool operator()(const Record& a, const Record& b) const { return a.key < b.key; }
+};
+
+using KeyOf = decltype(&Record::key);
+
+// Transparent comparators order the extracted keys, so only the key lands in the segment tables
+static_assert(std::is_same_v<jazzy::detail::segment_bound_t<Record, std::less<>, KeyOf>, std::uint64_t>);
+static_assert(std::is_same_v<jazzy::detail::segment_bound_t<Record, std::greater<>, KeyOf>, std::uint64_t>);
+// A comparator that only takes records keeps full copies; identity keeps T
+static_assert(std::is_same_v<jazzy::detail::segment_bound_t<Record, ByKey, KeyOf>, Record>);
+static_assert(std::is_same_v<jazzy::detail::segment_bound_t<double, std::less<>, jazzy::identity>, double>);
+
+using CompressedOptions = jazzy::IndexOptions<jazzy::layout::Compressed>;
+using CompressedBinaryOptions = jazzy::IndexOptions<jazzy::layout::Compressed, jazzy::routing::BinarySearch>;
+
+template <jazzy::SegmentCount Segments, typename Options = CompressedOptions>
+using CompressedIndex = jazzy::JazzyIndex<std::uint64_t, Segments, std::less<>, jazzy::identity, Options>;
+
+// Every query (hits, misses between keys and keys past either end) matches std:: algorithms
+template <typename Index>
+void expect_exact(const Index& index, const std::vector<std::uint64_t>& data) {
+    const std::uint64_t* begin = data.data();
+    const std::uint64_t* end = begin + data.size();
+    std::vector<std::uint64_t> queries{0, data.back() + 1, data.back() + 1000};
+    for (std::size_t i = 0; i < data.size(); i += 7) {
+        queries.push_back(data[i]);
+        queries.push_back(data[i] + 1);
+        if (data[i] > 0) {
+            queries.push_back(data[i] - 1);
+        }
+    }
+    for (const auto q : queries) {
+        const bool present = std::binary_search(begin, end, q);
+        const auto* found = index.find(q);
+        ASSERT_EQ(found != end, present) << "find " << q;
+        if (present) {
+            EXPECT_EQ(*found, q);
+        }
+        EXPECT_EQ(index.find_lower_bound(q), std::lower_bound(begin, end, q)) << "lower bound " << q;
+        EXPECT_EQ(index.find_upper_bound(q), std::upper_bound(begin, end, q)) << "upper bound " << q;
+    }
+
+    std::vector<const std::uint64_t*> batch(queries.size());
+    index.find_lower_bound_batch(queries, batch);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(batch[i], std::lower_bound(begin, end, queries[i])) << "batch " << queries[i];
+    }
+}
+
+}  // namespace
+
+TEST(CompactSegmentTest, QuantizedRecordIsHalfACacheLine) {
+    EXPECT_EQ(sizeof(jazzy::detail::QuantizedSegment), 32u);
+    EXPECT_LT(sizeof(jazzy::detail::QuantizedSegment), sizeof(jazzy::detail::CompactSegment));
+}
+
+TEST(CompactSegmentTest, CompressedUniformData) {
+    std::vector<std::uint64_t> data(50'000);
+    std::iota(data.begin(), data.end(), 100);
+    CompressedIndex<jazzy::SegmentCount::LARGE> index(data.data(), data.data() + data.size());
+    expect_exact(index, data);
+}
+
+TEST(CompactSegmentTest, CompressedSkewedData) {
+    const auto data = make_skewed(60'000, 3);
+    CompressedIndex<jazzy::SegmentCount::XXLARGE> eytzinger(data.data(), data.data() + data.size());
+    expect_exact(eytzinger, data);
+    CompressedIndex<jazzy::SegmentCount::SMALL, CompressedBinaryOptions> binary(data.data(),
+                                                                                 data.data() + data.size());
+    expect_exact(binary, data);
+}
+
+TEST(CompactSegmentTest, CompressedCurvedDataUsesEveryModel) {
+    std::vector<std::uint64_t> data(40'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        const double x = static_cast<double>(i) / static_cast<double>(data.size());
+        data[i] = static_cast<std::uint64_t>(std::pow(x, 5) * 1e12) + i;
+    }
+    CompressedIndex<jazzy::SegmentCount::MEDIUM> index(data.data(), data.data() + data.size());
+    expect_exact(index, data);
+}
+
+TEST(CompactSegmentTest, CompressedDuplicatesAndSmallInputs) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t v = 0; v < 200; ++v) {
+        data.insert(data.end(), 1 + v % 17, v * 3);
+    }
+    CompressedIndex<jazzy::SegmentCount::LARGE> index(data.data(), data.data() + data.size());
+    expect_exact(index, data);
+
+    const std::vector<std::uint64_t> one{42};
+    CompressedIndex<jazzy::SegmentCount::LARGE> single(one.data(), one.data() + 1);
+    EXPECT_EQ(single.find(42), one.data());
+    EXPECT_EQ(single.find(41), one.data() + 1);
+}
+
+TEST(CompactSegmentTest, CompressedParallelErrorBoundedAndDynamic) {
+    const auto data = make_skewed(30'000, 11);
+
+    CompressedIndex<jazzy::SegmentCount::LARGE> parallel;
+    parallel.build_parallel(data.data(), data.data() + data.size());
+    expect_exact(parallel, data);
+
+    CompressedIndex<jazzy::SegmentCount::XLARGE> bounded;
+    bounded.build_error_bounded(data.data(), data.data() + data.size(), 16);
+    ASSERT_TRUE(bounded.error_bound().has_value());
+    expect_exact(bounded, data);
+
+    jazzy::DynamicJazzyIndex<std::uint64_t, std::less<>, jazzy::identity, CompressedOptions> dynamic;
+    dynamic.build(data.data(), data.data() + data.size());
+    expect_exact(dynamic, data);
+}
+
+TEST(CompactSegmentTest, CompressedFloatingPointAndDescendingKeys) {
+    std::vector<double> values(10'000);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        values[i] = std::exp(static_cast<double>(i) / 1000.0) - 5.0;
+    }
+    jazzy::JazzyIndex<double, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity, CompressedOptions> index(
+        values.data(), values.data() + values.size());
+    for (std::size_t i = 0; i < values.size(); i += 13) {
+        EXPECT_EQ(index.find(values[i]), values.data() + i);
+    }
+
+    std::vector<std::uint64_t> descending = make_skewed(10'000, 5);
+    std::reverse(descending.begin(), descending.end());
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::greater<>, jazzy::identity, CompressedOptions>
+        down(descending.data(), descending.data() + descending.size());
+    for (std::size_t i = 0; i < descending.size(); i += 13) {
+        const auto* found = down.find(descending[i]);
+        ASSERT_NE(found, descending.data() + descending.size());
+        EXPECT_EQ(*found, descending[i]);
+        const auto expected = std::lower_bound(descending.begin(), descending.end(), descending[i], std::greater<>{});
+        EXPECT_EQ(down.find_lower_bound(descending[i]), descending.data() + (expected - descending.begin()));
+    }
+}
+
+TEST(CompactSegmentTest, CompressedSaveLoadAndView) {
+    const auto data = make_skewed(20'000, 8);
+    CompressedIndex<jazzy::SegmentCount::LARGE> index(data.data(), data.data() + data.size());
+
+    std::stringstream file;
+    index.save(file);
+    const std::string bytes = file.str();
+
+    CompressedIndex<jazzy::SegmentCount::LARGE> restored;
+    std::istringstream in(bytes);
+    restored.load(in, data.data(), data.data() + data.size());
+    expect_exact(restored, data);
+
+    // The file holds absolute float models with their own measured error, readable by any layout
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> interleaved;
+    std::istringstream again(bytes);
+    interleaved.load(again, data.data(), data.data() + data.size());
+    expect_exact(interleaved, data);
+
+    jazzy::JazzyIndexView<std::uint64_t> view(
+        std::span<const std::byte>(reinterpret_cast<const std::byte*>(bytes.data()), bytes.size()));
+    for (std::size_t i = 0; i < data.size(); i += 11) {
+        const auto* found = view.find(data[i]);
+        ASSERT_NE(found, view.end());
+        EXPECT_EQ(*found, data[i]);
+    }
+}
+
+TEST(CompactSegmentTest, RecordsKeepOnlyKeysInSegments) {
+    std::vector<Record> records;
+    for (std::uint64_t i = 0; i < 5'000; ++i) {
+        records.push_back({i * 7, "payload long enough to defeat the small string buffer " + std::to_string(i)});
+    }
+
+    jazzy::JazzyIndex<Record, jazzy::SegmentCount::LARGE, std::less<>, KeyOf> keyed(
+        records.data(), records.data() + records.size(), std::less<>{}, &Record::key);
+    jazzy::JazzyIndex<Record, jazzy::SegmentCount::LARGE, ByKey, KeyOf> copies(
+        records.data(), records.data() + records.size(), ByKey{}, &Record::key);
+    EXPECT_LT(keyed.memory_usage(), copies.memory_usage());
+
+    for (std::size_t i = 0; i < records.size(); i += 9) {
+        EXPECT_EQ(keyed.find(records[i]), records.data() + i);
+        EXPECT_EQ(keyed.find_lower_bound(Record{records[i].key + 1, {}}), records.data() + i + 1);
+        EXPECT_EQ(copies.find(records[i]), records.data() + i);
+    }
+    EXPECT_EQ(keyed.find(Record{3, {}}), records.data() + records.size());
+
+    std::vector<Record> descending(records.rbegin(), records.rend());
+    jazzy::JazzyIndex<Record, jazzy::SegmentCount::SMALL, std::greater<>, KeyOf,
+                      jazzy::IndexOptions<jazzy::layout::Compressed>>
+        down(descending.data(), descending.data() + descending.size(), std::greater<>{}, &Record::key);
+    for (std::size_t i = 0; i < descending.size(); i += 9) {
+        EXPECT_EQ(down.find(descending[i]), descending.data() + i);
+    }
+}
+
+TEST(CompactSegmentTest, MemoryUsageFollowsLayout) {
+    using Interleaved = jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::XXLARGE>;
+    using Split = jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::XXLARGE, std::less<>, jazzy::identity,
+                                    jazzy::IndexOptions<jazzy::layout::Split>>;
+    using Compressed = CompressedIndex<jazzy::SegmentCount::XXLARGE>;
+
+    const auto data = make_skewed(100'000, 2);
+    Interleaved interleaved(data.data(), data.data() + data.size());
+    Split split(data.data(), data.data() + data.size());
+    Compressed compressed(data.data(), data.data() + data.size());
+    // Everything but the run table (this data repeats keys) is held inline
+    EXPECT_EQ(interleaved.memory_usage(),
+              sizeof(Interleaved) + interleaved.num_tabled_runs() * sizeof(jazzy::detail::KeyRun));
+    EXPECT_LT(split.memory_usage(), interleaved.memory_usage());
+    EXPECT_LT(compressed.memory_usage(), split.memory_usage());
+
+    // Runtime-sized indexes count their heap tables, which grow with the segment count
+    jazzy::DynamicJazzyIndex<std::uint64_t> few(jazzy::SegmentSizing{.keys_per_segment = 10'000});
+    jazzy::DynamicJazzyIndex<std::uint64_t> many(jazzy::SegmentSizing{.keys_per_segment = 100});
+    few.build(data.data(), data.data() + data.size());
+    many.build(data.data(), data.data() + data.size());
+    EXPECT_GT(few.memory_usage(), sizeof(few));
+    EXPECT_GT(many.memory_usage(), few.memory_usage());
+}
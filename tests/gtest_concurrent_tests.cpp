@@ -0,0 +1,131 @@
+// Tests for ConcurrentJazzyIndex (jazzy_index_concurrent.hpp): publishing rebuilt versions,
+// snapshots pinning old versions, epoch reclamation, and readers racing a rebuilding writer
+
+#include "jazzy_index_concurrent.hpp"
+#include "jazzy_index_executor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Index = jazzy::ConcurrentJazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL>;
+
+// Version v holds the multiples of v + 1 below 20000 (v > 0)
+std::vector<std::uint64_t> keys_for(std::uint64_t v) {
+    std::vector<std::uint64_t> keys;
+    for (std::uint64_t k = 0; k < 20000; k += v + 1) {
+        keys.push_back(k);
+    }
+    return keys;
+}
+
+bool found(const Index::Snapshot& snap, std::uint64_t key) {
+    return snap->find(key) != snap.keys().data() + snap.keys().size();
+}
+
+}  // namespace
+
+TEST(ConcurrentJazzyIndexTest, StartsEmptyAndPublishesRebuilds) {
+    Index index;
+    EXPECT_EQ(index.version(), 0u);
+    EXPECT_FALSE(index.contains(0));
+
+    index.rebuild(keys_for(1));
+    EXPECT_EQ(index.version(), 1u);
+    EXPECT_TRUE(index.contains(2));
+    EXPECT_FALSE(index.contains(3));
+
+    jazzy::parallel::ThreadPool pool(4);
+    index.rebuild_parallel(keys_for(2), pool);
+    EXPECT_EQ(index.version(), 2u);
+    EXPECT_TRUE(index.contains(3));
+    EXPECT_FALSE(index.contains(2));
+}
+
+TEST(ConcurrentJazzyIndexTest, SnapshotKeepsItsVersionAlive) {
+    Index index;
+    index.rebuild(keys_for(1));
+    {
+        const auto snap = index.snapshot();
+        index.rebuild(keys_for(4));
+        index.rebuild(keys_for(9));
+
+        // The pinned version still answers from its own keys
+        EXPECT_EQ(snap.version(), 1u);
+        EXPECT_TRUE(found(snap, 2));
+        EXPECT_EQ(snap.keys().size(), keys_for(1).size());
+        EXPECT_EQ(index.reclaim(), 2u);
+    }
+    EXPECT_EQ(index.reclaim(), 0u);
+    EXPECT_TRUE(index.contains(10));
+    EXPECT_FALSE(index.contains(2));
+}
+
+TEST(ConcurrentJazzyIndexTest, FailedBuildPublishesNothing) {
+    Index index;
+    index.rebuild(keys_for(1));
+    EXPECT_THROW(index.rebuild({3, 1, 2}), std::runtime_error);
+    EXPECT_EQ(index.version(), 1u);
+    EXPECT_TRUE(index.contains(4));
+}
+
+TEST(ConcurrentJazzyIndexTest, SnapshotsMove) {
+    Index index;
+    index.rebuild(keys_for(1));
+    auto a = index.snapshot();
+    auto b = std::move(a);
+    index.rebuild(keys_for(2));
+    EXPECT_EQ(b.version(), 1u);
+    b = index.snapshot();
+    EXPECT_EQ(b.version(), 2u);
+    EXPECT_EQ(index.reclaim(), 0u);
+}
+
+TEST(ConcurrentJazzyIndexTest, ReadersSeeWholeVersionsWhileWriterRebuilds) {
+    Index index;
+    index.rebuild(keys_for(1));
+
+    std::atomic<bool> done{false};
+    std::atomic<std::size_t> failures{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 8; ++r) {
+        readers.emplace_back([&, r] {
+            std::uint64_t probe = static_cast<std::uint64_t>(r);
+            while (!done.load()) {
+                const auto snap = index.snapshot();
+                const std::uint64_t step = snap.version() + 1;
+                // Every key of the pinned version is found, and nothing from another version is
+                probe = (probe * 2654435761u + 1) % 20000;
+                const bool expected = probe % step == 0;
+                if (found(snap, probe) != expected ||
+                    snap.keys().size() != (19999 / step) + 1) {
+                    failures.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    jazzy::parallel::ThreadPool pool(2);
+    for (std::uint64_t v = 2; v <= 60; ++v) {
+        if (v % 2 == 0) {
+            index.rebuild(keys_for(v));
+        } else {
+            index.rebuild_parallel(keys_for(v), pool);
+        }
+    }
+    done.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0u);
+    EXPECT_EQ(index.version(), 60u);
+    EXPECT_EQ(index.reclaim(), 0u);
+}
@@ -0,0 +1,179 @@
+// Tests for coroutine lookups (jazzy_index_coroutine.hpp): find_async and the bound variants,
+// run alone and interleaved by interleave_lookups, against the synchronous API
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_coroutine.hpp"
+#include "test_data.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using jazzy::test::make_skewed;
+
+// Hits, misses next to keys and keys past either end, in random order
+template <typename T>
+std::vector<T> make_queries(const std::vector<T>& data, std::uint64_t seed) {
+    std::vector<T> queries{T{0}, static_cast<T>(data.back() + 1000)};
+    for (std::size_t i = 0; i < data.size(); i += 5) {
+        queries.push_back(data[i]);
+        queries.push_back(static_cast<T>(data[i] + 1));
+    }
+    std::shuffle(queries.begin(), queries.end(), std::mt19937_64(seed));
+    return queries;
+}
+
+// Every lookup kind, run alone and interleaved at each group size, answers as the synchronous call
+template <typename Index, typename T>
+void expect_matches_sync(const Index& index, const std::vector<T>& queries) {
+    std::vector<const T*> out(queries.size());
+    for (const std::size_t group : {1u, 2u, 3u, 8u, 32u}) {
+        jazzy::interleave_lookups(queries, std::span<const T*>(out), group,
+                                  [&index](T key) { return index.find_async(key); });
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            ASSERT_EQ(out[i], index.find(queries[i])) << "find " << queries[i] << " group " << group;
+        }
+        jazzy::interleave_lookups(queries, std::span<const T*>(out), group,
+                                  [&index](T key) { return index.find_lower_bound_async(key); });
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            ASSERT_EQ(out[i], index.find_lower_bound(queries[i])) << "lower " << queries[i] << " group " << group;
+        }
+        jazzy::interleave_lookups(queries, std::span<const T*>(out), group,
+                                  [&index](T key) { return index.find_upper_bound_async(key); });
+        for (std::size_t i = 0; i < queries.size(); ++i) {
+            ASSERT_EQ(out[i], index.find_upper_bound(queries[i])) << "upper " << queries[i] << " group " << group;
+        }
+    }
+    for (std::size_t i = 0; i < queries.size(); i += 11) {
+        EXPECT_EQ(index.find_async(queries[i]).get(), index.find(queries[i]));
+    }
+}
+
+}  // namespace
+
+TEST(CoroutineTest, UniformAndSkewedData) {
+    std::vector<std::uint64_t> uniform(20'000);
+    for (std::size_t i = 0; i < uniform.size(); ++i) {
+        uniform[i] = i * 4;
+    }
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> uniform_index(uniform.data(),
+                                                                               uniform.data() + uniform.size());
+    expect_matches_sync(uniform_index, make_queries(uniform, 1));
+
+    const auto skewed = make_skewed(20'000, 2);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> skewed_index(skewed.data(),
+                                                                              skewed.data() + skewed.size());
+    expect_matches_sync(skewed_index, make_queries(skewed, 3));
+}
+
+TEST(CoroutineTest, EveryLayout) {
+    const auto data = make_skewed(10'000, 4);
+    const auto queries = make_queries(data, 5);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM, std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Split>> split(data.data(), data.data() + data.size());
+    expect_matches_sync(split, queries);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM, std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Compressed>> compact(data.data(), data.data() + data.size());
+    expect_matches_sync(compact, queries);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM, std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Precise>> precise(data.data(), data.data() + data.size());
+    expect_matches_sync(precise, queries);
+}
+
+TEST(CoroutineTest, DuplicatesAndDescendingKeys) {
+    std::vector<std::uint32_t> data;
+    for (std::uint32_t v = 0; v < 500; ++v) {
+        data.insert(data.end(), 1 + v % 9, v * 2);
+    }
+    jazzy::JazzyIndex<std::uint32_t, jazzy::SegmentCount::MEDIUM> index(data.data(), data.data() + data.size());
+    expect_matches_sync(index, make_queries(data, 6));
+
+    std::vector<std::uint32_t> descending(data.rbegin(), data.rend());
+    jazzy::JazzyIndex<std::uint32_t, jazzy::SegmentCount::MEDIUM, std::greater<>> down(
+        descending.data(), descending.data() + descending.size());
+    std::vector<std::uint32_t> queries{0, 1, 2, 500, 997, 998, 999, 5000};
+    std::vector<const std::uint32_t*> out(queries.size());
+    jazzy::interleave_lookups(queries, std::span<const std::uint32_t*>(out), 4,
+                              [&down](std::uint32_t key) { return down.find_lower_bound_async(key); });
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(out[i], down.find_lower_bound(queries[i])) << queries[i];
+    }
+}
+
+TEST(CoroutineTest, EmptyAndSmallIndexes) {
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL> empty;
+    EXPECT_EQ(empty.find_async(1).get(), empty.find(1));
+    EXPECT_EQ(empty.find_lower_bound_async(1).get(), empty.find_lower_bound(1));
+
+    const std::vector<std::uint64_t> one{42};
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL> single(one.data(), one.data() + 1);
+    EXPECT_EQ(single.find_async(42).get(), one.data());
+    EXPECT_EQ(single.find_async(41).get(), one.data() + 1);
+    EXPECT_EQ(single.find_upper_bound_async(42).get(), one.data() + 1);
+
+    // No keys, no work; more slots than keys
+    const std::vector<std::uint64_t> none;
+    std::vector<const std::uint64_t*> out(2);
+    jazzy::interleave_lookups(none, std::span<const std::uint64_t*>(out), 8,
+                              [&single](std::uint64_t key) { return single.find_async(key); });
+    const std::vector<std::uint64_t> keys{42, 7};
+    jazzy::interleave_lookups(keys, std::span<const std::uint64_t*>(out), 8,
+                              [&single](std::uint64_t key) { return single.find_async(key); });
+    EXPECT_EQ(out[0], one.data());
+    EXPECT_EQ(out[1], one.data() + 1);
+}
+
+TEST(CoroutineTest, TaskStepsAndErrors) {
+    std::vector<std::uint64_t> data(5'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = i * 3;
+    }
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index(data.data(), data.data() + data.size());
+
+    // A lookup starts suspended and stops at each prefetch
+    auto task = index.find_async(300);
+    EXPECT_FALSE(task.done());
+    EXPECT_THROW((void)task.result(), std::logic_error);
+    std::size_t resumes = 0;
+    while (!task.done()) {
+        task.resume();
+        ++resumes;
+    }
+    EXPECT_EQ(resumes, 3u);
+    EXPECT_EQ(task.result(), data.data() + 100);
+
+    // Moved-from and default tasks are done but hold no result
+    jazzy::LookupTask<std::uint64_t> moved = std::move(task);
+    EXPECT_TRUE(task.done());
+    EXPECT_EQ(moved.result(), data.data() + 100);
+    jazzy::LookupTask<std::uint64_t> none;
+    EXPECT_TRUE(none.done());
+    EXPECT_THROW((void)none.result(), std::logic_error);
+
+    // Unfinished tasks free their frames
+    for (int i = 0; i < 1000; ++i) {
+        auto started = index.find_async(static_cast<std::uint64_t>(i));
+        started.resume();
+    }
+
+    std::vector<std::uint64_t> keys{3, 6, 9};
+    std::vector<const std::uint64_t*> short_out(2);
+    const auto make = [&index](std::uint64_t key) { return index.find_async(key); };
+    EXPECT_THROW(jazzy::interleave_lookups(keys, std::span<const std::uint64_t*>(short_out), 4, make),
+                 std::invalid_argument);
+    std::vector<const std::uint64_t*> out(3);
+    EXPECT_THROW(jazzy::interleave_lookups(keys, std::span<const std::uint64_t*>(out), 0, make),
+                 std::invalid_argument);
+}
@@ -0,0 +1,162 @@
+// Tests for JazzyIndex::Cursor: seek() and find() on sorted probe streams (short gallops and far
+// jumps), backwards and random seeks, and empty or rebuilt indexes
+
+#include "jazzy_index.hpp"
+#include "test_data.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+namespace {
+
+using jazzy::test::make_keys;
+
+// count ascending probes spread over the keys (and a little past both ends)
+std::vector<std::uint64_t> make_sorted_probes(const std::vector<std::uint64_t>& keys, std::size_t count,
+                                              std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<std::uint64_t> value(keys.front() - 50, keys.back() + 50);
+    std::vector<std::uint64_t> probes(count);
+    for (auto& p : probes) {
+        p = rng() % 2 == 0 ? keys[rng() % keys.size()] : value(rng);
+    }
+    std::sort(probes.begin(), probes.end());
+    return probes;
+}
+
+// Every seek and find through one cursor matches std::lower_bound over the keys
+template <typename Index>
+void expect_cursor_matches(const Index& index, const std::vector<std::uint64_t>& keys,
+                           const std::vector<std::uint64_t>& probes) {
+    auto cursor = index.cursor();
+    const auto* end = keys.data() + keys.size();
+    for (const std::uint64_t p : probes) {
+        const auto* expected = std::lower_bound(keys.data(), end, p);
+        ASSERT_EQ(cursor.seek(p), expected) << "probe " << p;
+        ASSERT_EQ(cursor.position(), expected);
+        ASSERT_EQ(cursor.find(p), expected != end && *expected == p ? expected : end) << "probe " << p;
+    }
+}
+
+}  // namespace
+
+TEST(CursorTest, SortedStreamsAtEveryDensity) {
+    const auto keys = make_keys(100000, 1);
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index(keys.data(), keys.data() + keys.size());
+    // Dense streams gallop a few keys per seek; sparse ones jump through the model
+    for (const std::size_t count : {300000u, 100000u, 5000u, 100u, 3u}) {
+        expect_cursor_matches(index, keys, make_sorted_probes(keys, count, count));
+    }
+
+    // Every key in order, each twice
+    std::vector<std::uint64_t> twice;
+    for (const auto k : keys) {
+        twice.push_back(k);
+        twice.push_back(k);
+    }
+    expect_cursor_matches(index, keys, twice);
+}
+
+TEST(CursorTest, LayoutsUniformAndDynamicIndexes) {
+    std::vector<std::uint64_t> uniform(50000);
+    for (std::size_t i = 0; i < uniform.size(); ++i) {
+        uniform[i] = i * 5;
+    }
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> flat(uniform.data(),
+                                                                             uniform.data() + uniform.size());
+    expect_cursor_matches(flat, uniform, make_sorted_probes(uniform, 20000, 2));
+    expect_cursor_matches(flat, uniform, make_sorted_probes(uniform, 50, 3));
+
+    const auto keys = make_keys(60000, 4);
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity,
+                            jazzy::IndexOptions<jazzy::layout::Compressed, jazzy::routing::BinarySearch>>
+        compressed(keys.data(), keys.data() + keys.size());
+    expect_cursor_matches(compressed, keys, make_sorted_probes(keys, 30000, 5));
+    expect_cursor_matches(compressed, keys, make_sorted_probes(keys, 300, 6));
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::DYNAMIC, std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Precise>>
+        dynamic(jazzy::SegmentSizing{});
+    dynamic.build_error_bounded(keys.data(), keys.data() + keys.size(), 8);
+    expect_cursor_matches(dynamic, keys, make_sorted_probes(keys, 30000, 7));
+    expect_cursor_matches(dynamic, keys, make_sorted_probes(keys, 300, 8));
+}
+
+TEST(CursorTest, BackwardsAndRandomSeeks) {
+    const auto keys = make_keys(40000, 9);
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index(keys.data(), keys.data() + keys.size());
+
+    auto probes = make_sorted_probes(keys, 20000, 10);
+    std::reverse(probes.begin(), probes.end());
+    expect_cursor_matches(index, keys, probes);
+    std::shuffle(probes.begin(), probes.end(), std::mt19937_64(11));
+    expect_cursor_matches(index, keys, probes);
+
+    // Short back-and-forth steps inside one run of duplicates and across its ends
+    std::vector<std::uint64_t> sawtooth;
+    for (std::size_t i = 100; i < 30000; i += 37) {
+        sawtooth.push_back(keys[i]);
+        sawtooth.push_back(keys[i] - 1);
+        sawtooth.push_back(keys[i + 3]);
+    }
+    expect_cursor_matches(index, keys, sawtooth);
+}
+
+TEST(CursorTest, EmptySingleAndRebuiltIndexes) {
+    const jazzy::JazzyIndex<std::uint64_t> empty;
+    auto none = empty.cursor();
+    EXPECT_EQ(none.seek(5), nullptr);
+    EXPECT_EQ(none.find(5), nullptr);
+
+    const std::vector<std::uint64_t> one{7};
+    const jazzy::JazzyIndex<std::uint64_t> single(one.data(), one.data() + 1);
+    expect_cursor_matches(single, one, {0, 7, 7, 8, 100});
+    expect_cursor_matches(single, one, {100, 7, 0});
+
+    // A cursor reset after a rebuild over fewer keys
+    const auto keys = make_keys(20000, 12);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> index(keys.data(), keys.data() + keys.size());
+    auto cursor = index.cursor();
+    EXPECT_EQ(cursor.position(), keys.data());
+    EXPECT_EQ(cursor.seek(keys.back()), std::lower_bound(keys.data(), keys.data() + keys.size(), keys.back()));
+
+    const std::vector<std::uint64_t> fewer(keys.begin(), keys.begin() + 500);
+    index.build(fewer.data(), fewer.data() + fewer.size());
+    cursor.reset();
+    EXPECT_EQ(cursor.position(), fewer.data());
+    for (const auto k : fewer) {
+        ASSERT_EQ(*cursor.find(k), k);
+    }
+    EXPECT_EQ(cursor.seek(fewer.back() + 1), fewer.data() + fewer.size());
+}
+
+TEST(CursorTest, DoublesAndDescendingComparator) {
+    std::vector<double> doubles(30000);
+    for (std::size_t i = 0; i < doubles.size(); ++i) {
+        doubles[i] = -100.0 + static_cast<double>(i * i) * 1e-4;
+    }
+    const jazzy::JazzyIndex<double, jazzy::SegmentCount::MEDIUM> by_value(doubles.data(),
+                                                                          doubles.data() + doubles.size());
+    auto cursor = by_value.cursor();
+    for (double v = -101.0; v < 90000.0; v += 3.7) {
+        ASSERT_EQ(cursor.seek(v), std::lower_bound(doubles.data(), doubles.data() + doubles.size(), v)) << v;
+    }
+
+    const auto ascending = make_keys(30000, 13);
+    const std::vector<std::uint64_t> descending(ascending.rbegin(), ascending.rend());
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::greater<>> reversed(
+        descending.data(), descending.data() + descending.size());
+    auto down = reversed.cursor();
+    auto probes = make_sorted_probes(ascending, 10000, 14);
+    std::reverse(probes.begin(), probes.end());  // Ascending under std::greater
+    const auto* end = descending.data() + descending.size();
+    for (const auto p : probes) {
+        ASSERT_EQ(down.seek(p), std::lower_bound(descending.data(), end, p, std::greater<>{})) << p;
+    }
+}
@@ -450,9 +450,9 @@ TEST_F(DebugLoggingTest, EqualRangeLogging) {
     // Verify equal_range was called
     EXPECT_TRUE(contains(log, "equal_range: Called")) << "Missing equal_range log";
 
-    // Should see both lower_bound and upper_bound operations
-    EXPECT_TRUE(contains(log, "find_lower_bound")) << "Missing find_lower_bound log";
-    EXPECT_TRUE(contains(log, "find_upper_bound")) << "Missing find_upper_bound log";
+    // Both bounds come from one segment lookup
+    EXPECT_TRUE(contains(log, "find_segment: Called")) << "Missing find_segment log";
+    EXPECT_TRUE(contains(log, "equal_range: Found range")) << "Missing equal_range result log";
 
     // Verify the range is correct
     // Data has 4 instances of value 3 at indices 5, 6, 7, 8
@@ -565,6 +565,34 @@ TEST_F(DebugLoggingTest, ErrorMetricsValidation) {
     }
 }
 
+// Test: Eytzinger routing (default) and the binary search routing policy
+TEST_F(DebugLoggingTest, RoutingPolicySegmentFinding) {
+    std::vector<int> data;
+    for (int i = 0; i < 200; ++i) {
+        data.push_back(i * i * i);
+    }
+
+    jazzy::JazzyIndex<int, jazzy::to_segment_count<16>()> eytzinger_index;
+    eytzinger_index.build(data.data(), data.data() + data.size());
+    jazzy::clear_debug_log();
+    const int* result = eytzinger_index.find(1000);  // 10^3
+    std::string log = get_log();
+    EXPECT_TRUE(contains(log, "Eytzinger binary search")) << "Non-uniform data should use Eytzinger routing";
+    ASSERT_NE(result, data.data() + data.size());
+    EXPECT_EQ(*result, 1000);
+
+    jazzy::JazzyIndex<int, jazzy::to_segment_count<16>(), std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Interleaved, jazzy::routing::BinarySearch>> binary_index;
+    binary_index.build(data.data(), data.data() + data.size());
+    jazzy::clear_debug_log();
+    result = binary_index.find(1000);
+    log = get_log();
+    EXPECT_TRUE(contains(log, "Binary search iter")) << "BinarySearch policy should log its iterations";
+    EXPECT_FALSE(contains(log, "Eytzinger"));
+    ASSERT_NE(result, data.data() + data.size());
+    EXPECT_EQ(*result, 1000);
+}
+
 #else
 
 // Placeholder test when debug logging is disabled
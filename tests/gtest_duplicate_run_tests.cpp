@@ -0,0 +1,165 @@
+// Tests for duplicate-heavy keys: long runs of equal keys recorded in the run table at build time,
+// and bound queries on them checked against std::lower_bound/upper_bound across layouts
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_executor.hpp"
+#include "jazzy_index_parallel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace {
+
+// Zipf-like keys: key k repeats about count / (k + 1) times, so the first few keys fill most of it
+std::vector<std::uint64_t> make_zipf_runs(std::size_t count) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t key = 0; data.size() < count; ++key) {
+        const std::size_t repeats = std::max<std::size_t>(1, count / (4 * (key + 1)));
+        data.insert(data.end(), std::min(repeats, count - data.size()), key * 3);
+    }
+    return data;
+}
+
+// Every key in data, and every gap next to one, gets std's answers
+template <typename Index, typename Compare = std::less<>>
+void expect_bounds_match(const Index& index, const std::vector<std::uint64_t>& data, Compare comp = Compare{}) {
+    const std::uint64_t* begin = data.data();
+    const std::uint64_t* end = begin + data.size();
+    std::vector<std::uint64_t> probes(data.begin(), data.end());
+    probes.erase(std::unique(probes.begin(), probes.end()), probes.end());
+    const std::size_t distinct = probes.size();
+    for (std::size_t i = 0; i < distinct; ++i) {
+        probes.push_back(probes[i] + 1);
+        if (probes[i] > 0) {
+            probes.push_back(probes[i] - 1);
+        }
+    }
+    for (const std::uint64_t probe : probes) {
+        const auto [lower, upper] = index.equal_range(probe);
+        ASSERT_EQ(lower, std::lower_bound(begin, end, probe, comp)) << "probe " << probe;
+        ASSERT_EQ(upper, std::upper_bound(begin, end, probe, comp)) << "probe " << probe;
+        ASSERT_EQ(index.find_lower_bound(probe), lower) << "probe " << probe;
+        ASSERT_EQ(index.find_upper_bound(probe), upper) << "probe " << probe;
+        const std::uint64_t* found = index.find(probe);
+        ASSERT_EQ(found == end, lower == upper) << "probe " << probe;
+        if (found != end) {
+            EXPECT_FALSE(comp(*found, probe) || comp(probe, *found)) << "probe " << probe;
+        }
+    }
+}
+
+}  // namespace
+
+TEST(DuplicateRunTest, LongRunsAreTabledAndAnswered) {
+    const auto data = make_zipf_runs(200'000);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index;
+    index.build(data.data(), data.data() + data.size());
+
+    // Key 0 alone fills a quarter of the keys, so it crosses dozens of segment boundaries
+    EXPECT_GT(index.num_tabled_runs(), 0u);
+    const auto [lower, upper] = index.equal_range(0);
+    EXPECT_EQ(lower, data.data());
+    EXPECT_EQ(upper - lower, 50'000);
+    expect_bounds_match(index, data);
+}
+
+TEST(DuplicateRunTest, ShortOrInteriorRunsAreNotTabled) {
+    // Runs of 32 keys, shorter than MIN_TABLED_RUN, wherever the segment boundaries fall
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t i = 0; i < 32'000; ++i) {
+        data.push_back(i / 32);
+    }
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL> index;
+    index.build(data.data(), data.data() + data.size());
+    EXPECT_EQ(index.num_tabled_runs(), 0u);
+    expect_bounds_match(index, data);
+
+    // One run that sits inside a single segment of a two-segment index is not tabled either
+    std::vector<std::uint64_t> interior(1000);
+    for (std::size_t i = 0; i < interior.size(); ++i) {
+        interior[i] = i < 100 || i >= 200 ? i : 100;
+    }
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MINIMAL> two;
+    two.build(interior.data(), interior.data() + interior.size());
+    EXPECT_EQ(two.num_tabled_runs(), 0u);
+    expect_bounds_match(two, interior);
+}
+
+TEST(DuplicateRunTest, RunTableIsRebuiltWithTheIndex) {
+    const auto data = make_zipf_runs(50'000);
+    std::vector<std::uint64_t> distinct(50'000);
+    for (std::size_t i = 0; i < distinct.size(); ++i) {
+        distinct[i] = i;
+    }
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> index;
+    index.build(data.data(), data.data() + data.size());
+    EXPECT_GT(index.num_tabled_runs(), 0u);
+    index.build(distinct.data(), distinct.data() + distinct.size());
+    EXPECT_EQ(index.num_tabled_runs(), 0u);
+    expect_bounds_match(index, distinct);
+}
+
+TEST(DuplicateRunTest, EveryLayoutAndBuildAgrees) {
+    const auto data = make_zipf_runs(60'000);
+    const std::uint64_t* first = data.data();
+    const std::uint64_t* last = first + data.size();
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Split, jazzy::routing::BinarySearch>> split(first, last);
+    expect_bounds_match(split, data);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Compressed>> compressed(first, last);
+    expect_bounds_match(compressed, data);
+
+    jazzy::DynamicJazzyIndex<std::uint64_t> dynamic(jazzy::SegmentSizing{.keys_per_segment = 256});
+    dynamic.build(first, last);
+    EXPECT_GT(dynamic.num_tabled_runs(), 0u);
+    expect_bounds_match(dynamic, data);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> bounded;
+    bounded.build_error_bounded(first, last, 16);
+    expect_bounds_match(bounded, data);
+
+    jazzy::parallel::ThreadPool pool(4);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> parallel;
+    parallel.build_parallel(first, last, pool);
+    EXPECT_GT(parallel.num_tabled_runs(), 0u);
+    expect_bounds_match(parallel, data);
+}
+
+TEST(DuplicateRunTest, DescendingKeys) {
+    auto data = make_zipf_runs(40'000);
+    std::reverse(data.begin(), data.end());
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::greater<>> index;
+    index.build(data.data(), data.data() + data.size());
+    EXPECT_GT(index.num_tabled_runs(), 0u);
+    expect_bounds_match(index, data, std::greater<>{});
+}
+
+TEST(DuplicateRunTest, BatchedBoundsUseTheRunTable) {
+    const auto data = make_zipf_runs(100'000);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index;
+    index.build(data.data(), data.data() + data.size());
+
+    std::mt19937_64 rng(11);
+    std::vector<std::uint64_t> keys(1000);
+    for (auto& key : keys) {
+        key = data[rng() % data.size()] + (rng() % 3 == 0 ? 1 : 0);
+    }
+    std::vector<const std::uint64_t*> lower(keys.size());
+    std::vector<const std::uint64_t*> upper(keys.size());
+    index.find_lower_bound_batch(keys, lower);
+    index.find_upper_bound_batch(keys, upper);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        EXPECT_EQ(lower[i], std::lower_bound(data.data(), data.data() + data.size(), keys[i]));
+        EXPECT_EQ(upper[i], std::upper_bound(data.data(), data.data() + data.size(), keys[i]));
+    }
+}
@@ -0,0 +1,202 @@
+// Tests for runtime-sized indexes (SegmentCount::DYNAMIC / DynamicJazzyIndex)
+// Segment count is chosen per build and storage comes from a pmr memory resource
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_export.hpp"
+#include "jazzy_index_parallel.hpp"
+#include "test_data.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using jazzy::test::make_skewed;
+
+// Forwards to another resource and counts the bytes currently allocated through it
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t bytes_in_use = 0;
+    std::size_t allocations = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        bytes_in_use += bytes;
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        bytes_in_use -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+template <typename Index>
+void expect_matches_std(const Index& index, const std::vector<std::uint64_t>& data) {
+    const std::uint64_t* begin = data.data();
+    const std::uint64_t* end = data.data() + data.size();
+    std::vector<std::uint64_t> queries;
+    for (std::size_t i = 0; i < data.size(); i += 1 + data.size() / 500) {
+        queries.push_back(data[i]);
+        queries.push_back(data[i] + 1);
+    }
+    queries.push_back(data.back() + 100);
+
+    for (const auto q : queries) {
+        const auto* expected_lower = std::lower_bound(begin, end, q);
+        const auto* found = index.find(q);
+        if (expected_lower != end && *expected_lower == q) {
+            ASSERT_NE(found, end) << "key " << q;
+            EXPECT_EQ(*found, q);
+        } else {
+            EXPECT_EQ(found, end) << "key " << q;
+        }
+        EXPECT_EQ(index.find_lower_bound(q), expected_lower) << "key " << q;
+        EXPECT_EQ(index.find_upper_bound(q), std::upper_bound(begin, end, q)) << "key " << q;
+    }
+
+    std::vector<const std::uint64_t*> batch(queries.size());
+    index.find_lower_bound_batch(queries, batch);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(batch[i], std::lower_bound(begin, end, queries[i])) << "batch key " << queries[i];
+    }
+}
+
+}  // namespace
+
+// Test: Same segment count as a fixed preset gives the same segments and answers
+TEST(DynamicIndexTest, MatchesFixedIndex) {
+    const auto data = make_skewed(25'600, 1);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> fixed(data.data(), data.data() + data.size());
+    jazzy::DynamicJazzyIndex<std::uint64_t> dynamic(jazzy::SegmentSizing{100, 4096});
+    dynamic.build(data.data(), data.data() + data.size());
+
+    ASSERT_EQ(dynamic.num_segments(), fixed.num_segments());
+    EXPECT_EQ(jazzy::export_index_metadata(dynamic), jazzy::export_index_metadata(fixed));
+    expect_matches_std(dynamic, data);
+}
+
+// Test: Segment count follows the data size and stays within the budget
+TEST(DynamicIndexTest, SegmentCountFromSize) {
+    const auto data = make_skewed(100'000, 2);
+    jazzy::DynamicJazzyIndex<std::uint64_t> index;
+    EXPECT_EQ(index.segment_budget(), 4096u);
+
+    index.build(data.data(), data.data() + 50);
+    EXPECT_EQ(index.num_segments(), 1u);
+    const std::vector<std::uint64_t> prefix(data.begin(), data.begin() + 10'000);
+    index.build(prefix.data(), prefix.data() + prefix.size());
+    EXPECT_EQ(index.num_segments(), 157u);  // ceil(10000 / 64)
+    expect_matches_std(index, prefix);
+    index.build(data.data(), data.data() + data.size());
+    EXPECT_EQ(index.num_segments(), 1563u);
+    expect_matches_std(index, data);
+
+    jazzy::DynamicJazzyIndex<std::uint64_t> capped(jazzy::SegmentSizing{16, 300});
+    capped.build(data.data(), data.data() + data.size());
+    EXPECT_EQ(capped.num_segments(), 300u);
+    expect_matches_std(capped, data);
+}
+
+// Test: The object itself stays small; segment storage comes from the supplied resource
+TEST(DynamicIndexTest, StorageFromMemoryResource) {
+    EXPECT_LT(sizeof(jazzy::DynamicJazzyIndex<std::uint64_t>), 1024u);
+    EXPECT_GT(sizeof(jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MAX>), 100'000u);
+
+    const auto data = make_skewed(5'000, 3);
+    CountingResource resource;
+    {
+        jazzy::DynamicJazzyIndex<std::uint64_t> index(&resource);
+        EXPECT_EQ(resource.allocations, 0u);
+        index.build(data.data(), data.data() + data.size());
+        EXPECT_GT(resource.allocations, 0u);
+        EXPECT_GT(resource.bytes_in_use, 0u);
+        expect_matches_std(index, data);
+    }
+    EXPECT_EQ(resource.bytes_in_use, 0u);
+
+    // Many small per-partition indexes sharing one arena
+    std::pmr::monotonic_buffer_resource arena;
+    std::vector<jazzy::DynamicJazzyIndex<std::uint64_t>> partitions;
+    partitions.reserve(100);
+    for (std::size_t p = 0; p < 100; ++p) {
+        partitions.emplace_back(&arena);
+        partitions.back().build(data.data() + p * 50, data.data() + (p + 1) * 50);
+    }
+    for (std::size_t p = 0; p < 100; ++p) {
+        const std::uint64_t key = data[p * 50 + 25];
+        EXPECT_EQ(partitions[p].find_lower_bound(key),
+                  std::lower_bound(data.data() + p * 50, data.data() + (p + 1) * 50, key));
+    }
+}
+
+// Test: Error-bounded builds take as many segments as the error target needs
+TEST(DynamicIndexTest, ErrorBoundedSizing) {
+    const auto data = make_skewed(50'000, 4);
+    jazzy::DynamicJazzyIndex<std::uint64_t> index;
+    index.build_error_bounded(data.data(), data.data() + data.size(), 8);
+    ASSERT_TRUE(index.error_bound().has_value());
+    EXPECT_LE(*index.error_bound(), 8u);
+    expect_matches_std(index, data);
+
+    jazzy::DynamicJazzyIndex<std::uint64_t> parallel;
+    parallel.build_parallel_error_bounded(data.data(), data.data() + data.size(), 8);
+    EXPECT_EQ(parallel.num_segments(), index.num_segments());
+    EXPECT_EQ(parallel.error_bound(), index.error_bound());
+
+    jazzy::DynamicJazzyIndex<std::uint64_t> small_budget(jazzy::SegmentSizing{64, 8});
+    small_budget.build_error_bounded(data.data(), data.data() + data.size(), 8);
+    EXPECT_LE(small_budget.num_segments(), 8u);
+    expect_matches_std(small_budget, data);
+}
+
+// Test: Parallel equal-count build, split layout and binary search routing
+TEST(DynamicIndexTest, ParallelAndPolicies) {
+    const auto data = make_skewed(20'000, 5);
+    jazzy::DynamicJazzyIndex<std::uint64_t> sequential(data.data(), data.data() + data.size());
+    jazzy::DynamicJazzyIndex<std::uint64_t> parallel;
+    parallel.build_parallel(data.data(), data.data() + data.size());
+    EXPECT_EQ(jazzy::export_index_metadata(parallel), jazzy::export_index_metadata(sequential));
+
+    using SplitBinary = jazzy::IndexOptions<jazzy::layout::Split, jazzy::routing::BinarySearch>;
+    jazzy::DynamicJazzyIndex<std::uint64_t, std::less<>, jazzy::identity, SplitBinary> split;
+    split.build(data.data(), data.data() + data.size());
+    EXPECT_EQ(split.num_segments(), sequential.num_segments());
+    expect_matches_std(split, data);
+}
+
+// Test: Empty, single element, copies and invalid sizing
+TEST(DynamicIndexTest, EdgeCases) {
+    std::vector<std::uint64_t> empty;
+    jazzy::DynamicJazzyIndex<std::uint64_t> empty_index(empty.data(), empty.data());
+    EXPECT_EQ(empty_index.num_segments(), 0u);
+    EXPECT_EQ(empty_index.find(1), empty.data());
+
+    std::vector<std::uint64_t> single{5};
+    jazzy::DynamicJazzyIndex<std::uint64_t> single_index(single.data(), single.data() + 1);
+    EXPECT_EQ(single_index.num_segments(), 1u);
+    EXPECT_EQ(single_index.find(5), single.data());
+
+    const auto data = make_skewed(3'000, 6);
+    jazzy::DynamicJazzyIndex<std::uint64_t> original(data.data(), data.data() + data.size());
+    const auto copy = original;
+    original.build(data.data(), data.data() + 10);
+    EXPECT_EQ(copy.num_segments(), 47u);
+    expect_matches_std(copy, data);
+
+    EXPECT_THROW((jazzy::DynamicJazzyIndex<std::uint64_t>(jazzy::SegmentSizing{0, 16})), std::invalid_argument);
+    EXPECT_THROW((jazzy::DynamicJazzyIndex<std::uint64_t>(jazzy::SegmentSizing{64, 0})), std::invalid_argument);
+    EXPECT_THROW((jazzy::DynamicJazzyIndex<std::uint64_t>(jazzy::SegmentSizing{64, 5000})), std::invalid_argument);
+}
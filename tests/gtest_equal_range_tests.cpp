@@ -61,13 +61,13 @@ TEST(EqualRangeTest, MultipleDuplicates) {
 #ifdef JAZZY_DEBUG_LOGGING
     std::string log = jazzy::get_debug_log();
     if (!log.empty()) {
-        // equal_range should call both find_lower_bound and find_upper_bound
+        // equal_range finds both bounds from a single segment lookup
         EXPECT_NE(log.find("equal_range: Called"), std::string::npos)
             << "Should log equal_range call";
-        EXPECT_NE(log.find("find_lower_bound"), std::string::npos)
-            << "Should call find_lower_bound";
-        EXPECT_NE(log.find("find_upper_bound"), std::string::npos)
-            << "Should call find_upper_bound";
+        const auto first_lookup = log.find("find_segment: Called");
+        EXPECT_NE(first_lookup, std::string::npos) << "Should look up the segment";
+        EXPECT_EQ(log.find("find_segment: Called", first_lookup + 1), std::string::npos)
+            << "Should look up the segment only once";
     }
     jazzy::clear_debug_log();
 #endif
@@ -0,0 +1,188 @@
+// Tests for error-bounded segmentation (build_error_bounded, build_parallel_error_bounded)
+// Segments are cut by an epsilon corridor; lookups must match std:: and stay within the bound
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_parallel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Piecewise data: dense uniform run, quadratic ramp, sparse clusters
+std::vector<std::uint64_t> make_mixed(std::size_t n) {
+    std::vector<std::uint64_t> data;
+    data.reserve(n);
+    std::mt19937_64 rng(7);
+    std::uint64_t v = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i < n / 3) {
+            v += 1;
+        } else if (i < 2 * n / 3) {
+            v += 1 + (i - n / 3) / 8;
+        } else {
+            v += (i % 500 == 0) ? 1'000'000 : 1 + rng() % 3;
+        }
+        data.push_back(v);
+    }
+    return data;
+}
+
+template <typename Index>
+void expect_matches_std(const Index& index, const std::vector<std::uint64_t>& data) {
+    const std::uint64_t* begin = data.data();
+    const std::uint64_t* end = data.data() + data.size();
+    std::mt19937_64 rng(11);
+    std::uniform_int_distribution<std::size_t> index_dist(0, data.size() - 1);
+    for (std::size_t i = 0; i < 3'000; ++i) {
+        const std::uint64_t hit = data[index_dist(rng)];
+        for (const std::uint64_t q : {hit, hit + 1, hit - 1}) {
+            const auto* expected_lower = std::lower_bound(begin, end, q);
+            const auto* found = index.find(q);
+            if (expected_lower != end && *expected_lower == q) {
+                ASSERT_NE(found, end) << "key " << q;
+                EXPECT_EQ(*found, q);
+            } else {
+                EXPECT_EQ(found, end) << "key " << q;
+            }
+            EXPECT_EQ(index.find_lower_bound(q), expected_lower) << "key " << q;
+            EXPECT_EQ(index.find_upper_bound(q), std::upper_bound(begin, end, q)) << "key " << q;
+        }
+    }
+}
+
+}  // namespace
+
+// Test: The reported bound stays within epsilon when the budget allows it
+TEST(ErrorBoundedTest, BoundWithinEpsilon) {
+    const auto data = make_mixed(60'000);
+    for (const std::size_t epsilon : {std::size_t{4}, std::size_t{16}, std::size_t{64}}) {
+        jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MAX> index;
+        index.build_error_bounded(data.data(), data.data() + data.size(), epsilon);
+
+        ASSERT_TRUE(index.error_bound().has_value());
+        EXPECT_LE(*index.error_bound(), epsilon) << "epsilon " << epsilon;
+        EXPECT_GE(index.num_segments(), 1u);
+        EXPECT_LE(index.num_segments(), 2048u);
+        expect_matches_std(index, data);
+    }
+}
+
+// Test: Segments adapt to the data (a uniform run needs far fewer segments than the budget)
+TEST(ErrorBoundedTest, UniformDataNeedsFewSegments) {
+    std::vector<std::uint64_t> data(100'000);
+    std::iota(data.begin(), data.end(), 1'000);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MAX> index;
+    index.build_error_bounded(data.data(), data.data() + data.size(), 8);
+    EXPECT_LE(index.num_segments(), 4u);
+    ASSERT_TRUE(index.error_bound().has_value());
+    EXPECT_LE(*index.error_bound(), 8u);
+    expect_matches_std(index, data);
+}
+
+// Test: A budget too small for epsilon widens the corridor instead of exceeding the budget
+TEST(ErrorBoundedTest, BudgetWidensCorridor) {
+    const auto data = make_mixed(20'000);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::PICO> index;
+    index.build_error_bounded(data.data(), data.data() + data.size(), 1);
+
+    EXPECT_LE(index.num_segments(), 4u);
+    ASSERT_TRUE(index.error_bound().has_value());
+    EXPECT_GT(*index.error_bound(), 1u);
+    expect_matches_std(index, data);
+}
+
+// Test: Long duplicate runs and an exact (epsilon = 0) corridor
+TEST(ErrorBoundedTest, DuplicatesAndZeroEpsilon) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t v = 0; v < 400; ++v) {
+        data.insert(data.end(), 1 + (v % 13) * (v % 5), v * 10);
+    }
+
+    const std::uint64_t* begin = data.data();
+    const std::uint64_t* end = data.data() + data.size();
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MAX> index;
+    index.build_error_bounded(begin, end, 0);
+    ASSERT_TRUE(index.error_bound().has_value());
+    expect_matches_std(index, data);
+
+    for (std::uint64_t v = 0; v < 400; ++v) {
+        const auto range = index.equal_range(v * 10);
+        EXPECT_EQ(range, std::equal_range(begin, end, v * 10)) << "key " << v * 10;
+    }
+}
+
+// Test: Parallel build places the same boundaries as the sequential build
+TEST(ErrorBoundedTest, ParallelMatchesSequential) {
+    const auto data = make_mixed(50'000);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::XLARGE> sequential;
+    sequential.build_error_bounded(data.data(), data.data() + data.size(), 16);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::XLARGE> parallel;
+    parallel.build_parallel_error_bounded(data.data(), data.data() + data.size(), 16);
+
+    EXPECT_EQ(parallel.num_segments(), sequential.num_segments());
+    EXPECT_EQ(parallel.error_bound(), sequential.error_bound());
+    expect_matches_std(parallel, data);
+
+    std::vector<std::uint64_t> queries(data.begin(), data.begin() + 1'000);
+    std::vector<const std::uint64_t*> batch(queries.size());
+    parallel.find_batch(queries, batch);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(batch[i], sequential.find(queries[i])) << "key " << queries[i];
+    }
+}
+
+// Test: Split layout, descending comparator and rebuild with the equal-count build
+TEST(ErrorBoundedTest, LayoutComparatorAndRebuild) {
+    const auto data = make_mixed(30'000);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Split>> split;
+    split.build_error_bounded(data.data(), data.data() + data.size(), 8);
+    expect_matches_std(split, data);
+
+    std::vector<int> desc(10'000);
+    for (int i = 0; i < 10'000; ++i) {
+        desc[static_cast<std::size_t>(i)] = (i * i) / 50;
+    }
+    std::reverse(desc.begin(), desc.end());
+    jazzy::JazzyIndex<int, jazzy::SegmentCount::LARGE, std::greater<int>> desc_index;
+    desc_index.build_error_bounded(desc.data(), desc.data() + desc.size(), 4, std::greater<int>{});
+    for (int k = -1; k < desc.front() + 2; k += 13) {
+        EXPECT_EQ(desc_index.find_lower_bound(k),
+                  std::lower_bound(desc.data(), desc.data() + desc.size(), k, std::greater<int>{})) << "key " << k;
+    }
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index;
+    index.build_error_bounded(data.data(), data.data() + data.size(), 8);
+    EXPECT_TRUE(index.error_bound().has_value());
+    index.build(data.data(), data.data() + data.size());
+    EXPECT_FALSE(index.error_bound().has_value());
+    EXPECT_EQ(index.num_segments(), 256u);
+}
+
+// Test: Empty, single element and unsorted input
+TEST(ErrorBoundedTest, EdgeCases) {
+    std::vector<std::uint64_t> empty;
+    jazzy::JazzyIndex<std::uint64_t> empty_index;
+    empty_index.build_error_bounded(empty.data(), empty.data(), 4);
+    EXPECT_EQ(empty_index.find(1), empty.data());
+
+    std::vector<std::uint64_t> single{5};
+    jazzy::JazzyIndex<std::uint64_t> single_index;
+    single_index.build_error_bounded(single.data(), single.data() + 1, 4);
+    EXPECT_EQ(single_index.find(5), single.data());
+    EXPECT_EQ(single_index.error_bound(), std::size_t{0});
+
+    std::vector<std::uint64_t> unsorted{1, 2, 3, 100, 4, 5, 6, 7};
+    jazzy::JazzyIndex<std::uint64_t> unsorted_index;
+    EXPECT_THROW(unsorted_index.build_error_bounded(unsorted.data(), unsorted.data() + unsorted.size(), 0),
+                 std::runtime_error);
+}
@@ -0,0 +1,220 @@
+// Tests for the find() accelerators (IndexOptions<..., filter::BlockedBloom, cache::DirectMapped>):
+// the blocked Bloom filter itself, and indexes with either or both policies against plain ones
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_parallel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using jazzy::layout::Interleaved;
+using jazzy::routing::Eytzinger;
+using jazzy::stats::Disabled;
+
+using FilterOptions = jazzy::IndexOptions<Interleaved, Eytzinger, Disabled, jazzy::filter::BlockedBloom<>>;
+using CacheOptions = jazzy::IndexOptions<Interleaved, Eytzinger, Disabled, jazzy::filter::None,
+                                         jazzy::cache::DirectMapped<256>>;
+using BothOptions = jazzy::IndexOptions<jazzy::layout::Compressed, jazzy::routing::BinarySearch,
+                                        jazzy::stats::PerThread, jazzy::filter::BlockedBloom<16>,
+                                        jazzy::cache::DirectMapped<>>;
+
+template <typename Options, jazzy::SegmentCount Segments = jazzy::SegmentCount::LARGE>
+using Index = jazzy::JazzyIndex<std::uint64_t, Segments, std::less<>, jazzy::identity, Options>;
+
+// Sorted keys with gaps (and some duplicates), so most absent keys lie inside [min, max]
+std::vector<std::uint64_t> make_gapped_keys(std::size_t count, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::uint64_t> keys(count);
+    std::uint64_t key = 1000;
+    for (auto& k : keys) {
+        key += rng() % 16 == 0 ? 0 : 1 + rng() % 8;
+        k = key;
+    }
+    return keys;
+}
+
+// find() on index and on a plain index agree for every key and every value between them
+template <typename Accelerated>
+void expect_matches_plain(const Accelerated& index, const std::vector<std::uint64_t>& keys) {
+    const jazzy::JazzyIndex<std::uint64_t> plain(keys.data(), keys.data() + keys.size());
+    const auto* end = keys.data() + keys.size();
+    for (std::uint64_t v = keys.front() - 2; v <= keys.back() + 2; ++v) {
+        const auto* expected = plain.find(v);
+        const auto* found = index.find(v);
+        if (expected == end) {
+            ASSERT_EQ(found, end) << "value " << v;
+        } else {
+            ASSERT_NE(found, end) << "value " << v;
+            ASSERT_EQ(*found, v);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(BlockedBloomFilterTest, NoFalseNegativesAndFewFalsePositives) {
+    std::mt19937_64 rng(7);
+    std::vector<std::uint64_t> inserted(100000);
+    for (auto& k : inserted) {
+        k = rng();
+    }
+    jazzy::detail::BlockedBloomFilter filter;
+    filter.build(inserted.size(), 10, [&](std::size_t i) { return jazzy::detail::filter_hash(inserted[i]); });
+    EXPECT_GE(filter.heap_bytes(), inserted.size() * 10 / 8);
+
+    for (const auto k : inserted) {
+        ASSERT_TRUE(filter.may_contain(filter.prepare(jazzy::detail::filter_hash(k))));
+    }
+    std::size_t passed = 0;
+    const std::size_t probes = 100000;
+    for (std::size_t i = 0; i < probes; ++i) {
+        passed += filter.may_contain(filter.prepare(jazzy::detail::filter_hash(rng()))) ? 1 : 0;
+    }
+    EXPECT_LT(static_cast<double>(passed) / probes, 0.03);
+
+    // Keys that compare equal hash equal
+    EXPECT_EQ(jazzy::detail::filter_hash(0.0), jazzy::detail::filter_hash(-0.0));
+    EXPECT_EQ(jazzy::detail::filter_hash(2.5f), jazzy::detail::filter_hash(2.5));
+    EXPECT_NE(jazzy::detail::filter_hash(std::uint64_t{1}), jazzy::detail::filter_hash(std::uint64_t{2}));
+}
+
+TEST(FindAcceleratorTest, PoliciesOffByDefault) {
+    static_assert(std::is_empty_v<jazzy::detail::NoFilter>);
+    static_assert(std::is_empty_v<jazzy::detail::NoCache>);
+    static_assert(std::is_same_v<jazzy::IndexOptions<>::filter_type, jazzy::filter::None>);
+    static_assert(std::is_same_v<jazzy::IndexOptions<>::cache_type, jazzy::cache::None>);
+
+    const auto keys = make_gapped_keys(20000, 1);
+    const jazzy::JazzyIndex<std::uint64_t> plain(keys.data(), keys.data() + keys.size());
+    Index<FilterOptions> filtered(keys.data(), keys.data() + keys.size());
+    // The filter is about 10 bits per key on top of the same tables
+    EXPECT_GE(filtered.memory_usage(), plain.memory_usage() + keys.size() * 10 / 8);
+}
+
+TEST(FindAcceleratorTest, FilterRejectsAbsentKeysOnly) {
+    const auto keys = make_gapped_keys(20000, 2);
+    Index<FilterOptions> index(keys.data(), keys.data() + keys.size());
+    expect_matches_plain(index, keys);
+
+    // Every build, parallel build and runtime-sized index rebuilds the filter over its keys
+    const auto other = make_gapped_keys(5000, 3);
+    index.build(other.data(), other.data() + other.size());
+    expect_matches_plain(index, other);
+    index.build_parallel(keys.data(), keys.data() + keys.size());
+    expect_matches_plain(index, keys);
+    index.build_error_bounded(other.data(), other.data() + other.size(), 8);
+    expect_matches_plain(index, other);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::DYNAMIC, std::less<>, jazzy::identity, FilterOptions> dynamic(
+        jazzy::SegmentSizing{});
+    dynamic.build(keys.data(), keys.data() + keys.size());
+    expect_matches_plain(dynamic, keys);
+
+    // Empty and single-key indexes
+    Index<FilterOptions> empty;
+    EXPECT_EQ(empty.find(5), nullptr);
+    const std::vector<std::uint64_t> one{42};
+    Index<FilterOptions> single(one.data(), one.data() + 1);
+    EXPECT_EQ(single.find(42), one.data());
+    EXPECT_EQ(single.find(41), one.data() + 1);
+}
+
+TEST(FindAcceleratorTest, FilterWithDoublesAndRecords) {
+    std::vector<double> doubles{-3.5, -1.0, -0.0, 0.0, 0.25, 1.5, 1e10};
+    jazzy::JazzyIndex<double, jazzy::SegmentCount::PICO, std::less<>, jazzy::identity, FilterOptions> index(
+        doubles.data(), doubles.data() + doubles.size());
+    for (const double d : doubles) {
+        const auto* found = index.find(d);
+        ASSERT_NE(found, doubles.data() + doubles.size());
+        EXPECT_EQ(*found, d);
+    }
+    EXPECT_NE(index.find(0.0), doubles.data() + doubles.size());  // Equal to -0.0 and 0.0
+    EXPECT_EQ(index.find(0.5), doubles.data() + doubles.size());
+
+    struct Record {
+        std::uint32_t id;
+        double payload;
+    };
+    struct ById {
+        std::uint32_t operator()(const Record& r) const { return r.id; }
+    };
+    struct ByIdLess {
+        bool operator()(const Record& a, const Record& b) const { return a.id < b.id; }
+    };
+    std::vector<Record> records;
+    for (std::uint32_t i = 0; i < 5000; ++i) {
+        records.push_back({i * 3, static_cast<double>(i)});
+    }
+    jazzy::JazzyIndex<Record, jazzy::SegmentCount::SMALL, ByIdLess, ById, FilterOptions> by_id(
+        records.data(), records.data() + records.size());
+    for (std::uint32_t id = 0; id < 15000; ++id) {
+        const auto* found = by_id.find(Record{id, -1.0});
+        if (id % 3 == 0) {
+            ASSERT_NE(found, records.data() + records.size());
+            EXPECT_EQ(found->payload, static_cast<double>(id / 3));
+        } else {
+            ASSERT_EQ(found, records.data() + records.size());
+        }
+    }
+}
+
+TEST(FindAcceleratorTest, CacheServesRepeatedKeysAndIsClearedByBuilds) {
+    const auto keys = make_gapped_keys(20000, 4);
+    Index<CacheOptions> index(keys.data(), keys.data() + keys.size());
+    for (int round = 0; round < 3; ++round) {
+        expect_matches_plain(index, keys);  // Later rounds are served from the cache where slots hold
+    }
+
+    // A rebuild over other keys never returns positions cached for the old ones
+    auto shifted = keys;
+    for (auto& k : shifted) {
+        k += 3;
+    }
+    shifted.resize(1000);
+    index.build(shifted.data(), shifted.data() + shifted.size());
+    expect_matches_plain(index, shifted);
+
+    // Copies start with an empty cache and answer the same
+    Index<CacheOptions> copy = index;
+    expect_matches_plain(copy, shifted);
+    copy = Index<CacheOptions>(keys.data(), keys.data() + keys.size());
+    expect_matches_plain(copy, keys);
+}
+
+TEST(FindAcceleratorTest, FilterAndCacheTogetherAcrossThreads) {
+    const auto keys = make_gapped_keys(50000, 5);
+    Index<BothOptions, jazzy::SegmentCount::XLARGE> index(keys.data(), keys.data() + keys.size());
+    expect_matches_plain(index, keys);
+
+    // Threads hammering a few hot keys (and absent neighbours) through the shared cache
+    std::vector<std::thread> threads;
+    std::vector<int> failures(4, 0);
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937_64 rng(static_cast<std::uint64_t>(t));
+            const auto* end = keys.data() + keys.size();
+            for (int i = 0; i < 20000; ++i) {
+                const std::uint64_t key = keys[(rng() % 64) * 700];
+                const auto* found = index.find(key);
+                failures[static_cast<std::size_t>(t)] += (found == end || *found != key) ? 1 : 0;
+                const bool present = std::binary_search(keys.begin(), keys.end(), key + 1);
+                failures[static_cast<std::size_t>(t)] += (index.find(key + 1) != end) != present ? 1 : 0;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const int f : failures) {
+        EXPECT_EQ(f, 0);
+    }
+}
@@ -0,0 +1,205 @@
+// Tests for find_sorted_batch() (merge-style batched find) and parallel::find_many() (chunked
+// batched find across an executor, with optional radix partitioning)
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_executor.hpp"
+#include "jazzy_index_parallel.hpp"
+#include "test_data.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using jazzy::test::make_keys;
+
+// Probes around the keys: hits, misses between keys and misses below and above them
+std::vector<std::uint64_t> make_probes(const std::vector<std::uint64_t>& keys, std::size_t count, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::uint64_t> probes(count);
+    for (auto& p : probes) {
+        const std::uint64_t key = keys[rng() % keys.size()];
+        switch (rng() % 4) {
+            case 0: p = key + 1; break;
+            case 1: p = rng() % 2 == 0 ? rng() % 100 : keys.back() + 1 + rng() % 100; break;
+            default: p = key; break;
+        }
+    }
+    return probes;
+}
+
+// Each result is find()'s: end for absent keys, an element equal to the key otherwise
+template <typename Index>
+void expect_finds(const Index& index, const std::vector<std::uint64_t>& keys,
+                  const std::vector<std::uint64_t>& probes, const std::vector<const std::uint64_t*>& out) {
+    const auto* end = keys.data() + keys.size();
+    for (std::size_t i = 0; i < probes.size(); ++i) {
+        if (std::binary_search(keys.begin(), keys.end(), probes[i])) {
+            ASSERT_NE(out[i], end) << "probe " << i;
+            ASSERT_EQ(*out[i], probes[i]) << "probe " << i;
+        } else {
+            ASSERT_EQ(out[i], end) << "probe " << i;
+        }
+        ASSERT_EQ(out[i] == end, index.find(probes[i]) == end);
+    }
+}
+
+}  // namespace
+
+TEST(FindSortedBatchTest, MatchesFindInAnyOrder) {
+    const auto keys = make_keys(50000, 1);
+    auto probes = make_probes(keys, 20000, 2);
+    std::vector<const std::uint64_t*> out(probes.size());
+
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index(keys.data(), keys.data() + keys.size());
+    index.find_sorted_batch(probes, out);  // Unsorted probes are routed afresh
+    expect_finds(index, keys, probes, out);
+
+    std::sort(probes.begin(), probes.end());
+    index.find_sorted_batch(probes, out);
+    expect_finds(index, keys, probes, out);
+
+    // Uniform keys take the computed segment
+    std::vector<std::uint64_t> uniform(40000);
+    for (std::size_t i = 0; i < uniform.size(); ++i) {
+        uniform[i] = i * 3;
+    }
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> flat(uniform.data(),
+                                                                             uniform.data() + uniform.size());
+    auto flat_probes = make_probes(uniform, 5000, 3);
+    std::sort(flat_probes.begin(), flat_probes.end());
+    flat.find_sorted_batch(flat_probes, out);
+    expect_finds(flat, uniform, flat_probes, out);
+}
+
+TEST(FindSortedBatchTest, EmptyInputsAndShortOutput) {
+    const jazzy::JazzyIndex<std::uint64_t> empty;
+    const std::vector<std::uint64_t> probes{1, 2, 3};
+    std::vector<const std::uint64_t*> out(3, nullptr);
+    empty.find_sorted_batch(probes, out);
+    for (const auto* result : out) {
+        EXPECT_EQ(result, nullptr);  // end() of an unbuilt index
+    }
+    empty.find_sorted_batch({}, {});
+
+    const auto keys = make_keys(1000, 4);
+    const jazzy::JazzyIndex<std::uint64_t> index(keys.data(), keys.data() + keys.size());
+    std::vector<const std::uint64_t*> short_out(2);
+    EXPECT_THROW(index.find_sorted_batch(probes, short_out), std::invalid_argument);
+}
+
+TEST(FindManyTest, MatchesFindOnEveryExecutor) {
+    const auto keys = make_keys(200000, 5);
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::XLARGE> index(keys.data(), keys.data() + keys.size());
+    auto probes = make_probes(keys, 100000, 6);
+    std::vector<const std::uint64_t*> out(probes.size());
+
+    jazzy::parallel::InlineExecutor inline_executor;
+    jazzy::parallel::ThreadPool pool(4);
+    for (const bool partition : {false, true}) {
+        const jazzy::parallel::FindManyOptions options{.chunk_size = 3000, .partition = partition};
+        jazzy::parallel::find_many(index, probes, out, inline_executor, options);
+        expect_finds(index, keys, probes, out);
+        std::fill(out.begin(), out.end(), nullptr);
+        jazzy::parallel::find_many(index, probes, out, pool, options);
+        expect_finds(index, keys, probes, out);
+        std::fill(out.begin(), out.end(), nullptr);
+        jazzy::parallel::find_many(index, probes, out, options);  // Default thread pool
+        expect_finds(index, keys, probes, out);
+    }
+
+    // Sorted probes, and chunks that are partly sorted
+    auto sorted = probes;
+    std::sort(sorted.begin(), sorted.end());
+    jazzy::parallel::find_many(index, sorted, out, pool);
+    expect_finds(index, keys, sorted, out);
+    std::sort(probes.begin(), probes.begin() + 50000);
+    jazzy::parallel::find_many(index, probes, out, pool, {.chunk_size = 7000, .partition = true});
+    expect_finds(index, keys, probes, out);
+}
+
+TEST(FindManyTest, EdgeCases) {
+    jazzy::parallel::ThreadPool pool(3);
+    const std::vector<std::uint64_t> probes{0, 5, 7, 9, 1000};
+    std::vector<const std::uint64_t*> out(probes.size());
+
+    // Empty index, single key, all keys equal
+    const jazzy::JazzyIndex<std::uint64_t> empty;
+    jazzy::parallel::find_many(empty, probes, out, pool, {.chunk_size = 2, .partition = true});
+    EXPECT_TRUE(std::all_of(out.begin(), out.end(), [](const auto* r) { return r == nullptr; }));
+
+    const std::vector<std::uint64_t> one{7};
+    const jazzy::JazzyIndex<std::uint64_t> single(one.data(), one.data() + 1);
+    jazzy::parallel::find_many(single, probes, out, pool, {.chunk_size = 2, .partition = true});
+    expect_finds(single, one, probes, out);
+
+    const std::vector<std::uint64_t> same(500, 9);
+    const jazzy::JazzyIndex<std::uint64_t> flat(same.data(), same.data() + same.size());
+    jazzy::parallel::find_many(flat, probes, out, pool, {.chunk_size = 1, .partition = true});
+    expect_finds(flat, same, probes, out);
+
+    // No probes, a zero chunk size, and an output span that is too short
+    jazzy::parallel::find_many(single, {}, {}, pool);
+    jazzy::parallel::find_many(single, probes, out, pool, {.chunk_size = 0});
+    expect_finds(single, one, probes, out);
+    std::vector<const std::uint64_t*> short_out(probes.size() - 1);
+    EXPECT_THROW(jazzy::parallel::find_many(single, probes, short_out, pool), std::invalid_argument);
+}
+
+TEST(FindManyTest, DoublesDescendingAndDynamicIndexes) {
+    // Doubles with NaN-free infinities among the probes
+    std::vector<double> doubles(20000);
+    for (std::size_t i = 0; i < doubles.size(); ++i) {
+        doubles[i] = -500.0 + static_cast<double>(i) * 0.25;
+    }
+    const jazzy::JazzyIndex<double, jazzy::SegmentCount::MEDIUM> by_value(doubles.data(),
+                                                                          doubles.data() + doubles.size());
+    std::vector<double> probes{1e300, -1e300, 0.125, 3.0, -500.0, 4499.75, 4500.0};
+    for (std::size_t i = 0; i < 1000; ++i) {
+        probes.push_back(doubles[(i * 7919) % doubles.size()]);
+    }
+    std::vector<const double*> out(probes.size());
+    jazzy::parallel::ThreadPool pool(2);
+    jazzy::parallel::find_many(by_value, probes, out, pool, {.chunk_size = 100, .partition = true});
+    for (std::size_t i = 0; i < probes.size(); ++i) {
+        EXPECT_EQ(out[i], by_value.find(probes[i])) << "probe " << i;
+    }
+
+    // Descending keys under std::greater: sortedness follows the index's comparator
+    std::vector<std::uint64_t> descending = make_keys(30000, 7);
+    std::reverse(descending.begin(), descending.end());
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::greater<>> reversed(
+        descending.data(), descending.data() + descending.size());
+    auto down_probes = make_probes(descending, 8000, 8);
+    std::vector<const std::uint64_t*> down_out(down_probes.size());
+    jazzy::parallel::find_many(reversed, down_probes, down_out, pool, {.chunk_size = 1000, .partition = true});
+    for (std::size_t i = 0; i < down_probes.size(); ++i) {
+        ASSERT_EQ(down_out[i], reversed.find(down_probes[i])) << "probe " << i;
+    }
+    std::sort(down_probes.begin(), down_probes.end(), std::greater<>{});
+    jazzy::parallel::find_many(reversed, down_probes, down_out, pool, {.chunk_size = 1000});
+    for (std::size_t i = 0; i < down_probes.size(); ++i) {
+        ASSERT_EQ(down_out[i], reversed.find(down_probes[i])) << "probe " << i;
+    }
+
+    // Runtime-sized index with the compressed layout
+    const auto keys = make_keys(60000, 9);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::DYNAMIC, std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Compressed>>
+        dynamic(jazzy::SegmentSizing{});
+    dynamic.build(keys.data(), keys.data() + keys.size());
+    auto key_probes = make_probes(keys, 30000, 10);
+    std::vector<const std::uint64_t*> key_out(key_probes.size());
+    jazzy::parallel::find_many(dynamic, key_probes, key_out, pool, {.chunk_size = 4096, .partition = true});
+    expect_finds(dynamic, keys, key_probes, key_out);
+    std::sort(key_probes.begin(), key_probes.end());
+    jazzy::parallel::find_many(dynamic, key_probes, key_out, pool);
+    expect_finds(dynamic, keys, key_probes, key_out);
+}
@@ -0,0 +1,153 @@
+// Tests for index_stats() (memory, model mix, error spread, routing and build timings) and
+// export_index_stats()
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_export.hpp"
+#include "jazzy_index_parallel.hpp"
+#include "jazzy_index_serialize.hpp"
+#include "test_data.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using jazzy::test::count_models;
+using jazzy::test::make_cubic_keys;
+
+// index_stats() agrees with the per-segment metadata and the index's own accessors
+template <typename Index>
+void expect_consistent(const Index& index) {
+    const jazzy::IndexStats stats = index.index_stats();
+    const std::string json = jazzy::export_index_metadata(index);
+    EXPECT_EQ(stats.num_keys, index.size());
+    EXPECT_EQ(stats.num_segments, index.num_segments());
+    EXPECT_EQ(stats.memory_bytes, index.memory_usage());
+    EXPECT_EQ(static_cast<int>(stats.constant_segments), count_models(json, "CONSTANT"));
+    EXPECT_EQ(static_cast<int>(stats.linear_segments), count_models(json, "LINEAR"));
+    EXPECT_EQ(static_cast<int>(stats.quadratic_segments), count_models(json, "QUADRATIC"));
+    EXPECT_EQ(static_cast<int>(stats.cubic_segments), count_models(json, "CUBIC"));
+    EXPECT_EQ(stats.max_error, index.max_segment_error());
+    EXPECT_LE(stats.mean_error, static_cast<double>(stats.max_error));
+    EXPECT_EQ(std::accumulate(stats.error_histogram.begin(), stats.error_histogram.end(), std::uint64_t{0}),
+              stats.num_segments);
+    EXPECT_EQ(stats.query_path, index.query_path());
+}
+
+}  // namespace
+
+TEST(IndexStatsTest, EmptyAndSingleKey) {
+    const jazzy::JazzyIndex<std::uint64_t> empty;
+    const jazzy::IndexStats none = empty.index_stats();
+    EXPECT_EQ(none.num_keys, 0u);
+    EXPECT_EQ(none.num_segments, 0u);
+    EXPECT_EQ(none.memory_bytes, empty.memory_usage());
+    EXPECT_EQ(none.expected_probes, 0.0);
+    EXPECT_EQ(none.build.total_ns(), 0u);
+
+    const std::vector<std::uint64_t> one{7};
+    const jazzy::JazzyIndex<std::uint64_t> single(one.data(), one.data() + 1);
+    const jazzy::IndexStats stats = single.index_stats();
+    EXPECT_EQ(stats.num_keys, 1u);
+    EXPECT_EQ(stats.constant_segments, 1u);
+    EXPECT_EQ(stats.max_error, 0u);
+    EXPECT_EQ(stats.error_histogram[0], 1u);
+}
+
+TEST(IndexStatsTest, SummarizesSegments) {
+    std::vector<std::uint64_t> uniform(100000);
+    std::iota(uniform.begin(), uniform.end(), std::uint64_t{0});
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> flat(uniform.data(),
+                                                                             uniform.data() + uniform.size());
+    expect_consistent(flat);
+    const jazzy::IndexStats flat_stats = flat.index_stats();
+    EXPECT_TRUE(flat_stats.uniform);
+    EXPECT_EQ(flat_stats.linear_segments, flat_stats.num_segments);
+    EXPECT_EQ(flat_stats.query_path, jazzy::QueryPath::LINEAR_UNIFORM);
+    EXPECT_GE(flat_stats.expected_probes, 1.0);
+
+    // Curved keys: looser models search wider windows, so a lookup expects more probes
+    const auto keys = make_cubic_keys(100000);
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> curved(keys.data(), keys.data() + keys.size());
+    expect_consistent(curved);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> lines;
+    lines.set_build_config(jazzy::BuildConfig::linear_only());
+    lines.build(keys.data(), keys.data() + keys.size());
+    expect_consistent(lines);
+
+    const jazzy::IndexStats curved_stats = curved.index_stats();
+    const jazzy::IndexStats line_stats = lines.index_stats();
+    EXPECT_FALSE(curved_stats.uniform);
+    EXPECT_GT(curved_stats.quadratic_segments + curved_stats.cubic_segments, 0u);
+    EXPECT_EQ(line_stats.linear_segments + line_stats.constant_segments, line_stats.num_segments);
+    EXPECT_GT(line_stats.mean_error, curved_stats.mean_error);
+    EXPECT_GT(line_stats.expected_probes, curved_stats.expected_probes);
+}
+
+TEST(IndexStatsTest, TimesEveryBuildPath) {
+    const auto keys = make_cubic_keys(200000);
+    const auto* first = keys.data();
+    const auto* last = keys.data() + keys.size();
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index;
+
+    // Equal-count builds place boundaries arithmetically, so only the fit and tables are timed
+    index.build(first, last);
+    jazzy::BuildTimings timings = index.index_stats().build;
+    EXPECT_EQ(timings.partition_ns, 0u);
+    EXPECT_GT(timings.analyze_ns, 0u);
+    EXPECT_GT(timings.finalize_ns, 0u);
+    EXPECT_EQ(timings.total_ns(), timings.partition_ns + timings.analyze_ns + timings.finalize_ns);
+
+    index.build_error_bounded(first, last, 16);
+    timings = index.index_stats().build;
+    EXPECT_GT(timings.partition_ns, 0u);
+    EXPECT_GT(timings.analyze_ns, 0u);
+    expect_consistent(index);
+
+    index.build_parallel(first, last);
+    timings = index.index_stats().build;
+    EXPECT_GT(timings.partition_ns, 0u);
+    EXPECT_GT(timings.analyze_ns, 0u);
+    EXPECT_GT(timings.finalize_ns, 0u);
+    expect_consistent(index);
+
+    std::vector<std::uint64_t> sample(keys.end() - 1000, keys.end());
+    index.rebuild_for_workload(sample);
+    timings = index.index_stats().build;
+    EXPECT_GT(timings.partition_ns, 0u);
+    expect_consistent(index);
+
+    // A load rebuilds only the tables
+    std::stringstream file;
+    index.save(file, jazzy::KeyData::EXTERNAL);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> loaded;
+    loaded.build(first, last);
+    loaded.load(file, first, last);
+    timings = loaded.index_stats().build;
+    EXPECT_EQ(timings.partition_ns, 0u);
+    EXPECT_EQ(timings.analyze_ns, 0u);
+    EXPECT_GT(timings.finalize_ns, 0u);
+    expect_consistent(loaded);
+}
+
+TEST(IndexStatsTest, ExportsCompactJson) {
+    const auto keys = make_cubic_keys(5000);
+    const jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL> index(keys.data(), keys.data() + keys.size());
+    const jazzy::IndexStats stats = index.index_stats();
+    const std::string json = jazzy::export_index_stats(index);
+
+    EXPECT_NE(json.find("\"num_keys\": 5000"), std::string::npos);
+    EXPECT_NE(json.find("\"memory_bytes\": " + std::to_string(stats.memory_bytes)), std::string::npos);
+    EXPECT_NE(json.find("\"LINEAR\": " + std::to_string(stats.linear_segments)), std::string::npos);
+    EXPECT_NE(json.find("\"max_error\": " + std::to_string(stats.max_error)), std::string::npos);
+    EXPECT_NE(json.find("\"query_path\": \"GENERAL\""), std::string::npos);
+    EXPECT_NE(json.find("\"build_ns\""), std::string::npos);
+    EXPECT_EQ(json.find("\"keys\""), std::string::npos);  // Unlike export_index_metadata
+    EXPECT_LT(json.size(), 1024u);
+}
@@ -0,0 +1,153 @@
+// Tests for the shared last-mile search (detail::last_mile_search, detail::windowed_search and
+// simd::count_before): every window size and key type must agree with std::lower_bound/upper_bound
+
+#include "jazzy_index.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// Sorted keys with runs of duplicates (starting below zero for signed K)
+template <typename K>
+std::vector<K> make_keys(std::size_t n, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<K> keys;
+    K value = std::is_signed_v<K> ? static_cast<K>(-500) : K{0};
+    for (std::size_t i = 0; i < n; ++i) {
+        if (rng() % 4 != 0) {
+            value = static_cast<K>(value + static_cast<K>(1 + rng() % 5));
+        }
+        keys.push_back(value);
+    }
+    return keys;
+}
+
+// Every window [first, last) of every size up to limit, against every probe around its keys
+template <typename K, typename Compare = std::less<>>
+void expect_matches_std(const std::vector<K>& keys, std::size_t limit, Compare comp = Compare{}) {
+    const K* data = keys.data();
+    for (std::size_t len = 0; len <= limit && len <= keys.size(); ++len) {
+        const std::size_t first = (keys.size() - len) / 2;
+        const K* lo = data + first;
+        const K* hi = lo + len;
+        std::vector<K> probes{std::numeric_limits<K>::lowest(), std::numeric_limits<K>::max()};
+        for (const K* p = lo; p != hi; ++p) {
+            probes.push_back(*p);
+            probes.push_back(static_cast<K>(*p - 1));
+            probes.push_back(static_cast<K>(*p + 1));
+        }
+        for (const K probe : probes) {
+            ASSERT_EQ(jazzy::detail::last_mile_search<false>(lo, hi, probe, comp), std::lower_bound(lo, hi, probe, comp))
+                << "len " << len;
+            ASSERT_EQ(jazzy::detail::last_mile_search<true>(lo, hi, probe, comp), std::upper_bound(lo, hi, probe, comp))
+                << "len " << len;
+        }
+    }
+}
+
+}  // namespace
+
+TEST(LastMileSearchTest, CountBeforeMatchesScalarForEveryTail) {
+    const std::vector<std::uint64_t> keys{0, 1, 1, 5, 9, 9, 9, 12, 40, 41, std::numeric_limits<std::uint64_t>::max()};
+    for (std::size_t n = 0; n <= keys.size(); ++n) {
+        for (const std::uint64_t probe : {std::uint64_t{0}, std::uint64_t{1}, std::uint64_t{9}, std::uint64_t{10},
+                                          std::numeric_limits<std::uint64_t>::max()}) {
+            const auto below = static_cast<std::size_t>(std::count_if(keys.begin(), keys.begin() + n,
+                                                                      [&](std::uint64_t k) { return k < probe; }));
+            const auto not_above = static_cast<std::size_t>(std::count_if(keys.begin(), keys.begin() + n,
+                                                                          [&](std::uint64_t k) { return !(probe < k); }));
+            EXPECT_EQ(jazzy::detail::simd::count_before<false>(keys.data(), n, probe), below);
+            EXPECT_EQ(jazzy::detail::simd::count_before<true>(keys.data(), n, probe), not_above);
+        }
+    }
+}
+
+TEST(LastMileSearchTest, UnsignedKeysAboveTheSignBit) {
+    // Vector units without unsigned 64-bit compares must still order these correctly
+    std::vector<std::uint64_t> keys;
+    for (std::uint64_t i = 0; i < 64; ++i) {
+        keys.push_back(i < 32 ? i : std::numeric_limits<std::uint64_t>::max() - 64 + i);
+    }
+    expect_matches_std(keys, 64);
+}
+
+TEST(LastMileSearchTest, MatchesStdForArithmeticKeys) {
+    expect_matches_std(make_keys<std::uint64_t>(300, 1), 200);
+    expect_matches_std(make_keys<std::int64_t>(300, 2), 200);
+    expect_matches_std(make_keys<std::int32_t>(300, 3), 200);
+    expect_matches_std(make_keys<double>(300, 4), 200);
+    expect_matches_std(make_keys<float>(300, 5), 200);
+}
+
+TEST(LastMileSearchTest, MatchesStdForCustomComparators) {
+    std::vector<std::uint64_t> keys = make_keys<std::uint64_t>(200, 6);
+    std::reverse(keys.begin(), keys.end());
+    expect_matches_std(keys, 120, std::greater<>{});
+
+    std::vector<std::string> words;
+    for (int i = 0; i < 100; ++i) {
+        words.push_back(std::to_string(1000 + i / 3));
+    }
+    for (std::size_t len = 0; len <= words.size(); ++len) {
+        const std::string* lo = words.data();
+        const std::string* hi = lo + len;
+        for (const std::string probe : {"0", "1010", "1020", "1033", "2"}) {
+            ASSERT_EQ(jazzy::detail::last_mile_search<false>(lo, hi, probe, std::less<>{}),
+                      std::lower_bound(lo, hi, probe));
+            ASSERT_EQ(jazzy::detail::last_mile_search<true>(lo, hi, probe, std::less<>{}),
+                      std::upper_bound(lo, hi, probe));
+        }
+    }
+}
+
+TEST(LastMileSearchTest, WindowedSearchLeavesTheWindowWhenTheAnswerIsOutside) {
+    // A long run of 7s around the window: the bounds lie far to either side of it
+    std::vector<std::uint64_t> keys(1000, 7);
+    for (std::size_t i = 0; i < 100; ++i) {
+        keys[i] = i * 7 / 100;
+        keys[keys.size() - 1 - i] = 1000 - i;
+    }
+    const std::uint64_t* begin = keys.data();
+    const std::uint64_t* end = begin + keys.size();
+    const std::uint64_t* lo = begin + 500;
+    const std::uint64_t* hi = begin + 510;
+    const std::less<> comp;
+    for (const std::uint64_t probe : {0u, 3u, 6u, 7u, 8u, 950u, 1000u, 1001u}) {
+        EXPECT_EQ(jazzy::detail::windowed_search<false>(begin, end, lo, hi, probe, comp),
+                  std::lower_bound(begin, end, probe)) << "probe " << probe;
+        EXPECT_EQ(jazzy::detail::windowed_search<true>(begin, end, lo, hi, probe, comp),
+                  std::upper_bound(begin, end, probe)) << "probe " << probe;
+    }
+}
+
+TEST(LastMileSearchTest, DuplicateRunsSpanningSegments) {
+    // Runs of 50 equal keys cross segment boundaries; the bounds come from outside the window
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t i = 0; i < 4000; ++i) {
+        data.push_back(i / 50);
+    }
+    const std::uint64_t* begin = data.data();
+    const std::uint64_t* end = begin + data.size();
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL> index;
+    index.build(begin, end);
+    for (std::uint64_t key = 0; key < 80; ++key) {
+        const std::uint64_t* found = index.find(key);
+        ASSERT_NE(found, end);
+        EXPECT_EQ(*found, key);
+        const std::uint64_t* lower = index.find_lower_bound(key);
+        EXPECT_EQ(lower, std::lower_bound(begin, end, key));
+        EXPECT_EQ(index.find_upper_bound(key), lower + 50);
+    }
+    EXPECT_EQ(index.find(80), end);
+    EXPECT_EQ(index.find_lower_bound(80), end);
+}
@@ -0,0 +1,170 @@
+// Tests for segment storage layouts (layout::Interleaved vs layout::Split)
+// The split layout must answer every query exactly like the default interleaved layout
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_export.hpp"
+#include "jazzy_index_parallel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+using SplitOptions = jazzy::IndexOptions<jazzy::layout::Split>;
+
+template <jazzy::SegmentCount Segments>
+using SplitIndex = jazzy::JazzyIndex<std::uint64_t, Segments, std::less<>, jazzy::identity, SplitOptions>;
+
+template <jazzy::SegmentCount Segments>
+using InterleavedIndex = jazzy::JazzyIndex<std::uint64_t, Segments>;
+
+std::vector<std::uint64_t> make_queries(const std::vector<std::uint64_t>& data, std::size_t count) {
+    std::mt19937_64 rng(99);
+    std::uniform_int_distribution<std::size_t> index_dist(0, data.size() - 1);
+    std::vector<std::uint64_t> queries;
+    queries.reserve(count + 2);
+    queries.push_back(0);
+    queries.push_back(data.back() + 10);
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint64_t hit = data[index_dist(rng)];
+        queries.push_back(i % 3 == 0 ? hit + 1 : hit);
+    }
+    return queries;
+}
+
+template <typename Lhs, typename Rhs>
+void expect_same_answers(const Lhs& lhs, const Rhs& rhs, const std::vector<std::uint64_t>& data,
+                         const std::vector<std::uint64_t>& queries) {
+    const std::uint64_t* end = data.data() + data.size();
+    for (const auto q : queries) {
+        // find may return any element of a duplicate run, so compare hit/miss and value
+        const auto* lhs_found = lhs.find(q);
+        const auto* rhs_found = rhs.find(q);
+        EXPECT_EQ(lhs_found != end && *lhs_found == q, rhs_found != end && *rhs_found == q)
+            << "find mismatch for key " << q;
+        EXPECT_EQ(lhs.find_lower_bound(q), rhs.find_lower_bound(q)) << "lower bound mismatch for key " << q;
+        EXPECT_EQ(lhs.find_upper_bound(q), rhs.find_upper_bound(q)) << "upper bound mismatch for key " << q;
+        EXPECT_EQ(lhs.equal_range(q), rhs.equal_range(q)) << "equal_range mismatch for key " << q;
+    }
+
+    std::vector<const std::uint64_t*> batch(queries.size());
+    rhs.find_lower_bound_batch(queries, batch);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(batch[i], lhs.find_lower_bound(queries[i])) << "batch mismatch for key " << queries[i];
+    }
+}
+
+}  // namespace
+
+// Test: Uniform data (O(1) routing verified against the dense key array)
+TEST(LayoutTest, SplitMatchesInterleavedUniform) {
+    std::vector<std::uint64_t> data(20'000);
+    std::iota(data.begin(), data.end(), 1);
+
+    InterleavedIndex<jazzy::SegmentCount::LARGE> interleaved(data.data(), data.data() + data.size());
+    SplitIndex<jazzy::SegmentCount::LARGE> split(data.data(), data.data() + data.size());
+    expect_same_answers(interleaved, split, data, make_queries(data, 2'000));
+}
+
+// Test: Skewed data with every model type and the largest segment count
+TEST(LayoutTest, SplitMatchesInterleavedSkewed) {
+    std::vector<std::uint64_t> data(60'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        const double x = static_cast<double>(i);
+        data[i] = static_cast<std::uint64_t>(std::exp(x / 6'000.0) * 1'000.0 + x * x / 50.0);
+    }
+    std::sort(data.begin(), data.end());
+
+    InterleavedIndex<jazzy::SegmentCount::MAX> interleaved(data.data(), data.data() + data.size());
+    SplitIndex<jazzy::SegmentCount::MAX> split(data.data(), data.data() + data.size());
+    expect_same_answers(interleaved, split, data, make_queries(data, 4'000));
+}
+
+// Test: Duplicate runs spanning segment boundaries
+TEST(LayoutTest, SplitMatchesInterleavedDuplicates) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t v = 0; v < 300; ++v) {
+        data.insert(data.end(), 1 + (v % 11), v * 2);
+    }
+
+    InterleavedIndex<jazzy::SegmentCount::MEDIUM> interleaved(data.data(), data.data() + data.size());
+    SplitIndex<jazzy::SegmentCount::MEDIUM> split(data.data(), data.data() + data.size());
+    expect_same_answers(interleaved, split, data, make_queries(data, 1'000));
+}
+
+// Test: Exported metadata is layout independent
+TEST(LayoutTest, ExportMatchesInterleaved) {
+    std::vector<std::uint64_t> data(5'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<std::uint64_t>(i) * static_cast<std::uint64_t>(i);
+    }
+
+    InterleavedIndex<jazzy::SegmentCount::SMALL> interleaved(data.data(), data.data() + data.size());
+    SplitIndex<jazzy::SegmentCount::SMALL> split(data.data(), data.data() + data.size());
+    EXPECT_EQ(jazzy::export_index_metadata(interleaved), jazzy::export_index_metadata(split));
+}
+
+// Test: Parallel build, single element and empty inputs
+TEST(LayoutTest, SplitParallelAndEdgeCases) {
+    std::vector<std::uint64_t> data(10'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<std::uint64_t>(i) * 3 + (i % 7);
+    }
+    std::sort(data.begin(), data.end());
+
+    InterleavedIndex<jazzy::SegmentCount::LARGE> interleaved(data.data(), data.data() + data.size());
+    SplitIndex<jazzy::SegmentCount::LARGE> split;
+    split.build_parallel(data.data(), data.data() + data.size());
+    expect_same_answers(interleaved, split, data, make_queries(data, 1'000));
+
+    std::vector<std::uint64_t> single{7};
+    SplitIndex<jazzy::SegmentCount::LARGE> single_index(single.data(), single.data() + 1);
+    EXPECT_EQ(single_index.find(7), single.data());
+    EXPECT_EQ(single_index.find(8), single.data() + 1);
+    EXPECT_EQ(single_index.find_lower_bound(6), single.data());
+
+    std::vector<std::uint64_t> empty;
+    SplitIndex<jazzy::SegmentCount::LARGE> empty_index(empty.data(), empty.data());
+    EXPECT_EQ(empty_index.find(1), empty.data());
+}
+
+// Test: Split layout with a key extractor and a descending comparator
+TEST(LayoutTest, SplitWithKeyExtractorAndComparator) {
+    struct Record {
+        std::uint32_t key;
+        float payload;
+    };
+    std::vector<Record> records;
+    for (std::uint32_t i = 0; i < 3'000; ++i) {
+        records.push_back({i * 4, static_cast<float>(i)});
+    }
+    auto key_of = [](const Record& r) { return r.key; };
+    auto by_key = [](const Record& a, const Record& b) { return a.key < b.key; };
+
+    jazzy::JazzyIndex<Record, jazzy::SegmentCount::MEDIUM, decltype(by_key), decltype(key_of), SplitOptions> kv_index(
+        records.data(), records.data() + records.size(), by_key, key_of);
+    for (std::uint32_t k : {0u, 4u, 5u, 11'996u, 12'000u}) {
+        const Record probe{k, 0.0f};
+        const auto* expected = std::lower_bound(records.data(), records.data() + records.size(), probe, by_key);
+        EXPECT_EQ(kv_index.find_lower_bound(probe), expected) << "key " << k;
+    }
+
+    std::vector<int> desc(2'000);
+    std::iota(desc.begin(), desc.end(), 0);
+    std::reverse(desc.begin(), desc.end());
+    jazzy::JazzyIndex<int, jazzy::SegmentCount::SMALL, std::greater<int>> desc_interleaved(
+        desc.data(), desc.data() + desc.size(), std::greater<int>{});
+    jazzy::JazzyIndex<int, jazzy::SegmentCount::SMALL, std::greater<int>, jazzy::identity, SplitOptions> desc_split(
+        desc.data(), desc.data() + desc.size(), std::greater<int>{});
+    for (int k : {1'999, 1'000, 0, -1, 2'000}) {
+        EXPECT_EQ(desc_split.find(k), desc_interleaved.find(k)) << "key " << k;
+        EXPECT_EQ(desc_split.find_upper_bound(k), desc_interleaved.find_upper_bound(k)) << "key " << k;
+    }
+}
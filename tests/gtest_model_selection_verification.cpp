@@ -11,6 +11,7 @@
 #include <numeric>
 #include <regex>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -638,3 +639,74 @@ TEST(ModelSelectionVerification, RobustnessWithVariousPatterns) {
         }
     }
 }
+
+// Test: analyze_segment reports the true worst error of the model it picks, whichever stage it
+// stops in: the LINEAR early exit, LINEAR after the polynomial fits lose, or a CUBIC measured on
+// its own (short segments) or fused with the quadratic pass (at least FUSED_CUBIC_MIN_KEYS keys)
+TEST(ModelSelectionVerification, AnalysisErrorMatchesFullScan) {
+    using jazzy::detail::ModelType;
+
+    // Keys placed so that the index is (t + c*t^3) / (1 + c) of the normalized key t
+    auto cubic_positions = [](std::size_t n, double c) {
+        std::vector<double> data(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const double target = static_cast<double>(i) / static_cast<double>(n - 1);
+            double lo = 0.0, hi = 1.0;
+            for (int iter = 0; iter < 60; ++iter) {
+                const double mid = (lo + hi) / 2.0;
+                ((mid + c * mid * mid * mid) / (1.0 + c) < target ? lo : hi) = mid;
+            }
+            data[i] = lo * 1e6;
+        }
+        return data;
+    };
+
+    for (const std::size_t n : {std::size_t{600}, std::size_t{2000}}) {
+        ASSERT_NE(n < jazzy::detail::FUSED_CUBIC_MIN_KEYS, n == 2000);
+
+        std::vector<double> linear(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            linear[i] = 5.0 * static_cast<double>(i);
+        }
+        std::vector<double> exponential(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            exponential[i] = std::exp(12.0 * static_cast<double>(i) / static_cast<double>(n));
+        }
+
+        const std::pair<std::vector<double>, ModelType> cases[] = {
+            {linear, ModelType::LINEAR},
+            {exponential, ModelType::LINEAR},  // Polynomial fits don't beat linear
+            {cubic_positions(n, 0.5), ModelType::CUBIC},
+        };
+
+        for (const auto& [data, expected_model] : cases) {
+            const auto analysis = jazzy::detail::analyze_segment<double>(data.data(), 0, data.size());
+            EXPECT_EQ(analysis.best_model, expected_model) << "n=" << n;
+
+            double worst = 0.0;
+            for (std::size_t i = 0; i < data.size(); ++i) {
+                const double x = data[i];
+                double pred = 0.0;
+                switch (analysis.best_model) {
+                    case ModelType::LINEAR:
+                        pred = analysis.linear_a * x + analysis.linear_b;
+                        break;
+                    case ModelType::QUADRATIC:
+                        pred = (analysis.quad_a * x + analysis.quad_b) * x + analysis.quad_c;
+                        break;
+                    case ModelType::CUBIC:
+                        pred = ((analysis.cubic_a * x + analysis.cubic_b) * x + analysis.cubic_c) * x +
+                               analysis.cubic_d;
+                        break;
+                    case ModelType::CONSTANT:
+                        break;
+                }
+                worst = std::max(worst, std::abs(pred - static_cast<double>(i)));
+            }
+
+            // Coefficients are reported in key space, the errors were measured in normalized space
+            EXPECT_NEAR(static_cast<double>(analysis.max_error), std::ceil(worst), 1.0) << "n=" << n;
+            EXPECT_LE(analysis.mean_error, static_cast<double>(analysis.max_error)) << "n=" << n;
+        }
+    }
+}
@@ -0,0 +1,262 @@
+// Tests for MutableJazzyIndex (jazzy_index_mutable.hpp): inserts, deletes and appends checked
+// against std::multiset, per-segment refits and splits, and the UpdatePolicy limits
+
+#include "jazzy_index_mutable.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using Index = jazzy::MutableJazzyIndex<std::uint64_t>;
+
+std::vector<std::uint64_t> contents(const Index& index) {
+    std::vector<std::uint64_t> out;
+    index.for_each([&](std::uint64_t key) { out.push_back(key); });
+    return out;
+}
+
+// Every lookup agrees with the reference multiset for keys in and around its range
+void expect_matches(const Index& index, const std::multiset<std::uint64_t>& reference, std::uint64_t max_probe) {
+    ASSERT_EQ(index.size(), reference.size());
+    EXPECT_EQ(contents(index), std::vector<std::uint64_t>(reference.begin(), reference.end()));
+    for (std::uint64_t probe = 0; probe <= max_probe; ++probe) {
+        const bool present = reference.count(probe) > 0;
+        const std::uint64_t* found = index.find(probe);
+        ASSERT_EQ(found != nullptr, present) << "probe " << probe;
+        if (found != nullptr) {
+            EXPECT_EQ(*found, probe);
+        }
+
+        const auto lower = reference.lower_bound(probe);
+        const std::uint64_t* lb = index.find_lower_bound(probe);
+        ASSERT_EQ(lb == nullptr, lower == reference.end()) << "probe " << probe;
+        if (lb != nullptr) {
+            EXPECT_EQ(*lb, *lower) << "probe " << probe;
+        }
+
+        const auto upper = reference.upper_bound(probe);
+        const std::uint64_t* ub = index.find_upper_bound(probe);
+        ASSERT_EQ(ub == nullptr, upper == reference.end()) << "probe " << probe;
+        if (ub != nullptr) {
+            EXPECT_EQ(*ub, *upper) << "probe " << probe;
+        }
+    }
+}
+
+}  // namespace
+
+TEST(MutableJazzyIndexTest, BuildMatchesSortedInput) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t i = 0; i < 5000; ++i) {
+        data.push_back(i * 3);
+    }
+    Index index(jazzy::UpdatePolicy{.keys_per_segment = 256});
+    index.build(data.data(), data.data() + data.size());
+
+    EXPECT_EQ(index.num_segments(), 5000u / 256u);
+    expect_matches(index, std::multiset<std::uint64_t>(data.begin(), data.end()), 15010);
+}
+
+TEST(MutableJazzyIndexTest, RejectsUnsortedInputAndBadPolicy) {
+    const std::vector<std::uint64_t> data{3, 1, 2};
+    Index index;
+    EXPECT_THROW(index.build(data.data(), data.data() + data.size()), std::runtime_error);
+    EXPECT_THROW(Index(jazzy::UpdatePolicy{.keys_per_segment = 0}), std::invalid_argument);
+    EXPECT_THROW(Index(jazzy::UpdatePolicy{.max_buffered = 0}), std::invalid_argument);
+}
+
+TEST(MutableJazzyIndexTest, EmptyIndexGrowsFromInserts) {
+    Index index(jazzy::UpdatePolicy{.keys_per_segment = 16, .max_buffered = 4});
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.find(1), nullptr);
+    EXPECT_EQ(index.find_lower_bound(1), nullptr);
+    EXPECT_FALSE(index.erase(1));
+
+    std::multiset<std::uint64_t> reference;
+    std::mt19937_64 rng(7);
+    for (int i = 0; i < 500; ++i) {
+        const std::uint64_t key = rng() % 1000;
+        index.insert(key);
+        reference.insert(key);
+    }
+    EXPECT_GT(index.num_segments(), 1u);
+    expect_matches(index, reference, 1001);
+}
+
+TEST(MutableJazzyIndexTest, RandomInsertsAndErasesMatchMultiset) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t i = 0; i < 4000; ++i) {
+        data.push_back(i * 5);
+    }
+    Index index(jazzy::UpdatePolicy{.keys_per_segment = 128, .max_buffered = 8, .max_drift = 8});
+    index.build(data.data(), data.data() + data.size());
+    std::multiset<std::uint64_t> reference(data.begin(), data.end());
+
+    std::mt19937_64 rng(42);
+    for (int step = 0; step < 20000; ++step) {
+        const std::uint64_t key = rng() % 22000;
+        if (rng() % 3 == 0) {
+            const auto it = reference.find(key);
+            EXPECT_EQ(index.erase(key), it != reference.end());
+            if (it != reference.end()) {
+                reference.erase(it);
+            }
+        } else {
+            index.insert(key);
+            reference.insert(key);
+        }
+    }
+    expect_matches(index, reference, 22001);
+}
+
+TEST(MutableJazzyIndexTest, DuplicatesAreCountedAndErasedOneAtATime) {
+    Index index(jazzy::UpdatePolicy{.keys_per_segment = 4, .max_buffered = 2});
+    std::multiset<std::uint64_t> reference;
+    for (int i = 0; i < 40; ++i) {
+        index.insert(10);
+        reference.insert(10);
+        index.insert(static_cast<std::uint64_t>(i));
+        reference.insert(static_cast<std::uint64_t>(i));
+    }
+    expect_matches(index, reference, 45);
+
+    // Runs of equivalent keys are never split across segments, so every copy stays reachable
+    for (int i = 0; i < 41; ++i) {
+        EXPECT_TRUE(index.erase(10));
+    }
+    EXPECT_FALSE(index.erase(10));
+    reference.erase(10);
+    expect_matches(index, reference, 45);
+}
+
+TEST(MutableJazzyIndexTest, BufferedInsertsRefitOnlyTheirSegment) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t i = 0; i < 1024; ++i) {
+        data.push_back(i * 100);
+    }
+    Index index(jazzy::UpdatePolicy{.keys_per_segment = 256, .max_buffered = 16});
+    index.build(data.data(), data.data() + data.size());
+    const std::size_t fits = index.fit_count();
+    ASSERT_EQ(index.num_segments(), 4u);
+
+    // The first 16 inserts into segment 0 stay buffered; the 17th merges and refits it alone
+    for (std::uint64_t i = 0; i < 16; ++i) {
+        index.insert(i * 100 + 50);
+    }
+    EXPECT_EQ(index.fit_count(), fits);
+    index.insert(1650);
+    EXPECT_EQ(index.fit_count(), fits + 1);
+    EXPECT_EQ(index.num_segments(), 4u);
+    ASSERT_NE(index.find(1650), nullptr);
+}
+
+TEST(MutableJazzyIndexTest, ErasesRefitAfterDriftAndDropEmptySegments) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t i = 0; i < 64; ++i) {
+        data.push_back(i);
+    }
+    Index index(jazzy::UpdatePolicy{.keys_per_segment = 16, .max_buffered = 4, .max_drift = 4});
+    index.build(data.data(), data.data() + data.size());
+    ASSERT_EQ(index.num_segments(), 4u);
+    const std::size_t fits = index.fit_count();
+
+    for (std::uint64_t key = 0; key < 5; ++key) {
+        EXPECT_TRUE(index.erase(key));
+    }
+    EXPECT_EQ(index.fit_count(), fits + 1);
+
+    for (std::uint64_t key = 5; key < 16; ++key) {
+        EXPECT_TRUE(index.erase(key));
+    }
+    EXPECT_EQ(index.num_segments(), 3u);
+
+    std::multiset<std::uint64_t> reference(data.begin() + 16, data.end());
+    index.insert(3);
+    reference.insert(3);
+    expect_matches(index, reference, 70);
+}
+
+TEST(MutableJazzyIndexTest, AppendsExtendTheLastSegment) {
+    Index index(jazzy::UpdatePolicy{.keys_per_segment = 512, .max_buffered = 16});
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t i = 0; i < 2048; ++i) {
+        data.push_back(i * 2);
+    }
+    index.build(data.data(), data.data() + data.size());
+    ASSERT_EQ(index.num_segments(), 4u);
+    const std::size_t fits = index.fit_count();
+
+    // Appends that follow the fitted trend stay within the last model's error: no refits at all
+    std::multiset<std::uint64_t> reference(data.begin(), data.end());
+    for (std::uint64_t i = 2048; i < 2048 + 300; ++i) {
+        index.insert(i * 2);
+        reference.insert(i * 2);
+    }
+    EXPECT_EQ(index.fit_count(), fits);
+    EXPECT_EQ(index.num_segments(), 4u);
+
+    // Growing past twice the segment size splits only the last segment
+    for (std::uint64_t i = 2348; i < 2048 + 600; ++i) {
+        index.insert(i * 2);
+        reference.insert(i * 2);
+    }
+    EXPECT_EQ(index.num_segments(), 5u);
+    EXPECT_EQ(index.fit_count(), fits + 2);
+    expect_matches(index, reference, 2 * 2700);
+}
+
+TEST(MutableJazzyIndexTest, AppendsOffTrendRefitTheLastSegment) {
+    Index index(jazzy::UpdatePolicy{.keys_per_segment = 256, .max_buffered = 16, .max_drift = 8});
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t i = 0; i < 512; ++i) {
+        data.push_back(i);
+    }
+    index.build(data.data(), data.data() + data.size());
+    const std::size_t fits = index.fit_count();
+
+    // Large jumps put the new keys far from where the fitted line predicts them
+    std::multiset<std::uint64_t> reference(data.begin(), data.end());
+    std::uint64_t key = 512;
+    for (int i = 0; i < 40; ++i) {
+        key += 1000;
+        index.insert(key);
+        reference.insert(key);
+    }
+    EXPECT_GT(index.fit_count(), fits);
+    expect_matches(index, reference, key + 1);
+}
+
+TEST(MutableJazzyIndexTest, CustomCompareAndKeyExtractor) {
+    struct Order {
+        std::uint64_t price;
+        std::uint64_t id;
+    };
+    struct ByPrice {
+        bool operator()(const Order& a, const Order& b) const { return a.price < b.price; }
+    };
+    struct PriceOf {
+        std::uint64_t operator()(const Order& o) const { return o.price; }
+    };
+
+    jazzy::MutableJazzyIndex<Order, ByPrice, PriceOf> book(
+        jazzy::UpdatePolicy{.keys_per_segment = 8, .max_buffered = 2});
+    for (std::uint64_t i = 0; i < 100; ++i) {
+        book.insert(Order{(i * 37) % 101, i});
+    }
+    const Order* best = book.find_lower_bound(Order{50, 0});
+    ASSERT_NE(best, nullptr);
+    EXPECT_EQ(best->price, 50u);
+    EXPECT_TRUE(book.erase(Order{50, 0}));
+    best = book.find_lower_bound(Order{50, 0});
+    ASSERT_NE(best, nullptr);
+    EXPECT_EQ(best->price, 51u);
+}
@@ -2,14 +2,21 @@
 // Verifies that parallel builds produce identical results to single-threaded builds
 
 #include "jazzy_index.hpp"
+#include "jazzy_index_executor.hpp"
+#include "jazzy_index_export.hpp"
 #include "jazzy_index_parallel.hpp"
 
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <numeric>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 
 namespace {
@@ -760,3 +767,128 @@ TEST_F(IntParallel, LargeSparseDataset) {
 
     EXPECT_TRUE(indexes_equal(idx_single, idx_parallel, data));
 }
+
+// Test: Thread pool runs every task exactly once, including nested bulks from inside a task
+TEST(ParallelExecutor, ThreadPoolRunsEveryTask) {
+    jazzy::parallel::ThreadPool pool(4);
+    EXPECT_EQ(pool.concurrency(), 4u);
+
+    std::vector<std::atomic<int>> hits(1000);
+    pool.bulk_execute(hits.size(), [&](std::size_t i) { hits[i].fetch_add(1); });
+    for (const auto& hit : hits) {
+        EXPECT_EQ(hit.load(), 1);
+    }
+
+    std::atomic<std::size_t> inner{0};
+    pool.bulk_execute(8, [&](std::size_t) {
+        pool.bulk_execute(50, [&](std::size_t) { inner.fetch_add(1); });
+    });
+    EXPECT_EQ(inner.load(), 400u);
+
+    jazzy::parallel::ThreadPool single(1);
+    EXPECT_EQ(single.concurrency(), 1u);
+    std::size_t sum = 0;
+    single.bulk_execute(10, [&](std::size_t i) { sum += i; });
+    EXPECT_EQ(sum, 45u);
+}
+
+// Test: Segments are grouped into chunks by element count, covering every task in order
+TEST(ParallelExecutor, ChunkPlanning) {
+    using Builder = jazzy::parallel::ParallelBuilder<int, jazzy::SegmentCount::MAX, std::less<>, jazzy::identity,
+                                                     jazzy::IndexOptions<>>;
+    std::vector<int> data(1'000'000);
+    std::iota(data.begin(), data.end(), 0);
+    jazzy::JazzyIndex<int, jazzy::SegmentCount::MAX> index;
+    const auto tasks = index.prepare_build_tasks(data.data(), data.data() + data.size());
+    ASSERT_EQ(tasks.size(), 2048u);
+
+    // 1M keys over 4 threads: ~16 chunks of ~62K keys
+    const auto chunks = Builder::plan_chunks(tasks, 4);
+    EXPECT_GE(chunks.size(), 15u);
+    EXPECT_LE(chunks.size(), 17u);
+    EXPECT_EQ(chunks.back(), tasks.size());
+    EXPECT_TRUE(std::is_sorted(chunks.begin(), chunks.end()));
+
+    // Many threads: chunks never drop below the minimum chunk size
+    const auto fine = Builder::plan_chunks(tasks, 1024);
+    EXPECT_LE(fine.size(), data.size() / jazzy::detail::PARALLEL_MIN_CHUNK_ELEMENTS + 1);
+    EXPECT_GT(fine.size(), chunks.size());
+
+    // Small inputs collapse into a single task
+    std::vector<int> small(1000);
+    std::iota(small.begin(), small.end(), 0);
+    const auto small_tasks = index.prepare_build_tasks(small.data(), small.data() + small.size());
+    EXPECT_EQ(Builder::plan_chunks(small_tasks, 64).size(), 1u);
+    EXPECT_TRUE(Builder::plan_chunks({}, 4).empty());
+}
+
+// Test: Every executor kind builds the same index as the sequential build
+TEST(ParallelExecutor, ExecutorsMatchSequentialBuild) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t i = 0; i < 200'000; ++i) {
+        data.push_back(i * i / 7 + (i % 3));
+    }
+    std::sort(data.begin(), data.end());
+    using IndexType = jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::XXLARGE>;
+
+    IndexType sequential(data.data(), data.data() + data.size());
+    const std::string expected = jazzy::export_index_metadata(sequential);
+
+    IndexType by_default;
+    by_default.build_parallel(data.data(), data.data() + data.size());
+    EXPECT_EQ(jazzy::export_index_metadata(by_default), expected);
+
+    for (std::size_t threads : {1u, 2u, 3u, 8u}) {
+        jazzy::parallel::ThreadPool pool(threads);
+        IndexType index;
+        index.build_parallel(data.data(), data.data() + data.size(), pool);
+        EXPECT_EQ(jazzy::export_index_metadata(index), expected) << threads << " threads";
+    }
+
+    jazzy::parallel::InlineExecutor inline_executor;
+    IndexType inline_index;
+    inline_index.build_parallel(data.data(), data.data() + data.size(), inline_executor);
+    EXPECT_EQ(jazzy::export_index_metadata(inline_index), expected);
+
+    // External scheduler: one std::thread per submitted task, joined after the build
+    std::vector<std::thread> threads;
+    jazzy::parallel::SchedulerExecutor scheduler([&threads](std::function<void()> task) {
+        threads.emplace_back(std::move(task));
+    }, 4);
+    IndexType scheduled;
+    scheduled.build_parallel(data.data(), data.data() + data.size(), scheduler);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(jazzy::export_index_metadata(scheduled), expected);
+
+    jazzy::parallel::ThreadPool pool(4);
+    IndexType bounded;
+    IndexType bounded_parallel;
+    bounded.build_error_bounded(data.data(), data.data() + data.size(), 16);
+    bounded_parallel.build_parallel_error_bounded(data.data(), data.data() + data.size(), 16, pool);
+    EXPECT_EQ(jazzy::export_index_metadata(bounded_parallel), jazzy::export_index_metadata(bounded));
+    EXPECT_EQ(bounded_parallel.error_bound(), bounded.error_bound());
+}
+
+// Test: An exception thrown inside a chunk reaches the caller and the pool stays usable
+TEST(ParallelExecutor, TaskExceptionPropagates) {
+    auto throwing_key = [](const int& v) -> int {
+        if (v == 77'777) {
+            throw std::domain_error("bad key");
+        }
+        return v;
+    };
+    std::vector<int> data(100'000);
+    std::iota(data.begin(), data.end(), 0);
+
+    jazzy::parallel::ThreadPool pool(4);
+    jazzy::JazzyIndex<int, jazzy::SegmentCount::LARGE, std::less<>, decltype(throwing_key)> index;
+    EXPECT_THROW(index.build_parallel(data.data(), data.data() + data.size(), pool, std::less<>{}, throwing_key),
+                 std::domain_error);
+
+    jazzy::JazzyIndex<int, jazzy::SegmentCount::LARGE> ok;
+    ok.build_parallel(data.data(), data.data() + data.size(), pool);
+    ASSERT_NE(ok.find(77'777), data.data() + data.size());
+    EXPECT_EQ(*ok.find(77'777), 77'777);
+}
@@ -0,0 +1,236 @@
+// Tests for layout::Precise: double-precision models over each key's offset from its segment's
+// first key, checked on 64-bit keys of large magnitude (nanosecond timestamps) against the float
+// models of the other layouts, and against std:: algorithms across builds, key types and files
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_export.hpp"
+#include "jazzy_index_parallel.hpp"
+#include "jazzy_index_serialize.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using PreciseOptions = jazzy::IndexOptions<jazzy::layout::Precise>;
+
+template <typename T, jazzy::SegmentCount Segments, typename Compare = std::less<>>
+using PreciseIndex = jazzy::JazzyIndex<T, Segments, Compare, jazzy::identity, PreciseOptions>;
+
+// Nanosecond timestamps from 1.7e18 (past 2^53, where doubles skip integers) arriving in bursts
+std::vector<std::uint64_t> make_timestamps(std::size_t count, std::uint64_t seed) {
+    std::vector<std::uint64_t> data(count);
+    std::mt19937_64 rng(seed);
+    std::uint64_t t = 1'700'000'000'000'000'000ULL;
+    std::uint64_t max_gap = 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i % 1000 == 0) {
+            max_gap = std::uint64_t{250} << (rng() % 4);
+        }
+        t += 1 + rng() % max_gap;
+        data[i] = t;
+    }
+    return data;
+}
+
+template <typename T>
+std::vector<T> make_skewed(std::size_t n, std::uint64_t seed, double offset = 0.0) {
+    std::mt19937_64 rng(seed);
+    std::lognormal_distribution<double> dist(0.0, 2.0);
+    std::vector<T> data(n);
+    for (auto& v : data) {
+        v = static_cast<T>(dist(rng) * 1000.0 + offset);
+    }
+    std::sort(data.begin(), data.end());
+    return data;
+}
+
+// Every query (hits, misses next to keys and keys past either end) matches std:: algorithms
+template <typename Index, typename T, typename Compare = std::less<>>
+void expect_exact(const Index& index, const std::vector<T>& data, Compare comp = Compare{}) {
+    const T* begin = data.data();
+    const T* end = begin + data.size();
+    std::vector<T> queries{std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max()};
+    for (std::size_t i = 0; i < data.size(); i += 7) {
+        queries.push_back(data[i]);
+        queries.push_back(static_cast<T>(data[i] + 1));
+        queries.push_back(static_cast<T>(data[i] - 1));
+    }
+    for (const T q : queries) {
+        const T* expected = std::lower_bound(begin, end, q, comp);
+        const bool present = expected != end && !comp(q, *expected);
+        const T* found = index.find(q);
+        ASSERT_EQ(found != end, present) << "find " << q;
+        if (present) {
+            EXPECT_EQ(*found, q);
+        }
+        EXPECT_EQ(index.find_lower_bound(q), expected) << "lower bound " << q;
+        EXPECT_EQ(index.find_upper_bound(q), std::upper_bound(begin, end, q, comp)) << "upper bound " << q;
+    }
+
+    std::vector<const T*> batch(queries.size());
+    index.find_lower_bound_batch(queries, batch);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(batch[i], std::lower_bound(begin, end, queries[i], comp)) << "batch " << queries[i];
+    }
+}
+
+}  // namespace
+
+TEST(PreciseSegmentTest, RecordTradesACacheLineForPrecision) {
+    // Bounds, model and extent fill the first line; max_error starts the second
+    EXPECT_EQ(sizeof(jazzy::detail::PreciseSegment<std::uint64_t>), 128u);
+    EXPECT_EQ(offsetof(jazzy::detail::PreciseSegment<std::uint64_t>, max_error), 64u);
+    EXPECT_EQ(sizeof(jazzy::detail::PreciseSegment<std::uint32_t>), 64u);
+
+    // Offsets of 64-bit integer keys are taken before the conversion to double
+    const std::uint64_t big = 1'700'000'000'000'000'001ULL;
+    EXPECT_EQ(jazzy::detail::key_offset(big, big - 1), 1.0);
+    EXPECT_EQ(jazzy::detail::key_offset(big - 3, big), -3.0);
+    EXPECT_EQ(jazzy::detail::key_offset(std::int64_t{-5}, std::int64_t{-9}), 4.0);
+    EXPECT_EQ(jazzy::detail::key_offset(std::numeric_limits<std::int64_t>::max(),
+                                        std::numeric_limits<std::int64_t>::min()),
+              std::ldexp(1.0, 64));
+}
+
+TEST(PreciseSegmentTest, LargeTimestampsKeepNarrowWindows) {
+    using Stats = jazzy::stats::PerThread;
+    const auto data = make_timestamps(200'000, 3);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Interleaved, jazzy::routing::Eytzinger, Stats>>
+        interleaved(data.data(), data.data() + data.size());
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Precise, jazzy::routing::Eytzinger, Stats>>
+        precise(data.data(), data.data() + data.size());
+
+    // Offsets from each segment's first key fit as well as the same keys starting at 0
+    std::vector<std::uint64_t> from_zero(data.size());
+    std::transform(data.begin(), data.end(), from_zero.begin(), [&data](std::uint64_t t) { return t - data[0]; });
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> shifted(from_zero.data(),
+                                                                         from_zero.data() + from_zero.size());
+    EXPECT_LE(precise.max_segment_error(), shifted.max_segment_error() + 2);
+
+    // Float coefficients over keys near 1.7e18 predict hundreds of positions off, so most
+    // lookups gallop out of the window; the precise models never leave it
+    for (const std::uint64_t key : data) {
+        ASSERT_EQ(*interleaved.find(key), key);
+        ASSERT_EQ(*precise.find(key), key);
+    }
+    EXPECT_GT(interleaved.query_stats().window_miss_rate(), 0.5);
+    EXPECT_EQ(precise.query_stats().window_misses, 0u);
+
+    expect_exact(precise, data);
+    expect_exact(interleaved, data);
+}
+
+TEST(PreciseSegmentTest, EveryModelAndKeyType) {
+    std::vector<std::uint64_t> curved(40'000);
+    for (std::size_t i = 0; i < curved.size(); ++i) {
+        const double x = static_cast<double>(i) / static_cast<double>(curved.size());
+        curved[i] = static_cast<std::uint64_t>(std::pow(x, 5) * 1e12) + i;
+    }
+    PreciseIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> curved_index(curved.data(),
+                                                                          curved.data() + curved.size());
+    expect_exact(curved_index, curved);
+
+    std::vector<std::uint64_t> uniform(50'000);
+    for (std::size_t i = 0; i < uniform.size(); ++i) {
+        uniform[i] = (std::uint64_t{1} << 62) + i * 3;
+    }
+    PreciseIndex<std::uint64_t, jazzy::SegmentCount::LARGE> uniform_index(uniform.data(),
+                                                                          uniform.data() + uniform.size());
+    EXPECT_EQ(uniform_index.max_segment_error(), 0u);
+    expect_exact(uniform_index, uniform);
+
+    const auto negative = make_skewed<std::int64_t>(30'000, 5, -1e6);
+    PreciseIndex<std::int64_t, jazzy::SegmentCount::XLARGE> signed_index(negative.data(),
+                                                                         negative.data() + negative.size());
+    expect_exact(signed_index, negative);
+
+    const auto doubles = make_skewed<double>(20'000, 6, -500.0);
+    PreciseIndex<double, jazzy::SegmentCount::LARGE> double_index(doubles.data(), doubles.data() + doubles.size());
+    for (std::size_t i = 0; i < doubles.size(); i += 13) {
+        EXPECT_EQ(*double_index.find(doubles[i]), doubles[i]);
+        EXPECT_EQ(double_index.find_lower_bound(doubles[i]),
+                  std::lower_bound(doubles.data(), doubles.data() + doubles.size(), doubles[i]));
+    }
+
+    auto descending = make_timestamps(20'000, 7);
+    std::reverse(descending.begin(), descending.end());
+    PreciseIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::greater<>> down(
+        descending.data(), descending.data() + descending.size());
+    expect_exact(down, descending, std::greater<>{});
+}
+
+TEST(PreciseSegmentTest, DuplicatesAndSmallInputs) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t v = 0; v < 200; ++v) {
+        data.insert(data.end(), 1 + v % 17, (std::uint64_t{1} << 61) + v * 3);
+    }
+    PreciseIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index(data.data(), data.data() + data.size());
+    expect_exact(index, data);
+
+    const std::vector<std::uint64_t> one{42};
+    PreciseIndex<std::uint64_t, jazzy::SegmentCount::LARGE> single(one.data(), one.data() + 1);
+    EXPECT_EQ(single.find(42), one.data());
+    EXPECT_EQ(single.find(41), one.data() + 1);
+    EXPECT_EQ(single.max_segment_error(), 0u);
+
+    PreciseIndex<std::uint64_t, jazzy::SegmentCount::LARGE> empty;
+    EXPECT_EQ(empty.max_segment_error(), 0u);
+}
+
+TEST(PreciseSegmentTest, ParallelErrorBoundedAndDynamic) {
+    const auto data = make_timestamps(60'000, 11);
+
+    PreciseIndex<std::uint64_t, jazzy::SegmentCount::LARGE> parallel;
+    parallel.build_parallel(data.data(), data.data() + data.size());
+    expect_exact(parallel, data);
+
+    PreciseIndex<std::uint64_t, jazzy::SegmentCount::XLARGE> bounded;
+    bounded.build_error_bounded(data.data(), data.data() + data.size(), 16);
+    ASSERT_TRUE(bounded.error_bound().has_value());
+    EXPECT_LE(bounded.max_segment_error(), *bounded.error_bound());
+    expect_exact(bounded, data);
+
+    jazzy::DynamicJazzyIndex<std::uint64_t, std::less<>, jazzy::identity, PreciseOptions> dynamic(
+        jazzy::SegmentSizing{.keys_per_segment = 256});
+    dynamic.build(data.data(), data.data() + data.size());
+    expect_exact(dynamic, data);
+}
+
+TEST(PreciseSegmentTest, SaveLoad) {
+    const auto data = make_timestamps(30'000, 8);
+    PreciseIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index(data.data(), data.data() + data.size());
+
+    std::stringstream file;
+    index.save(file);
+    const std::string bytes = file.str();
+
+    // Files hold float models over absolute keys, so a loaded index searches the wider windows of
+    // that form (measured again on load) but still answers exactly
+    PreciseIndex<std::uint64_t, jazzy::SegmentCount::LARGE> restored;
+    std::istringstream in(bytes);
+    restored.load(in, data.data(), data.data() + data.size());
+    EXPECT_GE(restored.max_segment_error(), index.max_segment_error());
+    expect_exact(restored, data);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> interleaved;
+    std::istringstream again(bytes);
+    interleaved.load(again, data.data(), data.data() + data.size());
+    expect_exact(interleaved, data);
+
+    // Metadata export reads the same absolute form
+    const std::string metadata = jazzy::export_index_metadata(index);
+    EXPECT_NE(metadata.find("\"slope\": "), std::string::npos);
+}
@@ -0,0 +1,246 @@
+// Tests for PrefixJazzyIndex and key_prefix (jazzy_index_prefix.hpp): string, tuple and record
+// keys with long shared prefixes, against std:: algorithms on the same keys
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_prefix.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct Trade {
+    std::string symbol;
+    std::uint64_t timestamp;
+    double price;
+};
+
+struct TradeKey {
+    auto operator()(const Trade& t) const { return std::tie(t.symbol, t.timestamp); }
+};
+
+struct TradeOrder {
+    bool operator()(const Trade& a, const Trade& b) const { return TradeKey{}(a) < TradeKey{}(b); }
+};
+
+// Random lowercase words with a shared head, so many keys agree on their first bytes
+std::vector<std::string> make_words(std::size_t count, const std::string& head, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::string> words(count);
+    for (auto& w : words) {
+        w = head;
+        const std::size_t length = 1 + rng() % 12;
+        for (std::size_t i = 0; i < length; ++i) {
+            w.push_back(static_cast<char>('a' + rng() % 26));
+        }
+    }
+    std::sort(words.begin(), words.end());
+    return words;
+}
+
+// Every query agrees with std::lower_bound / std::upper_bound over the same keys
+template <typename Index, typename T, typename Compare = std::less<>>
+void expect_exact(const Index& index, const std::vector<T>& data, const std::vector<T>& queries,
+                  Compare comp = Compare{}) {
+    const T* begin = data.data();
+    const T* end = begin + data.size();
+    for (const T& q : queries) {
+        const T* lower = std::lower_bound(begin, end, q, comp);
+        const T* upper = std::upper_bound(begin, end, q, comp);
+        ASSERT_EQ(index.find_lower_bound(q), lower);
+        ASSERT_EQ(index.find_upper_bound(q), upper);
+        const T* found = index.find(q);
+        if (lower != upper) {
+            ASSERT_NE(found, end);
+            EXPECT_FALSE(comp(*found, q) || comp(q, *found));
+        } else {
+            EXPECT_EQ(found, end);
+        }
+        EXPECT_EQ(index.equal_range(q), std::make_pair(lower, upper));
+    }
+}
+
+}  // namespace
+
+TEST(KeyPrefixTest, OrdersAsKeys) {
+    const jazzy::key_prefix prefix;
+    EXPECT_EQ(prefix(std::string("abcdefghij")), 0x6162636465666768ULL);
+    EXPECT_EQ(prefix(std::string("ab")), 0x6162000000000000ULL);
+    EXPECT_EQ(prefix(std::string("abcdefghij"), 8), 0x696A000000000000ULL);
+    EXPECT_EQ(prefix(std::uint32_t{5}), 0x0000000500000000ULL);
+    EXPECT_LT(prefix(std::int64_t{-1}), prefix(std::int64_t{0}));
+    EXPECT_LT(prefix(std::numeric_limits<std::int32_t>::min()), prefix(std::int32_t{-7}));
+    EXPECT_LT(prefix(-2.5), prefix(-1.0));
+    EXPECT_LT(prefix(-1.0), prefix(0.5));
+    EXPECT_EQ(prefix(-0.0), prefix(0.0));
+    EXPECT_LT(prefix(1.0f), prefix(1.5f));
+
+    // A string followed by other elements ends in 0x00 0x00 and escapes its zero bytes
+    EXPECT_EQ(prefix(std::make_tuple(std::string("AB"), std::uint32_t{7})), 0x4142000000000007ULL);
+    EXPECT_LT(prefix(std::make_tuple(std::string("A"), std::uint16_t{0xFFFF})),
+              prefix(std::make_tuple(std::string("A\0", 2), std::uint16_t{0})));
+    EXPECT_LT(prefix(std::make_tuple(std::string("A"), std::uint16_t{0xFFFF})),
+              prefix(std::make_tuple(std::string("AB"), std::uint16_t{0})));
+
+    // Random tuples: prefixes never order against the keys
+    std::mt19937_64 rng(1);
+    std::vector<std::tuple<std::int16_t, std::string, double>> keys(2000);
+    for (auto& [a, s, d] : keys) {
+        a = static_cast<std::int16_t>(static_cast<int>(rng() % 7) - 3);
+        s = std::string(rng() % 3, static_cast<char>(rng() % 3));
+        d = static_cast<double>(static_cast<int>(rng() % 11) - 5) / 4.0;
+    }
+    std::sort(keys.begin(), keys.end());
+    for (std::size_t skip : {0u, 2u, 5u}) {
+        for (std::size_t i = 1; i < keys.size(); ++i) {
+            if (keys[i - 1] == keys[i]) {
+                ASSERT_EQ(prefix(keys[i - 1], skip), prefix(keys[i], skip));
+            } else if (skip == 0) {
+                ASSERT_LE(prefix(keys[i - 1]), prefix(keys[i])) << i;
+            }
+        }
+    }
+}
+
+TEST(PrefixJazzyIndexTest, StringKeys) {
+    const auto words = make_words(20'000, "", 2);
+    jazzy::PrefixJazzyIndex<std::string> index(words.data(), words.data() + words.size());
+    EXPECT_EQ(index.size(), words.size());
+    EXPECT_LE(index.num_prefixes(), words.size());
+
+    auto queries = make_words(2'000, "", 3);
+    for (std::size_t i = 0; i < words.size(); i += 9) {
+        queries.push_back(words[i]);
+        queries.push_back(words[i] + "a");
+        queries.push_back(words[i].substr(0, words[i].size() - 1));
+    }
+    queries.push_back("");
+    queries.push_back("zzzzzzzzzzzzzzzzz");
+    expect_exact(index, words, queries);
+}
+
+TEST(PrefixJazzyIndexTest, LongSharedPrefixesGetTieLevels) {
+    // Every key shares its first 21 bytes, and groups share 8 more
+    std::vector<std::string> urls;
+    for (const std::string group : {"alpha/", "beta/", "gamma/"}) {
+        const auto words = make_words(3'000, "https://example.com/" + group + "item-", 4 + urls.size());
+        urls.insert(urls.end(), words.begin(), words.end());
+    }
+    jazzy::PrefixJazzyIndex<std::string, jazzy::SegmentCount::MEDIUM> index(urls.data(), urls.data() + urls.size());
+    EXPECT_EQ(index.num_prefixes(), 1u);
+    EXPECT_GE(index.num_tie_levels(), 1u);
+
+    auto queries = make_words(500, "https://example.com/beta/item-", 9);
+    for (std::size_t i = 0; i < urls.size(); i += 7) {
+        queries.push_back(urls[i]);
+        queries.push_back(urls[i] + "!");
+    }
+    queries.push_back("https://example.com/");
+    queries.push_back("https://example.com/zeta/");
+    // Differing from every key inside the bytes the tie level skips
+    queries.push_back("https://exalted.com/beta/item-a");
+    queries.push_back("https://examplf.com/beta/item-a");
+    queries.push_back("https://example");
+    expect_exact(index, urls, queries);
+
+    // One tie skipping a whole shared block, queried below, above and inside it
+    std::vector<std::string> blocks;
+    for (int i = 0; i < 600; ++i) {
+        blocks.push_back("AAAAAAAABBBBBBBB" + std::to_string(10000 + i));
+    }
+    jazzy::PrefixJazzyIndex<std::string> block_index(blocks.data(), blocks.data() + blocks.size());
+    EXPECT_EQ(block_index.num_tie_levels(), 1u);
+    const auto block_queries = std::vector<std::string>{
+        "AAAAAAAACCCCCCCC10300", "AAAAAAAAAAAAAAAA10300", "AAAAAAAABBBBBBBA99999", "AAAAAAAABBBBBBBC",
+        "AAAAAAAABBBB",          "AAAAAAAABBBBBBBB10300", "AAAAAAAABBBBBBBB1030",  "AAAAAAAABBBBBBBB2"};
+    expect_exact(block_index, blocks, block_queries);
+    EXPECT_EQ(block_index.find("AAAAAAAACCCCCCCC10300"), block_index.end());
+
+    // Keys equal for longer than the nested levels reach fall back to the comparator
+    std::vector<std::string> deep;
+    for (int i = 0; i < 600; ++i) {
+        deep.push_back(std::string(100, 'x') + std::to_string(1000 + i));
+    }
+    jazzy::PrefixJazzyIndex<std::string> deep_index(deep.data(), deep.data() + deep.size());
+    EXPECT_EQ(deep_index.num_tie_levels(), 0u);
+    expect_exact(deep_index, deep, deep);
+}
+
+TEST(PrefixJazzyIndexTest, CompositeRecordKeys) {
+    // (symbol, timestamp): each symbol's rows tie on the symbol bytes and are told apart by time
+    std::vector<Trade> trades;
+    std::mt19937_64 rng(5);
+    for (const std::string symbol : {"AAPL", "AMZN", "GOOGL", "MSFT", "NVDA", "TSLA"}) {
+        std::uint64_t t = 1'700'000'000'000'000'000ULL;
+        for (int i = 0; i < 4'000; ++i) {
+            t += 1 + rng() % 5'000;
+            trades.push_back(Trade{symbol, t, 100.0 + i});
+            if (i % 100 == 0) {
+                trades.push_back(Trade{symbol, t, 101.0 + i});  // Same key, another trade
+            }
+        }
+    }
+    jazzy::PrefixJazzyIndex<Trade, jazzy::SegmentCount::LARGE, TradeOrder, TradeKey> index(
+        trades.data(), trades.data() + trades.size());
+    EXPECT_EQ(index.num_prefixes(), 6u);
+    EXPECT_GE(index.num_tie_levels(), 6u);
+
+    std::vector<Trade> queries{{"A", 0, 0}, {"AAPL", 0, 0}, {"MSFT", ~0ULL, 0}, {"ZZZZ", 0, 0}};
+    for (std::size_t i = 0; i < trades.size(); i += 13) {
+        queries.push_back(trades[i]);
+        queries.push_back(Trade{trades[i].symbol, trades[i].timestamp + 1, 0});
+        queries.push_back(Trade{trades[i].symbol, trades[i].timestamp - 1, 0});
+    }
+    expect_exact(index, trades, queries, TradeOrder{});
+
+    // Plain tuples order with std::less<> directly
+    std::vector<std::tuple<std::uint32_t, std::string>> pairs;
+    for (std::uint32_t id = 0; id < 300; ++id) {
+        for (const auto& w : make_words(20, "", id)) {
+            pairs.emplace_back(id * 3, w);
+        }
+    }
+    std::sort(pairs.begin(), pairs.end());
+    jazzy::PrefixJazzyIndex<std::tuple<std::uint32_t, std::string>> tuples(pairs.data(), pairs.data() + pairs.size());
+    auto tuple_queries = pairs;
+    tuple_queries.emplace_back(1, "a");
+    tuple_queries.emplace_back(900, "");
+    expect_exact(tuples, pairs, tuple_queries);
+}
+
+TEST(PrefixJazzyIndexTest, EmptyDuplicatesAndErrors) {
+    jazzy::PrefixJazzyIndex<std::string> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.find("a"), empty.end());
+    EXPECT_EQ(empty.find_lower_bound("a"), empty.end());
+
+    std::vector<std::string> same(1'000, "repeated-key");
+    same.insert(same.begin(), 10, "a");
+    jazzy::PrefixJazzyIndex<std::string> dups(same.data(), same.data() + same.size());
+    EXPECT_EQ(dups.num_tie_levels(), 0u);
+    expect_exact(dups, same, {"a", "b", "repeated", "repeated-key", "repeated-keys", "z"});
+
+    std::vector<std::string> unsorted{"b", "a"};
+    EXPECT_THROW(jazzy::PrefixJazzyIndex<std::string>(unsorted.data(), unsorted.data() + 2), std::runtime_error);
+
+    // Descending strings do not order as their prefixes
+    std::vector<std::string> descending{"c", "b", "a"};
+    jazzy::PrefixJazzyIndex<std::string, jazzy::SegmentCount::SMALL, std::greater<>> down;
+    EXPECT_THROW(down.build(descending.data(), descending.data() + 3), std::invalid_argument);
+
+    const auto words = make_words(5'000, "k", 6);
+    jazzy::PrefixJazzyIndex<std::string> index(words.data(), words.data() + words.size());
+    EXPECT_GT(index.memory_usage(), words.size() * sizeof(std::uint64_t) / 2);
+    jazzy::PrefixJazzyIndex<std::string> moved = std::move(index);
+    expect_exact(moved, words, words);
+}
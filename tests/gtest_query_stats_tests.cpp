@@ -0,0 +1,213 @@
+// Tests for query statistics (IndexOptions<..., stats::PerThread>): search, run-table and
+// uniform-route counters, the error and gallop histograms, per-thread aggregation and JSON export
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_export.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Options = jazzy::IndexOptions<jazzy::layout::Interleaved, jazzy::routing::Eytzinger, jazzy::stats::PerThread>;
+
+template <jazzy::SegmentCount Segments = jazzy::SegmentCount::LARGE>
+using StatsIndex = jazzy::JazzyIndex<std::uint64_t, Segments, std::less<>, jazzy::identity, Options>;
+
+template <typename Index>
+concept HasQueryStats = requires(const Index& index) { index.query_stats(); };
+
+std::uint64_t total(const jazzy::QueryStats::Histogram& histogram) {
+    return std::accumulate(histogram.begin(), histogram.end(), std::uint64_t{0});
+}
+
+std::uint64_t total(const std::vector<std::uint64_t>& hits) {
+    return std::accumulate(hits.begin(), hits.end(), std::uint64_t{0});
+}
+
+// Keys in runs of 32, so runs straddle the segment boundaries without being long enough to table
+std::vector<std::uint64_t> make_short_runs(std::size_t count) {
+    std::vector<std::uint64_t> data(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        data[i] = i / 32;
+    }
+    return data;
+}
+
+}  // namespace
+
+TEST(QueryStatsTest, DisabledByDefault) {
+    static_assert(!HasQueryStats<jazzy::JazzyIndex<std::uint64_t>>);
+    static_assert(HasQueryStats<StatsIndex<>>);
+    static_assert(std::is_empty_v<jazzy::detail::NoStats>);  // Takes no room in the index
+
+    StatsIndex<> empty;
+    const auto stats = empty.query_stats();
+    EXPECT_EQ(stats.searches, 0u);
+    EXPECT_TRUE(stats.segment_hits.empty());
+    EXPECT_EQ(stats.window_miss_rate(), 0.0);
+    EXPECT_EQ(stats.uniform_miss_rate(), 0.0);
+}
+
+TEST(QueryStatsTest, CountsSearchesAndSegmentHits) {
+    std::vector<std::uint64_t> data(20'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = i * 3;
+    }
+    StatsIndex<> index(data.data(), data.data() + data.size());
+    for (std::size_t i = 0; i < data.size(); i += 2) {
+        ASSERT_EQ(*index.find(data[i]), data[i]);
+    }
+    static_cast<void>(index.find_lower_bound(7));
+    static_cast<void>(index.find_upper_bound(7));
+
+    const auto stats = index.query_stats();
+    EXPECT_EQ(stats.searches, data.size() / 2 + 2);
+    EXPECT_EQ(stats.segment_hits.size(), index.num_segments());
+    EXPECT_EQ(total(stats.segment_hits), stats.searches);
+    EXPECT_EQ(total(stats.error_histogram), stats.searches);
+    EXPECT_EQ(stats.run_table_hits, 0u);
+    EXPECT_EQ(total(stats.gallop_histogram), stats.window_misses);
+
+    // Evenly spaced keys are routed in O(1) and mostly predicted exactly
+    EXPECT_EQ(stats.uniform_routes, stats.searches);
+    EXPECT_GT(stats.error_histogram[0], stats.searches / 2);
+}
+
+TEST(QueryStatsTest, WindowMissesAndRunTableHits) {
+    // Upper bounds of runs that straddle a segment boundary lie past the window of the left segment
+    const auto data = make_short_runs(32'000);
+    StatsIndex<jazzy::SegmentCount::SMALL> index(data.data(), data.data() + data.size());
+    ASSERT_EQ(index.num_tabled_runs(), 0u);
+    for (std::uint64_t key = 0; key <= data.back(); ++key) {
+        static_cast<void>(index.find_upper_bound(key));
+    }
+    auto stats = index.query_stats();
+    EXPECT_GT(stats.window_misses, 0u);
+    EXPECT_EQ(total(stats.gallop_histogram), stats.window_misses);
+    EXPECT_GT(stats.window_miss_rate(), 0.0);
+    EXPECT_LT(stats.window_miss_rate(), 1.0);
+
+    // Runs of 2000 keys are tabled, and bounds on them bypass the error histogram
+    std::vector<std::uint64_t> long_runs(40'000);
+    for (std::size_t i = 0; i < long_runs.size(); ++i) {
+        long_runs[i] = i / 2000;
+    }
+    index.build(long_runs.data(), long_runs.data() + long_runs.size());
+    ASSERT_GT(index.num_tabled_runs(), 0u);
+    stats = index.query_stats();
+    EXPECT_EQ(stats.searches, 0u);  // Rebuilding starts over
+
+    for (std::uint64_t key = 0; key < 20; ++key) {
+        static_cast<void>(index.equal_range(key));
+    }
+    stats = index.query_stats();
+    EXPECT_EQ(stats.searches, 40u);
+    EXPECT_GT(stats.run_table_hits, 0u);
+    EXPECT_EQ(total(stats.error_histogram), stats.searches - stats.run_table_hits);
+}
+
+TEST(QueryStatsTest, UniformRouteMisses) {
+    // Spacing that changes halfway still passes the uniformity check, but the O(1) guess is off
+    // for keys near the change
+    std::vector<std::uint64_t> data(40'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = i < data.size() / 2 ? i * 10 : data.size() * 5 + (i - data.size() / 2) * 12;
+    }
+    StatsIndex<> index(data.data(), data.data() + data.size());
+    for (const std::uint64_t key : data) {
+        ASSERT_EQ(*index.find(key), key);
+    }
+    const auto stats = index.query_stats();
+    EXPECT_EQ(stats.uniform_routes, data.size());
+    EXPECT_GT(stats.uniform_misses, 0u);
+    EXPECT_LT(stats.uniform_miss_rate(), 1.0);
+}
+
+TEST(QueryStatsTest, ThreadsAndBatchesAreSummed) {
+    std::vector<std::uint64_t> data(50'000);
+    std::mt19937_64 rng(9);
+    for (auto& v : data) {
+        v = rng() % 10'000'000;
+    }
+    std::sort(data.begin(), data.end());
+    StatsIndex<jazzy::SegmentCount::XLARGE> index(data.data(), data.data() + data.size());
+
+    constexpr std::size_t threads = 4;
+    constexpr std::size_t per_thread = 5000;
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&index, &data, t] {
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                static_cast<void>(index.find_lower_bound(data[(i * 7 + t) % data.size()]));
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(index.query_stats().searches, threads * per_thread);
+
+    std::vector<std::uint64_t> keys(data.begin(), data.begin() + 1000);
+    std::vector<const std::uint64_t*> out(keys.size());
+    index.find_batch(keys, out);
+    const auto stats = index.query_stats();
+    EXPECT_EQ(stats.searches, threads * per_thread + keys.size());
+    EXPECT_EQ(total(stats.segment_hits), stats.searches);
+
+    index.reset_query_stats();
+    EXPECT_EQ(index.query_stats().searches, 0u);
+    static_cast<void>(index.find(data[0]));
+    EXPECT_EQ(index.query_stats().searches, 1u);
+}
+
+TEST(QueryStatsTest, CopiesStartEmptyAndMovesKeepCounts) {
+    std::vector<std::uint64_t> data(5000);
+    std::iota(data.begin(), data.end(), std::uint64_t{0});
+    StatsIndex<jazzy::SegmentCount::SMALL> index(data.data(), data.data() + data.size());
+    for (std::size_t i = 0; i < 100; ++i) {
+        static_cast<void>(index.find(data[i * 3]));
+    }
+
+    StatsIndex<jazzy::SegmentCount::SMALL> copy = index;
+    EXPECT_EQ(copy.query_stats().searches, 0u);
+    EXPECT_EQ(copy.query_stats().segment_hits.size(), index.num_segments());
+    static_cast<void>(copy.find(data[1]));
+    EXPECT_EQ(copy.query_stats().searches, 1u);
+    EXPECT_EQ(index.query_stats().searches, 100u);
+
+    StatsIndex<jazzy::SegmentCount::SMALL> moved = std::move(index);
+    EXPECT_EQ(moved.query_stats().searches, 100u);
+    static_cast<void>(moved.find(data[2]));
+    EXPECT_EQ(moved.query_stats().searches, 101u);
+}
+
+TEST(QueryStatsTest, ExportedAsJson) {
+    const auto data = make_short_runs(4000);
+    StatsIndex<jazzy::SegmentCount::SMALL> index(data.data(), data.data() + data.size());
+    for (std::uint64_t key = 0; key < 10; ++key) {
+        static_cast<void>(index.find(key));
+    }
+    const std::string stats = jazzy::export_query_stats(index);
+    EXPECT_NE(stats.find("\"searches\": 10,"), std::string::npos);
+    EXPECT_NE(stats.find("\"error_histogram\": ["), std::string::npos);
+    EXPECT_NE(stats.find("\"segment_hits\": ["), std::string::npos);
+
+    const std::string metadata = jazzy::export_index_metadata(index);
+    EXPECT_NE(metadata.find("\"query_stats\": {"), std::string::npos);
+    EXPECT_NE(metadata.find("\"searches\": 10,"), std::string::npos);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL> plain(data.data(), data.data() + data.size());
+    EXPECT_EQ(jazzy::export_index_metadata(plain).find("query_stats"), std::string::npos);
+}
@@ -0,0 +1,169 @@
+// Tests for range(), count_range() and for_each_in_range(): [lo, hi) scans checked against
+// std::lower_bound on both ends, across layouts, routers, comparators and uniform/skewed data
+
+#include "jazzy_index.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// A record wider than a cache line, ordered by key
+struct Wide {
+    std::uint64_t key;
+    char payload[120];
+};
+
+struct WideKey {
+    std::uint64_t operator()(const Wide& w) const { return w.key; }
+};
+
+struct WideLess {
+    bool operator()(const Wide& a, const Wide& b) const { return a.key < b.key; }
+};
+
+// Random [lo, hi) pairs, short and long, around stored keys and in the gaps
+template <typename Index, typename Compare = std::less<>>
+void expect_ranges_match(const Index& index, const std::vector<std::uint64_t>& data, Compare comp = Compare{}) {
+    const std::uint64_t* begin = data.data();
+    const std::uint64_t* end = begin + data.size();
+    std::mt19937_64 rng(17);
+    for (int trial = 0; trial < 3000; ++trial) {
+        const std::size_t i = rng() % data.size();
+        const std::size_t width = trial % 3 == 0 ? rng() % data.size() : rng() % 40;
+        const std::size_t j = std::min(data.size() - 1, i + width);
+        std::uint64_t lo = data[i] + (trial % 5 == 0 ? 1 : 0);
+        std::uint64_t hi = data[j] + (trial % 7 == 0 ? 1 : 0);
+        if (trial % 11 == 0) {
+            std::swap(lo, hi);  // Inverted ranges are empty
+        }
+        const auto* lower = std::lower_bound(begin, end, lo, comp);
+        const auto* upper = comp(lo, hi) ? std::lower_bound(begin, end, hi, comp) : lower;
+        const auto keys = index.range(lo, hi);
+        ASSERT_EQ(keys.data(), lower) << "lo " << lo << " hi " << hi;
+        ASSERT_EQ(keys.data() + keys.size(), std::max(lower, upper)) << "lo " << lo << " hi " << hi;
+        ASSERT_EQ(index.count_range(lo, hi), keys.size());
+    }
+}
+
+}  // namespace
+
+TEST(RangeScanTest, EmptyIndexAndEmptyRanges) {
+    jazzy::JazzyIndex<std::uint64_t> empty;
+    EXPECT_TRUE(empty.range(1, 5).empty());
+    EXPECT_EQ(empty.count_range(1, 5), 0u);
+
+    const std::vector<std::uint64_t> data{10, 20, 30, 40};
+    jazzy::JazzyIndex<std::uint64_t> index(data.data(), data.data() + data.size());
+    EXPECT_EQ(index.count_range(20, 20), 0u);
+    EXPECT_EQ(index.count_range(21, 29), 0u);
+    EXPECT_EQ(index.range(21, 29).data(), data.data() + 2);
+    EXPECT_EQ(index.count_range(50, 60), 0u);
+    EXPECT_EQ(index.count_range(30, 10), 0u);
+    EXPECT_EQ(index.count_range(0, 100), 4u);
+    EXPECT_EQ(index.count_range(20, 40), 2u);
+    EXPECT_EQ(index.count_range(20, 41), 3u);
+}
+
+TEST(RangeScanTest, UniformAndSkewedData) {
+    std::vector<std::uint64_t> uniform(50'000);
+    std::vector<std::uint64_t> skewed(50'000);
+    for (std::size_t i = 0; i < uniform.size(); ++i) {
+        uniform[i] = i * 3;
+        skewed[i] = static_cast<std::uint64_t>(std::pow(static_cast<double>(i), 2.5)) + i / 4;
+    }
+    std::sort(skewed.begin(), skewed.end());
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> a(uniform.data(), uniform.data() + uniform.size());
+    expect_ranges_match(a, uniform);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MAX> b(skewed.data(), skewed.data() + skewed.size());
+    expect_ranges_match(b, skewed);
+}
+
+TEST(RangeScanTest, EveryLayoutAndRouter) {
+    std::vector<std::uint64_t> data(30'000);
+    std::mt19937_64 rng(3);
+    for (auto& v : data) {
+        v = rng() % 1'000'000;
+    }
+    std::sort(data.begin(), data.end());
+    const auto* first = data.data();
+    const auto* last = first + data.size();
+
+    using Split = jazzy::IndexOptions<jazzy::layout::Split, jazzy::routing::BinarySearch>;
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity, Split> split(first, last);
+    expect_ranges_match(split, data);
+
+    using Compressed = jazzy::IndexOptions<jazzy::layout::Compressed, jazzy::routing::Eytzinger>;
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MAX, std::less<>, jazzy::identity, Compressed> compressed(
+        first, last);
+    expect_ranges_match(compressed, data);
+
+    jazzy::DynamicJazzyIndex<std::uint64_t> dynamic(jazzy::SegmentSizing{.keys_per_segment = 32});
+    dynamic.build(first, last);
+    expect_ranges_match(dynamic, data);
+}
+
+TEST(RangeScanTest, DuplicatesAndDescendingKeys) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t k = 0; k < 400; ++k) {
+        data.insert(data.end(), 1 + (k % 9 == 0 ? 300 : k % 5), k * 2);
+    }
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE> index(data.data(), data.data() + data.size());
+    expect_ranges_match(index, data);
+
+    std::reverse(data.begin(), data.end());
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::greater<>> desc(data.data(),
+                                                                                     data.data() + data.size());
+    expect_ranges_match(desc, data, std::greater<>{});
+}
+
+TEST(RangeScanTest, ForEachVisitsTheRangeInOrder) {
+    std::vector<std::uint64_t> data(10'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = i * 2;
+    }
+    jazzy::JazzyIndex<std::uint64_t> index(data.data(), data.data() + data.size());
+    for (const auto& [lo, hi] : {std::pair<std::uint64_t, std::uint64_t>{0, 20'000}, {100, 101}, {100, 103},
+                                {5, 7'001}, {19'990, 30'000}, {7, 7}}) {
+        std::vector<std::uint64_t> seen;
+        index.for_each_in_range(lo, hi, [&](std::uint64_t key) { seen.push_back(key); });
+        const auto keys = index.range(lo, hi);
+        EXPECT_EQ(seen, std::vector<std::uint64_t>(keys.begin(), keys.end())) << lo << ".." << hi;
+    }
+
+    // Keys wider than a cache line
+    std::vector<Wide> wide(500);
+    for (std::size_t i = 0; i < wide.size(); ++i) {
+        wide[i].key = i;
+    }
+    jazzy::JazzyIndex<Wide, jazzy::SegmentCount::SMALL, WideLess, WideKey> wide_index(wide.data(),
+                                                                                    wide.data() + wide.size());
+    std::uint64_t sum = 0;
+    wide_index.for_each_in_range(Wide{10, {}}, Wide{400, {}}, [&](const Wide& w) { sum += w.key; });
+    EXPECT_EQ(sum, (10 + 399) * 390 / 2);
+}
+
+TEST(RangeScanTest, EqualRangeMatchesStd) {
+    std::vector<std::uint64_t> data;
+    std::mt19937_64 rng(23);
+    for (std::uint64_t k = 0; data.size() < 20'000; ++k) {
+        data.insert(data.end(), 1 + rng() % 12, k * 5);
+    }
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MAX> index(data.data(), data.data() + data.size());
+    for (std::uint64_t probe = 0; probe <= data.back() + 1; ++probe) {
+        const std::uint64_t* begin = data.data();
+        const auto [lower, upper] = std::equal_range(begin, begin + data.size(), probe);
+        const auto [first, last] = index.equal_range(probe);
+        ASSERT_EQ(first, lower) << "probe " << probe;
+        ASSERT_EQ(last, upper) << "probe " << probe;
+    }
+}
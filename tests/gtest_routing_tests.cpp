@@ -0,0 +1,110 @@
+// Tests for segment routing policies (routing::Eytzinger vs routing::BinarySearch)
+// Both policies must pick the same segment, so every query result must match
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_parallel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+
+using BinaryOptions = jazzy::IndexOptions<jazzy::layout::Interleaved, jazzy::routing::BinarySearch>;
+using SplitEytzingerOptions = jazzy::IndexOptions<jazzy::layout::Split, jazzy::routing::Eytzinger>;
+
+std::vector<std::uint64_t> make_skewed(std::size_t n) {
+    std::vector<std::uint64_t> data(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double x = static_cast<double>(i) / static_cast<double>(n);
+        data[i] = static_cast<std::uint64_t>(std::pow(x, 4.0) * 1e12) + i;
+    }
+    return data;
+}
+
+std::vector<std::uint64_t> make_queries(const std::vector<std::uint64_t>& data, std::size_t count) {
+    std::mt19937_64 rng(2024);
+    std::uniform_int_distribution<std::size_t> index_dist(0, data.size() - 1);
+    std::vector<std::uint64_t> queries{0, data.front(), data.back(), data.back() + 1};
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::uint64_t hit = data[index_dist(rng)];
+        queries.push_back(i % 2 == 0 ? hit : hit + 1);
+    }
+    return queries;
+}
+
+template <std::size_t Segments>
+void expect_policies_agree(const std::vector<std::uint64_t>& data) {
+    constexpr auto S = jazzy::to_segment_count<Segments>();
+    jazzy::JazzyIndex<std::uint64_t, S> eytzinger(data.data(), data.data() + data.size());
+    jazzy::JazzyIndex<std::uint64_t, S, std::less<>, jazzy::identity, BinaryOptions> binary(
+        data.data(), data.data() + data.size());
+    jazzy::JazzyIndex<std::uint64_t, S, std::less<>, jazzy::identity, SplitEytzingerOptions> split(
+        data.data(), data.data() + data.size());
+
+    for (const auto q : make_queries(data, 1'000)) {
+        EXPECT_EQ(eytzinger.find(q), binary.find(q)) << "S=" << Segments << " key " << q;
+        EXPECT_EQ(eytzinger.find_lower_bound(q), binary.find_lower_bound(q)) << "S=" << Segments << " key " << q;
+        EXPECT_EQ(eytzinger.find_upper_bound(q), binary.find_upper_bound(q)) << "S=" << Segments << " key " << q;
+        EXPECT_EQ(split.find_lower_bound(q), binary.find_lower_bound(q)) << "S=" << Segments << " key " << q;
+    }
+}
+
+}  // namespace
+
+// Test: Every segment count, including counts that are not a power of two after clamping
+TEST(RoutingTest, EytzingerMatchesBinarySearchAcrossSegmentCounts) {
+    const auto data = make_skewed(50'000);
+    expect_policies_agree<1>(data);
+    expect_policies_agree<2>(data);
+    expect_policies_agree<3>(data);
+    expect_policies_agree<16>(data);
+    expect_policies_agree<100>(data);
+    expect_policies_agree<512>(data);
+    expect_policies_agree<2048>(data);
+
+    // Fewer elements than segments leaves a partially filled tree
+    const auto small = make_skewed(777);
+    expect_policies_agree<1024>(small);
+}
+
+// Test: Duplicate runs that straddle segment boundaries
+TEST(RoutingTest, EytzingerMatchesBinarySearchWithDuplicates) {
+    std::vector<std::uint64_t> data;
+    for (std::uint64_t v = 0; v < 2'000; ++v) {
+        data.insert(data.end(), 1 + (v * v) % 17, v * v);
+    }
+    expect_policies_agree<256>(data);
+}
+
+// Test: Descending comparator, parallel build and batched lookups
+TEST(RoutingTest, EytzingerWithComparatorAndParallelBuild) {
+    std::vector<int> desc(5'000);
+    for (int i = 0; i < 5'000; ++i) {
+        desc[static_cast<std::size_t>(i)] = i * i / 3;
+    }
+    std::reverse(desc.begin(), desc.end());
+
+    jazzy::JazzyIndex<int, jazzy::SegmentCount::LARGE, std::greater<int>> eytzinger;
+    eytzinger.build_parallel(desc.data(), desc.data() + desc.size(), std::greater<int>{});
+    jazzy::JazzyIndex<int, jazzy::SegmentCount::LARGE, std::greater<int>, jazzy::identity, BinaryOptions> binary(
+        desc.data(), desc.data() + desc.size(), std::greater<int>{});
+
+    std::vector<int> queries;
+    for (int q = -5; q < desc.front() + 5; q += 97) {
+        queries.push_back(q);
+    }
+    std::vector<const int*> batch(queries.size());
+    eytzinger.find_upper_bound_batch(queries, batch);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(eytzinger.find(queries[i]), binary.find(queries[i])) << "key " << queries[i];
+        EXPECT_EQ(eytzinger.find_lower_bound(queries[i]), binary.find_lower_bound(queries[i])) << "key " << queries[i];
+        EXPECT_EQ(batch[i], binary.find_upper_bound(queries[i])) << "key " << queries[i];
+    }
+}
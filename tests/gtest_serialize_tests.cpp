@@ -0,0 +1,317 @@
+// Tests for index files (jazzy_index_serialize.hpp): save/load round trips for every layout,
+// routing policy and build mode, JazzyIndexView over saved bytes, and rejection of bad files
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_serialize.hpp"
+#include "test_data.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using jazzy::test::make_skewed;
+
+std::vector<std::uint64_t> make_uniform(std::size_t n) {
+    std::vector<std::uint64_t> data(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        data[i] = i * 10;
+    }
+    return data;
+}
+
+template <typename Index>
+std::string save_to_string(const Index& index, jazzy::KeyData keys = jazzy::KeyData::EMBEDDED) {
+    std::ostringstream out(std::ios::binary);
+    index.save(out, keys);
+    return out.str();
+}
+
+// Saved bytes copied to a 64-byte aligned buffer, as a memory mapping would place them
+class AlignedBytes {
+public:
+    explicit AlignedBytes(const std::string& bytes) : storage_(bytes.size() + 64) {
+        std::size_t skip = 0;
+        while (reinterpret_cast<std::uintptr_t>(storage_.data() + skip) % 64 != 0) {
+            ++skip;
+        }
+        std::memcpy(storage_.data() + skip, bytes.data(), bytes.size());
+        bytes_ = std::span<std::byte>(storage_.data() + skip, bytes.size());
+    }
+
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return bytes_; }
+    [[nodiscard]] std::span<std::byte> mutable_bytes() noexcept { return bytes_; }
+
+private:
+    std::vector<std::byte> storage_;
+    std::span<std::byte> bytes_;
+};
+
+// Lookups on a loaded index or a view agree with std:: algorithms on the same keys
+template <typename Index>
+void expect_matches_std(const Index& index, const std::uint64_t* begin, const std::uint64_t* end,
+                        const std::vector<std::uint64_t>& data) {
+    std::vector<std::uint64_t> queries;
+    for (std::size_t i = 0; i < data.size(); i += 1 + data.size() / 400) {
+        queries.push_back(data[i]);
+        queries.push_back(data[i] + 1);
+    }
+    queries.push_back(0);
+    queries.push_back(data.back() + 100);
+
+    for (const auto q : queries) {
+        const auto* expected_lower = std::lower_bound(begin, end, q);
+        const auto* found = index.find(q);
+        if (expected_lower != end && *expected_lower == q) {
+            ASSERT_NE(found, end) << "key " << q;
+            EXPECT_EQ(*found, q);
+        } else {
+            EXPECT_EQ(found, end) << "key " << q;
+        }
+        EXPECT_EQ(index.find_lower_bound(q), expected_lower) << "key " << q;
+        EXPECT_EQ(index.find_upper_bound(q), std::upper_bound(begin, end, q)) << "key " << q;
+    }
+}
+
+template <typename Index>
+void expect_round_trip(const std::vector<std::uint64_t>& data, bool error_bounded) {
+    Index built;
+    if (error_bounded) {
+        built.build_error_bounded(data.data(), data.data() + data.size(), 16);
+    } else {
+        built.build(data.data(), data.data() + data.size());
+    }
+    const std::string bytes = save_to_string(built, jazzy::KeyData::EXTERNAL);
+
+    Index loaded;
+    std::istringstream in(bytes, std::ios::binary);
+    loaded.load(in, data.data(), data.data() + data.size());
+    EXPECT_EQ(in.tellg(), static_cast<std::streamoff>(bytes.size())) << "load should consume the whole file";
+
+    EXPECT_EQ(loaded.size(), built.size());
+    EXPECT_EQ(loaded.num_segments(), built.num_segments());
+    EXPECT_EQ(loaded.error_bound(), built.error_bound());
+    // Saving the loaded index reproduces the file byte for byte
+    EXPECT_EQ(save_to_string(loaded, jazzy::KeyData::EXTERNAL), bytes);
+    expect_matches_std(loaded, data.data(), data.data() + data.size(), data);
+}
+
+}  // namespace
+
+TEST(SerializeTest, RoundTripAllPolicies) {
+    using jazzy::IndexOptions;
+    namespace layout = jazzy::layout;
+    namespace routing = jazzy::routing;
+
+    for (const auto& data : {make_skewed(20000, 1), make_uniform(5000)}) {
+        for (const bool error_bounded : {false, true}) {
+            SCOPED_TRACE(error_bounded ? "error-bounded" : "equal-count");
+            expect_round_trip<jazzy::JazzyIndex<std::uint64_t>>(data, error_bounded);
+            expect_round_trip<jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>,
+                                                jazzy::identity, IndexOptions<layout::Split>>>(data, error_bounded);
+            expect_round_trip<jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL, std::less<>,
+                                                jazzy::identity,
+                                                IndexOptions<layout::Interleaved, routing::BinarySearch>>>(
+                data, error_bounded);
+            expect_round_trip<jazzy::DynamicJazzyIndex<std::uint64_t>>(data, error_bounded);
+        }
+    }
+}
+
+TEST(SerializeTest, TinyIndexes) {
+    for (const std::size_t n : {0u, 1u, 2u, 3u}) {
+        std::vector<std::uint64_t> data(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            data[i] = 5 + i * 3;
+        }
+        jazzy::JazzyIndex<std::uint64_t> built(data.data(), data.data() + data.size());
+        const std::string bytes = save_to_string(built);
+
+        jazzy::JazzyIndex<std::uint64_t> loaded;
+        std::istringstream in(bytes, std::ios::binary);
+        loaded.load(in, data.data(), data.data() + data.size());
+        EXPECT_EQ(loaded.num_segments(), built.num_segments());
+
+        const AlignedBytes file(bytes);
+        const jazzy::JazzyIndexView<std::uint64_t> view(file.bytes());
+        EXPECT_EQ(view.size(), n);
+        EXPECT_EQ(view.find(4), view.end());
+        for (std::size_t i = 0; i < n; ++i) {
+            EXPECT_EQ(loaded.find(data[i]), data.data() + i);
+            EXPECT_EQ(view.find(data[i]), view.begin() + i);
+        }
+    }
+}
+
+TEST(SerializeTest, ViewOverEmbeddedKeys) {
+    const auto data = make_skewed(50000, 2);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::XLARGE> built(data.data(), data.data() + data.size());
+    const AlignedBytes file(save_to_string(built));
+
+    const jazzy::JazzyIndexView<std::uint64_t> view(file.bytes());
+    EXPECT_EQ(view.size(), data.size());
+    EXPECT_EQ(view.num_segments(), built.num_segments());
+    ASSERT_TRUE(std::equal(view.begin(), view.end(), data.begin(), data.end()));
+    // The view reads the keys in place, inside the file bytes
+    EXPECT_GE(reinterpret_cast<const std::byte*>(view.begin()), file.bytes().data());
+    EXPECT_LE(reinterpret_cast<const std::byte*>(view.end()), file.bytes().data() + file.bytes().size());
+
+    expect_matches_std(view, view.begin(), view.end(), data);
+
+    const auto [lower, upper] = view.equal_range(data[1234]);
+    EXPECT_EQ(lower, view.begin() + (std::lower_bound(data.begin(), data.end(), data[1234]) - data.begin()));
+    EXPECT_EQ(upper, view.begin() + (std::upper_bound(data.begin(), data.end(), data[1234]) - data.begin()));
+}
+
+TEST(SerializeTest, ViewOverExternalKeys) {
+    const auto data = make_uniform(10000);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity,
+                      jazzy::IndexOptions<jazzy::layout::Interleaved, jazzy::routing::BinarySearch>>
+        built(data.data(), data.data() + data.size());
+    const AlignedBytes file(save_to_string(built, jazzy::KeyData::EXTERNAL));
+
+    EXPECT_THROW(jazzy::JazzyIndexView<std::uint64_t>{file.bytes()}, std::invalid_argument);
+    EXPECT_THROW((jazzy::JazzyIndexView<std::uint64_t>{file.bytes(), data.data(), data.data() + 10}),
+                 std::invalid_argument);
+
+    const jazzy::JazzyIndexView<std::uint64_t> view(file.bytes(), data.data(), data.data() + data.size());
+    EXPECT_TRUE(view.is_uniform());
+    expect_matches_std(view, data.data(), data.data() + data.size(), data);
+}
+
+TEST(SerializeTest, ViewOfErrorBoundedBuild) {
+    const auto data = make_skewed(30000, 3);
+    jazzy::DynamicJazzyIndex<std::uint64_t> built;
+    built.build_error_bounded(data.data(), data.data() + data.size(), 8);
+    const AlignedBytes file(save_to_string(built));
+
+    const jazzy::JazzyIndexView<std::uint64_t> view(file.bytes());
+    EXPECT_EQ(view.error_bound(), built.error_bound());
+    EXPECT_EQ(view.num_segments(), built.num_segments());
+    expect_matches_std(view, view.begin(), view.end(), data);
+}
+
+#ifdef JAZZY_HAS_MAPPED_FILE
+TEST(SerializeTest, ViewOverMappedFile) {
+    const auto data = make_skewed(20000, 4);
+    jazzy::JazzyIndex<std::uint64_t> built(data.data(), data.data() + data.size());
+
+    const auto path = std::filesystem::temp_directory_path() / "jazzy_serialize_test.jzi";
+    {
+        std::ofstream out(path, std::ios::binary);
+        built.save(out);
+    }
+
+    {
+        const jazzy::MappedFile mapped(path.string());
+        const jazzy::JazzyIndexView<std::uint64_t> view(mapped.bytes());
+        expect_matches_std(view, view.begin(), view.end(), data);
+    }
+    std::filesystem::remove(path);
+
+    EXPECT_THROW(jazzy::MappedFile{(path / "missing").string()}, std::runtime_error);
+}
+#endif
+
+TEST(SerializeTest, KeyValueRecordsWithExtractor) {
+    struct Record {
+        std::uint32_t key;
+        float payload;
+        bool operator<(const Record& other) const { return key < other.key; }
+    };
+    struct KeyOf {
+        std::uint32_t operator()(const Record& r) const { return r.key; }
+    };
+
+    std::vector<Record> data(3000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = {static_cast<std::uint32_t>(i * i / 5), static_cast<float>(i)};
+    }
+    jazzy::JazzyIndex<Record, jazzy::SegmentCount::MEDIUM, std::less<>, KeyOf> built(data.data(),
+                                                                                    data.data() + data.size());
+    const AlignedBytes file(save_to_string(built));
+
+    const jazzy::JazzyIndexView<Record, std::less<>, KeyOf> view(file.bytes());
+    for (std::size_t i = 0; i < data.size(); i += 7) {
+        const Record* found = view.find(Record{data[i].key, 0.0f});
+        ASSERT_NE(found, view.end());
+        EXPECT_EQ(found->key, data[i].key);
+    }
+}
+
+TEST(SerializeTest, RejectsMismatchedData) {
+    const auto data = make_skewed(5000, 5);
+    jazzy::JazzyIndex<std::uint64_t> built(data.data(), data.data() + data.size());
+    const std::string bytes = save_to_string(built);
+
+    {
+        // Different key count
+        jazzy::JazzyIndex<std::uint64_t> loaded;
+        std::istringstream in(bytes, std::ios::binary);
+        EXPECT_THROW(loaded.load(in, data.data(), data.data() + data.size() - 1), std::runtime_error);
+    }
+    {
+        // Different key type of the same size
+        std::vector<double> doubles(data.begin(), data.end());
+        jazzy::JazzyIndex<double> loaded;
+        std::istringstream in(bytes, std::ios::binary);
+        EXPECT_THROW(loaded.load(in, doubles.data(), doubles.data() + doubles.size()), std::runtime_error);
+    }
+    {
+        // More segments than the index can hold
+        jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL> loaded;
+        std::istringstream in(bytes, std::ios::binary);
+        EXPECT_THROW(loaded.load(in, data.data(), data.data() + data.size()), std::runtime_error);
+    }
+}
+
+TEST(SerializeTest, RejectsCorruptFiles) {
+    const auto data = make_skewed(5000, 6);
+    jazzy::JazzyIndex<std::uint64_t> built(data.data(), data.data() + data.size());
+    const std::string bytes = save_to_string(built);
+
+    auto expect_rejected = [&data](std::string corrupt) {
+        jazzy::JazzyIndex<std::uint64_t> loaded;
+        std::istringstream in(corrupt, std::ios::binary);
+        EXPECT_THROW(loaded.load(in, data.data(), data.data() + data.size()), std::runtime_error);
+        AlignedBytes file(corrupt);
+        EXPECT_THROW(jazzy::JazzyIndexView<std::uint64_t>{file.bytes()}, std::runtime_error);
+    };
+
+    std::string bad_magic = bytes;
+    bad_magic[0] = 'X';
+    expect_rejected(bad_magic);
+
+    // Version and byte order mark follow the 8-byte magic
+    std::string bad_version = bytes;
+    bad_version[8] = static_cast<char>(bad_version[8] + 1);
+    expect_rejected(bad_version);
+
+    std::string swapped = bytes;
+    std::reverse(swapped.begin() + 12, swapped.begin() + 16);
+    expect_rejected(swapped);
+
+    expect_rejected(bytes.substr(0, bytes.size() - 8));
+    expect_rejected(bytes.substr(0, 64));
+
+    // Segment extents that no longer tile the keys
+    std::string bad_segment = bytes;
+    jazzy::detail::FileHeader header{};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    jazzy::detail::FileSegment first_segment{};
+    std::memcpy(&first_segment, bytes.data() + header.segments_offset, sizeof(first_segment));
+    first_segment.end_idx += 1;
+    std::memcpy(bad_segment.data() + header.segments_offset, &first_segment, sizeof(first_segment));
+    expect_rejected(bad_segment);
+}
@@ -0,0 +1,373 @@
+// Tests for ShardedJazzyIndex (jazzy_index_sharded.hpp): cutting keys into shards, routing through
+// the root model, bounds that cross shard ends, and batched queries sent to placement domains
+
+#include "jazzy_index_sharded.hpp"
+#include "jazzy_index_executor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+using Index = jazzy::ShardedJazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM>;
+
+// Skewed keys with duplicates: spacing grows along the array, so a line fits the shard starts poorly
+std::vector<std::uint64_t> make_skewed_keys(std::size_t count) {
+    std::vector<std::uint64_t> keys(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keys[i] = static_cast<std::uint64_t>(std::pow(static_cast<double>(i / 3), 1.8));
+    }
+    return keys;
+}
+
+// Every stored key and the gaps around it against std on the original array (nullptr for end)
+template <typename Sharded, typename Compare = std::less<>>
+void expect_matches_std(const Sharded& index, const std::vector<std::uint64_t>& keys, Compare comp = Compare{}) {
+    const auto* begin = keys.data();
+    const auto* end = begin + keys.size();
+    const auto value_or_null = [end](const std::uint64_t* p) {
+        return p == end ? std::optional<std::uint64_t>{} : std::optional<std::uint64_t>{*p};
+    };
+    const auto value_of = [](const std::uint64_t* p) {
+        return p == nullptr ? std::optional<std::uint64_t>{} : std::optional<std::uint64_t>{*p};
+    };
+    std::vector<std::uint64_t> probes;
+    for (std::size_t i = 0; i < keys.size(); i += 7) {
+        probes.push_back(keys[i]);
+        probes.push_back(keys[i] + 1);
+        probes.push_back(keys[i] - 1);
+    }
+    probes.push_back(0);
+    probes.push_back(~std::uint64_t{0});
+    for (const std::uint64_t probe : probes) {
+        const auto* lower = std::lower_bound(begin, end, probe, comp);
+        const auto* upper = std::upper_bound(begin, end, probe, comp);
+        ASSERT_EQ(value_of(index.find_lower_bound(probe)), value_or_null(lower)) << "probe " << probe;
+        ASSERT_EQ(value_of(index.find_upper_bound(probe)), value_or_null(upper)) << "probe " << probe;
+        ASSERT_EQ(index.contains(probe), lower != upper) << "probe " << probe;
+    }
+}
+
+}  // namespace
+
+TEST(ShardedJazzyIndexTest, EmptyAndSingleShard) {
+    Index index;
+    EXPECT_EQ(index.find(1), nullptr);
+    EXPECT_EQ(index.find_lower_bound(1), nullptr);
+
+    const std::vector<std::uint64_t> keys{2, 4, 6, 8};
+    index.build(keys.data(), keys.data() + keys.size(), 1);
+    EXPECT_EQ(index.num_shards(), 1u);
+    EXPECT_EQ(index.size(), 4u);
+    expect_matches_std(index, keys);
+
+    index.build(keys.data(), keys.data(), 4);
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.num_shards(), 0u);
+    EXPECT_FALSE(index.contains(2));
+}
+
+TEST(ShardedJazzyIndexTest, ShardsCopyTheirKeys) {
+    std::vector<std::uint64_t> keys(10'000);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = i * 2;
+    }
+    Index index;
+    index.build(keys.data(), keys.data() + keys.size(), 8);
+    const std::vector<std::uint64_t> expected = keys;
+    keys.assign(keys.size(), 1);  // The input is no longer needed
+
+    EXPECT_EQ(index.num_shards(), 8u);
+    std::size_t total = 0;
+    for (std::size_t s = 0; s < index.num_shards(); ++s) {
+        EXPECT_EQ(index.shard(s).size(), index.shard_keys(s).size());
+        total += index.shard_keys(s).size();
+    }
+    EXPECT_EQ(total, expected.size());
+    expect_matches_std(index, expected);
+    EXPECT_GT(index.memory_usage(), sizeof(Index));
+}
+
+TEST(ShardedJazzyIndexTest, RunsOfEqualKeysStayInOneShard) {
+    // 1000 copies of each key, cut into shards of about 700: cuts move to the end of a run
+    std::vector<std::uint64_t> keys;
+    for (std::uint64_t k = 0; k < 20; ++k) {
+        keys.insert(keys.end(), 1000, k * 10);
+    }
+    Index index;
+    index.build(keys.data(), keys.data() + keys.size(), 28);
+    EXPECT_LE(index.num_shards(), 20u);
+    for (std::size_t s = 0; s + 1 < index.num_shards(); ++s) {
+        EXPECT_NE(index.shard_keys(s).back(), index.shard_keys(s + 1).front());
+    }
+    expect_matches_std(index, keys);
+
+    // More shards than keys leaves one key per shard
+    const std::vector<std::uint64_t> few{1, 5, 9};
+    index.build(few.data(), few.data() + few.size(), 10);
+    EXPECT_EQ(index.num_shards(), 3u);
+    expect_matches_std(index, few);
+}
+
+TEST(ShardedJazzyIndexTest, RootModelRoutesSkewedKeys) {
+    const auto keys = make_skewed_keys(60'000);
+    Index index;
+    index.build(keys.data(), keys.data() + keys.size(), 32);
+    EXPECT_EQ(index.num_shards(), 32u);
+    EXPECT_GE(index.root_error(), 1u);
+    for (std::size_t i = 0; i < keys.size(); i += 13) {
+        const std::size_t s = index.route(keys[i]);
+        const auto shard = index.shard_keys(s);
+        ASSERT_FALSE(keys[i] < shard.front()) << "key " << keys[i];
+        ASSERT_FALSE(shard.back() < keys[i] && s + 1 < index.num_shards() &&
+                     !(keys[i] < index.shard_keys(s + 1).front()))
+            << "key " << keys[i];
+    }
+    expect_matches_std(index, keys);
+}
+
+TEST(ShardedJazzyIndexTest, DescendingKeys) {
+    auto keys = make_skewed_keys(20'000);
+    std::reverse(keys.begin(), keys.end());
+    jazzy::ShardedJazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL, std::greater<>> index;
+    index.build(keys.data(), keys.data() + keys.size(), 6);
+    expect_matches_std(index, keys, std::greater<>{});
+}
+
+TEST(ShardedJazzyIndexTest, UnsortedInputThrows) {
+    std::vector<std::uint64_t> keys(1000);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = i;
+    }
+    std::swap(keys[499], keys[500]);  // Out of order right at a cut
+    Index index;
+    EXPECT_THROW(index.build(keys.data(), keys.data() + keys.size(), 2), std::runtime_error);
+    std::swap(keys[499], keys[500]);
+    std::reverse(keys.begin() + 600, keys.end());  // Out of order inside the second shard
+    EXPECT_THROW(index.build(keys.data(), keys.data() + keys.size(), 2), std::runtime_error);
+    EXPECT_THROW(index.build(keys.data(), keys.data() + keys.size(), 0), std::invalid_argument);
+}
+
+TEST(ShardedJazzyIndexTest, DomainsBuildAndAnswerTheirShards) {
+    const auto keys = make_skewed_keys(80'000);
+    jazzy::parallel::ThreadPool node0(2);
+    jazzy::parallel::ThreadPool node1(2);
+    const std::vector<jazzy::parallel::ThreadPool*> domains{&node0, &node1};
+
+    Index index;
+    index.build(keys.data(), keys.data() + keys.size(), 16, domains);
+    EXPECT_EQ(index.num_domains(), 2u);
+    for (std::size_t s = 0; s < index.num_shards(); ++s) {
+        EXPECT_EQ(index.shard_domain(s), s < 8 ? 0u : 1u);
+    }
+    expect_matches_std(index, keys);
+
+    std::mt19937_64 rng(5);
+    std::vector<std::uint64_t> queries(5000);
+    for (auto& q : queries) {
+        q = keys[rng() % keys.size()] + (rng() % 4 == 0 ? 1 : 0);
+    }
+    queries.push_back(~std::uint64_t{0});
+    std::vector<const std::uint64_t*> found(queries.size());
+    std::vector<const std::uint64_t*> lower(queries.size());
+    std::vector<const std::uint64_t*> upper(queries.size());
+    std::vector<const std::uint64_t*> inline_lower(queries.size());
+    index.find_batch(queries, found, domains);
+    index.find_lower_bound_batch(queries, lower, domains);
+    index.find_upper_bound_batch(queries, upper, domains);
+    index.find_lower_bound_batch(queries, inline_lower);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(found[i], index.find(queries[i]));
+        EXPECT_EQ(lower[i], index.find_lower_bound(queries[i]));
+        EXPECT_EQ(upper[i], index.find_upper_bound(queries[i]));
+        EXPECT_EQ(inline_lower[i], lower[i]);
+    }
+
+    const std::vector<jazzy::parallel::ThreadPool*> one{&node0};
+    EXPECT_THROW(index.find_batch(queries, found, one), std::invalid_argument);
+    std::vector<const std::uint64_t*> short_out(2);
+    EXPECT_THROW(index.find_batch(queries, short_out), std::invalid_argument);
+}
+
+TEST(ShardedJazzyIndexTest, DomainBuildFailureKeepsThePreviousShards) {
+    std::vector<std::uint64_t> keys(4000);
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = i;
+    }
+    jazzy::parallel::InlineExecutor a;
+    jazzy::parallel::InlineExecutor b;
+    const std::vector<jazzy::parallel::InlineExecutor*> domains{&a, &b};
+    Index index;
+    index.build(keys.data(), keys.data() + keys.size(), 4, domains);
+
+    std::vector<std::uint64_t> broken = keys;
+    std::swap(broken[3100], broken[3101]);
+    EXPECT_THROW(index.build(broken.data(), broken.data() + broken.size(), 4, domains), std::runtime_error);
+    EXPECT_EQ(index.num_shards(), 4u);
+    expect_matches_std(index, keys);
+}
+
+namespace {
+
+// keys cut into pages of page_keys (the last one shorter), plus an empty page after the first
+std::vector<std::vector<std::uint64_t>> make_pages(const std::vector<std::uint64_t>& keys, std::size_t page_keys) {
+    std::vector<std::vector<std::uint64_t>> pages;
+    for (std::size_t begin = 0; begin < keys.size(); begin += page_keys) {
+        const std::size_t end = std::min(keys.size(), begin + page_keys);
+        pages.emplace_back(keys.begin() + static_cast<std::ptrdiff_t>(begin),
+                           keys.begin() + static_cast<std::ptrdiff_t>(end));
+        if (pages.size() == 1) {
+            pages.emplace_back();
+        }
+    }
+    return pages;
+}
+
+// Whether p points into one of the pages
+bool in_pages(const std::vector<std::vector<std::uint64_t>>& pages, const std::uint64_t* p) {
+    return std::any_of(pages.begin(), pages.end(), [p](const auto& page) {
+        return !page.empty() && p >= page.data() && p < page.data() + page.size();
+    });
+}
+
+}  // namespace
+
+TEST(ShardedJazzyIndexTest, PagesAreBorrowedNotCopied) {
+    const auto keys = make_skewed_keys(50'000);
+    const auto pages = make_pages(keys, 4096);
+    Index index;
+    index.build_pages(pages);
+
+    // One shard per non-empty page, over the page itself
+    ASSERT_EQ(index.num_shards(), pages.size() - 1);
+    for (std::size_t s = 0, p = 0; s < index.num_shards(); ++s, ++p) {
+        p += pages[p].empty() ? 1 : 0;
+        EXPECT_EQ(index.shard_keys(s).data(), pages[p].data());
+        EXPECT_EQ(index.shard_keys(s).size(), pages[p].size());
+    }
+    EXPECT_EQ(index.size(), keys.size());
+    expect_matches_std(index, keys);
+    for (std::size_t i = 0; i < keys.size(); i += 101) {
+        EXPECT_TRUE(in_pages(pages, index.find(keys[i])));
+        EXPECT_TRUE(in_pages(pages, index.find_lower_bound(keys[i])));
+    }
+
+    // Any range of contiguous ranges will do
+    std::vector<std::span<const std::uint64_t>> spans;
+    for (const auto& page : pages) {
+        spans.emplace_back(page);
+    }
+    index.build_pages(spans);
+    expect_matches_std(index, keys);
+
+    index.build_pages(std::vector<std::vector<std::uint64_t>>(3));
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.find_lower_bound(1), nullptr);
+}
+
+TEST(ShardedJazzyIndexTest, PagesMaySplitRunsOfEqualKeys) {
+    // Runs of 2500 equal keys over pages of 1000: a run starts in one page and covers the next
+    std::vector<std::uint64_t> keys;
+    for (std::uint64_t k = 0; k < 12; ++k) {
+        keys.insert(keys.end(), 2500, k * 10);
+    }
+    const auto pages = make_pages(keys, 1000);
+    Index index;
+    index.build_pages(pages);
+    expect_matches_std(index, keys);
+
+    // Bounds land on the first and past the last key of each run, whichever page holds them
+    for (std::uint64_t k = 0; k < 12; ++k) {
+        const std::size_t first = k * 2500;
+        const std::size_t last = first + 2500;
+        const std::uint64_t* lower = index.find_lower_bound(k * 10);
+        const std::uint64_t* upper = index.find_upper_bound(k * 10);
+        const std::size_t page = first / 1000 + (first >= 1000 ? 1 : 0);  // The empty page sits second
+        EXPECT_EQ(lower, pages[page].data() + first % 1000) << "key " << k * 10;
+        if (last < keys.size()) {
+            const std::size_t next_page = last / 1000 + 1;
+            EXPECT_EQ(upper, pages[next_page].data() + last % 1000) << "key " << k * 10;
+        } else {
+            EXPECT_EQ(upper, nullptr);
+        }
+    }
+
+    std::vector<std::uint64_t> queries;
+    for (std::uint64_t q = 0; q < 125; ++q) {
+        queries.push_back(q);
+    }
+    std::vector<const std::uint64_t*> lower(queries.size());
+    std::vector<const std::uint64_t*> upper(queries.size());
+    index.find_lower_bound_batch(queries, lower);
+    index.find_upper_bound_batch(queries, upper);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(lower[i], index.find_lower_bound(queries[i])) << "query " << queries[i];
+        EXPECT_EQ(upper[i], index.find_upper_bound(queries[i])) << "query " << queries[i];
+    }
+}
+
+TEST(ShardedJazzyIndexTest, PrefetchHookSeesEveryRoutedPageFirst) {
+    const auto keys = make_skewed_keys(40'000);
+    const auto pages = make_pages(keys, 2048);
+    Index index;
+    index.build_pages(pages);
+
+    // Keys from three pages only, out of order
+    const std::vector<std::uint64_t> queries{keys[30'000], keys[100], keys[30'001], keys[9000], keys[101] + 1};
+    std::vector<std::size_t> prefetched;
+    std::vector<const std::uint64_t*> found(queries.size());
+    index.find_batch(queries, found, [&](std::size_t s, std::span<const std::uint64_t> page) {
+        EXPECT_EQ(page.data(), index.shard_keys(s).data());
+        prefetched.push_back(s);
+    });
+    EXPECT_EQ(prefetched, (std::vector<std::size_t>{index.route(keys[100]), index.route(keys[9000]),
+                                                    index.route(keys[30'000])}));
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(found[i], index.find(queries[i]));
+    }
+
+    std::size_t calls = 0;
+    std::vector<const std::uint64_t*> lower(queries.size());
+    std::vector<const std::uint64_t*> upper(queries.size());
+    const auto count = [&calls](std::size_t, std::span<const std::uint64_t>) { ++calls; };
+    index.find_lower_bound_batch(queries, lower, count);
+    index.find_upper_bound_batch(queries, upper, count);
+    EXPECT_EQ(calls, 6u);
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_EQ(lower[i], index.find_lower_bound(queries[i]));
+        EXPECT_EQ(upper[i], index.find_upper_bound(queries[i]));
+    }
+}
+
+TEST(ShardedJazzyIndexTest, PagesOnDomainsAndOutOfOrderPages) {
+    auto keys = make_skewed_keys(30'000);
+    jazzy::parallel::ThreadPool node0(2);
+    jazzy::parallel::ThreadPool node1(2);
+    const std::vector<jazzy::parallel::ThreadPool*> domains{&node0, &node1};
+    auto pages = make_pages(keys, 1024);
+    Index index;
+    index.build_pages(pages, domains);
+    EXPECT_EQ(index.num_domains(), 2u);
+    expect_matches_std(index, keys);
+
+    std::swap(pages[3], pages[4]);
+    EXPECT_THROW(index.build_pages(pages), std::runtime_error);
+    EXPECT_THROW(index.build_pages(pages, domains), std::runtime_error);
+    expect_matches_std(index, keys);  // The previous pages stay indexed
+
+    std::reverse(keys.begin(), keys.end());
+    const auto descending = make_pages(keys, 3000);
+    jazzy::ShardedJazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL, std::greater<>> down;
+    down.build_pages(descending, std::greater<>{});
+    expect_matches_std(down, keys, std::greater<>{});
+}
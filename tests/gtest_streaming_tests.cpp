@@ -0,0 +1,214 @@
+// Tests for StreamingIndexWriter (jazzy_index_streaming.hpp): index files written from keys
+// appended one at a time, loaded and viewed over the same keys, against builds and std:: algorithms
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_serialize.hpp"
+#include "jazzy_index_streaming.hpp"
+#include "test_data.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using jazzy::test::make_skewed;
+
+// The keys as text, read back through a single-pass iterator
+std::string as_text(const std::vector<std::uint64_t>& data) {
+    std::ostringstream text;
+    for (const auto v : data) {
+        text << v << '\n';
+    }
+    return text.str();
+}
+
+template <typename Writer>
+std::string finish_to_string(Writer& writer) {
+    std::ostringstream out(std::ios::binary);
+    writer.finish(out);
+    return out.str();
+}
+
+template <typename Index>
+Index load_from_string(const std::string& bytes, const std::vector<std::uint64_t>& data, Index index = Index{}) {
+    std::istringstream in(bytes, std::ios::binary);
+    index.load(in, data.data(), data.data() + data.size());
+    return index;
+}
+
+// Lookups agree with std:: algorithms on the same keys
+template <typename Index>
+void expect_matches_std(const Index& index, const std::vector<std::uint64_t>& data) {
+    const auto* begin = data.data();
+    const auto* end = begin + data.size();
+    std::vector<std::uint64_t> queries{0, data.back() + 100};
+    for (std::size_t i = 0; i < data.size(); i += 1 + data.size() / 500) {
+        queries.push_back(data[i]);
+        queries.push_back(data[i] + 1);
+    }
+    for (const auto q : queries) {
+        const auto* lower = std::lower_bound(begin, end, q);
+        const auto* found = index.find(q);
+        if (lower != end && *lower == q) {
+            ASSERT_NE(found, end) << "key " << q;
+            EXPECT_EQ(*found, q);
+        } else {
+            EXPECT_EQ(found, end) << "key " << q;
+        }
+        EXPECT_EQ(index.find_lower_bound(q), lower) << "key " << q;
+        EXPECT_EQ(index.find_upper_bound(q), std::upper_bound(begin, end, q)) << "key " << q;
+    }
+}
+
+}  // namespace
+
+TEST(StreamingIndexWriterTest, KnownCountCutsSegmentsLikeBuild) {
+    const auto data = make_skewed(100'003, 1);
+    jazzy::StreamingIndexWriter<std::uint64_t> writer(data.size(), 256);
+    std::istringstream text(as_text(data));
+    writer.append(std::istream_iterator<std::uint64_t>(text), std::istream_iterator<std::uint64_t>());
+    EXPECT_EQ(writer.size(), data.size());
+    EXPECT_EQ(writer.num_segments(), 256u);  // The last key closed the last segment
+    const std::string bytes = finish_to_string(writer);
+
+    using Index = jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE>;
+    const Index built(data.data(), data.data() + data.size());
+    const auto loaded = load_from_string<Index>(bytes, data);
+    EXPECT_EQ(loaded.num_segments(), built.num_segments());
+    EXPECT_EQ(loaded.query_path(), built.query_path());
+    // Same segment extents as the build's file, with models fitted from each segment's keys alone
+    std::ostringstream saved(std::ios::binary);
+    built.save(saved, jazzy::KeyData::EXTERNAL);
+    ASSERT_EQ(saved.str().size(), bytes.size());
+    jazzy::detail::FileHeader streamed_header{};
+    jazzy::detail::FileHeader built_header{};
+    std::memcpy(&streamed_header, bytes.data(), sizeof(streamed_header));
+    std::memcpy(&built_header, saved.str().data(), sizeof(built_header));
+    EXPECT_EQ(streamed_header.flags, built_header.flags);
+    for (std::size_t i = 0; i < 256; ++i) {
+        jazzy::detail::FileSegment streamed{};
+        jazzy::detail::FileSegment saved_segment{};
+        const std::size_t at = streamed_header.segments_offset + i * sizeof(jazzy::detail::FileSegment);
+        std::memcpy(&streamed, bytes.data() + at, sizeof(streamed));
+        std::memcpy(&saved_segment, saved.str().data() + at, sizeof(saved_segment));
+        EXPECT_EQ(streamed.start_idx, saved_segment.start_idx);
+        EXPECT_EQ(streamed.end_idx, saved_segment.end_idx);
+    }
+    EXPECT_EQ(std::memcmp(bytes.data() + streamed_header.route_keys_offset,
+                          saved.str().data() + built_header.route_keys_offset, 256 * sizeof(std::uint64_t)),
+              0);
+    expect_matches_std(loaded, data);
+
+    // In place, as over mapped index and key files
+    std::vector<std::uint64_t> aligned((bytes.size() + 7) / 8);
+    std::memcpy(aligned.data(), bytes.data(), bytes.size());
+    const jazzy::JazzyIndexView<std::uint64_t> view(
+        std::as_bytes(std::span(aligned)).first(bytes.size()), data.data(), data.data() + data.size());
+    EXPECT_EQ(view.num_segments(), 256u);
+    expect_matches_std(view, data);
+}
+
+TEST(StreamingIndexWriterTest, UniformKeysKeepArithmeticRouting) {
+    std::vector<std::uint64_t> data(50'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = 1000 + i * 7;
+    }
+    jazzy::StreamingIndexWriter<std::uint64_t> writer(data.size(), 128);
+    writer.append(data.begin(), data.end());
+    const std::string bytes = finish_to_string(writer);
+
+    using Index = jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM>;
+    const auto loaded = load_from_string<Index>(bytes, data);
+    EXPECT_EQ(loaded.query_path(), jazzy::QueryPath::LINEAR_UNIFORM);
+    EXPECT_EQ(loaded.max_segment_error(), 0u);
+    expect_matches_std(loaded, data);
+}
+
+TEST(StreamingIndexWriterTest, SegmentSizingWithoutAKeyCount) {
+    auto data = make_skewed(70'500, 2);
+    for (std::size_t i = 30'000; i < 31'000; ++i) {
+        data[i] = data[30'000];  // A run across a segment boundary
+    }
+    std::sort(data.begin(), data.end());
+    jazzy::StreamingIndexWriter<std::uint64_t> writer(jazzy::SegmentSizing{.keys_per_segment = 1000, .max_segments = 100});
+    for (const auto v : data) {
+        writer.append(v);
+    }
+    EXPECT_EQ(writer.num_segments(), 70u);  // The partial segment is fitted by finish
+    const std::string bytes = finish_to_string(writer);
+
+    const auto loaded = load_from_string(
+        bytes, data, jazzy::DynamicJazzyIndex<std::uint64_t>(jazzy::SegmentSizing{.keys_per_segment = 1000}));
+    EXPECT_EQ(loaded.num_segments(), 71u);
+    expect_matches_std(loaded, data);
+
+    // A fixed-size index needs room for every segment
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL> small;
+    std::istringstream in(bytes, std::ios::binary);
+    EXPECT_THROW(small.load(in, data.data(), data.data() + data.size()), std::runtime_error);
+
+    jazzy::StreamingIndexWriter<std::uint64_t> capped(jazzy::SegmentSizing{.keys_per_segment = 10, .max_segments = 3});
+    capped.append(data.begin(), data.begin() + 30);
+    EXPECT_THROW(capped.append(data[30]), std::runtime_error);
+}
+
+TEST(StreamingIndexWriterTest, DescendingKeysAndKeyExtractor) {
+    auto data = make_skewed(20'000, 3);
+    std::reverse(data.begin(), data.end());
+    jazzy::StreamingIndexWriter<std::uint64_t, std::greater<>> writer(data.size(), 64, std::greater<>{});
+    writer.append(data.begin(), data.end());
+    const std::string bytes = finish_to_string(writer);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL, std::greater<>> loaded;
+    std::istringstream in(bytes, std::ios::binary);
+    loaded.load(in, data.data(), data.data() + data.size(), std::greater<>{});
+    for (std::size_t i = 0; i < data.size(); i += 37) {
+        const auto expected = std::lower_bound(data.begin(), data.end(), data[i], std::greater<>{});
+        EXPECT_EQ(loaded.find_lower_bound(data[i]), data.data() + (expected - data.begin()));
+    }
+}
+
+TEST(StreamingIndexWriterTest, SmallInputsAndMisuse) {
+    jazzy::StreamingIndexWriter<std::uint64_t> empty(0, 64);
+    EXPECT_THROW(empty.append(1), std::runtime_error);
+    const std::vector<std::uint64_t> none;
+    const auto empty_index =
+        load_from_string<jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL>>(finish_to_string(empty), none);
+    EXPECT_EQ(empty_index.size(), 0u);
+
+    const std::vector<std::uint64_t> one{42};
+    jazzy::StreamingIndexWriter<std::uint64_t> single(1, 64);
+    single.append(42);
+    const auto single_index =
+        load_from_string<jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::SMALL>>(finish_to_string(single), one);
+    EXPECT_EQ(single_index.num_segments(), 1u);
+    EXPECT_EQ(single_index.find(42), one.data());
+    EXPECT_THROW(single.append(43), std::runtime_error);
+    std::ostringstream again;
+    EXPECT_THROW(single.finish(again), std::runtime_error);
+
+    jazzy::StreamingIndexWriter<std::uint64_t> unsorted(10, 2);
+    unsorted.append(5);
+    EXPECT_THROW(unsorted.append(4), std::runtime_error);
+
+    jazzy::StreamingIndexWriter<std::uint64_t> short_stream(10, 2);
+    short_stream.append(1);
+    std::ostringstream out;
+    EXPECT_THROW(short_stream.finish(out), std::runtime_error);
+
+    EXPECT_THROW(jazzy::StreamingIndexWriter<std::uint64_t>(10, 0), std::invalid_argument);
+    EXPECT_THROW(jazzy::StreamingIndexWriter<std::uint64_t>(10, 5000), std::invalid_argument);
+    EXPECT_THROW(jazzy::StreamingIndexWriter<std::uint64_t>(jazzy::SegmentSizing{.keys_per_segment = 0}),
+                 std::invalid_argument);
+}
@@ -7,6 +7,9 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <numeric>
 #include <vector>
 
@@ -34,6 +37,24 @@ protected:
     }
 };
 
+// Every query function against std on each key, the gaps between keys and both ends
+template <typename IndexType, typename T>
+void expect_queries_match(const IndexType& index, const std::vector<T>& data) {
+    const T* begin = data.data();
+    const T* end = begin + data.size();
+    std::vector<T> probes{std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max()};
+    for (const T& key : data) {
+        probes.insert(probes.end(), {key, static_cast<T>(key - 1), static_cast<T>(key + 1)});
+    }
+    for (const T& probe : probes) {
+        const T* found = std::binary_search(begin, end, probe) ? std::lower_bound(begin, end, probe) : end;
+        ASSERT_EQ(index.find(probe), found) << "probe " << probe;
+        ASSERT_EQ(index.find_lower_bound(probe), std::lower_bound(begin, end, probe)) << "probe " << probe;
+        ASSERT_EQ(index.find_upper_bound(probe), std::upper_bound(begin, end, probe)) << "probe " << probe;
+        ASSERT_EQ(index.equal_range(probe), std::equal_range(begin, end, probe)) << "probe " << probe;
+    }
+}
+
 using IntUniformityTest = UniformityTest<int, 256>;
 using DoubleUniformityTest = UniformityTest<double, 256>;
 
@@ -353,3 +374,57 @@ TEST_F(IntUniformityTest, ManySegmentsUniformData) {
         EXPECT_TRUE(is_found(index.find(i), data, i));
     }
 }
+
+// Test: Uniform data with every segment LINEAR takes the specialized query path
+TEST(QueryPathTest, LinearUniformPath) {
+    std::vector<int> data(5000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<int>(i * 4) - 10'000;  // Negative keys too, for the unsigned range check
+    }
+    jazzy::JazzyIndex<int> index(data.data(), data.data() + data.size());
+    EXPECT_EQ(index.query_path(), jazzy::QueryPath::LINEAR_UNIFORM);
+    expect_queries_match(index, data);
+
+    std::vector<std::uint64_t> wide(20'000);
+    for (std::size_t i = 0; i < wide.size(); ++i) {
+        wide[i] = (std::uint64_t{1} << 40) + i * 1000;
+    }
+    using Split = jazzy::IndexOptions<jazzy::layout::Split, jazzy::routing::BinarySearch>;
+    using Compressed = jazzy::IndexOptions<jazzy::layout::Compressed>;
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity, Split> split(
+        wide.data(), wide.data() + wide.size());
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity, Compressed> compressed(
+        wide.data(), wide.data() + wide.size());
+    EXPECT_EQ(split.query_path(), jazzy::QueryPath::LINEAR_UNIFORM);
+    EXPECT_EQ(compressed.query_path(), jazzy::QueryPath::LINEAR_UNIFORM);
+    expect_queries_match(split, wide);
+    expect_queries_match(compressed, wide);
+}
+
+// Test: Skewed data, empty rebuilds and single keys keep the general path
+TEST(QueryPathTest, GeneralPath) {
+    std::vector<std::uint64_t> skewed(5000);
+    for (std::size_t i = 0; i < skewed.size(); ++i) {
+        skewed[i] = static_cast<std::uint64_t>(i) * i * i;
+    }
+    jazzy::JazzyIndex<std::uint64_t> index(skewed.data(), skewed.data() + skewed.size());
+    EXPECT_EQ(index.query_path(), jazzy::QueryPath::GENERAL);
+    expect_queries_match(index, skewed);
+
+    std::vector<std::uint64_t> uniform(5000);
+    std::iota(uniform.begin(), uniform.end(), std::uint64_t{0});
+    index.build(uniform.data(), uniform.data() + uniform.size());
+    EXPECT_EQ(index.query_path(), jazzy::QueryPath::LINEAR_UNIFORM);
+
+    // Rebuilding over nothing must not leave the unchecked path behind
+    index.build(uniform.data(), uniform.data());
+    EXPECT_EQ(index.query_path(), jazzy::QueryPath::GENERAL);
+    EXPECT_EQ(index.find(3), uniform.data());
+
+    index.build(uniform.data(), uniform.data() + 1);
+    EXPECT_EQ(index.query_path(), jazzy::QueryPath::GENERAL);
+    EXPECT_EQ(*index.find(0), 0u);
+
+    jazzy::JazzyIndex<std::uint64_t> unbuilt;
+    EXPECT_EQ(unbuilt.query_path(), jazzy::QueryPath::GENERAL);
+}
@@ -0,0 +1,227 @@
+// Tests for workload-driven segmentation: rebuild_for_workload() from a query sample and adapt()
+// from counted segment hits, checked for where segments land and against std bounds
+
+#include "jazzy_index.hpp"
+#include "jazzy_index_export.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <regex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Timestamps arriving in bursts: the rate changes every 500 keys, so the data is not uniform
+// and each segment model has some error to lose
+std::vector<std::uint64_t> make_timestamps(std::size_t count) {
+    std::vector<std::uint64_t> data(count);
+    std::mt19937_64 rng(41);
+    std::uint64_t t = 1'000'000;
+    std::uint64_t scale = 1;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (i % 500 == 0) {
+            scale = std::uint64_t{1} << (rng() % 8);
+        }
+        t += 1 + rng() % (200 * scale);
+        data[i] = t;
+    }
+    return data;
+}
+
+// 90% of queries on the most recent 5% of keys, the rest anywhere
+std::vector<std::uint64_t> make_recent_queries(const std::vector<std::uint64_t>& data, std::size_t count) {
+    std::vector<std::uint64_t> queries(count);
+    std::mt19937_64 rng(7);
+    const std::size_t hot_start = data.size() - data.size() / 20;
+    for (auto& q : queries) {
+        const std::size_t i = rng() % 10 != 0 ? hot_start + rng() % (data.size() - hot_start) : rng() % data.size();
+        q = data[i] + (rng() % 4 == 0 ? 1 : 0);
+    }
+    return queries;
+}
+
+// (start_idx, max_error) of every segment, read back from the metadata export
+template <typename Index>
+std::vector<std::pair<std::size_t, std::size_t>> segment_extents(const Index& index) {
+    const std::string json = jazzy::export_index_metadata(index);
+    const std::regex field(R"xxx("start_idx":\s*(\d+)[\s\S]*?"max_error":\s*(\d+))xxx");
+    std::vector<std::pair<std::size_t, std::size_t>> extents;
+    for (auto it = std::sregex_iterator(json.begin(), json.end(), field); it != std::sregex_iterator(); ++it) {
+        extents.emplace_back(std::stoull((*it)[1]), std::stoull((*it)[2]));
+    }
+    return extents;
+}
+
+template <typename Index>
+std::size_t segments_from(const Index& index, std::size_t position) {
+    const auto extents = segment_extents(index);
+    return static_cast<std::size_t>(std::count_if(extents.begin(), extents.end(),
+                                                  [position](const auto& e) { return e.first >= position; }));
+}
+
+template <typename Index, typename Compare = std::less<>>
+void expect_bounds_match(const Index& index, const std::vector<std::uint64_t>& data, Compare comp = Compare{}) {
+    const std::uint64_t* begin = data.data();
+    const std::uint64_t* end = begin + data.size();
+    for (std::size_t i = 0; i < data.size(); i += 3) {
+        for (const std::uint64_t probe : {data[i], data[i] + 1, data[i] - 1}) {
+            ASSERT_EQ(index.find_lower_bound(probe), std::lower_bound(begin, end, probe, comp)) << "probe " << probe;
+            ASSERT_EQ(index.find_upper_bound(probe), std::upper_bound(begin, end, probe, comp)) << "probe " << probe;
+        }
+        ASSERT_EQ(*index.find(data[i]), data[i]);
+    }
+}
+
+}  // namespace
+
+TEST(WorkloadSegmentationTest, HotRangeGetsFinerSegments) {
+    const auto data = make_timestamps(200'000);
+    const auto queries = make_recent_queries(data, 10'000);
+    const std::size_t hot_start = data.size() - data.size() / 20;
+
+    jazzy::JazzyIndex<std::uint64_t> index(data.data(), data.data() + data.size());
+    const std::size_t bytes = index.memory_usage();
+    const std::size_t hot_before = segments_from(index, hot_start);
+    index.rebuild_for_workload(queries);
+
+    // Segments in the hot 5%: about 13 by key count, well over half of the budget after
+    EXPECT_EQ(index.num_segments(), 256u);
+    EXPECT_LE(hot_before, 14u);
+    EXPECT_GT(segments_from(index, hot_start), 128u);
+    EXPECT_EQ(index.memory_usage(), bytes);
+
+    // Short hot segments fit tighter than the equal-count ones did
+    jazzy::JazzyIndex<std::uint64_t> equal(data.data(), data.data() + data.size());
+    const auto worst_from = [hot_start](const auto& extents) {
+        std::size_t worst = 0;
+        for (const auto& [start, max_error] : extents) {
+            worst = start >= hot_start ? std::max(worst, max_error) : worst;
+        }
+        return worst;
+    };
+    EXPECT_LT(worst_from(segment_extents(index)), worst_from(segment_extents(equal)));
+    expect_bounds_match(index, data);
+}
+
+TEST(WorkloadSegmentationTest, NoQueriesMeansEqualCount) {
+    const auto data = make_timestamps(30'001);
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> equal(data.data(), data.data() + data.size());
+    const std::string expected = jazzy::export_index_metadata(equal);
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::MEDIUM> index(data.data(), data.data() + data.size());
+    index.rebuild_for_workload({});
+    EXPECT_EQ(jazzy::export_index_metadata(index), expected);
+
+    const auto queries = make_recent_queries(data, 1000);
+    index.rebuild_for_workload(queries, 0.0);
+    EXPECT_EQ(jazzy::export_index_metadata(index), expected);
+
+    // All of the budget on one key: single-key segments pile up at it, and answers stay exact
+    const std::vector<std::uint64_t> one_key(500, data[20'000]);
+    index.rebuild_for_workload(one_key, 1.0);
+    EXPECT_EQ(index.num_segments(), 128u);
+    EXPECT_GT(segments_from(index, 20'000) - segments_from(index, 20'200), 100u);
+    expect_bounds_match(index, data);
+}
+
+TEST(WorkloadSegmentationTest, UniformIndexKeepsItsSegments) {
+    // Evenly spaced keys are routed in O(1) with exact models; reshaping them can only cost more
+    std::vector<std::uint64_t> data(100'000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = i * 8;
+    }
+    jazzy::JazzyIndex<std::uint64_t> index(data.data(), data.data() + data.size());
+    const std::string expected = jazzy::export_index_metadata(index);
+    index.rebuild_for_workload(make_recent_queries(data, 5000));
+    EXPECT_EQ(jazzy::export_index_metadata(index), expected);
+    expect_bounds_match(index, data);
+}
+
+TEST(WorkloadSegmentationTest, InvalidShareAndTinyIndexes) {
+    const auto data = make_timestamps(1000);
+    jazzy::JazzyIndex<std::uint64_t> index(data.data(), data.data() + data.size());
+    const std::vector<std::uint64_t> queries{data[10], data[500]};
+    EXPECT_THROW(index.rebuild_for_workload(queries, -0.1), std::invalid_argument);
+    EXPECT_THROW(index.rebuild_for_workload(queries, 1.5), std::invalid_argument);
+    EXPECT_THROW(index.rebuild_for_workload(queries, std::numeric_limits<double>::quiet_NaN()),
+                 std::invalid_argument);
+
+    jazzy::JazzyIndex<std::uint64_t> unbuilt;
+    unbuilt.rebuild_for_workload(queries);
+    EXPECT_FALSE(unbuilt.is_built());
+
+    const std::vector<std::uint64_t> single{42};
+    jazzy::JazzyIndex<std::uint64_t> one(single.data(), single.data() + 1);
+    one.rebuild_for_workload(queries);
+    EXPECT_EQ(one.num_segments(), 1u);
+    EXPECT_EQ(*one.find(42), 42u);
+
+    // Queries past either end count against the first and last keys
+    const std::vector<std::uint64_t> outside{0, ~std::uint64_t{0}};
+    index.rebuild_for_workload(outside);
+    expect_bounds_match(index, data);
+}
+
+TEST(WorkloadSegmentationTest, DynamicAndDescendingIndexes) {
+    auto data = make_timestamps(50'000);
+    const auto queries = make_recent_queries(data, 5000);
+
+    jazzy::DynamicJazzyIndex<std::uint64_t> dynamic(jazzy::SegmentSizing{.keys_per_segment = 128});
+    dynamic.build(data.data(), data.data() + data.size());
+    const std::size_t segments = dynamic.num_segments();
+    dynamic.rebuild_for_workload(queries);
+    EXPECT_EQ(dynamic.num_segments(), segments);
+    EXPECT_GT(segments_from(dynamic, data.size() - data.size() / 20), segments / 2);
+    expect_bounds_match(dynamic, data);
+
+    std::reverse(data.begin(), data.end());
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::greater<>> desc(data.data(),
+                                                                                     data.data() + data.size());
+    desc.rebuild_for_workload(queries);
+    EXPECT_LT(segment_extents(desc)[128].first, data.size() / 20);  // Recent keys now come first
+    EXPECT_GT(segment_extents(desc)[200].first, data.size() / 20);
+    expect_bounds_match(desc, data, std::greater<>{});
+}
+
+TEST(WorkloadSegmentationTest, AdaptFollowsCountedQueries) {
+    using Options = jazzy::IndexOptions<jazzy::layout::Interleaved, jazzy::routing::Eytzinger, jazzy::stats::PerThread>;
+    const auto data = make_timestamps(200'000);
+    const auto queries = make_recent_queries(data, 20'000);
+    const std::size_t hot_start = data.size() - data.size() / 20;
+
+    jazzy::JazzyIndex<std::uint64_t, jazzy::SegmentCount::LARGE, std::less<>, jazzy::identity, Options> index(
+        data.data(), data.data() + data.size());
+    index.adapt();  // Nothing counted yet
+    EXPECT_LE(segments_from(index, hot_start), 14u);
+
+    // Mean log2 prediction error over the workload
+    const auto mean_error_bucket = [&index, &queries] {
+        index.reset_query_stats();
+        for (const std::uint64_t q : queries) {
+            static_cast<void>(index.find_lower_bound(q));
+        }
+        const auto stats = index.query_stats();
+        double sum = 0;
+        for (std::size_t b = 0; b < stats.error_histogram.size(); ++b) {
+            sum += static_cast<double>(b * stats.error_histogram[b]);
+        }
+        return sum / static_cast<double>(stats.searches);
+    };
+    const double before = mean_error_bucket();
+
+    index.adapt();
+    EXPECT_EQ(index.query_stats().searches, 0u);  // The rebuild starts the counts over
+    EXPECT_GT(segments_from(index, hot_start), 128u);
+    EXPECT_LT(mean_error_bucket(), before);
+    expect_bounds_match(index, data);
+}
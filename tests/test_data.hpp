@@ -0,0 +1,57 @@
+#pragma once
+
+// Key generators and export helpers shared by the gtest suites
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace jazzy::test {
+
+// Sorted lognormal keys: dense at the low end with a long sparse tail, and duplicates
+inline std::vector<std::uint64_t> make_skewed(std::size_t n, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::lognormal_distribution<double> dist(0.0, 2.0);
+    std::vector<std::uint64_t> data(n);
+    for (auto& v : data) {
+        v = static_cast<std::uint64_t>(dist(rng) * 1000.0);
+    }
+    std::sort(data.begin(), data.end());
+    return data;
+}
+
+// Sorted keys with gaps and runs of duplicates
+inline std::vector<std::uint64_t> make_keys(std::size_t count, std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<std::uint64_t> keys(count);
+    std::uint64_t key = 100;
+    for (auto& k : keys) {
+        key += rng() % 8 == 0 ? 0 : 1 + rng() % 32;
+        k = key;
+    }
+    return keys;
+}
+
+// Keys growing with the cube of their index: curved enough that every default build fits
+// QUADRATIC or CUBIC models
+inline std::vector<std::uint64_t> make_cubic_keys(std::size_t count) {
+    std::vector<std::uint64_t> keys(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keys[i] = static_cast<std::uint64_t>(i) * i * i;
+    }
+    return keys;
+}
+
+// Count of each model type in export_index_metadata's segment list
+inline int count_models(const std::string& json, const std::string& type) {
+    const std::regex model_regex("\"model_type\":\\s*\"" + type + "\"");
+    return static_cast<int>(std::distance(std::sregex_iterator(json.begin(), json.end(), model_regex),
+                                          std::sregex_iterator()));
+}
+
+}  // namespace jazzy::test